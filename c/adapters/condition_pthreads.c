@@ -7,6 +7,7 @@
 #include <iot_logging.h>
 #include <errno.h>
 #include <pthread.h>
+#include <time.h>
 
 DEFINE_ENUM_STRINGS(COND_RESULT, COND_RESULT_VALUES);
 
@@ -52,9 +53,16 @@ COND_RESULT Condition_Wait(COND_HANDLE handle, LOCK_HANDLE lock, int timeout_mil
     {
         if (timeout_milliseconds > 0)
         {
+            /*pthread_cond_timedwait takes an absolute CLOCK_REALTIME deadline, not a duration*/
             struct timespec tm;
-            tm.tv_sec = timeout_milliseconds / 1000;
-            tm.tv_nsec = (timeout_milliseconds % 1000) * 1000000L;
+            (void)clock_gettime(CLOCK_REALTIME, &tm);
+            tm.tv_sec += timeout_milliseconds / 1000;
+            tm.tv_nsec += (timeout_milliseconds % 1000) * 1000000L;
+            if (tm.tv_nsec >= 1000000000L)
+            {
+                tm.tv_sec++;
+                tm.tv_nsec -= 1000000000L;
+            }
             int wait_result = pthread_cond_timedwait((pthread_cond_t *)handle, (pthread_mutex_t *)lock, &tm);
             if (wait_result == ETIMEDOUT)
             {
@@ -1,8 +1,13 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
-#include <stdio.h>
 #include <stdlib.h>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+#include "gballoc.h"
+
+#include <stdio.h>
 #include <string.h>
 #include <stddef.h>
 #include <ctype.h>
@@ -378,34 +383,51 @@ HTTPAPI_RESULT HTTPAPI_ExecuteRequest(HTTP_HANDLE handle, HTTPAPI_REQUEST_TYPE r
                 {
                     /* add headers */
                     struct curl_slist* headers = NULL;
-                    size_t i;
+                    BUFFER_HANDLE wire = BUFFER_new();
 
-                    for (i = 0; i < headersCount; i++)
+                    if (wire == NULL)
+                    {
+                        result = HTTPAPI_ALLOC_FAILED;
+                        LogError("(result = %s)\r\n", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+                    }
+                    else
                     {
-                        char *tempBuffer;
-                        if (HTTPHeaders_GetHeader(httpHeadersHandle, i, &tempBuffer) != HTTP_HEADERS_OK)
+                        /*all the headers are serialized with one allocation, then every "name: value\r\n" line is
+                        terminated in place and handed to curl, which keeps its own copy*/
+                        if (HTTPHeaders_Serialize(httpHeadersHandle, wire) != HTTP_HEADERS_OK)
                         {
-                            /* error */
                             result = HTTPAPI_HTTP_HEADERS_FAILED;
                             LogError("(result = %s)\r\n", ENUM_TO_STRING(HTTPAPI_RESULT, result));
-                            break;
                         }
-                        else
+                        else if (BUFFER_length(wire) > 0)
                         {
-                            struct curl_slist* newHeaders = curl_slist_append(headers, tempBuffer);
-                            if (newHeaders == NULL)
-                            {
-                                result = HTTPAPI_ALLOC_FAILED;
-                                LogError("(result = %s)\r\n", ENUM_TO_STRING(HTTPAPI_RESULT, result));
-                                free(tempBuffer);
-                                break;
-                            }
-                            else
+                            char* line = (char*)BUFFER_u_char(wire);
+                            char* wireEnd = line + BUFFER_length(wire);
+                            while (line < wireEnd)
                             {
-                                free(tempBuffer);
-                                headers = newHeaders;
+                                char* lineEnd = line;
+                                struct curl_slist* newHeaders;
+                                while ((lineEnd[0] != '\r') || (lineEnd[1] != '\n'))
+                                {
+                                    lineEnd++;
+                                }
+                                *lineEnd = '\0';
+
+                                newHeaders = curl_slist_append(headers, line);
+                                if (newHeaders == NULL)
+                                {
+                                    result = HTTPAPI_ALLOC_FAILED;
+                                    LogError("(result = %s)\r\n", ENUM_TO_STRING(HTTPAPI_RESULT, result));
+                                    break;
+                                }
+                                else
+                                {
+                                    headers = newHeaders;
+                                    line = lineEnd + 2;
+                                }
                             }
                         }
+                        BUFFER_delete(wire);
                     }
 
                     if (result == HTTPAPI_OK)
@@ -19,10 +19,12 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include "list.h"
+#include "ring_buffer.h"
 #include "gballoc.h"
 
 #define SOCKET_SUCCESS      0
 #define INVALID_SOCKET      -1
+#define RECEIVE_BUFFER_SIZE 1024
 
 typedef struct PENDING_SOCKET_IO_TAG
 {
@@ -31,6 +33,8 @@ typedef struct PENDING_SOCKET_IO_TAG
     ON_SEND_COMPLETE on_send_complete;
     void* callback_context;
     LIST_HANDLE pending_io_list;
+    /* queueing a pending IO does not allocate a separate list node */
+    LIST_ITEM_INSTANCE list_node;
 } PENDING_SOCKET_IO;
 
 typedef struct SOCKET_IO_INSTANCE_TAG
@@ -44,6 +48,8 @@ typedef struct SOCKET_IO_INSTANCE_TAG
     int port;
     IO_STATE io_state;
     LIST_HANDLE pending_io_list;
+    /* recv writes straight into it and on_bytes_received is handed the same bytes */
+    RING_BUFFER_HANDLE receive_buffer;
 } SOCKET_IO_INSTANCE;
 
 static const IO_INTERFACE_DESCRIPTION socket_io_interface_description = 
@@ -90,7 +96,7 @@ static int add_pending_io(SOCKET_IO_INSTANCE* socket_io_instance, const unsigned
             pending_socket_io->pending_io_list = socket_io_instance->pending_io_list;
             (void)memcpy(pending_socket_io->bytes, buffer, size);
 
-            if (list_add(socket_io_instance->pending_io_list, pending_socket_io) == NULL)
+            if (list_add_node(socket_io_instance->pending_io_list, &pending_socket_io->list_node, pending_socket_io) == NULL)
             {
                 free(pending_socket_io->bytes);
                 free(pending_socket_io);
@@ -137,14 +143,25 @@ CONCRETE_IO_HANDLE socketio_create(void* io_create_parameters, LOGGER_LOG logger
                 }
                 else
                 {
-                    strcpy(result->hostname, socket_io_config->hostname);
-                    result->port = socket_io_config->port;
-                    result->on_bytes_received = NULL;
-                    result->on_io_state_changed = NULL;
-                    result->logger_log = logger_log;
-                    result->socket = INVALID_SOCKET;
-                    result->callback_context = NULL;
-                    result->io_state = IO_STATE_NOT_OPEN;
+                    result->receive_buffer = RING_BUFFER_create(RECEIVE_BUFFER_SIZE);
+                    if (result->receive_buffer == NULL)
+                    {
+                        free(result->hostname);
+                        list_destroy(result->pending_io_list);
+                        free(result);
+                        result = NULL;
+                    }
+                    else
+                    {
+                        strcpy(result->hostname, socket_io_config->hostname);
+                        result->port = socket_io_config->port;
+                        result->on_bytes_received = NULL;
+                        result->on_io_state_changed = NULL;
+                        result->logger_log = logger_log;
+                        result->socket = INVALID_SOCKET;
+                        result->callback_context = NULL;
+                        result->io_state = IO_STATE_NOT_OPEN;
+                    }
                 }
             }
         }
@@ -166,17 +183,19 @@ void socketio_destroy(CONCRETE_IO_HANDLE socket_io)
         while (first_pending_io != NULL)
         {
             PENDING_SOCKET_IO* pending_socket_io = (PENDING_SOCKET_IO*)list_item_get_value(first_pending_io);
+
+            /* the node lives in the pending IO, so it has to be unlinked before it is freed */
+            (void)list_remove(socket_io_instance->pending_io_list, first_pending_io);
             if (pending_socket_io != NULL)
             {
                 free(pending_socket_io->bytes);
                 free(pending_socket_io);
             }
-
-            (void)list_remove(socket_io_instance->pending_io_list, first_pending_io);
             first_pending_io = list_get_head_item(socket_io_instance->pending_io_list);
         }
 
         list_destroy(socket_io_instance->pending_io_list);
+        RING_BUFFER_destroy(socket_io_instance->receive_buffer);
         free(socket_io_instance->hostname);
         free(socket_io);
     }
@@ -378,9 +397,9 @@ void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
                 {
                     if (send_result == INVALID_SOCKET)
                     {
+                        (void)list_remove(socket_io_instance->pending_io_list, first_pending_io);
                         free(pending_socket_io->bytes);
                         free(pending_socket_io);
-                        (void)list_remove(socket_io_instance->pending_io_list, first_pending_io);
 
                         set_io_state(socket_io_instance, IO_STATE_ERROR);
                     }
@@ -397,12 +416,12 @@ void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
                         pending_socket_io->on_send_complete(pending_socket_io->callback_context, send_result);
                     }
 
-                    free(pending_socket_io->bytes);
-                    free(pending_socket_io);
                     if (list_remove(socket_io_instance->pending_io_list, first_pending_io) != 0)
                     {
                         set_io_state(socket_io_instance, IO_STATE_ERROR);
                     }
+                    free(pending_socket_io->bytes);
+                    free(pending_socket_io);
                 }
 
                 first_pending_io = list_get_head_item(socket_io_instance->pending_io_list);
@@ -410,20 +429,30 @@ void socketio_dowork(CONCRETE_IO_HANDLE socket_io)
 
             while (received > 0)
             {
-                unsigned char recv_bytes[1];
-                received = recv(socket_io_instance->socket, recv_bytes, sizeof(recv_bytes), 0);
+                size_t recv_size;
+                unsigned char* recv_bytes = RING_BUFFER_write_region(socket_io_instance->receive_buffer, &recv_size);
+                received = (recv_bytes == NULL) ? 0 : recv(socket_io_instance->socket, recv_bytes, recv_size, 0);
                 if (received > 0)
                 {
-                    int i;
-                    for (i = 0; i < received; i++)
-                    {
-                        LOG(socket_io_instance->logger_log, 0, "<-%02x ", (unsigned char)recv_bytes[i]);
-                    }
+                    const unsigned char* received_bytes;
+                    size_t received_size;
+                    (void)RING_BUFFER_commit_write(socket_io_instance->receive_buffer, (size_t)received);
 
-                    if (socket_io_instance->on_bytes_received != NULL)
+                    /* the buffer is drained after every recv, so this hands over exactly the bytes just received, in place */
+                    while ((received_bytes = RING_BUFFER_read_region(socket_io_instance->receive_buffer, &received_size)) != NULL)
                     {
-                        /* explictly ignoring here the result of the callback */
-                        (void)socket_io_instance->on_bytes_received(socket_io_instance->callback_context, recv_bytes, received);
+                        size_t i;
+                        for (i = 0; i < received_size; i++)
+                        {
+                            LOG(socket_io_instance->logger_log, 0, "<-%02x ", (unsigned char)received_bytes[i]);
+                        }
+
+                        if (socket_io_instance->on_bytes_received != NULL)
+                        {
+                            /* explictly ignoring here the result of the callback */
+                            (void)socket_io_instance->on_bytes_received(socket_io_instance->callback_context, received_bytes, received_size);
+                        }
+                        (void)RING_BUFFER_commit_read(socket_io_instance->receive_buffer, received_size);
                     }
                 }
             }
@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+#include <stdint.h>
+#include <time.h>
+#include "tickcounter.h"
+#include "iot_logging.h"
+
+#define NANOSECONDS_IN_1_SECOND 1000000000
+
+/* CLOCK_MONOTONIC keeps counting while the process sleeps or blocks and is not affected by changes of the system time.
+Reading it goes through the vDSO, so it does not cost a system call */
+typedef struct TICK_COUNTER_INSTANCE_TAG
+{
+	uint64_t start_ns;
+} TICK_COUNTER_INSTANCE;
+
+static int get_monotonic_ns(uint64_t* monotonic_ns)
+{
+	int result;
+	struct timespec now;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		LogError("clock_gettime failed\r\n");
+		result = __LINE__;
+	}
+	else
+	{
+		*monotonic_ns = ((uint64_t)now.tv_sec * NANOSECONDS_IN_1_SECOND) + (uint64_t)now.tv_nsec;
+		result = 0;
+	}
+
+	return result;
+}
+
+TICK_COUNTER_HANDLE tickcounter_create(void)
+{
+	TICK_COUNTER_INSTANCE* result = (TICK_COUNTER_INSTANCE*)malloc(sizeof(TICK_COUNTER_INSTANCE));
+	if (result != NULL)
+	{
+		if (get_monotonic_ns(&result->start_ns) != 0)
+		{
+			free(result);
+			result = NULL;
+		}
+	}
+
+	return result;
+}
+
+void tickcounter_destroy(TICK_COUNTER_HANDLE tick_counter)
+{
+	if (tick_counter != NULL)
+	{
+		free(tick_counter);
+	}
+}
+
+/* the accessors share it instead of calling each other */
+static int get_current_ns(TICK_COUNTER_HANDLE tick_counter, uint64_t* current_ns)
+{
+	int result;
+	uint64_t monotonic_ns;
+
+	if (get_monotonic_ns(&monotonic_ns) != 0)
+	{
+		result = __LINE__;
+	}
+	else
+	{
+		*current_ns = monotonic_ns - ((TICK_COUNTER_INSTANCE*)tick_counter)->start_ns;
+		result = 0;
+	}
+
+	return result;
+}
+
+int tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, uint64_t* current_ms)
+{
+	int result;
+	uint64_t current_ns;
+
+	if (tick_counter == NULL || current_ms == NULL)
+	{
+		result = __LINE__;
+	}
+	else if (get_current_ns(tick_counter, &current_ns) != 0)
+	{
+		result = __LINE__;
+	}
+	else
+	{
+		*current_ms = current_ns / 1000000;
+		result = 0;
+	}
+
+	return result;
+}
+
+int tickcounter_get_current_us(TICK_COUNTER_HANDLE tick_counter, uint64_t* current_us)
+{
+	int result;
+	uint64_t current_ns;
+
+	if (tick_counter == NULL || current_us == NULL)
+	{
+		result = __LINE__;
+	}
+	else if (get_current_ns(tick_counter, &current_ns) != 0)
+	{
+		result = __LINE__;
+	}
+	else
+	{
+		*current_us = current_ns / 1000;
+		result = 0;
+	}
+
+	return result;
+}
+
+int tickcounter_get_current_ns(TICK_COUNTER_HANDLE tick_counter, uint64_t* current_ns)
+{
+	int result;
+
+	if (tick_counter == NULL || current_ns == NULL)
+	{
+		result = __LINE__;
+	}
+	else
+	{
+		result = get_current_ns(tick_counter, current_ns);
+	}
+
+	return result;
+}
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C"
+{
+#else
+#include <stddef.h>
+#endif
+
+/* an arena hands out memory by bumping a pointer in big blocks. Nothing allocated from it is freed on its own,
+everything is released at once by ARENA_reset or ARENA_destroy. It is meant for the temporaries of one operation. */
+typedef struct ARENA_TAG* ARENA_HANDLE;
+
+/* creation. blockSize is the size of the blocks carved by the arena, 0 picks a default */
+extern ARENA_HANDLE ARENA_create(size_t blockSize);
+extern void ARENA_destroy(ARENA_HANDLE arena);
+
+/* allocation. The memory is aligned like malloc's. ARENA_realloc grows the most recent allocation in place when it can,
+otherwise it copies oldSize bytes to a new allocation */
+extern void* ARENA_malloc(ARENA_HANDLE arena, size_t size);
+extern void* ARENA_realloc(ARENA_HANDLE arena, void* ptr, size_t oldSize, size_t size);
+
+/* releases everything allocated so far, the arena keeps one block for reuse */
+extern void ARENA_reset(ARENA_HANDLE arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARENA_H */
@@ -0,0 +1,175 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*this header contains the atomic operations the lock-free parts of the library are built on. They come for three kinds
+of objects, declared with the types below and only ever accessed through the macros of their kind:
+ATOMIC_SIZE    - a size_t
+ATOMIC_POINTER - a void*
+ATOMIC_UINT64  - a uint64_t, for the packed index + tag words that have to be 64 bits wide everywhere
+
+The operations are
+xxx_LOAD(object)                                 - sequentially consistent load
+xxx_LOAD_ACQUIRE(object)                         - load, nothing after it is moved before it
+xxx_STORE_RELEASE(object, value)                 - store, nothing before it is moved after it
+xxx_EXCHANGE(object, value)                      - stores value and returns the previous value, a full barrier
+xxx_COMPARE_EXCHANGE(object, expected, desired)  - stores desired if object holds expected, a full barrier. Returns
+                                                   non-zero when it did. expected shall be a variable, its value after a
+                                                   failed exchange is unspecified
+ATOMIC_SIZE_ADD(object, value)                   - adds value and returns the sum, a full barrier
+xxx_INIT(object, value)                          - initializes an object that no other thread can see yet
+
+The mechanisms are the ones refcount.h considers, in the same order
+C11
+    - will result in #include <stdatomic.h>
+    - the objects are _Atomic, the macros map to the generic atomic_xxx functions
+windows
+    - will result in #include "windows.h"
+    - the objects are volatile and every operation, loads and stores included, is an Interlockedxxx function
+gcc
+    - will result in no include (for gcc these are intrinsics build in)
+    - the objects are volatile, the macros map to the __sync_xxx builtins, loads and stores are fenced by __sync_synchronize
+other cases
+    - ATOMIC_NOT_SUPPORTED is defined and the operations are plain reads and writes. Code that cannot fall back to
+      something that works without atomics shall refuse to build then, unless REFCOUNT_ATOMIC_DONTCARE is defined.
+
+The C++ compilers the unit tests are built with do not define __STDC_VERSION__, so a C++ translation unit sees the
+windows/gcc declaration of an object, which has the same representation as its C11 declaration.
+*/
+
+#ifndef ATOMICS_H
+#define ATOMICS_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ == 201112) && (__STDC_NO_ATOMICS__!=1)
+#include <stdatomic.h>
+typedef atomic_size_t ATOMIC_SIZE;
+typedef _Atomic(void*) ATOMIC_POINTER;
+typedef _Atomic(uint64_t) ATOMIC_UINT64;
+
+#define ATOMIC_GENERIC_LOAD(object) atomic_load(object)
+#define ATOMIC_GENERIC_LOAD_ACQUIRE(object) atomic_load_explicit((object), memory_order_acquire)
+#define ATOMIC_GENERIC_STORE_RELEASE(object, value) atomic_store_explicit((object), (value), memory_order_release)
+#define ATOMIC_GENERIC_EXCHANGE(object, value) atomic_exchange((object), (value))
+#define ATOMIC_GENERIC_COMPARE_EXCHANGE(object, expected, desired) atomic_compare_exchange_strong((object), &(expected), (desired))
+#define ATOMIC_GENERIC_INIT(object, value) atomic_init((object), (value))
+
+#define ATOMIC_SIZE_ADD(object, value) (atomic_fetch_add((object), (value)) + (value))
+
+#elif defined(WIN32)
+#include "windows.h"
+typedef volatile size_t ATOMIC_SIZE;
+typedef void* volatile ATOMIC_POINTER;
+typedef volatile LONGLONG ATOMIC_UINT64;
+
+/*size_t and void* have the same size on windows, both go through the pointer sized functions*/
+#define ATOMIC_SIZE_LOAD(object) (size_t)InterlockedCompareExchangePointer((PVOID volatile*)(object), NULL, NULL)
+#define ATOMIC_SIZE_LOAD_ACQUIRE(object) ATOMIC_SIZE_LOAD(object)
+#define ATOMIC_SIZE_STORE_RELEASE(object, value) (void)InterlockedExchangePointer((PVOID volatile*)(object), (PVOID)(value))
+#define ATOMIC_SIZE_EXCHANGE(object, value) (size_t)InterlockedExchangePointer((PVOID volatile*)(object), (PVOID)(value))
+#define ATOMIC_SIZE_COMPARE_EXCHANGE(object, expected, desired) (InterlockedCompareExchangePointer((PVOID volatile*)(object), (PVOID)(desired), (PVOID)(expected)) == (PVOID)(expected))
+#define ATOMIC_SIZE_ADD(object, value) ((size_t)InterlockedExchangeAddSizeT((object), (value)) + (value))
+#define ATOMIC_SIZE_INIT(object, value) (*(object) = (value))
+
+#define ATOMIC_POINTER_LOAD(object) InterlockedCompareExchangePointer((object), NULL, NULL)
+#define ATOMIC_POINTER_LOAD_ACQUIRE(object) ATOMIC_POINTER_LOAD(object)
+#define ATOMIC_POINTER_STORE_RELEASE(object, value) (void)InterlockedExchangePointer((object), (value))
+#define ATOMIC_POINTER_EXCHANGE(object, value) InterlockedExchangePointer((object), (value))
+#define ATOMIC_POINTER_COMPARE_EXCHANGE(object, expected, desired) (InterlockedCompareExchangePointer((object), (desired), (expected)) == (expected))
+#define ATOMIC_POINTER_INIT(object, value) (*(object) = (value))
+
+#define ATOMIC_UINT64_LOAD(object) (uint64_t)InterlockedCompareExchange64((object), 0, 0)
+#define ATOMIC_UINT64_LOAD_ACQUIRE(object) ATOMIC_UINT64_LOAD(object)
+#define ATOMIC_UINT64_STORE_RELEASE(object, value) (void)InterlockedExchange64((object), (LONGLONG)(value))
+#define ATOMIC_UINT64_EXCHANGE(object, value) (uint64_t)InterlockedExchange64((object), (LONGLONG)(value))
+#define ATOMIC_UINT64_COMPARE_EXCHANGE(object, expected, desired) (InterlockedCompareExchange64((object), (LONGLONG)(desired), (LONGLONG)(expected)) == (LONGLONG)(expected))
+#define ATOMIC_UINT64_INIT(object, value) (*(object) = (LONGLONG)(value))
+
+#elif defined(__GNUC__)
+typedef volatile size_t ATOMIC_SIZE;
+typedef void* volatile ATOMIC_POINTER;
+typedef volatile uint64_t ATOMIC_UINT64;
+
+/*__sync_lock_test_and_set is only an acquire barrier, the full barrier in front of it makes the exchange a full one*/
+#define ATOMIC_GENERIC_LOAD(object) (__sync_synchronize(), ATOMIC_GENERIC_LOAD_ACQUIRE(object))
+#define ATOMIC_GENERIC_LOAD_ACQUIRE(object) __extension__ ({ __typeof__(*(object)) atomicValue = *(object); __sync_synchronize(); atomicValue; })
+#define ATOMIC_GENERIC_STORE_RELEASE(object, value) (__sync_synchronize(), (void)(*(object) = (value)))
+#define ATOMIC_GENERIC_EXCHANGE(object, value) (__sync_synchronize(), __sync_lock_test_and_set((object), (value)))
+#define ATOMIC_GENERIC_COMPARE_EXCHANGE(object, expected, desired) __sync_bool_compare_and_swap((object), (expected), (desired))
+#define ATOMIC_GENERIC_INIT(object, value) (*(object) = (value))
+
+#define ATOMIC_SIZE_ADD(object, value) __sync_add_and_fetch((object), (value))
+
+#else
+#define ATOMIC_NOT_SUPPORTED
+typedef size_t ATOMIC_SIZE;
+typedef void* ATOMIC_POINTER;
+typedef uint64_t ATOMIC_UINT64;
+
+#define ATOMIC_GENERIC_LOAD(object) (*(object))
+#define ATOMIC_GENERIC_LOAD_ACQUIRE(object) (*(object))
+#define ATOMIC_GENERIC_STORE_RELEASE(object, value) (void)(*(object) = (value))
+#define ATOMIC_GENERIC_COMPARE_EXCHANGE(object, expected, desired) ((*(object) == (expected)) ? ((*(object) = (desired)), 1) : 0)
+#define ATOMIC_GENERIC_INIT(object, value) (*(object) = (value))
+
+#define ATOMIC_SIZE_ADD(object, value) (*(object) += (value))
+#define ATOMIC_SIZE_EXCHANGE(object, value) atomicsExchangeSize((object), (value))
+#define ATOMIC_POINTER_EXCHANGE(object, value) atomicsExchangePointer((object), (value))
+#define ATOMIC_UINT64_EXCHANGE(object, value) atomicsExchangeUint64((object), (value))
+
+static size_t atomicsExchangeSize(ATOMIC_SIZE* object, size_t value)
+{
+    size_t result = *object;
+    *object = value;
+    return result;
+}
+
+static void* atomicsExchangePointer(ATOMIC_POINTER* object, void* value)
+{
+    void* result = *object;
+    *object = value;
+    return result;
+}
+
+static uint64_t atomicsExchangeUint64(ATOMIC_UINT64* object, uint64_t value)
+{
+    uint64_t result = *object;
+    *object = value;
+    return result;
+}
+#endif
+
+/*where the operations do not depend on the kind of object, the kinds share them*/
+#ifdef ATOMIC_GENERIC_LOAD
+#define ATOMIC_SIZE_LOAD(object) ATOMIC_GENERIC_LOAD(object)
+#define ATOMIC_SIZE_LOAD_ACQUIRE(object) ATOMIC_GENERIC_LOAD_ACQUIRE(object)
+#define ATOMIC_SIZE_STORE_RELEASE(object, value) ATOMIC_GENERIC_STORE_RELEASE((object), (value))
+#define ATOMIC_SIZE_COMPARE_EXCHANGE(object, expected, desired) ATOMIC_GENERIC_COMPARE_EXCHANGE((object), expected, (desired))
+#define ATOMIC_SIZE_INIT(object, value) ATOMIC_GENERIC_INIT((object), (value))
+
+#define ATOMIC_POINTER_LOAD(object) ATOMIC_GENERIC_LOAD(object)
+#define ATOMIC_POINTER_LOAD_ACQUIRE(object) ATOMIC_GENERIC_LOAD_ACQUIRE(object)
+#define ATOMIC_POINTER_STORE_RELEASE(object, value) ATOMIC_GENERIC_STORE_RELEASE((object), (value))
+#define ATOMIC_POINTER_COMPARE_EXCHANGE(object, expected, desired) ATOMIC_GENERIC_COMPARE_EXCHANGE((object), expected, (desired))
+#define ATOMIC_POINTER_INIT(object, value) ATOMIC_GENERIC_INIT((object), (value))
+
+#define ATOMIC_UINT64_LOAD(object) ATOMIC_GENERIC_LOAD(object)
+#define ATOMIC_UINT64_LOAD_ACQUIRE(object) ATOMIC_GENERIC_LOAD_ACQUIRE(object)
+#define ATOMIC_UINT64_STORE_RELEASE(object, value) ATOMIC_GENERIC_STORE_RELEASE((object), (value))
+#define ATOMIC_UINT64_COMPARE_EXCHANGE(object, expected, desired) ATOMIC_GENERIC_COMPARE_EXCHANGE((object), expected, (desired))
+#define ATOMIC_UINT64_INIT(object, value) ATOMIC_GENERIC_INIT((object), (value))
+#endif
+
+#ifdef ATOMIC_GENERIC_EXCHANGE
+#define ATOMIC_SIZE_EXCHANGE(object, value) ATOMIC_GENERIC_EXCHANGE((object), (value))
+#define ATOMIC_POINTER_EXCHANGE(object, value) ATOMIC_GENERIC_EXCHANGE((object), (value))
+#define ATOMIC_UINT64_EXCHANGE(object, value) ATOMIC_GENERIC_EXCHANGE((object), (value))
+#endif
+
+#endif /*ATOMICS_H*/
@@ -12,10 +12,15 @@ extern "C"
 #include <stddef.h>
 #endif
 
+#include "arena.h"
+
 typedef struct BUFFER_TAG* BUFFER_HANDLE;
 
 extern BUFFER_HANDLE BUFFER_new(void);
 extern BUFFER_HANDLE BUFFER_create(const unsigned char* source, size_t size);
+/* the buffer and its bytes come from arena, BUFFER_delete releases nothing and the memory goes away with the arena */
+extern BUFFER_HANDLE BUFFER_new_in_arena(ARENA_HANDLE arena);
+extern BUFFER_HANDLE BUFFER_create_in_arena(ARENA_HANDLE arena, const unsigned char* source, size_t size);
 extern void BUFFER_delete(BUFFER_HANDLE handle);
 extern int BUFFER_pre_build(BUFFER_HANDLE handle, size_t size);
 extern int BUFFER_build(BUFFER_HANDLE handle, const unsigned char* source, size_t size);
@@ -28,6 +33,25 @@ extern int BUFFER_prepend(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2);
 extern unsigned char* BUFFER_u_char(BUFFER_HANDLE handle);
 extern size_t BUFFER_length(BUFFER_HANDLE handle);
 extern BUFFER_HANDLE BUFFER_clone(BUFFER_HANDLE handle);
+/* the storage of a buffer grows geometrically. BUFFER_reserve makes room for capacity bytes upfront,
+BUFFER_shrink_to_fit gives back what is not used by the content */
+extern int BUFFER_reserve(BUFFER_HANDLE handle, size_t capacity);
+extern int BUFFER_shrink_to_fit(BUFFER_HANDLE handle);
+/* BUFFER_share and BUFFER_slice return a new buffer that views all or length bytes from offset of handle without copying them.
+The bytes are ref counted and copied by the first buffer that modifies them, BUFFER_u_char counts as a modification since it
+gives write access, BUFFER_content does not. A shared buffer created in an arena still needs BUFFER_delete to release the sharing */
+extern BUFFER_HANDLE BUFFER_share(BUFFER_HANDLE handle);
+extern BUFFER_HANDLE BUFFER_slice(BUFFER_HANDLE handle, size_t offset, size_t length);
+
+/* a pool keeps bufferCount buffers with bufferSize bytes of storage each and recycles them through a lock-free free list.
+BUFFER_POOL_acquire returns an empty buffer with room for bufferSize bytes; when all the buffers of the pool are in use it
+returns a heap buffer instead. BUFFER_delete gives a buffer of the pool back to it. All the buffers acquired from a pool
+shall be deleted before the pool is destroyed */
+typedef struct BUFFER_POOL_TAG* BUFFER_POOL_HANDLE;
+
+extern BUFFER_POOL_HANDLE BUFFER_POOL_create(size_t bufferCount, size_t bufferSize);
+extern void BUFFER_POOL_destroy(BUFFER_POOL_HANDLE pool);
+extern BUFFER_HANDLE BUFFER_POOL_acquire(BUFFER_POOL_HANDLE pool);
 
 #ifdef __cplusplus
 }
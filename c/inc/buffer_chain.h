@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef BUFFER_CHAIN_H
+#define BUFFER_CHAIN_H
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C"
+{
+#else
+#include <stddef.h>
+#endif
+
+#include "buffer_.h"
+
+#ifndef WIN32
+#include <sys/uio.h>
+#endif
+
+/* a chain is a sequence of buffers (segments) that is read as one payload. Segments are appended and prepended in
+constant time without copying their bytes, so a message can be framed (header, body, trailer) without flattening it */
+typedef struct BUFFER_CHAIN_TAG* BUFFER_CHAIN_HANDLE;
+
+extern BUFFER_CHAIN_HANDLE BUFFER_CHAIN_create(void);
+/* deletes the chain and every segment in it */
+extern void BUFFER_CHAIN_destroy(BUFFER_CHAIN_HANDLE chain);
+
+/* the chain owns segment once these succeed, it is deleted with the chain. BUFFER_share gives a segment that leaves
+the original buffer with the caller. A segment must not be modified while it is in the chain */
+extern int BUFFER_CHAIN_append(BUFFER_CHAIN_HANDLE chain, BUFFER_HANDLE segment);
+extern int BUFFER_CHAIN_prepend(BUFFER_CHAIN_HANDLE chain, BUFFER_HANDLE segment);
+
+/* the number of segments and the total number of bytes in the chain */
+extern size_t BUFFER_CHAIN_segment_count(BUFFER_CHAIN_HANDLE chain);
+extern size_t BUFFER_CHAIN_length(BUFFER_CHAIN_HANDLE chain);
+
+/* copies the whole payload into a new buffer, for consumers that need it contiguous */
+extern BUFFER_HANDLE BUFFER_CHAIN_flatten(BUFFER_CHAIN_HANDLE chain);
+
+#ifndef WIN32
+/* fills iov with one entry per segment, ready for writev. iovCount is the number of entries of iov on input and the
+number of entries filled on output, it fails when iov has less entries than BUFFER_CHAIN_segment_count.
+The entries point into the segments and stay valid as long as the chain is not modified */
+extern int BUFFER_CHAIN_get_iovec(BUFFER_CHAIN_HANDLE chain, struct iovec* iov, size_t* iovCount);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BUFFER_CHAIN_H */
@@ -1,6 +1,31 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
+/* the definitions gballoc.c shares with its callers have a guard of their own, because the unit tests that compile
+gballoc.c into their own binary define GBALLOC_H to keep the redirection below out of it */
+#ifndef GBALLOC_SHARED_DEFINITIONS
+#define GBALLOC_SHARED_DEFINITIONS
+
+#ifdef __cplusplus
+#include <cstddef>
+#else
+#include <stddef.h>
+#endif
+
+/* one bucket for 0 byte allocations, then bucket n counts the allocations of 2^(n-1) to 2^n-1 bytes */
+#define GBALLOC_SIZE_HISTOGRAM_BUCKET_COUNT (sizeof(size_t) * 8 + 1)
+
+typedef struct GBALLOC_ALLOCATION_SITE_TAG
+{
+    const char* file;
+    int line;
+    size_t liveBytes;
+    size_t liveCount;
+    size_t totalCount;
+} GBALLOC_ALLOCATION_SITE;
+
+#endif /* GBALLOC_SHARED_DEFINITIONS */
+
 #ifndef GBALLOC_H
 #define GBALLOC_H
 
@@ -18,6 +43,9 @@ extern "C"
 
 /* all translation units that need memory measurement need to have GB_MEASURE_MEMORY_FOR_THIS defined */
 /* GB_DEBUG_ALLOC is the switch that turns the measurement on/off, so that it is not on always */
+/* GB_POOL_ALLOC is the switch that sends the allocations of the same translation units to the size-class pool instead; it is ignored when GB_DEBUG_ALLOC is defined */
+/* GB_TRACK_ALLOC_SITES makes the redirection pass __FILE__/__LINE__ along, so that gballoc can tell which call site holds the memory; it needs GB_DEBUG_ALLOC */
+
 #if defined(GB_DEBUG_ALLOC)
 
 extern int gballoc_init(void);
@@ -30,6 +58,18 @@ extern void gballoc_free(void* ptr);
 extern size_t gballoc_getMaximumMemoryUsed(void);
 extern size_t gballoc_getCurrentMemoryUsed(void);
 
+/* the same as the functions above, but the allocation is also accounted to the file/line call site and to the size histogram */
+extern void* gballoc_malloc_at(size_t size, const char* file, int line);
+extern void* gballoc_calloc_at(size_t nmemb, size_t size, const char* file, int line);
+extern void* gballoc_realloc_at(void* ptr, size_t size, const char* file, int line);
+
+/* fills sites with up to siteCount call sites, the ones holding the most live bytes first, and returns how many were filled */
+extern size_t gballoc_getAllocationSites(GBALLOC_ALLOCATION_SITE* sites, size_t siteCount);
+/* copies the first bucketCount buckets of the size histogram, returns 0 upon success */
+extern int gballoc_getSizeHistogram(size_t* histogram, size_t bucketCount);
+/* logs the memory used, the siteCount call sites holding the most live bytes and the size histogram */
+extern void gballoc_dumpAllocationSites(size_t siteCount);
+
 /* if GB_MEASURE_MEMORY_FOR_THIS is defined then we want to redirect memory allocation functions to gballoc_xxx functions */
 #ifdef GB_MEASURE_MEMORY_FOR_THIS
 #if defined(_CRTDBG_MAP_ALLOC) && defined(_DEBUG)
@@ -37,10 +77,21 @@ extern size_t gballoc_getCurrentMemoryUsed(void);
 #undef _calloc_dbg
 #undef _realloc_dbg
 #undef _free_dbg
+#if defined(GB_TRACK_ALLOC_SITES)
+#define _malloc_dbg(size, blockType, file, line) gballoc_malloc_at(size, file, line)
+#define _calloc_dbg(nmemb, size, blockType, file, line) gballoc_calloc_at(nmemb, size, file, line)
+#define _realloc_dbg(ptr, size, blockType, file, line) gballoc_realloc_at(ptr, size, file, line)
+#else
 #define _malloc_dbg(size, ...) gballoc_malloc(size)
 #define _calloc_dbg(nmemb, size, ...) gballoc_calloc(nmemb, size)
 #define _realloc_dbg(ptr, size, ...) gballoc_realloc(ptr, size)
+#endif
 #define _free_dbg(ptr, ...) gballoc_free(ptr)
+#elif defined(GB_TRACK_ALLOC_SITES)
+#define malloc(size) gballoc_malloc_at(size, __FILE__, __LINE__)
+#define calloc(nmemb, size) gballoc_calloc_at(nmemb, size, __FILE__, __LINE__)
+#define realloc(ptr, size) gballoc_realloc_at(ptr, size, __FILE__, __LINE__)
+#define free gballoc_free
 #else
 #define malloc gballoc_malloc
 #define calloc gballoc_calloc
@@ -57,8 +108,50 @@ extern size_t gballoc_getCurrentMemoryUsed(void);
 #define gballoc_getMaximumMemoryUsed() SIZE_MAX
 #define gballoc_getCurrentMemoryUsed() SIZE_MAX
 
+#define gballoc_getAllocationSites(sites, siteCount) ((size_t)0)
+#define gballoc_getSizeHistogram(histogram, bucketCount) __LINE__
+#define gballoc_dumpAllocationSites(siteCount) ((void)0)
+
+#if defined(GB_POOL_ALLOC)
+
+/* small blocks come from per size class free lists with a per thread cache, bigger ones from malloc.
+Memory obtained from these functions can only be released or resized by them, never by the CRT free/realloc.
+gballoc_pool_free/gballoc_pool_realloc also accept memory that came from the CRT and hand it back to the CRT. */
+extern void* gballoc_pool_malloc(size_t size);
+extern void* gballoc_pool_calloc(size_t nmemb, size_t size);
+extern void* gballoc_pool_realloc(void* ptr, size_t size);
+extern void gballoc_pool_free(void* ptr);
+/* the CRT malloc, for memory that a public API hands to its caller to release with free */
+extern void* gballoc_pool_crt_malloc(size_t size);
+#define gballoc_malloc_for_caller(size) gballoc_pool_crt_malloc(size)
+
+#ifdef GB_MEASURE_MEMORY_FOR_THIS
+#if defined(_CRTDBG_MAP_ALLOC) && defined(_DEBUG)
+#undef _malloc_dbg
+#undef _calloc_dbg
+#undef _realloc_dbg
+#undef _free_dbg
+#define _malloc_dbg(size, ...) gballoc_pool_malloc(size)
+#define _calloc_dbg(nmemb, size, ...) gballoc_pool_calloc(nmemb, size)
+#define _realloc_dbg(ptr, size, ...) gballoc_pool_realloc(ptr, size)
+#define _free_dbg(ptr, ...) gballoc_pool_free(ptr)
+#else
+#define malloc gballoc_pool_malloc
+#define calloc gballoc_pool_calloc
+#define realloc gballoc_pool_realloc
+#define free gballoc_pool_free
+#endif
+#endif
+
+#endif /* GB_POOL_ALLOC */
+
 #endif /* GB_DEBUG_ALLOC */
 
+/* memory that a public API hands to its caller to release with free is allocated with gballoc_malloc_for_caller */
+#ifndef gballoc_malloc_for_caller
+#define gballoc_malloc_for_caller(size) malloc(size)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,9 @@
 #define HTTPHEADERS_H
 
 #include "macro_utils.h"
+#include "arena.h"
+#include "buffer_.h"
+#include "buffer_chain.h"
 
 #ifdef __cplusplus
 #include <cstddef>
@@ -53,6 +56,19 @@ typedef struct HTTP_HEADERS_HANDLE_DATA_TAG* HTTP_HEADERS_HANDLE;
  */
 extern HTTP_HEADERS_HANDLE HTTPHeaders_Alloc(void);
 
+/**
+ * @brief	Produces a @c HTTP_HEADERS_HANDLE whose memory comes from @p arena.
+ *
+ *			The headers behave like the ones produced by ::HTTPHeaders_Alloc, except that
+ *			::HTTPHeaders_Free releases nothing: the memory goes away with the arena.
+ *			::HTTPHeaders_Clone of such headers produces regular headers.
+ *
+ * @param	arena	A valid @c ARENA_HANDLE value.
+ *
+ * @return	A HTTP_HEADERS_HANDLE or @c NULL in case an error occurs.
+ */
+extern HTTP_HEADERS_HANDLE HTTPHeaders_AllocInArena(ARENA_HANDLE arena);
+
 /**
  * @brief	De-allocates the data structures allocated by previous API calls to the same handle.
  *
@@ -72,7 +88,8 @@ extern void HTTPHeaders_Free(HTTP_HEADERS_HANDLE httpHeadersHandle);
  *			The function stores the @c name:value pair in such a way that when later
  *			retrieved by a call to ::HTTPHeaders_GetHeader it will return a string
  *			that is @c strcmp equal to @c name+": "+value. If the name already exists
- *			in the collection of headers, the function concatenates the new value
+ *			in the collection of headers (names are compared without regard to case,
+ *			the name keeps the case it was first added with), the function concatenates the new value
  *			after the existing value, separated by a comma and a space as in:
  *			<code>old-value+", "+new-value</code>.
  * 
@@ -101,7 +118,8 @@ extern HTTP_HEADERS_RESULT HTTPHeaders_ReplaceHeaderNameValuePair(HTTP_HEADERS_H
  * @brief	Retrieves the value for a previously stored name.
  *
  * @param	httpHeadersHandle	A valid @c HTTP_HEADERS_HANDLE value.
- * @param	name			 	The name of the HTTP header to find.
+ * @param	name			 	The name of the HTTP header to find. It is compared
+ * 								without regard to case.
  *
  * @return	The return value points to a string that shall be @c strcmp equal
  * 			to the original stored string.
@@ -150,6 +168,39 @@ extern HTTP_HEADERS_RESULT HTTPHeaders_GetHeader(HTTP_HEADERS_HANDLE handle, siz
  */
 extern HTTP_HEADERS_HANDLE HTTPHeaders_Clone(HTTP_HEADERS_HANDLE handle);
 
+/**
+ * @brief	This API appends the wire form of all the headers, that is
+ * 			<code>name + ": " + value + "\r\n"</code> for every header,
+ * 			to @p destination.
+ *
+ * @param	handle			A valid @c HTTP_HEADERS_HANDLE value.
+ * @param	destination		A valid @c BUFFER_HANDLE. Its content is kept and
+ * 							the headers are written after it. The buffer is
+ * 							grown at most once, no other memory is allocated.
+ *
+ * @return	Returns @c HTTP_HEADERS_OK when execution is successful,
+ * 			@c HTTP_HEADERS_ALLOC_FAILED when @p destination cannot be grown or
+ * 			@c HTTP_HEADERS_ERROR when an error occurs.
+ */
+extern HTTP_HEADERS_RESULT HTTPHeaders_Serialize(HTTP_HEADERS_HANDLE handle, BUFFER_HANDLE destination);
+
+/**
+ * @brief	This API appends the wire form of all the headers to
+ * 			@p destination as one new segment, so that they can be sent
+ * 			together with the other segments of a message by
+ * 			::BUFFER_CHAIN_get_iovec and writev.
+ *
+ * @param	handle			A valid @c HTTP_HEADERS_HANDLE value.
+ * @param	destination		A valid @c BUFFER_CHAIN_HANDLE. Nothing is appended
+ * 							when there are no headers. On failure
+ * 							@p destination is left as it was.
+ *
+ * @return	Returns @c HTTP_HEADERS_OK when execution is successful,
+ * 			@c HTTP_HEADERS_ALLOC_FAILED when the segment cannot be created
+ * 			or appended or @c HTTP_HEADERS_ERROR when an error occurs.
+ */
+extern HTTP_HEADERS_RESULT HTTPHeaders_SerializeToChain(HTTP_HEADERS_HANDLE handle, BUFFER_CHAIN_HANDLE destination);
+
 #ifdef __cplusplus
 }
 #endif 
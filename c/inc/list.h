@@ -15,9 +15,18 @@ typedef struct LIST_INSTANCE_TAG* LIST_HANDLE;
 typedef struct LIST_ITEM_INSTANCE_TAG* LIST_ITEM_HANDLE;
 typedef bool (*LIST_MATCH_FUNCTION)(LIST_ITEM_HANDLE list_item, const void* match_context);
 
+/* a list node, public only so that it can be embedded in the structure of the item it links (see list_add_node). Its fields belong to the list */
+typedef struct LIST_ITEM_INSTANCE_TAG
+{
+    const void* item;
+    struct LIST_ITEM_INSTANCE_TAG* next;
+    bool is_embedded;
+} LIST_ITEM_INSTANCE;
+
 extern LIST_HANDLE list_create(void);
 extern void list_destroy(LIST_HANDLE list);
 extern LIST_ITEM_HANDLE list_add(LIST_HANDLE list, const void* item);
+extern LIST_ITEM_HANDLE list_add_node(LIST_HANDLE list, LIST_ITEM_INSTANCE* node, const void* item);
 extern int list_remove(LIST_HANDLE list, LIST_ITEM_HANDLE item_handle);
 extern LIST_ITEM_HANDLE list_get_head_item(LIST_HANDLE list);
 extern LIST_ITEM_HANDLE list_get_next_item(LIST_ITEM_HANDLE item_handle);
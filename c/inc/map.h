@@ -55,6 +55,32 @@ typedef int (*MAP_FILTER_CALLBACK)(const char* mapProperty, const char* mapValue
  */
 extern MAP_HANDLE Map_Create(MAP_FILTER_CALLBACK mapFilterFunc);
 
+/**
+ * @brief   Creates a new, empty map whose storage comes from @p arena.
+ *
+ * @param   arena           The arena that holds the map, its keys and values.
+ *                          ::Map_Destroy releases nothing for such a map, the
+ *                          memory goes away with the arena. ::Map_Clone of
+ *                          such a map produces a regular map.
+ * @param   mapFilterFunc   The same as for ::Map_Create.
+ *
+ * @return  A valid @c MAP_HANDLE or @c NULL in case an error occurs.
+ */
+extern MAP_HANDLE Map_CreateInArena(ARENA_HANDLE arena, MAP_FILTER_CALLBACK mapFilterFunc);
+
+/**
+ * @brief   Makes the map compare its keys without regard to the case of
+ *          ASCII letters, as needed for HTTP header names. A key keeps the
+ *          case it was first added with. Clones and snapshots of the map
+ *          ignore the case of their keys too.
+ *
+ * @param   handle  The handle to an existing, empty map.
+ *
+ * @return  @c MAP_INVALIDARG if @p handle is @c NULL, @c MAP_ERROR if the
+ *          map is not empty or is a snapshot, @c MAP_OK otherwise.
+ */
+extern MAP_RESULT Map_IgnoreKeyCase(MAP_HANDLE handle);
+
 /**
  * @brief   Release all resources associated with the map.
  *
@@ -66,6 +92,11 @@ extern void Map_Destroy(MAP_HANDLE handle);
  * @brief   Creates a copy of the map indicated by @p handle and returns a
  *          handle to it.
  *
+ *          The copy shares the keys and values of @p handle instead of
+ *          duplicating them. Whichever of the maps is modified first gets
+ *          its own copy of them, so such a modification can fail with
+ *          @c MAP_ERROR for lack of memory.
+ *
  * @param   handle  The handle to an existing map.
  *
  * @return  A valid @c MAP_HANDLE to the cloned copy of the map or @c NULL
@@ -73,6 +104,22 @@ extern void Map_Destroy(MAP_HANDLE handle);
  */
 extern MAP_HANDLE Map_Clone(MAP_HANDLE handle);
 
+/**
+ * @brief   Creates a read-only copy of the map indicated by @p handle, in
+ *          the same way as ::Map_Clone.
+ *
+ *          ::Map_Add, ::Map_AddOrUpdate and ::Map_Delete on the snapshot
+ *          return @c MAP_ERROR. Since it never changes, any number of
+ *          threads can read the snapshot without locking, while @p handle
+ *          keeps being modified. ::Map_Clone of a snapshot can be modified.
+ *
+ * @param   handle  The handle to an existing map.
+ *
+ * @return  A valid @c MAP_HANDLE to the snapshot or @c NULL in case an
+ *          error occurs.
+ */
+extern MAP_HANDLE Map_Snapshot(MAP_HANDLE handle);
+
 /**
  * @brief   Adds a key/value pair to the map.
  *
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C"
+{
+#else
+#include <stddef.h>
+#endif
+
+#include "atomics.h"
+
+/* a multi-producer, single-consumer FIFO queue. Any number of threads can push without taking a lock, only one thread
+at a time may pop. The queue is intrusive: the caller embeds a MPSC_QUEUE_NODE in its own structure, so pushing does not
+allocate, and gets the structure back from a popped node with MPSC_QUEUE_ITEM */
+
+/* the node belongs to the queue from MPSC_QUEUE_push until it is handed out by a pop */
+typedef struct MPSC_QUEUE_NODE_TAG
+{
+    ATOMIC_POINTER next;
+} MPSC_QUEUE_NODE;
+
+#define MPSC_QUEUE_ITEM(node, type, field) ((type*)((unsigned char*)(node) - offsetof(type, field)))
+
+typedef struct MPSC_QUEUE_TAG* MPSC_QUEUE_HANDLE;
+
+extern MPSC_QUEUE_HANDLE MPSC_QUEUE_create(void);
+/* the nodes still in the queue are left to their owner */
+extern void MPSC_QUEUE_destroy(MPSC_QUEUE_HANDLE handle);
+
+/* any thread. Returns 0 on success */
+extern int MPSC_QUEUE_push(MPSC_QUEUE_HANDLE handle, MPSC_QUEUE_NODE* node);
+
+/* consumer thread only. Returns the oldest node, or NULL when the queue is empty. A push that is still in progress
+on another thread may not be visible yet */
+extern MPSC_QUEUE_NODE* MPSC_QUEUE_pop(MPSC_QUEUE_HANDLE handle);
+/* consumer thread only. Like MPSC_QUEUE_pop, but blocks until a node is pushed or timeout_milliseconds pass (0 waits
+without a time limit). Returns NULL on timeout. Producers only take a lock while the consumer is blocked */
+extern MPSC_QUEUE_NODE* MPSC_QUEUE_wait_pop(MPSC_QUEUE_HANDLE handle, int timeout_milliseconds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MPSC_QUEUE_H */
@@ -78,6 +78,9 @@ other cases
        
 It seems windows is "one off" because it returns the value "after" the decrement, as opposed to C11 standard and gcc that return the value "before". 
 The macro DEC_RETURN_ZERO will be "0" on windows, and "1" on the other cases.
+
+GET_REF reads the ref count with acquire semantics, so that an owner that reads 1 also sees every write that the released
+references made before they went away, and can then modify the object in place.
 */
 
 /*if macro DEC_REF returns DEC_RETURN_ZERO that means the ref count has reached zero.*/
@@ -86,23 +89,27 @@ The macro DEC_RETURN_ZERO will be "0" on windows, and "1" on the other cases.
 #define DEC_RETURN_ZERO (1)
 #define INC_REF(type, var) atomic_fetch_add((&((REFCOUNT_TYPE(type)*)var)->count), 1)
 #define DEC_REF(type, var) atomic_fetch_sub((&((REFCOUNT_TYPE(type)*)var)->count), 1)
+#define GET_REF(type, var) atomic_load_explicit((&((REFCOUNT_TYPE(type)*)var)->count), memory_order_acquire)
 
 #elif defined(WIN32)
 #include "windows.h"
 #define DEC_RETURN_ZERO (0)
 #define INC_REF(type, var) InterlockedIncrement(&(((REFCOUNT_TYPE(type)*)var)->count))
 #define DEC_REF(type, var) InterlockedDecrement(&(((REFCOUNT_TYPE(type)*)var)->count))
+#define GET_REF(type, var) (uint32_t)InterlockedCompareExchange((volatile LONG*)&(((REFCOUNT_TYPE(type)*)var)->count), 0, 0)
 
 #elif defined(__GNUC__)
 #define DEC_RETURN_ZERO (0)
 #define INC_REF(type, var) __sync_add_and_fetch((&((REFCOUNT_TYPE(type)*)var)->count), 1)
 #define DEC_REF(type, var) __sync_sub_and_fetch((&((REFCOUNT_TYPE(type)*)var)->count), 1)
+#define GET_REF(type, var) __extension__ ({ uint32_t refCount = *(volatile uint32_t*)(&((REFCOUNT_TYPE(type)*)var)->count); __sync_synchronize(); refCount; })
 
 #else
 #if defined(REFCOUNT_ATOMIC_DONTCARE)
 #define DEC_RETURN_ZERO (0)
 #define INC_REF(type, var) ++(&(((REFCOUNT_TYPE(type)*)var)->count))
 #define DEC_REF(type, var) --(&(((REFCOUNT_TYPE(type)*)var)->count))
+#define GET_REF(type, var) (((REFCOUNT_TYPE(type)*)var)->count)
 #else
 #error do not know how to atomically increment and decrement a uint32_t :(. Platform support needs to be extended to your platform.
 #endif /*defined(REFCOUNT_ATOMIC_DONTCARE)*/
@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C"
+{
+#else
+#include <stddef.h>
+#endif
+
+/* a fixed size byte FIFO for one producer and one consumer, which may be different threads. Neither side takes a lock.
+The producer can write straight into the buffer: RING_BUFFER_write_region hands out the contiguous free bytes and
+RING_BUFFER_commit_write publishes what was written to them. The consumer reads in place the same way, with
+RING_BUFFER_read_region and RING_BUFFER_commit_read. A region ends at the end of the storage, so draining a buffer
+that wrapped takes two regions */
+
+typedef struct RING_BUFFER_TAG* RING_BUFFER_HANDLE;
+
+/* capacity is rounded up to a power of two */
+extern RING_BUFFER_HANDLE RING_BUFFER_create(size_t capacity);
+extern void RING_BUFFER_destroy(RING_BUFFER_HANDLE handle);
+
+/* producer only. Returns the first free byte and writes the number of contiguous free bytes to size, NULL when the
+buffer is full */
+extern unsigned char* RING_BUFFER_write_region(RING_BUFFER_HANDLE handle, size_t* size);
+/* producer only. size shall not exceed the last write region. Returns 0 on success */
+extern int RING_BUFFER_commit_write(RING_BUFFER_HANDLE handle, size_t size);
+/* producer only. Copies as many bytes as fit and returns how many */
+extern size_t RING_BUFFER_write(RING_BUFFER_HANDLE handle, const unsigned char* source, size_t size);
+
+/* consumer only. Returns the oldest byte and writes the number of contiguous readable bytes to size, NULL when the
+buffer is empty */
+extern const unsigned char* RING_BUFFER_read_region(RING_BUFFER_HANDLE handle, size_t* size);
+/* consumer only. size shall not exceed the last read region. Returns 0 on success */
+extern int RING_BUFFER_commit_read(RING_BUFFER_HANDLE handle, size_t size);
+/* consumer only. Copies up to size bytes and returns how many */
+extern size_t RING_BUFFER_read(RING_BUFFER_HANDLE handle, unsigned char* destination, size_t size);
+
+/* the number of readable bytes, exact on the consumer side and a lower bound elsewhere */
+extern size_t RING_BUFFER_size(RING_BUFFER_HANDLE handle);
+extern size_t RING_BUFFER_capacity(RING_BUFFER_HANDLE handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BUFFER_H */
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef STRING_INTERN_H
+#define STRING_INTERN_H
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C"
+{
+#else
+#include <stddef.h>
+#endif
+
+/* interned strings are read-only copies kept in one process-wide, thread-safe table. Interning a string equal to one
+already in the table hands out the same pointer, so equal interned strings share their storage and compare equal as
+pointers. Every pointer handed out holds a reference, a string leaves the table when its last reference is released */
+
+/* returns the interned copy of value, or NULL on failure */
+extern const char* STRING_INTERN_acquire(const char* value);
+/* takes one more reference on an interned string, without looking it up. Returns interned, or NULL on failure */
+extern const char* STRING_INTERN_add_ref(const char* interned);
+/* interned shall be a pointer handed out by STRING_INTERN_acquire or STRING_INTERN_add_ref */
+extern void STRING_INTERN_release(const char* interned);
+
+/* the number of distinct strings in the table */
+extern size_t STRING_INTERN_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STRING_INTERN_H */
@@ -12,9 +12,14 @@ extern "C"
 #include <stddef.h>
 #endif
 
+#include "arena.h"
+
 typedef struct STRING_TAG* STRING_HANDLE;
 
 extern STRING_HANDLE STRING_new(void);
+/* the string and its characters come from arena, STRING_delete releases nothing and the memory goes away with the arena */
+extern STRING_HANDLE STRING_new_in_arena(ARENA_HANDLE arena);
+extern STRING_HANDLE STRING_construct_in_arena(ARENA_HANDLE arena, const char* psz);
 extern STRING_HANDLE STRING_clone(STRING_HANDLE handle);
 extern STRING_HANDLE STRING_construct(const char* psz);
 extern STRING_HANDLE STRING_construct_n(const char* psz, size_t n);
@@ -24,6 +29,10 @@ extern STRING_HANDLE STRING_new_JSON(const char* source);
 extern void STRING_delete(STRING_HANDLE handle);
 extern int STRING_concat(STRING_HANDLE handle, const char* s2);
 extern int STRING_concat_with_STRING(STRING_HANDLE s1, STRING_HANDLE s2);
+/* printf-like formatting straight into the string. STRING_sprintf replaces the content (and leaves the string empty when it fails),
+STRING_concat_format appends to it (and leaves it unchanged when it fails). The arguments shall not point into the string itself */
+extern int STRING_sprintf(STRING_HANDLE handle, const char* format, ...);
+extern int STRING_concat_format(STRING_HANDLE handle, const char* format, ...);
 extern int STRING_quote(STRING_HANDLE handle);
 extern int STRING_copy(STRING_HANDLE s1, const char* s2);
 extern int STRING_copy_n(STRING_HANDLE s1, const char* s2, size_t n);
@@ -13,9 +13,14 @@ extern "C" {
 
 	typedef struct TICK_COUNTER_INSTANCE_TAG* TICK_COUNTER_HANDLE;
 
+	/* a tick counter measures the time elapsed since it was created. It never goes backwards. Where the platform has a
+	monotonic clock (see adapters/tickcounter_linux.c) that is wall time, otherwise it may only be the process time */
 	extern TICK_COUNTER_HANDLE tickcounter_create(void);
 	extern void tickcounter_destroy(TICK_COUNTER_HANDLE tick_counter);
 	extern int tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, uint64_t* current_ms);
+	/* the same time with a finer unit, the actual resolution depends on the platform */
+	extern int tickcounter_get_current_us(TICK_COUNTER_HANDLE tick_counter, uint64_t* current_us);
+	extern int tickcounter_get_current_ns(TICK_COUNTER_HANDLE tick_counter, uint64_t* current_ns);
 
 #ifdef __cplusplus
 }
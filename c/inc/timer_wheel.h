@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "tickcounter.h"
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <cstdbool>
+extern "C"
+{
+#else
+#include <stdint.h>
+#include <stdbool.h>
+#endif
+
+/* a hierarchical timer wheel with millisecond resolution. Scheduling and cancelling a timer take constant time and
+TIMER_WHEEL_dowork only visits the timers that are due, so idle timers cost nothing. Timers are intrusive: the caller
+owns the TIMER_WHEEL_TIMER, usually embedded in the structure the timeout is about, so scheduling does not allocate.
+A wheel is not thread safe, it is meant to be pumped from the same dowork loop as the IOs it times */
+
+typedef void(*ON_TIMER_EXPIRED)(void* context);
+
+/* the fields are private to the wheel, initialize them with TIMER_WHEEL_init_timer */
+typedef struct TIMER_WHEEL_TIMER_TAG
+{
+    struct TIMER_WHEEL_TIMER_TAG* next;
+    /* the pointer that points to this timer, NULL while the timer is not scheduled */
+    struct TIMER_WHEEL_TIMER_TAG** link;
+    uint64_t expiry_ms;
+    ON_TIMER_EXPIRED on_timer_expired;
+    void* callback_context;
+} TIMER_WHEEL_TIMER;
+
+typedef struct TIMER_WHEEL_TAG* TIMER_WHEEL_HANDLE;
+
+/* the wheel reads the time from tick_counter, which has to outlive it */
+extern TIMER_WHEEL_HANDLE TIMER_WHEEL_create(TICK_COUNTER_HANDLE tick_counter);
+/* the timers still scheduled are cancelled, they stay with their owner */
+extern void TIMER_WHEEL_destroy(TIMER_WHEEL_HANDLE handle);
+
+extern void TIMER_WHEEL_init_timer(TIMER_WHEEL_TIMER* timer, ON_TIMER_EXPIRED on_timer_expired, void* callback_context);
+/* the timer fires from the first TIMER_WHEEL_dowork at least timeout_ms from now, and never in the millisecond it was
+scheduled in. Scheduling a timer that is already scheduled moves it. Returns 0 on success */
+extern int TIMER_WHEEL_schedule(TIMER_WHEEL_HANDLE handle, TIMER_WHEEL_TIMER* timer, uint64_t timeout_ms);
+/* does nothing if the timer is not scheduled */
+extern void TIMER_WHEEL_cancel(TIMER_WHEEL_HANDLE handle, TIMER_WHEEL_TIMER* timer);
+extern bool TIMER_WHEEL_is_scheduled(const TIMER_WHEEL_TIMER* timer);
+
+/* fires the expired timers, oldest expiry first. A callback may schedule or cancel any timer, including its own, but
+shall not destroy the wheel */
+extern void TIMER_WHEEL_dowork(TIMER_WHEEL_HANDLE handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMER_WHEEL_H */
@@ -18,6 +18,9 @@ typedef struct VECTOR_TAG* VECTOR_HANDLE;
 
 typedef bool(*PREDICATE_FUNCTION)(const void* element, const void* value);
 
+/* returns <0, 0 or >0 when left orders before, together with or after right, like the qsort comparator */
+typedef int(*VECTOR_COMPARE_FUNCTION)(const void* left, const void* right);
+
 /* creation */
 extern VECTOR_HANDLE VECTOR_create(size_t elementSize);
 extern void VECTOR_destroy(VECTOR_HANDLE handle);
@@ -27,6 +30,7 @@ extern int VECTOR_push_back(VECTOR_HANDLE handle, const void* elements, size_t n
 
 /* removal */
 extern void VECTOR_erase(VECTOR_HANDLE handle, void* elements, size_t numElements);
+extern void VECTOR_pop_back(VECTOR_HANDLE handle);
 extern void VECTOR_clear(VECTOR_HANDLE handle);
 
 /* access */
@@ -37,6 +41,15 @@ extern void* VECTOR_find_if(const VECTOR_HANDLE handle, PREDICATE_FUNCTION pred,
 
 /* capacity */
 extern size_t VECTOR_size(const VECTOR_HANDLE handle);
+extern size_t VECTOR_capacity(const VECTOR_HANDLE handle);
+extern int VECTOR_reserve(VECTOR_HANDLE handle, size_t numElements);
+extern void VECTOR_shrink_to_fit(VECTOR_HANDLE handle);
+
+/* ordering, the lookups and VECTOR_insert_sorted expect a vector sorted by the same compare. They pass the element as left and value as right */
+extern void VECTOR_sort(VECTOR_HANDLE handle, VECTOR_COMPARE_FUNCTION compare);
+extern int VECTOR_insert_sorted(VECTOR_HANDLE handle, const void* element, VECTOR_COMPARE_FUNCTION compare);
+extern void* VECTOR_lower_bound(const VECTOR_HANDLE handle, VECTOR_COMPARE_FUNCTION compare, const void* value);
+extern void* VECTOR_binary_search(const VECTOR_HANDLE handle, VECTOR_COMPARE_FUNCTION compare, const void* value);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,240 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+#include "gballoc.h"
+
+#include <stdint.h>
+#include <string.h>
+#include "arena.h"
+#include "iot_logging.h"
+
+#ifndef SIZE_MAX
+#define SIZE_MAX ((size_t)~(size_t)0)
+#endif
+
+#define ARENA_DEFAULT_BLOCK_SIZE 4096
+
+/*every allocation is rounded up to a multiple of the size of this union, which keeps it as aligned as malloc would*/
+typedef union ARENA_ALIGNMENT_TAG
+{
+    long double alignLongDouble;
+    long long alignLongLong;
+    void* alignPointer;
+} ARENA_ALIGNMENT;
+
+typedef union ARENA_BLOCK_TAG
+{
+    struct
+    {
+        union ARENA_BLOCK_TAG* next;
+        size_t size;
+    } header;
+    ARENA_ALIGNMENT alignment;
+} ARENA_BLOCK;
+
+typedef struct ARENA_TAG
+{
+    /*allocations are bumped in the first block of the list*/
+    ARENA_BLOCK* blocks;
+    unsigned char* current;
+    unsigned char* end;
+    /*the most recent allocation, the only one that can be resized in place*/
+    unsigned char* last;
+    size_t blockSize;
+} ARENA;
+
+/*returns 0 if the size cannot be rounded up without overflowing*/
+static size_t getRoundedSize(size_t size)
+{
+    size_t result;
+    if (size == 0)
+    {
+        /*every allocation gets its own address*/
+        result = sizeof(ARENA_ALIGNMENT);
+    }
+    else if (size > SIZE_MAX - (sizeof(ARENA_ALIGNMENT) - 1))
+    {
+        result = 0;
+    }
+    else
+    {
+        result = ((size + sizeof(ARENA_ALIGNMENT) - 1) / sizeof(ARENA_ALIGNMENT)) * sizeof(ARENA_ALIGNMENT);
+    }
+    return result;
+}
+
+ARENA_HANDLE ARENA_create(size_t blockSize)
+{
+    ARENA* result = (ARENA*)malloc(sizeof(ARENA));
+    if (result == NULL)
+    {
+        LogError("malloc failed\r\n");
+    }
+    else
+    {
+        result->blocks = NULL;
+        result->current = NULL;
+        result->end = NULL;
+        result->last = NULL;
+        result->blockSize = (blockSize == 0) ? ARENA_DEFAULT_BLOCK_SIZE : getRoundedSize(blockSize);
+        if (result->blockSize == 0)
+        {
+            LogError("invalid arg (blockSize too big)\r\n");
+            free(result);
+            result = NULL;
+        }
+    }
+    return (ARENA_HANDLE)result;
+}
+
+void ARENA_destroy(ARENA_HANDLE arena)
+{
+    if (arena != NULL)
+    {
+        ARENA* a = (ARENA*)arena;
+        while (a->blocks != NULL)
+        {
+            ARENA_BLOCK* next = a->blocks->header.next;
+            free(a->blocks);
+            a->blocks = next;
+        }
+        free(a);
+    }
+}
+
+void* ARENA_malloc(ARENA_HANDLE arena, size_t size)
+{
+    void* result;
+    size_t roundedSize;
+    if (arena == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else if (((roundedSize = getRoundedSize(size)) == 0) ||
+        (roundedSize > SIZE_MAX - sizeof(ARENA_BLOCK)))
+    {
+        LogError("invalid arg (size too big)\r\n");
+        result = NULL;
+    }
+    else
+    {
+        ARENA* a = (ARENA*)arena;
+        if ((a->blocks != NULL) && (roundedSize <= (size_t)(a->end - a->current)))
+        {
+            result = a->current;
+            a->last = a->current;
+            a->current += roundedSize;
+        }
+        else
+        {
+            size_t blockSize = (roundedSize > a->blockSize) ? roundedSize : a->blockSize;
+            ARENA_BLOCK* block = (ARENA_BLOCK*)malloc(sizeof(ARENA_BLOCK) + blockSize);
+            if (block == NULL)
+            {
+                LogError("malloc failed\r\n");
+                result = NULL;
+            }
+            else
+            {
+                block->header.size = blockSize;
+                result = block + 1;
+                if ((blockSize > a->blockSize) && (a->blocks != NULL))
+                {
+                    /*an oversized allocation gets a block of its own, the current block keeps serving the small ones*/
+                    block->header.next = a->blocks->header.next;
+                    a->blocks->header.next = block;
+                }
+                else
+                {
+                    block->header.next = a->blocks;
+                    a->blocks = block;
+                    a->last = (unsigned char*)result;
+                    a->current = (unsigned char*)result + roundedSize;
+                    a->end = (unsigned char*)result + blockSize;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+void* ARENA_realloc(ARENA_HANDLE arena, void* ptr, size_t oldSize, size_t size)
+{
+    void* result;
+    if (arena == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else if (ptr == NULL)
+    {
+        result = ARENA_malloc(arena, size);
+    }
+    else
+    {
+        ARENA* a = (ARENA*)arena;
+        size_t roundedSize = getRoundedSize(size);
+        if (((unsigned char*)ptr == a->last) &&
+            (roundedSize != 0) &&
+            (roundedSize <= (size_t)(a->end - a->last)))
+        {
+            /*the most recent allocation simply moves the end of the used part of the block*/
+            a->current = a->last + roundedSize;
+            result = ptr;
+        }
+        else if (size <= oldSize)
+        {
+            result = ptr;
+        }
+        else
+        {
+            result = ARENA_malloc(arena, size);
+            if (result != NULL)
+            {
+                (void)memcpy(result, ptr, oldSize);
+            }
+        }
+    }
+    return result;
+}
+
+void ARENA_reset(ARENA_HANDLE arena)
+{
+    if (arena != NULL)
+    {
+        ARENA* a = (ARENA*)arena;
+        ARENA_BLOCK* kept = NULL;
+        while (a->blocks != NULL)
+        {
+            ARENA_BLOCK* next = a->blocks->header.next;
+            if ((kept == NULL) && (a->blocks->header.size == a->blockSize))
+            {
+                kept = a->blocks;
+                kept->header.next = NULL;
+            }
+            else
+            {
+                free(a->blocks);
+            }
+            a->blocks = next;
+        }
+
+        a->blocks = kept;
+        a->last = NULL;
+        if (kept == NULL)
+        {
+            a->current = NULL;
+            a->end = NULL;
+        }
+        else
+        {
+            a->current = (unsigned char*)(kept + 1);
+            a->end = a->current + kept->header.size;
+        }
+    }
+}
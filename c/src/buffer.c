@@ -11,20 +11,191 @@
 #include "gballoc.h"
 
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 //
 // PUT NO CLIENT LIBRARY INCLUDES BEFORE HERE
 //
 
 #include "buffer_.h"
+#include "arena.h"
+#include "refcount.h"
+#include "atomics.h"
 #include "iot_logging.h"
 
+/*the bytes of buffers made by BUFFER_share/BUFFER_slice are owned by a ref counted storage that all of them point into*/
+typedef struct BUFFER_STORAGE_TAG
+{
+    unsigned char* bytes;
+    size_t capacity;
+    /*NULL unless bytes come from an arena, in which case they are not freed with the storage*/
+    ARENA_HANDLE arena;
+}BUFFER_STORAGE;
+
+DEFINE_REFCOUNT_TYPE(BUFFER_STORAGE);
+
+/*the free list of a BUFFER_POOL is a lock-free stack of indexes. Its head packs the index + 1 of the top buffer (0 when empty)
+in the low 32 bits and a tag bumped by every change in the high 32 bits, so a compare-and-swap cannot succeed on a head
+that was popped and pushed back in between (ABA). When no atomic primitive is known for the platform, the pool hands out heap buffers.*/
+#ifndef ATOMIC_NOT_SUPPORTED
+#define BUFFER_POOL_ENABLED
+#endif
+
+#define POOL_HEAD_INDEX_MASK 0xFFFFFFFFULL
+#define POOL_HEAD_MAKE(oldHead, indexPlus1) ((((oldHead) >> 32) + 1) << 32 | (uint64_t)(indexPlus1))
+
 typedef struct BUFFER_TAG
 {
     unsigned char* buffer;
     size_t size;
+    /*how many bytes buffer can hold, size <= capacity*/
+    size_t capacity;
+    /*NULL unless the buffer was created in an arena*/
+    ARENA_HANDLE arena;
+    /*NULL unless buffer points into bytes shared with other buffers, which are then read only*/
+    BUFFER_STORAGE* storage;
+    /*NULL unless the buffer belongs to a pool, BUFFER_delete then gives it back to the pool*/
+    BUFFER_POOL_HANDLE pool;
 }BUFFER;
 
+typedef struct BUFFER_POOL_TAG
+{
+    /*all the buffers of the pool are in one array, the index of a buffer is its position in it*/
+    BUFFER* buffers;
+    /*next[i] is the index + 1 of the buffer under buffer i in the free list*/
+    ATOMIC_SIZE* next;
+    size_t bufferCount;
+    size_t bufferSize;
+#ifdef BUFFER_POOL_ENABLED
+    ATOMIC_UINT64 head;
+#endif
+}BUFFER_POOL;
+
+/*the bytes of a buffer created in an arena come from the arena and are only released with it*/
+static unsigned char* mallocBytes(BUFFER* b, size_t size)
+{
+    return (b->arena == NULL) ? (unsigned char*)malloc(size) : (unsigned char*)ARENA_malloc(b->arena, size);
+}
+
+static unsigned char* reallocBytes(BUFFER* b, size_t size)
+{
+    return (b->arena == NULL) ? (unsigned char*)realloc(b->buffer, size) : (unsigned char*)ARENA_realloc(b->arena, b->buffer, b->size, size);
+}
+
+static void freeBytes(BUFFER* b, unsigned char* bytes)
+{
+    if (b->arena == NULL)
+    {
+        free(bytes);
+    }
+}
+
+static void releaseStorage(BUFFER* b)
+{
+    if (DEC_REF(BUFFER_STORAGE, b->storage) == DEC_RETURN_ZERO)
+    {
+        if (b->storage->arena == NULL)
+        {
+            free(b->storage->bytes);
+        }
+        free(b->storage);
+    }
+    b->storage = NULL;
+}
+
+/*drops the bytes of the buffer, whether they are its own or shared*/
+static void releaseBytes(BUFFER* b)
+{
+    if (b->storage != NULL)
+    {
+        releaseStorage(b);
+    }
+    else
+    {
+        freeBytes(b, b->buffer);
+    }
+    b->buffer = NULL;
+    b->size = 0;
+    b->capacity = 0;
+}
+
+/*copy-on-write: a buffer that shares its bytes gets its own copy of them before they are modified*/
+static int makeExclusive(BUFFER* b)
+{
+    int result;
+    if (b->storage == NULL)
+    {
+        result = 0;
+    }
+    else if ((GET_REF(BUFFER_STORAGE, b->storage) == 1) &&
+        (b->buffer == b->storage->bytes) &&
+        (b->storage->arena == b->arena))
+    {
+        /*nobody else looks at the bytes anymore, they can be taken back without a copy*/
+        b->capacity = b->storage->capacity;
+        free(b->storage);
+        b->storage = NULL;
+        result = 0;
+    }
+    else
+    {
+        unsigned char* bytes = mallocBytes(b, b->size);
+        if (bytes == NULL)
+        {
+            LogError("unable to copy %lu shared bytes\r\n", (unsigned long)b->size);
+            result = __LINE__;
+        }
+        else
+        {
+            size_t size = b->size;
+            memcpy(bytes, b->buffer, size);
+            releaseStorage(b);
+            b->buffer = bytes;
+            b->size = size;
+            b->capacity = size;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+/*the capacity doubles when it has to grow, so that appending many small pieces costs amortized O(1) per byte*/
+static size_t getGrownCapacity(BUFFER* b, size_t requiredSize)
+{
+    size_t result = (b->capacity > SIZE_MAX / 2) ? SIZE_MAX : 2 * b->capacity;
+    if (result < requiredSize)
+    {
+        result = requiredSize;
+    }
+    return result;
+}
+
+/*makes room for requiredSize bytes, the content is kept*/
+static int ensureCapacity(BUFFER* b, size_t requiredSize)
+{
+    int result;
+    if (requiredSize <= b->capacity)
+    {
+        result = 0;
+    }
+    else
+    {
+        size_t newCapacity = getGrownCapacity(b, requiredSize);
+        unsigned char* temp = reallocBytes(b, newCapacity);
+        if (temp == NULL)
+        {
+            result = __LINE__;
+        }
+        else
+        {
+            b->buffer = temp;
+            b->capacity = newCapacity;
+            result = 0;
+        }
+    }
+    return result;
+}
+
 /* Codes_SRS_BUFFER_07_001: [BUFFER_new shall allocate a BUFFER_HANDLE that will contain a NULL unsigned char*.] */
 BUFFER_HANDLE BUFFER_new(void)
 {
@@ -34,10 +205,38 @@ BUFFER_HANDLE BUFFER_new(void)
     {
         temp->buffer = NULL;
         temp->size = 0;
+        temp->capacity = 0;
+        temp->arena = NULL;
+        temp->storage = NULL;
+        temp->pool = NULL;
     }
     return (BUFFER_HANDLE)temp;
 }
 
+BUFFER_HANDLE BUFFER_new_in_arena(ARENA_HANDLE arena)
+{
+    BUFFER* result;
+    if (arena == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else if ((result = (BUFFER*)ARENA_malloc(arena, sizeof(BUFFER))) == NULL)
+    {
+        LogError("ARENA_malloc failed\r\n");
+    }
+    else
+    {
+        result->buffer = NULL;
+        result->size = 0;
+        result->capacity = 0;
+        result->arena = arena;
+        result->storage = NULL;
+        result->pool = NULL;
+    }
+    return (BUFFER_HANDLE)result;
+}
+
 BUFFER_HANDLE BUFFER_create(const unsigned char* source, size_t size)
 {
     BUFFER* result;
@@ -69,12 +268,121 @@ BUFFER_HANDLE BUFFER_create(const unsigned char* source, size_t size)
                 /*Codes_SRS_BUFFER_02_004: [Otherwise, BUFFER_create shall return a non-NULL handle.] */
                 memcpy(result->buffer, source, size);
                 result->size = size;
+                result->capacity = size;
+                result->arena = NULL;
+                result->storage = NULL;
+                result->pool = NULL;
             }
         }
     }
     return (BUFFER_HANDLE)result;
 }
 
+BUFFER_HANDLE BUFFER_create_in_arena(ARENA_HANDLE arena, const unsigned char* source, size_t size)
+{
+    BUFFER* result;
+    if ((arena == NULL) || (source == NULL))
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else if ((result = (BUFFER*)ARENA_malloc(arena, sizeof(BUFFER))) == NULL)
+    {
+        LogError("ARENA_malloc failed\r\n");
+    }
+    else if ((result->buffer = (unsigned char*)ARENA_malloc(arena, size)) == NULL)
+    {
+        /*what was taken from the arena goes away with it*/
+        LogError("ARENA_malloc failed\r\n");
+        result = NULL;
+    }
+    else
+    {
+        memcpy(result->buffer, source, size);
+        result->size = size;
+        result->capacity = size;
+        result->arena = arena;
+        result->storage = NULL;
+        result->pool = NULL;
+    }
+    return (BUFFER_HANDLE)result;
+}
+
+#ifdef BUFFER_POOL_ENABLED
+static void pushToPool(BUFFER_POOL* pool, uint32_t index)
+{
+    uint64_t oldHead;
+    uint64_t newHead;
+    do
+    {
+        oldHead = ATOMIC_UINT64_LOAD(&pool->head);
+        ATOMIC_SIZE_STORE_RELEASE(&pool->next[index], (size_t)(oldHead & POOL_HEAD_INDEX_MASK));
+        newHead = POOL_HEAD_MAKE(oldHead, index + 1);
+    } while (!ATOMIC_UINT64_COMPARE_EXCHANGE(&pool->head, oldHead, newHead));
+}
+
+/*returns NULL when all the buffers of the pool are in use*/
+static BUFFER* popFromPool(BUFFER_POOL* pool)
+{
+    BUFFER* result;
+    uint64_t oldHead;
+    uint64_t newHead;
+    do
+    {
+        oldHead = ATOMIC_UINT64_LOAD(&pool->head);
+        if ((oldHead & POOL_HEAD_INDEX_MASK) == 0)
+        {
+            break;
+        }
+        /*next may be stale if another thread took this buffer meanwhile, the tag in the head makes the swap fail then*/
+        newHead = POOL_HEAD_MAKE(oldHead, ATOMIC_SIZE_LOAD_ACQUIRE(&pool->next[(oldHead & POOL_HEAD_INDEX_MASK) - 1]));
+    } while (!ATOMIC_UINT64_COMPARE_EXCHANGE(&pool->head, oldHead, newHead));
+
+    if ((oldHead & POOL_HEAD_INDEX_MASK) == 0)
+    {
+        result = NULL;
+    }
+    else
+    {
+        result = &pool->buffers[(oldHead & POOL_HEAD_INDEX_MASK) - 1];
+    }
+    return result;
+}
+#endif
+
+/*a pooled buffer goes back empty, with the size of the pool's buffers, whatever was done with it meanwhile*/
+static void returnToPool(BUFFER* b)
+{
+    BUFFER_POOL* pool = (BUFFER_POOL*)b->pool;
+    if (b->storage != NULL)
+    {
+        releaseBytes(b);
+    }
+    b->size = 0;
+    if (b->capacity > pool->bufferSize)
+    {
+        if (pool->bufferSize == 0)
+        {
+            /*realloc to 0 bytes may free the bytes and return NULL, so they are freed here instead*/
+            freeBytes(b, b->buffer);
+            b->buffer = NULL;
+            b->capacity = 0;
+        }
+        else
+        {
+            unsigned char* temp = reallocBytes(b, pool->bufferSize);
+            if (temp != NULL)
+            {
+                b->buffer = temp;
+                b->capacity = pool->bufferSize;
+            }
+        }
+    }
+#ifdef BUFFER_POOL_ENABLED
+    pushToPool(pool, (uint32_t)(b - pool->buffers));
+#endif
+}
+
 /* Codes_SRS_BUFFER_07_003: [BUFFER_delete shall delete the data associated with the BUFFER_HANDLE along with the Buffer.] */
 void BUFFER_delete(BUFFER_HANDLE handle)
 {
@@ -82,12 +390,25 @@ void BUFFER_delete(BUFFER_HANDLE handle)
     if (handle != NULL)
     {
         BUFFER* b = (BUFFER*)handle;
-        if (b->buffer != NULL)
+        if (b->pool != NULL)
+        {
+            returnToPool(b);
+        }
+        else if (b->storage != NULL)
+        {
+            releaseStorage(b);
+        }
+        /*a buffer created in an arena is released with the arena*/
+        else if ((b->arena == NULL) && (b->buffer != NULL))
         {
             /* Codes_SRS_BUFFER_07_003: [BUFFER_delete shall delete the data associated with the BUFFER_HANDLE along with the Buffer.] */
             free(b->buffer);
         }
-        free(b);
+
+        if ((b->arena == NULL) && (b->pool == NULL))
+        {
+            free(b);
+        }
     }
 }
 
@@ -107,9 +428,7 @@ int BUFFER_build(BUFFER_HANDLE handle, const unsigned char* source, size_t size)
     {
         /* Codes_SRS_BUFFER_01_003: [If size is zero, source can be NULL.] */
         BUFFER* b = (BUFFER*)handle;
-        free(b->buffer);
-        b->buffer = NULL;
-        b->size = 0;
+        releaseBytes(b);
 
         result = 0;
     }
@@ -123,8 +442,15 @@ int BUFFER_build(BUFFER_HANDLE handle, const unsigned char* source, size_t size)
         else
         {
             BUFFER* b = (BUFFER*)handle;
+            unsigned char* newBuffer;
+            if (b->storage != NULL)
+            {
+                /*all the content is replaced, there is nothing to copy from the shared bytes*/
+                releaseBytes(b);
+            }
             /* Codes_SRS_BUFFER_07_011: [BUFFER_build shall overwrite previous contents if the buffer has been previously allocated.] */
-            unsigned char* newBuffer = (unsigned char*)realloc(b->buffer, size);
+            /*the storage is reused when it is big enough, otherwise it grows to exactly size since nothing is being accumulated*/
+            newBuffer = (size <= b->capacity) ? b->buffer : reallocBytes(b, size);
             if (newBuffer == NULL)
             {
                 /* Codes_SRS_BUFFER_07_010: [BUFFER_build shall return nonzero if any error is encountered.] */
@@ -134,6 +460,10 @@ int BUFFER_build(BUFFER_HANDLE handle, const unsigned char* source, size_t size)
             {
                 b->buffer = newBuffer;
                 b->size = size;
+                if (size > b->capacity)
+                {
+                    b->capacity = size;
+                }
                 /* Codes_SRS_BUFFER_01_002: [The size argument can be zero, in which case nothing shall be copied from source.] */
                 (void)memcpy(b->buffer, source, size);
 
@@ -164,14 +494,29 @@ int BUFFER_pre_build(BUFFER_HANDLE handle, size_t size)
     else
     {
         BUFFER* b = (BUFFER*)handle;
-        if (b->buffer != NULL)
+        /*storage obtained through BUFFER_reserve does not count as allocated, it holds no content yet*/
+        if (b->size != 0)
         {
             /* Codes_SRS_BUFFER_07_007: [BUFFER_pre_build shall return nonzero if the buffer has been previously allocated and is not NULL.] */
             result = __LINE__;
         }
+        else if (b->buffer == NULL)
+        {
+            if ((b->buffer = mallocBytes(b, size)) == NULL)
+            {
+                /* Codes_SRS_BUFFER_07_013: [BUFFER_pre_build shall return nonzero if any error is encountered.] */
+                result = __LINE__;
+            }
+            else
+            {
+                b->size = size;
+                b->capacity = size;
+                result = 0;
+            }
+        }
         else
         {
-            if ((b->buffer = (unsigned char*)malloc(size)) == NULL)
+            if (ensureCapacity(b, size) != 0)
             {
                 /* Codes_SRS_BUFFER_07_013: [BUFFER_pre_build shall return nonzero if any error is encountered.] */
                 result = __LINE__;
@@ -219,9 +564,7 @@ extern int BUFFER_unbuild(BUFFER_HANDLE handle)
         BUFFER* b = (BUFFER*)handle;
         if (b->buffer != NULL)
         {
-            free(b->buffer);
-            b->buffer = NULL;
-            b->size = 0;
+            releaseBytes(b);
             result = 0;
         }
         else
@@ -250,15 +593,15 @@ int BUFFER_enlarge(BUFFER_HANDLE handle, size_t enlargeSize)
     else
     {
         BUFFER* b = (BUFFER*)handle;
-        unsigned char* temp = (unsigned char*)realloc(b->buffer, b->size + enlargeSize);
-        if (temp == NULL)
+        if ((b->size + enlargeSize < b->size) ||
+            (makeExclusive(b) != 0) ||
+            (ensureCapacity(b, b->size + enlargeSize) != 0))
         {
             /* Codes_SRS_BUFFER_07_018: [BUFFER_enlarge shall return a nonzero result if any error is encountered.] */
             result = __LINE__;
         }
         else
         {
-            b->buffer = temp;
             b->size += enlargeSize;
             result = 0;
         }
@@ -309,15 +652,15 @@ int BUFFER_append(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2)
         }
         else
         {
-            unsigned char* temp = (unsigned char*)realloc(b1->buffer, b1->size + b2->size);
-            if (temp == NULL)
+            if ((b1->size + b2->size < b1->size) ||
+                (makeExclusive(b1) != 0) ||
+                (ensureCapacity(b1, b1->size + b2->size) != 0))
             {
                 /* Codes_SRS_BUFFER_07_023: [BUFFER_append shall return a nonzero upon any error that is encountered.] */
                 result = __LINE__;
             }
             else
             {
-                b1->buffer = temp;
                 // Append the BUFFER
                 memcpy(&b1->buffer[b1->size], b2->buffer, b2->size);
                 b1->size += b2->size;
@@ -350,9 +693,24 @@ int BUFFER_prepend(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2)
             /* : [BUFFER_append shall return a nonzero upon any error that is encountered.] */
             result = __LINE__;
         }
+        else if ((b1->size + b2->size < b1->size) ||
+            (makeExclusive(b1) != 0))
+        {
+            /* : [BUFFER_append shall return a nonzero upon any error that is encountered.] */
+            result = __LINE__;
+        }
+        else if (b1->size + b2->size <= b1->capacity)
+        {
+            /*there is room, the content moves over in place*/
+            memmove(&b1->buffer[b2->size], b1->buffer, b1->size);
+            memcpy(b1->buffer, b2->buffer, b2->size);
+            b1->size += b2->size;
+            result = 0;
+        }
         else
         {
-            unsigned char* temp = (unsigned char*)malloc(b1->size + b2->size);
+            size_t newCapacity = getGrownCapacity(b1, b1->size + b2->size);
+            unsigned char* temp = mallocBytes(b1, newCapacity);
             if (temp == NULL)
             {
                 /* : [BUFFER_append shall return a nonzero upon any error that is encountered.] */
@@ -363,9 +721,10 @@ int BUFFER_prepend(BUFFER_HANDLE handle1, BUFFER_HANDLE handle2)
                 // Append the BUFFER
                 memcpy(temp, b2->buffer, b2->size);
                 memcpy(&temp[b2->size], b1->buffer, b1->size);
-                free(b1->buffer);
+                freeBytes(b1, b1->buffer);
                 b1->buffer = temp;
                 b1->size += b2->size;
+                b1->capacity = newCapacity;
                 result = 0;
             }
         }
@@ -386,7 +745,15 @@ unsigned char* BUFFER_u_char(BUFFER_HANDLE handle)
     else
     {
         BUFFER* b = (BUFFER*)handle;
-        result = b->buffer;
+        /*the bytes can be written through the returned pointer, so shared bytes are copied first*/
+        if (makeExclusive(b) != 0)
+        {
+            result = NULL;
+        }
+        else
+        {
+            result = b->buffer;
+        }
     }
     return result;
 }
@@ -430,6 +797,11 @@ BUFFER_HANDLE BUFFER_clone(BUFFER_HANDLE handle)
             {
                 memcpy(b->buffer, suppliedBuff->buffer, suppliedBuff->size);
                 b->size = suppliedBuff->size;
+                b->capacity = suppliedBuff->size;
+                /*a clone is always on the heap, even when the source lives in an arena*/
+                b->arena = NULL;
+                b->storage = NULL;
+                b->pool = NULL;
                 result = (BUFFER_HANDLE)b;
             }
         }
@@ -440,3 +812,321 @@ BUFFER_HANDLE BUFFER_clone(BUFFER_HANDLE handle)
     }
     return result;
 }
+
+static int reserveBytes(BUFFER* b, size_t capacity)
+{
+    int result;
+    if (capacity <= b->capacity)
+    {
+        result = 0;
+    }
+    else
+    {
+        /*exactly what was asked for, the caller knows how much is coming*/
+        unsigned char* temp = reallocBytes(b, capacity);
+        if (temp == NULL)
+        {
+            LogError("unable to reserve %lu bytes\r\n", (unsigned long)capacity);
+            result = __LINE__;
+        }
+        else
+        {
+            b->buffer = temp;
+            b->capacity = capacity;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+int BUFFER_reserve(BUFFER_HANDLE handle, size_t capacity)
+{
+    int result;
+    if (handle == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        BUFFER* b = (BUFFER*)handle;
+        if ((makeExclusive(b) != 0) ||
+            (reserveBytes(b, capacity) != 0))
+        {
+            result = __LINE__;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+    return result;
+}
+
+int BUFFER_shrink_to_fit(BUFFER_HANDLE handle)
+{
+    int result;
+    if (handle == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        BUFFER* b = (BUFFER*)handle;
+        /*shared bytes have no spare capacity of this buffer to give back*/
+        if ((b->storage != NULL) || (b->capacity == b->size))
+        {
+            result = 0;
+        }
+        else if (b->size == 0)
+        {
+            freeBytes(b, b->buffer);
+            b->buffer = NULL;
+            b->capacity = 0;
+            result = 0;
+        }
+        else
+        {
+            unsigned char* temp = reallocBytes(b, b->size);
+            if (temp == NULL)
+            {
+                LogError("unable to shrink to %lu bytes\r\n", (unsigned long)b->size);
+                result = __LINE__;
+            }
+            else
+            {
+                b->buffer = temp;
+                b->capacity = b->size;
+                result = 0;
+            }
+        }
+    }
+    return result;
+}
+
+/*the bytes of b move into a storage that b is the only owner of*/
+static int createStorage(BUFFER* b)
+{
+    int result;
+    b->storage = REFCOUNT_TYPE_CREATE(BUFFER_STORAGE);
+    if (b->storage == NULL)
+    {
+        LogError("unable to allocate the shared storage\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        b->storage->bytes = b->buffer;
+        b->storage->capacity = b->capacity;
+        b->storage->arena = b->arena;
+        b->capacity = b->size;
+        result = 0;
+    }
+    return result;
+}
+
+/*the bytes of handle become shared by handle and the returned buffer, which views length bytes from offset.
+Whichever buffer is modified first gets its own copy of the bytes*/
+static BUFFER_HANDLE shareBytes(BUFFER_HANDLE handle, size_t offset, size_t length)
+{
+    BUFFER* result;
+    BUFFER* b = (BUFFER*)handle;
+    if ((b->buffer == NULL) || (length == 0))
+    {
+        /*nothing to share*/
+        result = (BUFFER*)BUFFER_new();
+    }
+    else if ((b->storage == NULL) &&
+        (createStorage(b) != 0))
+    {
+        result = NULL;
+    }
+    else if ((result = (BUFFER*)malloc(sizeof(BUFFER))) == NULL)
+    {
+        /*a storage that was just created only has handle as owner, handle takes its bytes back when it is modified*/
+        LogError("malloc failed\r\n");
+    }
+    else
+    {
+        result->buffer = b->buffer + offset;
+        result->size = length;
+        result->capacity = length;
+        result->arena = NULL;
+        result->storage = b->storage;
+        result->pool = NULL;
+        INC_REF(BUFFER_STORAGE, b->storage);
+    }
+    return (BUFFER_HANDLE)result;
+}
+
+BUFFER_HANDLE BUFFER_share(BUFFER_HANDLE handle)
+{
+    BUFFER_HANDLE result;
+    if (handle == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else
+    {
+        result = shareBytes(handle, 0, ((BUFFER*)handle)->size);
+    }
+    return result;
+}
+
+BUFFER_HANDLE BUFFER_slice(BUFFER_HANDLE handle, size_t offset, size_t length)
+{
+    BUFFER_HANDLE result;
+    if (handle == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else if ((offset > ((BUFFER*)handle)->size) ||
+        (length > ((BUFFER*)handle)->size - offset))
+    {
+        LogError("invalid arg (offset %lu, length %lu out of %lu bytes)\r\n", (unsigned long)offset, (unsigned long)length, (unsigned long)((BUFFER*)handle)->size);
+        result = NULL;
+    }
+    else
+    {
+        result = shareBytes(handle, offset, length);
+    }
+    return result;
+}
+
+BUFFER_POOL_HANDLE BUFFER_POOL_create(size_t bufferCount, size_t bufferSize)
+{
+    BUFFER_POOL* result;
+    if ((bufferCount == 0) ||
+        (bufferCount >= POOL_HEAD_INDEX_MASK) ||
+        (bufferCount > SIZE_MAX / sizeof(BUFFER)))
+    {
+        LogError("invalid arg (bufferCount %lu)\r\n", (unsigned long)bufferCount);
+        result = NULL;
+    }
+    else if ((result = (BUFFER_POOL*)malloc(sizeof(BUFFER_POOL))) == NULL)
+    {
+        LogError("malloc failed\r\n");
+    }
+    else if ((result->buffers = (BUFFER*)malloc(bufferCount * sizeof(BUFFER))) == NULL)
+    {
+        LogError("unable to allocate %lu buffers\r\n", (unsigned long)bufferCount);
+        free(result);
+        result = NULL;
+    }
+    else if ((result->next = (ATOMIC_SIZE*)malloc(bufferCount * sizeof(ATOMIC_SIZE))) == NULL)
+    {
+        LogError("malloc failed\r\n");
+        free(result->buffers);
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        size_t i;
+        result->bufferCount = bufferCount;
+        result->bufferSize = bufferSize;
+        for (i = 0; i < bufferCount; i++)
+        {
+            BUFFER* b = &result->buffers[i];
+            b->size = 0;
+            b->arena = NULL;
+            b->storage = NULL;
+            b->pool = (BUFFER_POOL_HANDLE)result;
+            if (bufferSize == 0)
+            {
+                b->buffer = NULL;
+                b->capacity = 0;
+            }
+            else if ((b->buffer = mallocBytes(b, bufferSize)) == NULL)
+            {
+                LogError("unable to allocate %lu bytes\r\n", (unsigned long)bufferSize);
+                break;
+            }
+            else
+            {
+                b->capacity = bufferSize;
+            }
+            /*the buffers are stacked so that the first one is on top*/
+            ATOMIC_SIZE_INIT(&result->next[i], (i + 1 < bufferCount) ? (i + 2) : 0);
+        }
+
+        if (i < bufferCount)
+        {
+            while (i > 0)
+            {
+                i--;
+                free(result->buffers[i].buffer);
+            }
+            free((void*)result->next);
+            free(result->buffers);
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+#ifdef BUFFER_POOL_ENABLED
+            ATOMIC_UINT64_INIT(&result->head, 1);
+#endif
+        }
+    }
+    return (BUFFER_POOL_HANDLE)result;
+}
+
+void BUFFER_POOL_destroy(BUFFER_POOL_HANDLE pool)
+{
+    if (pool != NULL)
+    {
+        BUFFER_POOL* p = (BUFFER_POOL*)pool;
+        size_t i;
+        for (i = 0; i < p->bufferCount; i++)
+        {
+            free(p->buffers[i].buffer);
+        }
+        free((void*)p->next);
+        free(p->buffers);
+        free(p);
+    }
+}
+
+BUFFER_HANDLE BUFFER_POOL_acquire(BUFFER_POOL_HANDLE pool)
+{
+    BUFFER* result;
+    if (pool == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else
+    {
+        BUFFER_POOL* p = (BUFFER_POOL*)pool;
+#ifdef BUFFER_POOL_ENABLED
+        result = popFromPool(p);
+#else
+        result = NULL;
+#endif
+        if (result == NULL)
+        {
+            /*the pool is exhausted, a heap buffer does the job and is freed by BUFFER_delete as usual*/
+            result = (BUFFER*)BUFFER_new();
+            if (result == NULL)
+            {
+                LogError("unable to create a buffer\r\n");
+            }
+            else if (reserveBytes(result, p->bufferSize) != 0)
+            {
+                free(result);
+                result = NULL;
+            }
+        }
+        else if (reserveBytes(result, p->bufferSize) != 0)
+        {
+            /*the storage was given back by BUFFER_shrink_to_fit or the like and cannot be had again*/
+            returnToPool(result);
+            result = NULL;
+        }
+    }
+    return (BUFFER_HANDLE)result;
+}
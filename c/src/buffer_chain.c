@@ -0,0 +1,226 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+#include "gballoc.h"
+
+#include <stdint.h>
+#include <string.h>
+#include "buffer_chain.h"
+#include "doublylinkedlist.h"
+#include "iot_logging.h"
+
+typedef struct BUFFER_CHAIN_SEGMENT_TAG
+{
+    DLIST_ENTRY entry;
+    BUFFER_HANDLE buffer;
+} BUFFER_CHAIN_SEGMENT;
+
+typedef struct BUFFER_CHAIN_TAG
+{
+    DLIST_ENTRY segments;
+    size_t segmentCount;
+    /*segments are not modified while in the chain, so their total length is kept as they come and go*/
+    size_t length;
+} BUFFER_CHAIN;
+
+static int insertSegment(BUFFER_CHAIN_HANDLE chain, BUFFER_HANDLE segment, int atHead)
+{
+    int result;
+    if ((chain == NULL) || (segment == NULL))
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        BUFFER_CHAIN* c = (BUFFER_CHAIN*)chain;
+        size_t segmentLength = BUFFER_length(segment);
+        BUFFER_CHAIN_SEGMENT* newSegment;
+        if (c->length + segmentLength < c->length)
+        {
+            LogError("the chain would be longer than SIZE_MAX\r\n");
+            result = __LINE__;
+        }
+        else if ((newSegment = (BUFFER_CHAIN_SEGMENT*)malloc(sizeof(BUFFER_CHAIN_SEGMENT))) == NULL)
+        {
+            LogError("malloc failed\r\n");
+            result = __LINE__;
+        }
+        else
+        {
+            newSegment->buffer = segment;
+            if (atHead)
+            {
+                DList_InsertHeadList(&c->segments, &newSegment->entry);
+            }
+            else
+            {
+                DList_InsertTailList(&c->segments, &newSegment->entry);
+            }
+            c->segmentCount++;
+            c->length += segmentLength;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+BUFFER_CHAIN_HANDLE BUFFER_CHAIN_create(void)
+{
+    BUFFER_CHAIN* result = (BUFFER_CHAIN*)malloc(sizeof(BUFFER_CHAIN));
+    if (result == NULL)
+    {
+        LogError("malloc failed\r\n");
+    }
+    else
+    {
+        DList_InitializeListHead(&result->segments);
+        result->segmentCount = 0;
+        result->length = 0;
+    }
+    return (BUFFER_CHAIN_HANDLE)result;
+}
+
+void BUFFER_CHAIN_destroy(BUFFER_CHAIN_HANDLE chain)
+{
+    if (chain != NULL)
+    {
+        BUFFER_CHAIN* c = (BUFFER_CHAIN*)chain;
+        while (!DList_IsListEmpty(&c->segments))
+        {
+            BUFFER_CHAIN_SEGMENT* segment = containingRecord(DList_RemoveHeadList(&c->segments), BUFFER_CHAIN_SEGMENT, entry);
+            BUFFER_delete(segment->buffer);
+            free(segment);
+        }
+        free(c);
+    }
+}
+
+int BUFFER_CHAIN_append(BUFFER_CHAIN_HANDLE chain, BUFFER_HANDLE segment)
+{
+    return insertSegment(chain, segment, 0);
+}
+
+int BUFFER_CHAIN_prepend(BUFFER_CHAIN_HANDLE chain, BUFFER_HANDLE segment)
+{
+    return insertSegment(chain, segment, 1);
+}
+
+size_t BUFFER_CHAIN_segment_count(BUFFER_CHAIN_HANDLE chain)
+{
+    size_t result;
+    if (chain == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = 0;
+    }
+    else
+    {
+        result = ((BUFFER_CHAIN*)chain)->segmentCount;
+    }
+    return result;
+}
+
+size_t BUFFER_CHAIN_length(BUFFER_CHAIN_HANDLE chain)
+{
+    size_t result;
+    if (chain == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = 0;
+    }
+    else
+    {
+        result = ((BUFFER_CHAIN*)chain)->length;
+    }
+    return result;
+}
+
+BUFFER_HANDLE BUFFER_CHAIN_flatten(BUFFER_CHAIN_HANDLE chain)
+{
+    BUFFER_HANDLE result;
+    if (chain == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else if ((result = BUFFER_new()) == NULL)
+    {
+        LogError("unable to create the flattened buffer\r\n");
+    }
+    else
+    {
+        BUFFER_CHAIN* c = (BUFFER_CHAIN*)chain;
+        if (c->length > 0)
+        {
+            if (BUFFER_pre_build(result, c->length) != 0)
+            {
+                LogError("unable to allocate %lu bytes\r\n", (unsigned long)c->length);
+                BUFFER_delete(result);
+                result = NULL;
+            }
+            else
+            {
+                unsigned char* destination = BUFFER_u_char(result);
+                PDLIST_ENTRY entry;
+                for (entry = c->segments.Flink; entry != &c->segments; entry = entry->Flink)
+                {
+                    BUFFER_CHAIN_SEGMENT* segment = containingRecord(entry, BUFFER_CHAIN_SEGMENT, entry);
+                    const unsigned char* content;
+                    size_t size;
+                    if ((BUFFER_content(segment->buffer, &content) == 0) &&
+                        (BUFFER_size(segment->buffer, &size) == 0) &&
+                        (size > 0))
+                    {
+                        (void)memcpy(destination, content, size);
+                        destination += size;
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+#ifndef WIN32
+int BUFFER_CHAIN_get_iovec(BUFFER_CHAIN_HANDLE chain, struct iovec* iov, size_t* iovCount)
+{
+    int result;
+    if ((chain == NULL) || (iov == NULL) || (iovCount == NULL))
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = __LINE__;
+    }
+    else if (*iovCount < ((BUFFER_CHAIN*)chain)->segmentCount)
+    {
+        LogError("%lu iovec entries are needed, only %lu given\r\n", (unsigned long)((BUFFER_CHAIN*)chain)->segmentCount, (unsigned long)*iovCount);
+        result = __LINE__;
+    }
+    else
+    {
+        BUFFER_CHAIN* c = (BUFFER_CHAIN*)chain;
+        PDLIST_ENTRY entry;
+        size_t i = 0;
+        for (entry = c->segments.Flink; entry != &c->segments; entry = entry->Flink)
+        {
+            BUFFER_CHAIN_SEGMENT* segment = containingRecord(entry, BUFFER_CHAIN_SEGMENT, entry);
+            const unsigned char* content;
+            if (BUFFER_content(segment->buffer, &content) != 0)
+            {
+                content = NULL;
+            }
+            /*writev does not write to iov_base, the const is only dropped because struct iovec has none*/
+            iov[i].iov_base = (void*)content;
+            iov[i].iov_len = BUFFER_length(segment->buffer);
+            i++;
+        }
+        *iovCount = i;
+        result = 0;
+    }
+    return result;
+}
+#endif
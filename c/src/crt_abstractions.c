@@ -261,7 +261,7 @@ int mallocAndStrcpy_s(char** destination, const char* source)
     else
     {
         size_t l = strlen(source);
-        *destination = (char*)malloc(l + 1);
+        *destination = (char*)gballoc_malloc_for_caller(l + 1);
         /*Codes_SRS_CRT_ABSTRACTIONS_99_037: [Upon failure to allocate memory for the destination, the function will return ENOMEM.]*/
         if (*destination == NULL)
         {
@@ -5,59 +5,344 @@
 #ifdef _CRTDBG_MAP_ALLOC
 #include <crtdbg.h>
 #endif
+/* gballoc.c always implements the GB_DEBUG_ALLOC interface, and its own allocations are never redirected */
+#ifdef GB_MEASURE_MEMORY_FOR_THIS
+#undef GB_MEASURE_MEMORY_FOR_THIS
+#endif
+#ifndef GB_DEBUG_ALLOC
+#define GB_DEBUG_ALLOC
+#endif
+#include "gballoc.h"
 #include "lock.h"
+#include "atomics.h"
 #include "iot_logging.h"
 #include <stdint.h>
+#include <string.h>
 
 #ifndef SIZE_MAX
 #define SIZE_MAX ((size_t)~(size_t)0)
 #endif
 
+/*the memory counters are shared by all shards and are updated atomically.
+When no atomic primitive is known for the platform, a single shard is used and the counters are only ever modified under its lock.*/
+#ifdef ATOMIC_NOT_SUPPORTED
+#define GBALLOC_LOCK_SHARD_COUNT 1
+#else
+#define GBALLOC_LOCK_SHARD_COUNT 16
+#endif
+
+/* the number of buckets in the statically allocated table each shard uses until the number of live allocations in the shard exceeds it, must be a power of 2 */
+#define GBALLOC_INITIAL_BUCKET_COUNT 256
+
+/* the number of buckets of the allocation site table, must be a power of 2 */
+#define GBALLOC_SITE_BUCKET_COUNT 256
+
+typedef struct ALLOCATION_SITE_TAG
+{
+    GBALLOC_ALLOCATION_SITE info;
+    struct ALLOCATION_SITE_TAG* next;
+} ALLOCATION_SITE;
+
 typedef struct ALLOCATION_TAG
 {
     size_t size;
     void* ptr;
     void* next;
+    ALLOCATION_SITE* site;
 } ALLOCATION;
 
+/* allocations are spread over several shards by pointer, each with its own lock and its own chained hash table keyed on the pointer,
+so that threads working on different blocks do not serialize on one lock and lookups do not need to walk every live allocation */
+typedef struct GBALLOC_SHARD_TAG
+{
+    LOCK_HANDLE lock;
+    ALLOCATION* initialBuckets[GBALLOC_INITIAL_BUCKET_COUNT];
+    ALLOCATION** buckets;
+    size_t bucketCount;
+    size_t allocationCount;
+} GBALLOC_SHARD;
+
 typedef enum GBALLOC_STATE_TAG
 {
     GBALLOC_STATE_INIT,
     GBALLOC_STATE_NOT_INIT
 } GBALLOC_STATE;
 
-static ALLOCATION* head = NULL;
-static size_t totalSize = 0;
-static size_t maxSize = 0;
+static GBALLOC_SHARD shards[GBALLOC_LOCK_SHARD_COUNT];
+static ATOMIC_SIZE totalSize;
+static ATOMIC_SIZE maxSize;
 static GBALLOC_STATE gballocState = GBALLOC_STATE_NOT_INIT;
 
-static LOCK_HANDLE gballocThreadSafeLock = NULL;
+/* the site table and the size histogram are only fed by the gballoc_xxx_at functions and have their own lock,
+which is taken after (never before) a shard lock */
+static LOCK_HANDLE sitesLock;
+static ALLOCATION_SITE* siteBuckets[GBALLOC_SITE_BUCKET_COUNT];
+static size_t sizeHistogram[GBALLOC_SIZE_HISTOGRAM_BUCKET_COUNT];
 
-int gballoc_init(void)
+static size_t hashPointer(const void* ptr)
+{
+    /* heap pointers are aligned, so the low bits carry no information; mix the rest before masking */
+    size_t hash = (size_t)(uintptr_t)ptr;
+    hash ^= hash >> 4;
+    hash *= (size_t)0x9E3779B1;
+    hash ^= hash >> 15;
+    return hash;
+}
+
+static GBALLOC_SHARD* getShard(const void* ptr)
+{
+    return &shards[hashPointer(ptr) & (GBALLOC_LOCK_SHARD_COUNT - 1)];
+}
+
+static size_t getBucketIndex(const void* ptr, size_t count)
+{
+    /* the low bits of the hash already picked the shard */
+    return (hashPointer(ptr) / GBALLOC_LOCK_SHARD_COUNT) & (count - 1);
+}
+
+static void growAllocationTable(GBALLOC_SHARD* shard)
+{
+    size_t newBucketCount = shard->bucketCount * 2;
+    ALLOCATION** newBuckets = (ALLOCATION**)calloc(newBucketCount, sizeof(ALLOCATION*));
+    if (newBuckets != NULL)
+    {
+        size_t i;
+        for (i = 0; i < shard->bucketCount; i++)
+        {
+            ALLOCATION* curr = shard->buckets[i];
+            while (curr != NULL)
+            {
+                ALLOCATION* next = (ALLOCATION*)curr->next;
+                size_t index = getBucketIndex(curr->ptr, newBucketCount);
+                curr->next = newBuckets[index];
+                newBuckets[index] = curr;
+                curr = next;
+            }
+        }
+
+        if (shard->buckets != shard->initialBuckets)
+        {
+            free(shard->buckets);
+        }
+
+        shard->buckets = newBuckets;
+        shard->bucketCount = newBucketCount;
+    }
+    /* if the table cannot grow, tracking keeps working with longer chains */
+}
+
+static void addAllocation(GBALLOC_SHARD* shard, ALLOCATION* allocation)
+{
+    size_t index;
+
+    if (shard->allocationCount >= shard->bucketCount)
+    {
+        growAllocationTable(shard);
+    }
+
+    index = getBucketIndex(allocation->ptr, shard->bucketCount);
+    allocation->next = shard->buckets[index];
+    shard->buckets[index] = allocation;
+    shard->allocationCount++;
+}
+
+static ALLOCATION* removeAllocation(GBALLOC_SHARD* shard, const void* ptr)
+{
+    ALLOCATION** link = &shard->buckets[getBucketIndex(ptr, shard->bucketCount)];
+    ALLOCATION* curr = *link;
+    while ((curr != NULL) && (curr->ptr != ptr))
+    {
+        link = (ALLOCATION**)&curr->next;
+        curr = *link;
+    }
+
+    if (curr != NULL)
+    {
+        *link = (ALLOCATION*)curr->next;
+        shard->allocationCount--;
+    }
+
+    return curr;
+}
+
+static void increaseMemoryUsed(size_t size)
+{
+    /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
+    size_t newTotalSize = ATOMIC_SIZE_ADD(&totalSize, size);
+    size_t currentMaxSize = ATOMIC_SIZE_LOAD(&maxSize);
+    while ((currentMaxSize < newTotalSize) &&
+        !ATOMIC_SIZE_COMPARE_EXCHANGE(&maxSize, currentMaxSize, newTotalSize))
+    {
+        currentMaxSize = ATOMIC_SIZE_LOAD(&maxSize);
+    }
+}
+
+static void decreaseMemoryUsed(size_t size)
+{
+    (void)ATOMIC_SIZE_ADD(&totalSize, (size_t)0 - size);
+}
+
+/* the memory counters are updated under the shard lock, so that the size of a block is always added before it can be subtracted by a free on another thread */
+static int trackAllocation(ALLOCATION* allocation)
 {
     int result;
+    GBALLOC_SHARD* shard = getShard(allocation->ptr);
 
-    if (gballocState != GBALLOC_STATE_NOT_INIT)
+    if (LOCK_OK != Lock(shard->lock))
     {
-        /* Codes_SRS_GBALLOC_01_025: [Init after Init shall fail and return a non-zero value.] */
+        LogError("Failed to get the Lock.\r\n");
         result = __LINE__;
     }
-    /* Codes_SRS_GBALLOC_01_026: [gballoc_Init shall create a lock handle that will be used to make the other gballoc APIs thread-safe.] */
-    else if ((gballocThreadSafeLock = Lock_Init()) == NULL)
+    else
     {
-        /* Codes_SRS_GBALLOC_01_027: [If the Lock creation fails, gballoc_init shall return a non-zero value.]*/
+        addAllocation(shard, allocation);
+        increaseMemoryUsed(allocation->size);
+        (void)Unlock(shard->lock);
+
+        result = 0;
+    }
+
+    return result;
+}
+
+static size_t getHistogramBucket(size_t size)
+{
+    /* the bucket is the number of significant bits of the size */
+    size_t result = 0;
+    while (size != 0)
+    {
+        result++;
+        size >>= 1;
+    }
+
+    return result;
+}
+
+/* has to be called under the sites lock. Sites are told apart by the address of the __FILE__ literal and the line */
+static ALLOCATION_SITE* getAllocationSite(const char* file, int line)
+{
+    ALLOCATION_SITE** bucket = &siteBuckets[(hashPointer(file) + (size_t)line) & (GBALLOC_SITE_BUCKET_COUNT - 1)];
+    ALLOCATION_SITE* result = *bucket;
+    while ((result != NULL) && ((result->info.file != file) || (result->info.line != line)))
+    {
+        result = result->next;
+    }
+
+    if (result == NULL)
+    {
+        result = (ALLOCATION_SITE*)malloc(sizeof(ALLOCATION_SITE));
+        if (result != NULL)
+        {
+            result->info.file = file;
+            result->info.line = line;
+            result->info.liveBytes = 0;
+            result->info.liveCount = 0;
+            result->info.totalCount = 0;
+            result->next = *bucket;
+            *bucket = result;
+        }
+    }
+
+    return result;
+}
+
+static void attachAllocationToSite(ALLOCATION* allocation, const char* file, int line)
+{
+    if (LOCK_OK != Lock(sitesLock))
+    {
+        LogError("Failed to get the Lock.\r\n");
+    }
+    else
+    {
+        sizeHistogram[getHistogramBucket(allocation->size)]++;
+
+        allocation->site = getAllocationSite(file, line);
+        if (allocation->site == NULL)
+        {
+            /* the allocation stays tracked, it is only left out of the per site figures */
+            LogError("Could not allocate the record for allocation site %s:%d\r\n", file, line);
+        }
+        else
+        {
+            allocation->site->info.liveBytes += allocation->size;
+            allocation->site->info.liveCount++;
+            allocation->site->info.totalCount++;
+        }
+
+        (void)Unlock(sitesLock);
+    }
+}
+
+static void detachAllocationFromSite(ALLOCATION* allocation)
+{
+    if (allocation->site != NULL)
+    {
+        if (LOCK_OK != Lock(sitesLock))
+        {
+            LogError("Failed to get the Lock.\r\n");
+        }
+        else
+        {
+            allocation->site->info.liveBytes -= allocation->size;
+            allocation->site->info.liveCount--;
+            (void)Unlock(sitesLock);
+        }
+
+        allocation->site = NULL;
+    }
+}
+
+int gballoc_init(void)
+{
+    int result;
+
+    if (gballocState != GBALLOC_STATE_NOT_INIT)
+    {
+        /* Codes_SRS_GBALLOC_01_025: [Init after Init shall fail and return a non-zero value.] */
         result = __LINE__;
     }
     else
     {
-        gballocState = GBALLOC_STATE_INIT;
+        size_t i;
+
+        /* Codes_SRS_GBALLOC_01_026: [gballoc_Init shall create a lock handle that will be used to make the other gballoc APIs thread-safe.] */
+        for (i = 0; i < GBALLOC_LOCK_SHARD_COUNT; i++)
+        {
+            if ((shards[i].lock = Lock_Init()) == NULL)
+            {
+                break;
+            }
 
-        /* Codes_ SRS_GBALLOC_01_002: [Upon initialization the total memory used and maximum total memory used tracked by the module shall be set to 0.] */
-        totalSize = 0;
-        maxSize = 0;
+            if (shards[i].buckets == NULL)
+            {
+                shards[i].buckets = shards[i].initialBuckets;
+                shards[i].bucketCount = GBALLOC_INITIAL_BUCKET_COUNT;
+            }
+        }
 
-        /* Codes_SRS_GBALLOC_01_024: [gballoc_init shall initialize the gballoc module and return 0 upon success.] */
-        result = 0;
+        if ((i < GBALLOC_LOCK_SHARD_COUNT) ||
+            ((sitesLock = Lock_Init()) == NULL))
+        {
+            /* Codes_SRS_GBALLOC_01_027: [If the Lock creation fails, gballoc_init shall return a non-zero value.]*/
+            while (i > 0)
+            {
+                i--;
+                (void)Lock_Deinit(shards[i].lock);
+            }
+            result = __LINE__;
+        }
+        else
+        {
+            gballocState = GBALLOC_STATE_INIT;
+
+            /* Codes_ SRS_GBALLOC_01_002: [Upon initialization the total memory used and maximum total memory used tracked by the module shall be set to 0.] */
+            ATOMIC_SIZE_STORE_RELEASE(&totalSize, 0);
+            ATOMIC_SIZE_STORE_RELEASE(&maxSize, 0);
+            (void)memset(sizeHistogram, 0, sizeof(sizeHistogram));
+
+            /* Codes_SRS_GBALLOC_01_024: [gballoc_init shall initialize the gballoc module and return 0 upon success.] */
+            result = 0;
+        }
     }
 
     return result;
@@ -67,14 +352,50 @@ void gballoc_deinit(void)
 {
     if (gballocState == GBALLOC_STATE_INIT)
     {
-        /* Codes_SRS_GBALLOC_01_028: [gballoc_deinit shall free all resources allocated by gballoc_init.] */
-        (void)Lock_Deinit(gballocThreadSafeLock);
+        size_t i;
+        for (i = 0; i < GBALLOC_LOCK_SHARD_COUNT; i++)
+        {
+            /* Codes_SRS_GBALLOC_01_028: [gballoc_deinit shall free all resources allocated by gballoc_init.] */
+            (void)Lock_Deinit(shards[i].lock);
+
+            /* a grown table is only released once nothing is tracked in it anymore */
+            if ((shards[i].allocationCount == 0) && (shards[i].buckets != shards[i].initialBuckets))
+            {
+                free(shards[i].buckets);
+                shards[i].buckets = shards[i].initialBuckets;
+                shards[i].bucketCount = GBALLOC_INITIAL_BUCKET_COUNT;
+            }
+            else
+            {
+                /* blocks still tracked keep being tracked, but the site records they point to are about to go away */
+                size_t j;
+                for (j = 0; j < shards[i].bucketCount; j++)
+                {
+                    ALLOCATION* curr;
+                    for (curr = shards[i].buckets[j]; curr != NULL; curr = (ALLOCATION*)curr->next)
+                    {
+                        curr->site = NULL;
+                    }
+                }
+            }
+        }
+
+        (void)Lock_Deinit(sitesLock);
+        for (i = 0; i < GBALLOC_SITE_BUCKET_COUNT; i++)
+        {
+            while (siteBuckets[i] != NULL)
+            {
+                ALLOCATION_SITE* next = siteBuckets[i]->next;
+                free(siteBuckets[i]);
+                siteBuckets[i] = next;
+            }
+        }
     }
 
     gballocState = GBALLOC_STATE_NOT_INIT;
 }
 
-void* gballoc_malloc(size_t size)
+void* gballoc_malloc_at(size_t size, const char* file, int line)
 {
     void* result;
 
@@ -83,53 +404,54 @@ void* gballoc_malloc(size_t size)
         /* Codes_SRS_GBALLOC_01_039: [If gballoc was not initialized gballoc_malloc shall simply call malloc without any memory tracking being performed.] */
         result = malloc(size);
     }
-    /* Codes_SRS_GBALLOC_01_030: [gballoc_malloc shall ensure thread safety by using the lock created by gballoc_Init.] */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
-    {
-        /* Codes_SRS_GBALLOC_01_048: [If acquiring the lock fails, gballoc_malloc shall return NULL.] */
-        LogError("Failed to get the Lock.\r\n");
-        result = NULL;
-    }
-    else
-    {
-    ALLOCATION* allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION));
-    if (allocation == NULL)
-    {
-        result = NULL;
-    }
     else
     {
-        /* Codes_SRS_GBALLOC_01_003: [gb_malloc shall call the C99 malloc function and return its result.] */
-        result = malloc(size);
-        if (result == NULL)
+        ALLOCATION* allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION));
+        if (allocation == NULL)
         {
-            /* Codes_SRS_GBALLOC_01_012: [When the underlying malloc call fails, gballoc_malloc shall return NULL and size should not be counted towards total memory used.] */
-            free(allocation);
+            result = NULL;
         }
         else
         {
-            /* Codes_SRS_GBALLOC_01_004: [If the underlying malloc call is successful, gb_malloc shall increment the total memory used with the amount indicated by size.] */
-            allocation->ptr = result;
-            allocation->size = size;
-            allocation->next = head;
-            head = allocation;
-
-            totalSize += size;
-            /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
-            if (maxSize < totalSize)
+            /* Codes_SRS_GBALLOC_01_003: [gb_malloc shall call the C99 malloc function and return its result.] */
+            result = malloc(size);
+            if (result == NULL)
+            {
+                /* Codes_SRS_GBALLOC_01_012: [When the underlying malloc call fails, gballoc_malloc shall return NULL and size should not be counted towards total memory used.] */
+                free(allocation);
+            }
+            else
             {
-                maxSize = totalSize;
+                /* Codes_SRS_GBALLOC_01_004: [If the underlying malloc call is successful, gb_malloc shall increment the total memory used with the amount indicated by size.] */
+                allocation->ptr = result;
+                allocation->size = size;
+                allocation->site = NULL;
+
+                /* Codes_SRS_GBALLOC_01_030: [gballoc_malloc shall ensure thread safety by using the lock created by gballoc_Init.] */
+                if (trackAllocation(allocation) != 0)
+                {
+                    /* Codes_SRS_GBALLOC_01_048: [If acquiring the lock fails, gballoc_malloc shall return NULL.] */
+                    free(result);
+                    free(allocation);
+                    result = NULL;
+                }
+                else if (file != NULL)
+                {
+                    attachAllocationToSite(allocation, file, line);
+                }
             }
         }
     }
 
-        (void)Unlock(gballocThreadSafeLock);
-    }
-    
     return result;
 }
 
-void* gballoc_calloc(size_t nmemb, size_t size)
+void* gballoc_malloc(size_t size)
+{
+    return gballoc_malloc_at(size, NULL, 0);
+}
+
+void* gballoc_calloc_at(size_t nmemb, size_t size, const char* file, int line)
 {
     void* result;
 
@@ -138,250 +460,420 @@ void* gballoc_calloc(size_t nmemb, size_t size)
         /* Codes_SRS_GBALLOC_01_040: [If gballoc was not initialized gballoc_calloc shall simply call calloc without any memory tracking being performed.] */
         result = calloc(nmemb, size);
     }
-    /* Codes_SRS_GBALLOC_01_031: [gballoc_calloc shall ensure thread safety by using the lock created by gballoc_Init]  */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
-    {
-        /* Codes_SRS_GBALLOC_01_046: [If acquiring the lock fails, gballoc_calloc shall return NULL.] */
-        LogError("Failed to get the Lock.\r\n");
-        result = NULL;
-    }
     else
     {
-    ALLOCATION* allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION));
-    if (allocation == NULL)
-    {
-        result = NULL;
-    }
-    else
-    {
-        /* Codes_SRS_GBALLOC_01_020: [gballoc_calloc shall call the C99 calloc function and return its result.] */
-        result = calloc(nmemb, size);
-        if (result == NULL)
+        ALLOCATION* allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION));
+        if (allocation == NULL)
         {
-            /* Codes_SRS_GBALLOC_01_022: [When the underlying calloc call fails, gballoc_calloc shall return NULL and size should not be counted towards total memory used.] */
-            free(allocation);
+            result = NULL;
         }
         else
         {
-            /* Codes_SRS_GBALLOC_01_021: [If the underlying calloc call is successful, gballoc_calloc shall increment the total memory used with nmemb*size.] */
-            allocation->ptr = result;
-            allocation->size = nmemb * size;
-            allocation->next = head;
-            head = allocation;
-
-            totalSize += allocation->size;
-            /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
-            if (maxSize < totalSize)
+            /* Codes_SRS_GBALLOC_01_020: [gballoc_calloc shall call the C99 calloc function and return its result.] */
+            result = calloc(nmemb, size);
+            if (result == NULL)
             {
-                maxSize = totalSize;
+                /* Codes_SRS_GBALLOC_01_022: [When the underlying calloc call fails, gballoc_calloc shall return NULL and size should not be counted towards total memory used.] */
+                free(allocation);
+            }
+            else
+            {
+                /* Codes_SRS_GBALLOC_01_021: [If the underlying calloc call is successful, gballoc_calloc shall increment the total memory used with nmemb*size.] */
+                allocation->ptr = result;
+                allocation->size = nmemb * size;
+                allocation->site = NULL;
+
+                /* Codes_SRS_GBALLOC_01_031: [gballoc_calloc shall ensure thread safety by using the lock created by gballoc_Init]  */
+                if (trackAllocation(allocation) != 0)
+                {
+                    /* Codes_SRS_GBALLOC_01_046: [If acquiring the lock fails, gballoc_calloc shall return NULL.] */
+                    free(result);
+                    free(allocation);
+                    result = NULL;
+                }
+                else if (file != NULL)
+                {
+                    attachAllocationToSite(allocation, file, line);
+                }
             }
         }
-        }
-
-        (void)Unlock(gballocThreadSafeLock);
     }
 
     return result;
 }
 
-void* gballoc_realloc(void* ptr, size_t size)
+void* gballoc_calloc(size_t nmemb, size_t size)
+{
+    return gballoc_calloc_at(nmemb, size, NULL, 0);
+}
+
+void* gballoc_realloc_at(void* ptr, size_t size, const char* file, int line)
 {
-    ALLOCATION* curr;
     void* result;
-    ALLOCATION* allocation = NULL;
 
     if (gballocState != GBALLOC_STATE_INIT)
     {
         /* Codes_SRS_GBALLOC_01_041: [If gballoc was not initialized gballoc_realloc shall shall simply call realloc without any memory tracking being performed.] */
         result = realloc(ptr, size);
     }
-    /* Codes_SRS_GBALLOC_01_032: [gballoc_realloc shall ensure thread safety by using the lock created by gballoc_Init.] */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
-    {
-        /* Codes_SRS_GBALLOC_01_047: [If acquiring the lock fails, gballoc_realloc shall return NULL.] */
-        LogError("Failed to get the Lock.\r\n");
-        result = NULL;
-    }
-    else
-    {
-    if (ptr == NULL)
+    else if (ptr == NULL)
     {
         /* Codes_SRS_GBALLOC_01_017: [When ptr is NULL, gballoc_realloc shall call the underlying realloc with ptr being NULL and the realloc result shall be tracked by gballoc.] */
-        allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION));
-    }
-    else
-    {
-        curr = head;
-        while (curr != NULL)
+        ALLOCATION* allocation = (ALLOCATION*)malloc(sizeof(ALLOCATION));
+        if (allocation == NULL)
+        {
+            /* Codes_SRS_GBALLOC_01_015: [When allocating memory used for tracking by gballoc_realloc fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+            result = NULL;
+        }
+        else
         {
-            if (curr->ptr == ptr)
+            /* Codes_SRS_GBALLOC_01_005: [gballoc_realloc shall call the C99 realloc function and return its result.] */
+            result = realloc(NULL, size);
+            if (result == NULL)
             {
-                allocation = curr;
-                break;
+                /* Codes_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+                free(allocation);
             }
             else
             {
-                curr = (ALLOCATION*)curr->next;
+                allocation->ptr = result;
+                allocation->size = size;
+                allocation->site = NULL;
+
+                /* Codes_SRS_GBALLOC_01_032: [gballoc_realloc shall ensure thread safety by using the lock created by gballoc_Init.] */
+                if (trackAllocation(allocation) != 0)
+                {
+                    /* Codes_SRS_GBALLOC_01_047: [If acquiring the lock fails, gballoc_realloc shall return NULL.] */
+                    free(result);
+                    free(allocation);
+                    result = NULL;
+                }
+                else if (file != NULL)
+                {
+                    attachAllocationToSite(allocation, file, line);
+                }
             }
         }
     }
-
-    if (allocation == NULL)
-    {
-        /* Codes_SRS_GBALLOC_01_015: [When allocating memory used for tracking by gballoc_realloc fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
-        /* Codes_SRS_GBALLOC_01_016: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_realloc shall return NULL and the underlying realloc shall not be called.] */
-        result = NULL;
-    }
     else
     {
-        result = realloc(ptr, size);
-        if (result == NULL)
+        GBALLOC_SHARD* shard = getShard(ptr);
+
+        /* Codes_SRS_GBALLOC_01_032: [gballoc_realloc shall ensure thread safety by using the lock created by gballoc_Init.] */
+        if (LOCK_OK != Lock(shard->lock))
         {
-            /* Codes_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
-            if (ptr == NULL)
-            {
-                free(allocation);
-            }
+            /* Codes_SRS_GBALLOC_01_047: [If acquiring the lock fails, gballoc_realloc shall return NULL.] */
+            LogError("Failed to get the Lock.\r\n");
+            result = NULL;
         }
         else
         {
-            if (ptr != NULL)
+            /* the record is unlinked before realloc, so that the pointer value is not used anymore once realloc may have freed it */
+            ALLOCATION* allocation = removeAllocation(shard, ptr);
+            ALLOCATION* movedAllocation = NULL;
+
+            if (allocation == NULL)
             {
-                /* Codes_SRS_GBALLOC_01_006: [If the underlying realloc call is successful, gballoc_realloc shall look up the size associated with the pointer ptr and decrease the total memory used with that size.] */
-                allocation->ptr = result;
-                totalSize -= allocation->size;
-                allocation->size = size;
+                /* Codes_SRS_GBALLOC_01_016: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_realloc shall return NULL and the underlying realloc shall not be called.] */
+                result = NULL;
             }
             else
             {
-                /* add block */
-                allocation->ptr = result;
-                allocation->size = size;
-                allocation->next = head;
-                head = allocation;
+                /* Codes_SRS_GBALLOC_01_005: [gballoc_realloc shall call the C99 realloc function and return its result.] */
+                result = realloc(ptr, size);
+
+                /* Codes_SRS_GBALLOC_01_014: [When the underlying realloc call fails, gballoc_realloc shall return NULL and no change should be made to the counted total memory usage.] */
+                if (result == NULL)
+                {
+                    /* the block is left as it was, and so is its record */
+                    addAllocation(shard, allocation);
+                }
+                else
+                {
+                    ALLOCATION_SITE* previousSite = allocation->site;
+
+                    /* Codes_SRS_GBALLOC_01_006: [If the underlying realloc call is successful, gballoc_realloc shall look up the size associated with the pointer ptr and decrease the total memory used with that size.] */
+                    decreaseMemoryUsed(allocation->size);
+                    detachAllocationFromSite(allocation);
+
+                    /* Codes_SRS_GBALLOC_01_007: [If realloc is successful, gballoc_realloc shall also increment the total memory used value tracked by this module.] */
+                    increaseMemoryUsed(size);
+                    allocation->size = size;
+
+                    /* the block is accounted to the site that resized it last, a plain realloc leaves it where it was */
+                    if (file != NULL)
+                    {
+                        attachAllocationToSite(allocation, file, line);
+                    }
+                    else if (previousSite != NULL)
+                    {
+                        attachAllocationToSite(allocation, previousSite->info.file, previousSite->info.line);
+                    }
+
+                    /* the block may have moved, so it is hashed under its new address, possibly in another shard */
+                    allocation->ptr = result;
+                    if (getShard(result) == shard)
+                    {
+                        addAllocation(shard, allocation);
+                    }
+                    else
+                    {
+                        movedAllocation = allocation;
+                    }
+                }
             }
 
-            /* Codes_SRS_GBALLOC_01_007: [If realloc is successful, gballoc_realloc shall also increment the total memory used value tracked by this module.] */
-            totalSize += size;
+            (void)Unlock(shard->lock);
 
-            /* Codes_SRS_GBALLOC_01_011: [The maximum total memory used shall be the maximum of the total memory used at any point.] */
-            if (maxSize < totalSize)
+            /* only one shard lock is ever held at a time, so that two reallocs moving blocks in opposite directions cannot deadlock */
+            if (movedAllocation != NULL)
             {
-                maxSize = totalSize;
+                shard = getShard(result);
+                if (LOCK_OK != Lock(shard->lock))
+                {
+                    /* the block has already been moved by realloc, so it is handed out untracked rather than lost */
+                    LogError("Failed to get the Lock, allocation %p is no longer tracked.\r\n", result);
+                    decreaseMemoryUsed(movedAllocation->size);
+                    detachAllocationFromSite(movedAllocation);
+                    free(movedAllocation);
+                }
+                else
+                {
+                    addAllocation(shard, movedAllocation);
+                    (void)Unlock(shard->lock);
+                }
             }
         }
-        }
-
-        (void)Unlock(gballocThreadSafeLock);
     }
 
     return result;
 }
 
-void gballoc_free(void* ptr)
+void* gballoc_realloc(void* ptr, size_t size)
 {
-    ALLOCATION* curr = head;
-    ALLOCATION* prev = NULL;
+    return gballoc_realloc_at(ptr, size, NULL, 0);
+}
 
+void gballoc_free(void* ptr)
+{
     if (gballocState != GBALLOC_STATE_INIT)
     {
         /* Codes_SRS_GBALLOC_01_042: [If gballoc was not initialized gballoc_free shall shall simply call free.] */
         free(ptr);
     }
-    /* Codes_SRS_GBALLOC_01_033: [gballoc_free shall ensure thread safety by using the lock created by gballoc_Init.] */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
-    {
-        /* Codes_SRS_GBALLOC_01_049: [If acquiring the lock fails, gballoc_free shall do nothing.] */
-        LogError("Failed to get the Lock.\r\n");
-    }
     else
     {
-    /* Codes_SRS_GBALLOC_01_009: [gballoc_free shall also look up the size associated with the ptr pointer and decrease the total memory used with the associated size amount.] */
-    while (curr != NULL)
-    {
-        if (curr->ptr == ptr)
+        GBALLOC_SHARD* shard = getShard(ptr);
+
+        /* Codes_SRS_GBALLOC_01_033: [gballoc_free shall ensure thread safety by using the lock created by gballoc_Init.] */
+        if (LOCK_OK != Lock(shard->lock))
         {
-            /* Codes_SRS_GBALLOC_01_008: [gballoc_free shall call the C99 free function.] */
-            free(ptr);
-            totalSize -= curr->size;
-            if (prev != NULL)
+            /* Codes_SRS_GBALLOC_01_049: [If acquiring the lock fails, gballoc_free shall do nothing.] */
+            LogError("Failed to get the Lock.\r\n");
+        }
+        else
+        {
+            /* Codes_SRS_GBALLOC_01_009: [gballoc_free shall also look up the size associated with the ptr pointer and decrease the total memory used with the associated size amount.] */
+            ALLOCATION* allocation = removeAllocation(shard, ptr);
+            if (allocation != NULL)
             {
-                prev->next = curr->next;
+                /* Codes_SRS_GBALLOC_01_008: [gballoc_free shall call the C99 free function.] */
+                free(ptr);
+                decreaseMemoryUsed(allocation->size);
+                detachAllocationFromSite(allocation);
+                free(allocation);
             }
-            else
+            else if (ptr != NULL)
             {
-                head = (ALLOCATION*)curr->next;
+                /* Codes_SRS_GBALLOC_01_019: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_free shall not free any memory.] */
+
+                /* could not find the allocation */
+                LogError("Could not free allocation for address %p (not found)\r\n", ptr);
             }
 
-            free(curr);
-            break;
+            (void)Unlock(shard->lock);
         }
-
-        prev = curr;
-        curr = (ALLOCATION*)curr->next;
     }
+}
 
-        if ((curr == NULL) && (ptr != NULL))
-    {
-        /* Codes_SRS_GBALLOC_01_019: [When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_free shall not free any memory.] */
+size_t gballoc_getMaximumMemoryUsed(void)
+{
+    size_t result;
 
-        /* could not find the allocation */
-        LogError("Could not free allocation for address %p (not found)\r\n", ptr);
+    /* Codes_SRS_GBALLOC_01_038: [If gballoc was not initialized gballoc_getMaximumMemoryUsed shall return MAX_INT_SIZE.] */
+    if (gballocState != GBALLOC_STATE_INIT)
+    {
+        LogError("gballoc is not initialized.\r\n");
+        result = SIZE_MAX;
     }
-        (void)Unlock(gballocThreadSafeLock);
+    else
+    {
+        /* Codes_SRS_GBALLOC_01_010: [gballoc_getMaximumMemoryUsed shall return the maximum amount of total memory used recorded since the module initialization.] */
+        /* the counter is read atomically, no lock is taken */
+        result = ATOMIC_SIZE_LOAD(&maxSize);
     }
+
+    return result;
 }
 
-size_t gballoc_getMaximumMemoryUsed(void)
+size_t gballoc_getCurrentMemoryUsed(void)
 {
     size_t result;
 
-    /* Codes_SRS_GBALLOC_01_038: [If gballoc was not initialized gballoc_getMaximumMemoryUsed shall return MAX_INT_SIZE.] */
+    /* Codes_SRS_GBALLOC_01_044: [If gballoc was not initialized gballoc_getCurrentMemoryUsed shall return SIZE_MAX.] */
     if (gballocState != GBALLOC_STATE_INIT)
     {
         LogError("gballoc is not initialized.\r\n");
         result = SIZE_MAX;
     }
-    /* Codes_SRS_GBALLOC_01_034: [gballoc_getMaximumMemoryUsed shall ensure thread safety by using the lock created by gballoc_Init.]  */
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
+    else
+    {
+        /*Codes_SRS_GBALLOC_02_001: [gballoc_getCurrentMemoryUsed shall return the currently used memory size.] */
+        /* the counter is read atomically, no lock is taken */
+        result = ATOMIC_SIZE_LOAD(&totalSize);
+    }
+
+    return result;
+}
+
+size_t gballoc_getAllocationSites(GBALLOC_ALLOCATION_SITE* sites, size_t siteCount)
+{
+    size_t result;
+
+    if (gballocState != GBALLOC_STATE_INIT)
+    {
+        LogError("gballoc is not initialized.\r\n");
+        result = 0;
+    }
+    else if (sites == NULL)
+    {
+        LogError("Invalid argument sites=NULL\r\n");
+        result = 0;
+    }
+    else if (LOCK_OK != Lock(sitesLock))
     {
-        /* Codes_SRS_GBALLOC_01_050: [If the lock cannot be acquired, gballoc_getMaximumMemoryUsed shall return SIZE_MAX.]  */
         LogError("Failed to get the Lock.\r\n");
-        result = SIZE_MAX;
+        result = 0;
     }
     else
     {
-    /* Codes_SRS_GBALLOC_01_010: [gballoc_getMaximumMemoryUsed shall return the maximum amount of total memory used recorded since the module initialization.] */
-        result = maxSize;
-        Unlock(gballocThreadSafeLock);
-}
+        size_t i;
+
+        result = 0;
+        for (i = 0; i < GBALLOC_SITE_BUCKET_COUNT; i++)
+        {
+            ALLOCATION_SITE* curr;
+            for (curr = siteBuckets[i]; curr != NULL; curr = curr->next)
+            {
+                /* insertion into the sorted output, only the siteCount biggest sites are kept */
+                size_t position = result;
+                while ((position > 0) && (sites[position - 1].liveBytes < curr->info.liveBytes))
+                {
+                    position--;
+                }
+
+                if (position < siteCount)
+                {
+                    size_t keptCount = (result < siteCount) ? result : siteCount - 1;
+                    (void)memmove(&sites[position + 1], &sites[position], (keptCount - position) * sizeof(GBALLOC_ALLOCATION_SITE));
+                    sites[position] = curr->info;
+                    if (result < siteCount)
+                    {
+                        result++;
+                    }
+                }
+            }
+        }
+
+        (void)Unlock(sitesLock);
+    }
 
     return result;
 }
 
-size_t gballoc_getCurrentMemoryUsed(void)
+int gballoc_getSizeHistogram(size_t* histogram, size_t bucketCount)
 {
-    size_t result;
+    int result;
 
-    /* Codes_SRS_GBALLOC_01_044: [If gballoc was not initialized gballoc_getCurrentMemoryUsed shall return SIZE_MAX.] */
     if (gballocState != GBALLOC_STATE_INIT)
     {
         LogError("gballoc is not initialized.\r\n");
-        result = SIZE_MAX;
+        result = __LINE__;
     }
-    /* Codes_SRS_GBALLOC_01_036: [gballoc_getCurrentMemoryUsed shall ensure thread safety by using the lock created by gballoc_Init.]*/
-    else if (LOCK_OK != Lock(gballocThreadSafeLock))
+    else if (histogram == NULL)
+    {
+        LogError("Invalid argument histogram=NULL\r\n");
+        result = __LINE__;
+    }
+    else if (LOCK_OK != Lock(sitesLock))
     {
-        /* Codes_SRS_GBALLOC_01_051: [If the lock cannot be acquired, gballoc_getCurrentMemoryUsed shall return SIZE_MAX.] */
         LogError("Failed to get the Lock.\r\n");
-        result = SIZE_MAX;
+        result = __LINE__;
     }
     else
     {
-    /*Codes_SRS_GBALLOC_02_001: [gballoc_getCurrentMemoryUsed shall return the currently used memory size.] */
-        result = totalSize;
-        Unlock(gballocThreadSafeLock);
+        if (bucketCount > GBALLOC_SIZE_HISTOGRAM_BUCKET_COUNT)
+        {
+            bucketCount = GBALLOC_SIZE_HISTOGRAM_BUCKET_COUNT;
+        }
+
+        (void)memcpy(histogram, sizeHistogram, bucketCount * sizeof(size_t));
+        (void)Unlock(sitesLock);
+
+        result = 0;
     }
 
     return result;
 }
+
+void gballoc_dumpAllocationSites(size_t siteCount)
+{
+    if (gballocState != GBALLOC_STATE_INIT)
+    {
+        LogError("gballoc is not initialized.\r\n");
+    }
+    else
+    {
+        size_t histogram[GBALLOC_SIZE_HISTOGRAM_BUCKET_COUNT];
+        size_t i;
+
+        LogInfo("gballoc: %lu bytes in use, at most %lu bytes used\r\n", (unsigned long)ATOMIC_SIZE_LOAD(&totalSize), (unsigned long)ATOMIC_SIZE_LOAD(&maxSize));
+
+        if (siteCount > 0)
+        {
+            GBALLOC_ALLOCATION_SITE* sites = (siteCount > SIZE_MAX / sizeof(GBALLOC_ALLOCATION_SITE)) ? NULL : (GBALLOC_ALLOCATION_SITE*)malloc(siteCount * sizeof(GBALLOC_ALLOCATION_SITE));
+            if (sites == NULL)
+            {
+                LogError("Could not allocate memory for %lu allocation sites\r\n", (unsigned long)siteCount);
+            }
+            else
+            {
+                siteCount = gballoc_getAllocationSites(sites, siteCount);
+                for (i = 0; i < siteCount; i++)
+                {
+                    LogInfo("gballoc: %s:%d holds %lu bytes in %lu blocks, %lu allocations made\r\n",
+                        sites[i].file, sites[i].line, (unsigned long)sites[i].liveBytes, (unsigned long)sites[i].liveCount, (unsigned long)sites[i].totalCount);
+                }
+
+                free(sites);
+            }
+        }
+
+        if (gballoc_getSizeHistogram(histogram, GBALLOC_SIZE_HISTOGRAM_BUCKET_COUNT) == 0)
+        {
+            if (histogram[0] != 0)
+            {
+                LogInfo("gballoc: %lu allocations of 0 bytes\r\n", (unsigned long)histogram[0]);
+            }
+
+            for (i = 1; i < GBALLOC_SIZE_HISTOGRAM_BUCKET_COUNT; i++)
+            {
+                if (histogram[i] != 0)
+                {
+                    size_t lowest = (size_t)1 << (i - 1);
+                    LogInfo("gballoc: %lu allocations of %lu to %lu bytes\r\n", (unsigned long)histogram[i], (unsigned long)lowest, (unsigned long)(lowest + (lowest - 1)));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,447 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/*this file must not include gballoc.h, the pool sits underneath the redirection and uses the CRT allocator directly*/
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "atomics.h"
+
+#ifndef SIZE_MAX
+#define SIZE_MAX ((size_t)~(size_t)0)
+#endif
+
+/*the shared free lists are protected by a spin lock. When no atomic primitive is known for the platform,
+the gballoc_pool_xxx functions simply forward to the CRT allocator.*/
+#ifndef ATOMIC_NOT_SUPPORTED
+#define GBALLOC_POOL_ENABLED
+typedef ATOMIC_SIZE POOL_SPINLOCK;
+#define POOL_SPINLOCK_ACQUIRE(lock) while (ATOMIC_SIZE_EXCHANGE((lock), 1) != 0) {}
+#define POOL_SPINLOCK_RELEASE(lock) ATOMIC_SIZE_STORE_RELEASE((lock), 0)
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ == 201112)
+#define POOL_THREAD_LOCAL _Thread_local
+#elif defined(WIN32)
+#define POOL_THREAD_LOCAL __declspec(thread)
+#else
+#define POOL_THREAD_LOCAL __thread
+#endif
+#endif
+
+#ifdef GBALLOC_POOL_ENABLED
+
+#define GBALLOC_POOL_CLASS_COUNT 8
+/*blocks bigger than the biggest class are plain CRT blocks, without a header*/
+#define GBALLOC_POOL_LARGE_CLASS GBALLOC_POOL_CLASS_COUNT
+/*the size of the chunks carved into blocks when a class runs dry, slabs are also aligned on it*/
+#define GBALLOC_POOL_SLAB_SIZE (16 * 1024)
+/*the number of slots of the set the first slabs are registered in, must be a power of 2*/
+#define GBALLOC_POOL_INITIAL_SLAB_SLOTS 256
+/*a thread keeps at most this many free blocks per class; above it half of them go back to the shared list*/
+#define GBALLOC_POOL_CACHE_LIMIT 64
+
+/*slabs are aligned on their size, so that the slab of a block is its address with the low bits cleared*/
+#if defined(_MSC_VER)
+#include <malloc.h>
+#define POOL_SLAB_ALLOC() _aligned_malloc(GBALLOC_POOL_SLAB_SIZE, GBALLOC_POOL_SLAB_SIZE)
+#define POOL_SLAB_FREE(slab) _aligned_free(slab)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112)
+#define POOL_SLAB_ALLOC() aligned_alloc(GBALLOC_POOL_SLAB_SIZE, GBALLOC_POOL_SLAB_SIZE)
+#define POOL_SLAB_FREE(slab) free(slab)
+#else
+static void* allocateSlab(void)
+{
+    void* result;
+    if (posix_memalign(&result, GBALLOC_POOL_SLAB_SIZE, GBALLOC_POOL_SLAB_SIZE) != 0)
+    {
+        result = NULL;
+    }
+    return result;
+}
+#define POOL_SLAB_ALLOC() allocateSlab()
+#define POOL_SLAB_FREE(slab) free(slab)
+#endif
+
+static const size_t classSizes[GBALLOC_POOL_CLASS_COUNT] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+/*every block starts with a header holding its class. A free block reuses the header to link it in a free list.
+The alignment members keep the user part of the block as aligned as malloc would.*/
+typedef union POOL_HEADER_TAG
+{
+    size_t classIndex;
+    union POOL_HEADER_TAG* next;
+    long double alignLongDouble;
+    long long alignLongLong;
+    void* alignPointer;
+} POOL_HEADER;
+
+typedef struct POOL_SHARED_CLASS_TAG
+{
+    POOL_SPINLOCK lock;
+    POOL_HEADER* freeList;
+} POOL_SHARED_CLASS;
+
+typedef struct POOL_THREAD_CACHE_TAG
+{
+    POOL_HEADER* freeList[GBALLOC_POOL_CLASS_COUNT];
+    size_t count[GBALLOC_POOL_CLASS_COUNT];
+} POOL_THREAD_CACHE;
+
+static POOL_SHARED_CLASS sharedClasses[GBALLOC_POOL_CLASS_COUNT];
+
+/*the blocks cached by a thread are not handed back when the thread exits, which bounds what a thread can strand
+to GBALLOC_POOL_CACHE_LIMIT blocks per class*/
+static POOL_THREAD_LOCAL POOL_THREAD_CACHE threadCache;
+
+/*the slabs are registered in open addressing sets of their addresses, so that any pointer can be told to be a pool block or not.
+Slots go from NULL to a slab once and slabs are never given back, so lookups take no lock. When the newest set is half full
+a set twice as big is put in front of it, the older sets stay searchable behind it*/
+typedef struct POOL_SLAB_SET_TAG
+{
+    struct POOL_SLAB_SET_TAG* older;
+    size_t mask;
+    /*guarded by slabSetsLock*/
+    size_t count;
+    ATOMIC_POINTER* slots;
+} POOL_SLAB_SET;
+
+static ATOMIC_POINTER initialSlabSlots[GBALLOC_POOL_INITIAL_SLAB_SLOTS];
+static POOL_SLAB_SET initialSlabSet = { NULL, GBALLOC_POOL_INITIAL_SLAB_SLOTS - 1, 0, initialSlabSlots };
+static ATOMIC_POINTER newestSlabSet = &initialSlabSet;
+static POOL_SPINLOCK slabSetsLock;
+
+static size_t getSlabSlot(const void* slab, size_t mask)
+{
+    return (size_t)(((uintptr_t)slab / GBALLOC_POOL_SLAB_SIZE) * 2654435761u) & mask;
+}
+
+/*pointers that did not come from the pool (large blocks, memory that crossed a public API, allocations made by translation
+units that are not redirected) are released and resized by the CRT*/
+static int isPoolBlock(const void* ptr)
+{
+    void* slab = (void*)((uintptr_t)ptr & ~(uintptr_t)(GBALLOC_POOL_SLAB_SIZE - 1));
+    POOL_SLAB_SET* set = (POOL_SLAB_SET*)ATOMIC_POINTER_LOAD_ACQUIRE(&newestSlabSet);
+    int result = 0;
+
+    while ((result == 0) && (set != NULL))
+    {
+        size_t slot = getSlabSlot(slab, set->mask);
+        void* current;
+        while (((current = ATOMIC_POINTER_LOAD_ACQUIRE(&set->slots[slot])) != NULL) && (current != slab))
+        {
+            slot = (slot + 1) & set->mask;
+        }
+        result = (current != NULL);
+        set = set->older;
+    }
+
+    return result;
+}
+
+static int registerSlab(void* slab)
+{
+    int result;
+    POOL_SLAB_SET* set;
+
+    /*growing the set allocates under the lock, it happens once per doubling of the number of slabs*/
+    POOL_SPINLOCK_ACQUIRE(&slabSetsLock);
+    set = (POOL_SLAB_SET*)ATOMIC_POINTER_LOAD_ACQUIRE(&newestSlabSet);
+    if ((set->count + 1) * 2 > set->mask + 1)
+    {
+        size_t slotCount = (set->mask + 1) * 2;
+        POOL_SLAB_SET* newSet = (POOL_SLAB_SET*)malloc(sizeof(POOL_SLAB_SET));
+        if (newSet == NULL)
+        {
+            set = NULL;
+        }
+        else if ((slotCount > SIZE_MAX / sizeof(ATOMIC_POINTER)) ||
+            ((newSet->slots = (ATOMIC_POINTER*)malloc(slotCount * sizeof(ATOMIC_POINTER))) == NULL))
+        {
+            free(newSet);
+            set = NULL;
+        }
+        else
+        {
+            size_t i;
+            for (i = 0; i < slotCount; i++)
+            {
+                ATOMIC_POINTER_INIT(&newSet->slots[i], NULL);
+            }
+            newSet->older = set;
+            newSet->mask = slotCount - 1;
+            newSet->count = 0;
+            ATOMIC_POINTER_STORE_RELEASE(&newestSlabSet, newSet);
+            set = newSet;
+        }
+    }
+
+    if (set == NULL)
+    {
+        result = __LINE__;
+    }
+    else
+    {
+        size_t slot = getSlabSlot(slab, set->mask);
+        while (ATOMIC_POINTER_LOAD_ACQUIRE(&set->slots[slot]) != NULL)
+        {
+            slot = (slot + 1) & set->mask;
+        }
+        ATOMIC_POINTER_STORE_RELEASE(&set->slots[slot], slab);
+        set->count++;
+        result = 0;
+    }
+    POOL_SPINLOCK_RELEASE(&slabSetsLock);
+
+    return result;
+}
+
+static size_t getClassIndex(size_t size)
+{
+    size_t result = 0;
+    while ((result < GBALLOC_POOL_CLASS_COUNT) && (classSizes[result] < size))
+    {
+        result++;
+    }
+
+    return result;
+}
+
+static void refillThreadCache(size_t classIndex)
+{
+    POOL_SHARED_CLASS* sharedClass = &sharedClasses[classIndex];
+    POOL_HEADER* first;
+    POOL_HEADER* last;
+    size_t count = 1;
+
+    POOL_SPINLOCK_ACQUIRE(&sharedClass->lock);
+    first = sharedClass->freeList;
+    last = first;
+    if (first != NULL)
+    {
+        while ((count < GBALLOC_POOL_CACHE_LIMIT / 2) && (last->next != NULL))
+        {
+            last = last->next;
+            count++;
+        }
+        sharedClass->freeList = last->next;
+    }
+    POOL_SPINLOCK_RELEASE(&sharedClass->lock);
+
+    if (first != NULL)
+    {
+        last->next = threadCache.freeList[classIndex];
+        threadCache.freeList[classIndex] = first;
+        threadCache.count[classIndex] += count;
+    }
+    else
+    {
+        /*nothing to reuse, carve a new slab. Slabs are never given back, their blocks are recycled through the free lists*/
+        unsigned char* slab = (unsigned char*)POOL_SLAB_ALLOC();
+        if (slab == NULL)
+        {
+            /*nothing to hand out*/
+        }
+        else if (registerSlab(slab) != 0)
+        {
+            POOL_SLAB_FREE(slab);
+        }
+        else
+        {
+            size_t blockSize = sizeof(POOL_HEADER) + classSizes[classIndex];
+            size_t blockCount = GBALLOC_POOL_SLAB_SIZE / blockSize;
+            size_t keptCount = (blockCount < GBALLOC_POOL_CACHE_LIMIT / 2) ? blockCount : GBALLOC_POOL_CACHE_LIMIT / 2;
+            size_t i;
+
+            for (i = 0; i < blockCount - 1; i++)
+            {
+                ((POOL_HEADER*)(slab + (i * blockSize)))->next = (POOL_HEADER*)(slab + ((i + 1) * blockSize));
+            }
+            ((POOL_HEADER*)(slab + ((blockCount - 1) * blockSize)))->next = NULL;
+
+            /*the calling thread keeps the first blocks, the rest is shared with the other threads*/
+            last = (POOL_HEADER*)(slab + ((keptCount - 1) * blockSize));
+            if (last->next != NULL)
+            {
+                POOL_HEADER* rest = last->next;
+                POOL_HEADER* restLast = (POOL_HEADER*)(slab + ((blockCount - 1) * blockSize));
+
+                POOL_SPINLOCK_ACQUIRE(&sharedClass->lock);
+                restLast->next = sharedClass->freeList;
+                sharedClass->freeList = rest;
+                POOL_SPINLOCK_RELEASE(&sharedClass->lock);
+            }
+
+            last->next = threadCache.freeList[classIndex];
+            threadCache.freeList[classIndex] = (POOL_HEADER*)slab;
+            threadCache.count[classIndex] += keptCount;
+        }
+    }
+}
+
+static void drainThreadCache(size_t classIndex)
+{
+    POOL_SHARED_CLASS* sharedClass = &sharedClasses[classIndex];
+    POOL_HEADER* first = threadCache.freeList[classIndex];
+    POOL_HEADER* last = first;
+    size_t count = 1;
+
+    while (count < GBALLOC_POOL_CACHE_LIMIT / 2)
+    {
+        last = last->next;
+        count++;
+    }
+    threadCache.freeList[classIndex] = last->next;
+    threadCache.count[classIndex] -= count;
+
+    POOL_SPINLOCK_ACQUIRE(&sharedClass->lock);
+    last->next = sharedClass->freeList;
+    sharedClass->freeList = first;
+    POOL_SPINLOCK_RELEASE(&sharedClass->lock);
+}
+
+void* gballoc_pool_malloc(size_t size)
+{
+    POOL_HEADER* block;
+    void* result;
+    size_t classIndex = getClassIndex(size);
+
+    if (classIndex == GBALLOC_POOL_LARGE_CLASS)
+    {
+        result = malloc(size);
+    }
+    else
+    {
+        if (threadCache.freeList[classIndex] == NULL)
+        {
+            refillThreadCache(classIndex);
+        }
+
+        block = threadCache.freeList[classIndex];
+        if (block == NULL)
+        {
+            result = NULL;
+        }
+        else
+        {
+            threadCache.freeList[classIndex] = block->next;
+            threadCache.count[classIndex]--;
+
+            block->classIndex = classIndex;
+            result = block + 1;
+        }
+    }
+
+    return result;
+}
+
+void* gballoc_pool_calloc(size_t nmemb, size_t size)
+{
+    void* result;
+
+    if ((size != 0) && (nmemb > SIZE_MAX / size))
+    {
+        result = NULL;
+    }
+    else
+    {
+        result = gballoc_pool_malloc(nmemb * size);
+        if (result != NULL)
+        {
+            (void)memset(result, 0, nmemb * size);
+        }
+    }
+
+    return result;
+}
+
+void gballoc_pool_free(void* ptr)
+{
+    if (ptr == NULL)
+    {
+        /*nothing to do*/
+    }
+    else if (!isPoolBlock(ptr))
+    {
+        free(ptr);
+    }
+    else
+    {
+        POOL_HEADER* block = (POOL_HEADER*)ptr - 1;
+        size_t classIndex = block->classIndex;
+
+        block->next = threadCache.freeList[classIndex];
+        threadCache.freeList[classIndex] = block;
+        threadCache.count[classIndex]++;
+
+        if (threadCache.count[classIndex] > GBALLOC_POOL_CACHE_LIMIT)
+        {
+            drainThreadCache(classIndex);
+        }
+    }
+}
+
+void* gballoc_pool_realloc(void* ptr, size_t size)
+{
+    void* result;
+
+    if (ptr == NULL)
+    {
+        result = gballoc_pool_malloc(size);
+    }
+    else if (!isPoolBlock(ptr))
+    {
+        /*large blocks and foreign blocks stay with the CRT, its realloc can then grow or shrink them in place*/
+        result = realloc(ptr, size);
+    }
+    else
+    {
+        POOL_HEADER* block = (POOL_HEADER*)ptr - 1;
+        size_t classIndex = block->classIndex;
+
+        if (size <= classSizes[classIndex])
+        {
+            /*the block already has room for the new size*/
+            result = ptr;
+        }
+        else
+        {
+            result = gballoc_pool_malloc(size);
+            if (result != NULL)
+            {
+                (void)memcpy(result, ptr, classSizes[classIndex]);
+                gballoc_pool_free(ptr);
+            }
+        }
+    }
+
+    return result;
+}
+
+#else /* GBALLOC_POOL_ENABLED */
+
+void* gballoc_pool_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void* gballoc_pool_calloc(size_t nmemb, size_t size)
+{
+    return calloc(nmemb, size);
+}
+
+void* gballoc_pool_realloc(void* ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+void gballoc_pool_free(void* ptr)
+{
+    free(ptr);
+}
+
+#endif /* GBALLOC_POOL_ENABLED */
+
+void* gballoc_pool_crt_malloc(size_t size)
+{
+    return malloc(size);
+}
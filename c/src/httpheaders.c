@@ -20,11 +20,16 @@ static const char COLON_AND_SPACE[] = { ':', ' ', '\0' };
 static const char COMMA_AND_SPACE[] = { ',', ' ', '\0' };
 #define COMMA_AND_SPACE_LENGTH  ((sizeof(COMMA_AND_SPACE)/sizeof(COMMA_AND_SPACE[0]))-1)
 
+static const char CR_LF[] = { '\r', '\n', '\0' };
+#define CR_LF_LENGTH  ((sizeof(CR_LF)/sizeof(CR_LF[0]))-1)
+
 DEFINE_ENUM_STRINGS(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 
 typedef struct HTTP_HEADERS_HANDLE_DATA_TAG
 {
     MAP_HANDLE headers;
+    /*NULL unless the headers were allocated in an arena*/
+    ARENA_HANDLE arena;
 } HTTP_HEADERS_HANDLE_DATA;
 
 HTTP_HEADERS_HANDLE HTTPHeaders_Alloc(void)
@@ -47,9 +52,17 @@ HTTP_HEADERS_HANDLE HTTPHeaders_Alloc(void)
             free(result);
             result = NULL;
         }
+        /*header names are case-insensitive (RFC 2616, chapter 4.2)*/
+        else if (Map_IgnoreKeyCase(result->headers) != MAP_OK)
+        {
+            LogError("Map_IgnoreKeyCase failed\r\n");
+            Map_Destroy(result->headers);
+            free(result);
+            result = NULL;
+        }
         else
         {
-            /*all is fine*/
+            result->arena = NULL;
         }
     }
 
@@ -57,6 +70,37 @@ HTTP_HEADERS_HANDLE HTTPHeaders_Alloc(void)
     return (HTTP_HEADERS_HANDLE)result;
 }
 
+HTTP_HEADERS_HANDLE HTTPHeaders_AllocInArena(ARENA_HANDLE arena)
+{
+    HTTP_HEADERS_HANDLE_DATA* result;
+    if (arena == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else if ((result = (HTTP_HEADERS_HANDLE_DATA*)ARENA_malloc(arena, sizeof(HTTP_HEADERS_HANDLE_DATA))) == NULL)
+    {
+        LogError("ARENA_malloc failed\r\n");
+    }
+    else if ((result->headers = Map_CreateInArena(arena, NULL)) == NULL)
+    {
+        /*what was taken from the arena goes away with it*/
+        LogError("Map_CreateInArena failed\r\n");
+        result = NULL;
+    }
+    else if (Map_IgnoreKeyCase(result->headers) != MAP_OK)
+    {
+        LogError("Map_IgnoreKeyCase failed\r\n");
+        Map_Destroy(result->headers);
+        result = NULL;
+    }
+    else
+    {
+        result->arena = arena;
+    }
+    return (HTTP_HEADERS_HANDLE)result;
+}
+
 /*Codes_SRS_HTTP_HEADERS_99_005:[ Calling this API shall de-allocate the data structures allocated by previous API calls to the same handle.]*/
 void HTTPHeaders_Free(HTTP_HEADERS_HANDLE handle)
 {
@@ -71,7 +115,11 @@ void HTTPHeaders_Free(HTTP_HEADERS_HANDLE handle)
         HTTP_HEADERS_HANDLE_DATA* handleData = (HTTP_HEADERS_HANDLE_DATA*)handle;
 
         Map_Destroy(handleData->headers);
-        free(handleData);
+        /*headers allocated in an arena are released with the arena*/
+        if (handleData->arena == NULL)
+        {
+            free(handleData);
+        }
     }
 }
 
@@ -276,7 +324,7 @@ HTTP_HEADERS_RESULT HTTPHeaders_GetHeader(HTTP_HEADERS_HANDLE handle, size_t ind
             }
             else
             {
-                *destination = (char*)malloc(strlen(keys[index]) + COLON_AND_SPACE_LENGTH + strlen(values[index]) + 1);
+                *destination = (char*)gballoc_malloc_for_caller(strlen(keys[index]) + COLON_AND_SPACE_LENGTH + strlen(values[index]) + 1);
                 if (*destination == NULL)
                 {
                     /*Codes_SRS_HTTP_HEADERS_99_034:[ The function shall return HTTP_HEADERS_ERROR when an internal error occurs]*/
@@ -328,9 +376,157 @@ HTTP_HEADERS_HANDLE HTTPHeaders_Clone(HTTP_HEADERS_HANDLE handle)
             }
             else
             {
-                /*all is fine*/
+                /*a clone is always on the heap, even when the source lives in an arena*/
+                result->arena = NULL;
+            }
+        }
+    }
+    return result;
+}
+
+/*the wire form of a header is name + ": " + value + "\r\n"*/
+static size_t getWireSize(const char*const* keys, const char*const* values, size_t headerCount)
+{
+    size_t wireSize = 0;
+    size_t i;
+    for (i = 0; i < headerCount; i++)
+    {
+        wireSize += strlen(keys[i]) + COLON_AND_SPACE_LENGTH + strlen(values[i]) + CR_LF_LENGTH;
+    }
+    return wireSize;
+}
+
+static void writeWire(char* wire, const char*const* keys, const char*const* values, size_t headerCount)
+{
+    size_t i;
+    for (i = 0; i < headerCount; i++)
+    {
+        size_t nameLength = strlen(keys[i]);
+        size_t valueLength = strlen(values[i]);
+        (void)memcpy(wire, keys[i], nameLength);
+        wire += nameLength;
+        (void)memcpy(wire, COLON_AND_SPACE, COLON_AND_SPACE_LENGTH);
+        wire += COLON_AND_SPACE_LENGTH;
+        (void)memcpy(wire, values[i], valueLength);
+        wire += valueLength;
+        (void)memcpy(wire, CR_LF, CR_LF_LENGTH);
+        wire += CR_LF_LENGTH;
+    }
+}
+
+HTTP_HEADERS_RESULT HTTPHeaders_Serialize(HTTP_HEADERS_HANDLE handle, BUFFER_HANDLE destination)
+{
+    HTTP_HEADERS_RESULT result;
+
+    if (
+        (handle == NULL) ||
+        (destination == NULL)
+        )
+    {
+        result = HTTP_HEADERS_INVALID_ARG;
+        LogError("invalid arg (NULL), result= %s\r\n", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+    }
+    else
+    {
+        HTTP_HEADERS_HANDLE_DATA* handleData = (HTTP_HEADERS_HANDLE_DATA*)handle;
+        const char*const* keys;
+        const char*const* values;
+        size_t headerCount;
+        if (Map_GetInternals(handleData->headers, &keys, &values, &headerCount) != MAP_OK)
+        {
+            result = HTTP_HEADERS_ERROR;
+            LogError("Map_GetInternals failed, result= %s\r\n", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+        }
+        else
+        {
+            /*the whole wire form is measured first so that destination grows only once*/
+            size_t wireSize = getWireSize(keys, values, headerCount);
+            if (wireSize == 0)
+            {
+                result = HTTP_HEADERS_OK;
+            }
+            else
+            {
+                size_t oldSize = BUFFER_length(destination);
+                if (BUFFER_enlarge(destination, wireSize) != 0)
+                {
+                    result = HTTP_HEADERS_ALLOC_FAILED;
+                    LogError("unable to BUFFER_enlarge, result= %s\r\n", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+                }
+                else
+                {
+                    writeWire((char*)BUFFER_u_char(destination) + oldSize, keys, values, headerCount);
+                    result = HTTP_HEADERS_OK;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+HTTP_HEADERS_RESULT HTTPHeaders_SerializeToChain(HTTP_HEADERS_HANDLE handle, BUFFER_CHAIN_HANDLE destination)
+{
+    HTTP_HEADERS_RESULT result;
+
+    if (
+        (handle == NULL) ||
+        (destination == NULL)
+        )
+    {
+        result = HTTP_HEADERS_INVALID_ARG;
+        LogError("invalid arg (NULL), result= %s\r\n", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+    }
+    else
+    {
+        HTTP_HEADERS_HANDLE_DATA* handleData = (HTTP_HEADERS_HANDLE_DATA*)handle;
+        const char*const* keys;
+        const char*const* values;
+        size_t headerCount;
+        if (Map_GetInternals(handleData->headers, &keys, &values, &headerCount) != MAP_OK)
+        {
+            result = HTTP_HEADERS_ERROR;
+            LogError("Map_GetInternals failed, result= %s\r\n", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+        }
+        else
+        {
+            size_t wireSize = getWireSize(keys, values, headerCount);
+            if (wireSize == 0)
+            {
+                result = HTTP_HEADERS_OK;
+            }
+            else
+            {
+                /*a segment owns its bytes, so the headers are written once into a single segment of the exact size*/
+                BUFFER_HANDLE segment = BUFFER_new();
+                if (segment == NULL)
+                {
+                    result = HTTP_HEADERS_ALLOC_FAILED;
+                    LogError("unable to BUFFER_new, result= %s\r\n", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+                }
+                else if (BUFFER_enlarge(segment, wireSize) != 0)
+                {
+                    BUFFER_delete(segment);
+                    result = HTTP_HEADERS_ALLOC_FAILED;
+                    LogError("unable to BUFFER_enlarge, result= %s\r\n", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+                }
+                else
+                {
+                    writeWire((char*)BUFFER_u_char(segment), keys, values, headerCount);
+                    if (BUFFER_CHAIN_append(destination, segment) != 0)
+                    {
+                        BUFFER_delete(segment);
+                        result = HTTP_HEADERS_ALLOC_FAILED;
+                        LogError("unable to BUFFER_CHAIN_append, result= %s\r\n", ENUM_TO_STRING(HTTP_HEADERS_RESULT, result));
+                    }
+                    else
+                    {
+                        result = HTTP_HEADERS_OK;
+                    }
+                }
             }
         }
     }
+
     return result;
 }
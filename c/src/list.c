@@ -9,17 +9,30 @@
 #include "gballoc.h"
 #include "list.h"
 
-typedef struct LIST_ITEM_INSTANCE_TAG
-{
-    const void* item;
-    void* next;
-} LIST_ITEM_INSTANCE;
-
 typedef struct LIST_INSTANCE_TAG
 {
     LIST_ITEM_INSTANCE* head;
+    /* the last node, so that adding to the tail does not walk the list */
+    LIST_ITEM_INSTANCE* tail;
 } LIST_INSTANCE;
 
+static void list_append(LIST_INSTANCE* list_instance, LIST_ITEM_INSTANCE* node, const void* item)
+{
+    node->next = NULL;
+    node->item = item;
+
+    if (list_instance->head == NULL)
+    {
+        list_instance->head = node;
+    }
+    else
+    {
+        list_instance->tail->next = node;
+    }
+
+    list_instance->tail = node;
+}
+
 LIST_HANDLE list_create(void)
 {
     LIST_INSTANCE* result;
@@ -30,6 +43,7 @@ LIST_HANDLE list_create(void)
     {
         /* Codes_SRS_LIST_01_002: [If any error occurs during the list creation, list_create shall return NULL.] */
         result->head = NULL;
+        result->tail = NULL;
     }
 
     return result;
@@ -46,7 +60,10 @@ void list_destroy(LIST_HANDLE list)
         {
             LIST_ITEM_INSTANCE* current_item = list_instance->head;
             list_instance->head = current_item->next;
-            free(current_item);
+            if (!current_item->is_embedded)
+            {
+                free(current_item);
+            }
         }
 
         /* Codes_SRS_LIST_01_003: [list_destroy shall free all resources associated with the list identified by the handle argument.] */
@@ -77,24 +94,30 @@ LIST_ITEM_HANDLE list_add(LIST_HANDLE list, const void* item)
         else
         {
             /* Codes_SRS_LIST_01_005: [list_add shall add one item to the tail of the list and on success it shall return a handle to the added item.] */
-            result->next = NULL;
-            result->item = item;
+            result->is_embedded = false;
+            list_append(list_instance, result, item);
+        }
+    }
 
-            if (list_instance->head == NULL)
-            {
-                list_instance->head = result;
-            }
-            else
-            {
-                LIST_ITEM_INSTANCE* current = list_instance->head;
-                while (current->next != NULL)
-                {
-                    current = current->next;
-                }
+    return result;
+}
 
-                current->next = result;
-            }
-        }
+LIST_ITEM_HANDLE list_add_node(LIST_HANDLE list, LIST_ITEM_INSTANCE* node, const void* item)
+{
+    LIST_ITEM_INSTANCE* result;
+
+    if ((list == NULL) ||
+        (node == NULL) ||
+        (item == NULL))
+    {
+        result = NULL;
+    }
+    else
+    {
+        /* the node is owned by the caller, the list links it but never frees it */
+        node->is_embedded = true;
+        list_append((LIST_INSTANCE*)list, node, item);
+        result = node;
     }
 
     return result;
@@ -129,11 +152,20 @@ int list_remove(LIST_HANDLE list, LIST_ITEM_HANDLE item)
                     list_instance->head = current_item->next;
                 }
 
-                free(current_item);
+                if (list_instance->tail == current_item)
+                {
+                    list_instance->tail = previous_item;
+                }
+
+                if (!current_item->is_embedded)
+                {
+                    free(current_item);
+                }
 
                 break;
             }
 
+			previous_item = current_item;
 			current_item = current_item->next;
         }
 
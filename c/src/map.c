@@ -7,21 +7,264 @@
 #endif
 #include "gballoc.h"
 
+#include <stdint.h>
 #include "map.h"
+#include "string_intern.h"
+#include "refcount.h"
 #include "iot_logging.h"
 
 DEFINE_ENUM_STRINGS(MAP_RESULT, MAP_RESULT_VALUES);
 
+/*the first growth of the keys and values arrays makes room for this many pairs, every later growth doubles them*/
+#define MAP_INITIAL_CAPACITY 4
+/*maps with up to this many keys are scanned, they do not have an index*/
+#define MAP_INDEX_THRESHOLD 8
+/*only ASCII letters are folded, which is what case-insensitive protocol tokens (such as HTTP header names) need*/
+#define MAP_FOLD_CASE(c) ((((c) >= 'A') && ((c) <= 'Z')) ? (char)((c) - 'A' + 'a') : (c))
+
 typedef struct MAP_HANDLE_DATA_TAG
 {
+    /*the keys and values, in insertion order. There is room for capacity pairs*/
     char** keys;
     char** values;
     size_t count;
+    size_t capacity;
+    /*open addressing (linear probing) over the keys. A slot holds the position of a key + 1, 0 marks an empty slot.
+    The index is kept at most half full. It is NULL while the map is small enough to be scanned or if building it failed*/
+    size_t* index;
+    size_t indexSize;
     MAP_FILTER_CALLBACK mapFilterCallback;
+    /*NULL unless the map was created in an arena*/
+    ARENA_HANDLE arena;
+    /*NULL unless the pairs are shared with clones or snapshots, see MAP_STORAGE*/
+    struct MAP_STORAGE_TAG* storage;
+    /*set for snapshots, which refuse to be modified*/
+    bool readOnly;
+    /*set by Map_IgnoreKeyCase*/
+    bool ignoreKeyCase;
 }MAP_HANDLE_DATA;
 
+/*the pairs of a map that has been cloned are owned by a ref counted storage that the map and all its clones point to.
+Nobody modifies them while they are shared, whichever map is modified first gets its own copy of the pairs*/
+typedef struct MAP_STORAGE_TAG
+{
+    char** keys;
+    char** values;
+    size_t count;
+    size_t capacity;
+    size_t* index;
+    size_t indexSize;
+}MAP_STORAGE;
+
+DEFINE_REFCOUNT_TYPE(MAP_STORAGE);
+
 #define LOG_MAP_ERROR LogError("result = %s\r\n", ENUM_TO_STRING(MAP_RESULT, result));
 
+/*the storage of a map created in an arena comes from the arena and is only released with it*/
+static void* Map_Realloc(MAP_HANDLE_DATA* handleData, void* ptr, size_t oldSize, size_t size)
+{
+    return (handleData->arena == NULL) ? realloc(ptr, size) : ARENA_realloc(handleData->arena, ptr, oldSize, size);
+}
+
+static void Map_Free(MAP_HANDLE_DATA* handleData, void* ptr)
+{
+    if (handleData->arena == NULL)
+    {
+        free(ptr);
+    }
+}
+
+static int Map_Strcpy(MAP_HANDLE_DATA* handleData, char** destination, const char* source)
+{
+    int result;
+    if (handleData->arena == NULL)
+    {
+        result = mallocAndStrcpy_s(destination, source);
+    }
+    else
+    {
+        size_t length = strlen(source) + 1;
+        if ((*destination = (char*)ARENA_malloc(handleData->arena, length)) == NULL)
+        {
+            result = __LINE__;
+        }
+        else
+        {
+            memcpy(*destination, source, length);
+            result = 0;
+        }
+    }
+    return result;
+}
+
+/*the keys of a heap map are interned, so maps holding the same keys share their storage*/
+static int Map_KeyCopy(MAP_HANDLE_DATA* handleData, char** destination, const char* source)
+{
+    int result;
+    if (handleData->arena != NULL)
+    {
+        result = Map_Strcpy(handleData, destination, source);
+    }
+    else if ((*destination = (char*)STRING_INTERN_acquire(source)) == NULL)
+    {
+        result = __LINE__;
+    }
+    else
+    {
+        result = 0;
+    }
+    return result;
+}
+
+static void Map_KeyFree(MAP_HANDLE_DATA* handleData, char* key)
+{
+    if (handleData->arena == NULL)
+    {
+        STRING_INTERN_release(key);
+    }
+}
+
+/*FNV-1a, over the folded chars when the keys are case-insensitive*/
+static size_t Map_Hash(MAP_HANDLE_DATA* handleData, const char* key)
+{
+    uint32_t hash = 2166136261u;
+    if (handleData->ignoreKeyCase)
+    {
+        while (*key != '\0')
+        {
+            hash = (hash ^ (unsigned char)MAP_FOLD_CASE(*key)) * 16777619u;
+            key++;
+        }
+    }
+    else
+    {
+        while (*key != '\0')
+        {
+            hash = (hash ^ (unsigned char)*key) * 16777619u;
+            key++;
+        }
+    }
+    return (size_t)hash;
+}
+
+static bool Map_KeysAreEqual(MAP_HANDLE_DATA* handleData, const char* key1, const char* key2)
+{
+    bool result;
+    if (key1 == key2)
+    {
+        /*an interned key passed back to the map is found without comparing the chars*/
+        result = true;
+    }
+    else if (handleData->ignoreKeyCase)
+    {
+        while ((*key1 != '\0') && (MAP_FOLD_CASE(*key1) == MAP_FOLD_CASE(*key2)))
+        {
+            key1++;
+            key2++;
+        }
+        result = (MAP_FOLD_CASE(*key1) == MAP_FOLD_CASE(*key2));
+    }
+    else
+    {
+        result = (strcmp(key1, key2) == 0);
+    }
+    return result;
+}
+
+static void Map_IndexInsert(MAP_HANDLE_DATA* handleData, size_t position)
+{
+    size_t slot = Map_Hash(handleData, handleData->keys[position]) & (handleData->indexSize - 1);
+    while (handleData->index[slot] != 0)
+    {
+        slot = (slot + 1) & (handleData->indexSize - 1);
+    }
+    handleData->index[slot] = position + 1;
+}
+
+/*(re)builds the index from the keys. Without an index the lookups are linear, which is what a failure here degrades to*/
+static void Map_BuildIndex(MAP_HANDLE_DATA* handleData)
+{
+    size_t newIndexSize = 2 * MAP_INDEX_THRESHOLD;
+    while ((newIndexSize < 2 * handleData->count) && (newIndexSize <= SIZE_MAX / (2 * sizeof(size_t))))
+    {
+        newIndexSize *= 2;
+    }
+
+    if ((handleData->index != NULL) &&
+        ((handleData->count <= MAP_INDEX_THRESHOLD) || (newIndexSize != handleData->indexSize)))
+    {
+        Map_Free(handleData, handleData->index);
+        handleData->index = NULL;
+        handleData->indexSize = 0;
+    }
+
+    if (handleData->count <= MAP_INDEX_THRESHOLD)
+    {
+        /*scanning is good enough*/
+    }
+    else if ((handleData->index == NULL) &&
+        ((handleData->index = (size_t*)Map_Realloc(handleData, NULL, 0, newIndexSize * sizeof(size_t))) == NULL))
+    {
+        LogError("unable to allocate the index of the map, lookups will be linear\r\n");
+    }
+    else
+    {
+        size_t i;
+        handleData->indexSize = newIndexSize;
+        (void)memset(handleData->index, 0, newIndexSize * sizeof(size_t));
+        for (i = 0; i < handleData->count; i++)
+        {
+            Map_IndexInsert(handleData, i);
+        }
+    }
+}
+
+/*releases the pairs of a heap map*/
+static void Map_FreePairs(char** keys, char** values, size_t count, size_t* index)
+{
+    size_t i;
+    for (i = 0; i < count; i++)
+    {
+        STRING_INTERN_release(keys[i]);
+        free(values[i]);
+    }
+    free(keys);
+    free(values);
+    free(index);
+}
+
+static void Map_ReleaseStorage(MAP_STORAGE* storage)
+{
+    if (DEC_REF(MAP_STORAGE, storage) == DEC_RETURN_ZERO)
+    {
+        Map_FreePairs(storage->keys, storage->values, storage->count, storage->index);
+        free(storage);
+    }
+}
+
+/*the pairs of the map move into a storage that the map is the only owner of*/
+static int Map_CreateStorage(MAP_HANDLE_DATA* handleData)
+{
+    int result;
+    handleData->storage = REFCOUNT_TYPE_CREATE(MAP_STORAGE);
+    if (handleData->storage == NULL)
+    {
+        LogError("unable to allocate the shared storage\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        handleData->storage->keys = handleData->keys;
+        handleData->storage->values = handleData->values;
+        handleData->storage->count = handleData->count;
+        handleData->storage->capacity = handleData->capacity;
+        handleData->storage->index = handleData->index;
+        handleData->storage->indexSize = handleData->indexSize;
+        result = 0;
+    }
+    return result;
+}
+
 MAP_HANDLE Map_Create(MAP_FILTER_CALLBACK mapFilterFunc)
 {
     /*Codes_SRS_MAP_02_001: [Map_Create shall create a new, empty map.]*/
@@ -33,7 +276,43 @@ MAP_HANDLE Map_Create(MAP_FILTER_CALLBACK mapFilterFunc)
         result->keys = NULL;
         result->values = NULL;
         result->count = 0;
+        result->capacity = 0;
+        result->index = NULL;
+        result->indexSize = 0;
+        result->mapFilterCallback = mapFilterFunc;
+        result->arena = NULL;
+        result->storage = NULL;
+        result->readOnly = false;
+        result->ignoreKeyCase = false;
+    }
+    return (MAP_HANDLE)result;
+}
+
+MAP_HANDLE Map_CreateInArena(ARENA_HANDLE arena, MAP_FILTER_CALLBACK mapFilterFunc)
+{
+    MAP_HANDLE_DATA* result;
+    if (arena == NULL)
+    {
+        LogError("invalid arg to Map_CreateInArena (NULL)\r\n");
+        result = NULL;
+    }
+    else if ((result = (MAP_HANDLE_DATA*)ARENA_malloc(arena, sizeof(MAP_HANDLE_DATA))) == NULL)
+    {
+        LogError("unable to ARENA_malloc\r\n");
+    }
+    else
+    {
+        result->keys = NULL;
+        result->values = NULL;
+        result->count = 0;
+        result->capacity = 0;
+        result->index = NULL;
+        result->indexSize = 0;
         result->mapFilterCallback = mapFilterFunc;
+        result->arena = arena;
+        result->storage = NULL;
+        result->readOnly = false;
+        result->ignoreKeyCase = false;
     }
     return (MAP_HANDLE)result;
 }
@@ -45,16 +324,19 @@ void Map_Destroy(MAP_HANDLE handle)
     {
         /*Codes_SRS_MAP_02_004: [Map_Destroy shall release all resources associated with the map.] */
         MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
-        size_t i;
-      
-        for (i = 0; i < handleData->count; i++)
+        /*a map created in an arena is released with the arena*/
+        if (handleData->arena == NULL)
         {
-            free(handleData->keys[i]);
-            free(handleData->values[i]);
+            if (handleData->storage != NULL)
+            {
+                Map_ReleaseStorage(handleData->storage);
+            }
+            else
+            {
+                Map_FreePairs(handleData->keys, handleData->values, handleData->count, handleData->index);
+            }
+            free(handleData);
         }
-        free(handleData->keys);
-        free(handleData->values);
-        free(handleData);
     }
 }
 
@@ -97,6 +379,48 @@ static char** Map_CloneVector(const char*const * source, size_t count)
     return result;
 }
 
+/*the clone is a heap map, so it interns its keys. The keys of a heap source are already interned and only get one more reference*/
+/*returns NULL if it fails*/
+static char** Map_CloneKeys(MAP_HANDLE_DATA* handleData)
+{
+    char** result;
+    result = (char**)malloc(handleData->count * sizeof(char*));
+    if (result == NULL)
+    {
+        /*do nothing, just return it (NULL)*/
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < handleData->count; i++)
+        {
+            result[i] = (handleData->arena == NULL) ?
+                (char*)STRING_INTERN_add_ref(handleData->keys[i]) :
+                (char*)STRING_INTERN_acquire(handleData->keys[i]);
+            if (result[i] == NULL)
+            {
+                break;
+            }
+        }
+
+        if (i == handleData->count)
+        {
+            /*it is all good, proceed to return result*/
+        }
+        else
+        {
+            size_t j;
+            for (j = 0; j < i; j++)
+            {
+                STRING_INTERN_release(result[j]);
+            }
+            free(result);
+            result = NULL;
+        }
+    }
+    return result;
+}
+
 /*Codes_SRS_MAP_02_039: [Map_Clone shall make a copy of the map indicated by parameter handle and return a non-NULL handle to it.]*/
 MAP_HANDLE Map_Clone(MAP_HANDLE handle)
 {
@@ -119,18 +443,51 @@ MAP_HANDLE Map_Clone(MAP_HANDLE handle)
         }
         else
         {
+            /*a clone is always on the heap, even when the source lives in an arena*/
+            result->arena = NULL;
+            result->index = NULL;
+            result->indexSize = 0;
+            result->storage = NULL;
+            result->readOnly = false;
+            result->ignoreKeyCase = handleData->ignoreKeyCase;
             if (handleData->count == 0)  
             {
                 result->count = 0;
+                result->capacity = 0;
                 result->keys = NULL;
                 result->values = NULL;
                 result->mapFilterCallback = NULL;
             }
+            else if (handleData->arena == NULL)
+            {
+                /*the pairs of a heap map are not copied, the clone shares them until one of the maps is modified*/
+                if ((handleData->storage == NULL) &&
+                    (Map_CreateStorage(handleData) != 0))
+                {
+                    /*Codes_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
+                    LogError("unable to share the pairs\r\n");
+                    free(result);
+                    result = NULL;
+                }
+                else
+                {
+                    result->mapFilterCallback = handleData->mapFilterCallback;
+                    result->keys = handleData->keys;
+                    result->values = handleData->values;
+                    result->count = handleData->count;
+                    result->capacity = handleData->count;
+                    result->index = handleData->index;
+                    result->indexSize = handleData->indexSize;
+                    result->storage = handleData->storage;
+                    INC_REF(MAP_STORAGE, handleData->storage);
+                }
+            }
             else
             {
                 result->mapFilterCallback = handleData->mapFilterCallback;
                 result->count = handleData->count;
-                if( (result->keys = Map_CloneVector((const char* const*)handleData->keys, handleData->count))==NULL)
+                result->capacity = handleData->count;
+                if( (result->keys = Map_CloneKeys(handleData))==NULL)
                 {
                     /*Codes_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
                     LogError("unable to clone keys\r\n");
@@ -144,7 +501,7 @@ MAP_HANDLE Map_Clone(MAP_HANDLE handle)
                     size_t i;
                     for (i = 0; i < result->count; i++)
                     {
-                        free(result->keys[i]); 
+                        STRING_INTERN_release(result->keys[i]);
                     }
                     free(result->keys);
                     free(result);
@@ -153,6 +510,7 @@ MAP_HANDLE Map_Clone(MAP_HANDLE handle)
                 else
                 {
                     /*all fine, return it*/
+                    Map_BuildIndex(result);
                 }
             }
         }
@@ -160,89 +518,158 @@ MAP_HANDLE Map_Clone(MAP_HANDLE handle)
     return (MAP_HANDLE)result;
 }
 
-static int Map_IncreaseStorageKeysValues(MAP_HANDLE_DATA* handleData)
+MAP_RESULT Map_IgnoreKeyCase(MAP_HANDLE handle)
+{
+    MAP_RESULT result;
+    if (handle == NULL)
+    {
+        result = MAP_INVALIDARG;
+        LOG_MAP_ERROR;
+    }
+    else if ((((MAP_HANDLE_DATA*)handle)->count != 0) ||
+        (((MAP_HANDLE_DATA*)handle)->readOnly))
+    {
+        /*the keys already in the map might be equal once their case is ignored*/
+        result = MAP_ERROR;
+        LogError("only an empty map can start ignoring the case of its keys\r\n");
+    }
+    else
+    {
+        ((MAP_HANDLE_DATA*)handle)->ignoreKeyCase = true;
+        result = MAP_OK;
+    }
+    return result;
+}
+
+MAP_HANDLE Map_Snapshot(MAP_HANDLE handle)
+{
+    MAP_HANDLE_DATA* result = (MAP_HANDLE_DATA*)Map_Clone(handle);
+    if (result != NULL)
+    {
+        result->readOnly = true;
+    }
+    return (MAP_HANDLE)result;
+}
+
+/*copy-on-write: a map that shares its pairs gets its own copy of them before they are modified*/
+static int Map_MakeExclusive(MAP_HANDLE_DATA* handleData)
 {
     int result;
-    char** newKeys = (char**)realloc(handleData->keys, (handleData->count + 1) * sizeof(char*));
-    if (newKeys == NULL)
+    if (handleData->storage == NULL)
     {
-        LogError("realloc error\r\n");
-        result = __LINE__;
+        result = 0;
+    }
+    else if (GET_REF(MAP_STORAGE, handleData->storage) == 1)
+    {
+        /*nobody else looks at the pairs anymore, they can be taken back without a copy*/
+        handleData->capacity = handleData->storage->capacity;
+        free(handleData->storage);
+        handleData->storage = NULL;
+        result = 0;
     }
     else
     {
-        char** newValues;
-        handleData->keys = newKeys;
-        handleData->keys[handleData->count] = NULL;
-        newValues = (char**)realloc(handleData->values, (handleData->count + 1) * sizeof(char*));
-        if (newValues == NULL)
+        char** keys;
+        char** values;
+        if ((keys = Map_CloneKeys(handleData)) == NULL)
         {
-            LogError("realloc error\r\n");
-            if (handleData->count == 0) /*avoiding an implementation defined behavior */
-            {
-                free(handleData->keys);
-                handleData->keys = NULL;
-            }
-            else
+            LogError("unable to copy the shared keys\r\n");
+            result = __LINE__;
+        }
+        else if ((values = Map_CloneVector((const char* const*)handleData->values, handleData->count)) == NULL)
+        {
+            size_t i;
+            for (i = 0; i < handleData->count; i++)
             {
-                char** undoneKeys = (char**)realloc(handleData->keys, (handleData->count) * sizeof(char*));
-                if (undoneKeys == NULL)
-                {
-                    LogError("CATASTROPHIC error, unable to undo through realloc to a smaller size\r\n");
-                }
-                else
-                {
-                    handleData->keys = undoneKeys;
-                }
+                STRING_INTERN_release(keys[i]);
             }
+            free(keys);
+            LogError("unable to copy the shared values\r\n");
             result = __LINE__;
         }
         else
         {
-            handleData->values = newValues;
-            handleData->values[handleData->count] = NULL;
-            handleData->count++;
+            Map_ReleaseStorage(handleData->storage);
+            handleData->storage = NULL;
+            handleData->keys = keys;
+            handleData->values = values;
+            handleData->capacity = handleData->count;
+            handleData->index = NULL;
+            handleData->indexSize = 0;
+            Map_BuildIndex(handleData);
             result = 0;
         }
     }
     return result;
 }
 
-static void Map_DecreaseStorageKeysValues(MAP_HANDLE_DATA* handleData)
+/*makes room for one more pair*/
+static int Map_IncreaseStorageKeysValues(MAP_HANDLE_DATA* handleData)
 {
-    if (handleData->count == 1)
+    int result;
+    if (handleData->count < handleData->capacity)
     {
-        free(handleData->keys);
-        handleData->keys = NULL;
-        free(handleData->values);
-        handleData->values = NULL;
-        handleData->count = 0;
-        handleData->mapFilterCallback = NULL;
+        result = 0;
     }
     else
     {
-        /*certainly > 1...*/
-        char** undoneKeys = (char**)realloc(handleData->keys, sizeof(char*)* (handleData->count - 1)); 
-        if (undoneKeys == NULL)
-        {
-            LogError("CATASTROPHIC error, unable to undo through realloc to a smaller size\r\n");
-        }
-        else
+        size_t newCapacity = (handleData->capacity == 0) ? MAP_INITIAL_CAPACITY : 2 * handleData->capacity;
+        char** newKeys;
+        char** newValues;
+        if (newCapacity > SIZE_MAX / sizeof(char*))
         {
-            handleData->keys = undoneKeys;
+            LogError("too many keys\r\n");
+            result = __LINE__;
         }
-
-        char** undoneValues = (char**)realloc(handleData->values, sizeof(char*)* (handleData->count - 1));
-        if (undoneValues == NULL)
+        else if ((newKeys = (char**)Map_Realloc(handleData, handleData->keys, handleData->capacity * sizeof(char*), newCapacity * sizeof(char*))) == NULL)
         {
-            LogError("CATASTROPHIC error, unable to undo through realloc to a smaller size\r\n");
+            LogError("realloc error\r\n");
+            result = __LINE__;
         }
         else
         {
-            handleData->values = undoneValues;
+            /*keys might now have room for more than capacity pairs, which is harmless*/
+            handleData->keys = newKeys;
+            if ((newValues = (char**)Map_Realloc(handleData, handleData->values, handleData->capacity * sizeof(char*), newCapacity * sizeof(char*))) == NULL)
+            {
+                LogError("realloc error\r\n");
+                result = __LINE__;
+            }
+            else
+            {
+                handleData->values = newValues;
+                handleData->capacity = newCapacity;
+                result = 0;
+            }
         }
+    }
+    return result;
+}
 
+/*called once the pair at position has been removed from the arrays*/
+static void Map_DecreaseStorageKeysValues(MAP_HANDLE_DATA* handleData, size_t position)
+{
+    if (handleData->count == 1)
+    {
+        Map_Free(handleData, handleData->keys);
+        handleData->keys = NULL;
+        Map_Free(handleData, handleData->values);
+        handleData->values = NULL;
+        Map_Free(handleData, handleData->index);
+        handleData->index = NULL;
+        handleData->indexSize = 0;
+        handleData->count = 0;
+        handleData->capacity = 0;
+        handleData->mapFilterCallback = NULL;
+    }
+    else
+    {
+        /*certainly > 1...*/
+        memmove(handleData->keys + position, handleData->keys + position + 1, (handleData->count - position - 1) * sizeof(char*)); /*if order doesn't matter... then this can be optimized*/
+        memmove(handleData->values + position, handleData->values + position + 1, (handleData->count - position - 1) * sizeof(char*));
         handleData->count--;
+        /*the positions after the removed one have moved*/
+        Map_BuildIndex(handleData);
     }
 }
 
@@ -253,13 +680,28 @@ static char** findKey(MAP_HANDLE_DATA* handleData, const char* key)
     {
         result = NULL;
     }
+    else if (handleData->index != NULL)
+    {
+        size_t slot = Map_Hash(handleData, key) & (handleData->indexSize - 1);
+        result = NULL;
+        while (handleData->index[slot] != 0)
+        {
+            char** candidate = handleData->keys + (handleData->index[slot] - 1);
+            if (Map_KeysAreEqual(handleData, *candidate, key))
+            {
+                result = candidate;
+                break;
+            }
+            slot = (slot + 1) & (handleData->indexSize - 1);
+        }
+    }
     else
     {
         size_t i;
         result = NULL;
         for (i = 0; i < handleData->count; i++)
         {
-            if (strcmp(handleData->keys[i], key) == 0)
+            if (Map_KeysAreEqual(handleData, handleData->keys[i], key))
             {
                 result = handleData->keys + i;
                 break;
@@ -295,32 +737,39 @@ static char** findValue(MAP_HANDLE_DATA* handleData, const char* value)
 static int insertNewKeyValue(MAP_HANDLE_DATA* handleData, const char* key, const char* value)
 {
     int result;
-    if (Map_IncreaseStorageKeysValues(handleData) != 0) /*this increases handleData->count*/
+    if ((Map_MakeExclusive(handleData) != 0) ||
+        (Map_IncreaseStorageKeysValues(handleData) != 0))
+    {
+        result = __LINE__;
+    }
+    else if (Map_KeyCopy(handleData, &(handleData->keys[handleData->count]), key) != 0)
     {
+        /*the room made for the pair stays for the next insertion*/
+        LogError("unable to mallocAndStrcpy_s\r\n");
+        result = __LINE__;
+    }
+    else if (Map_Strcpy(handleData, &(handleData->values[handleData->count]), value) != 0)
+    {
+        Map_KeyFree(handleData, handleData->keys[handleData->count]);
+        LogError("unable to mallocAndStrcpy_s\r\n");
         result = __LINE__;
     }
     else
     {
-        if (mallocAndStrcpy_s(&(handleData->keys[handleData->count - 1]), key) != 0)
+        handleData->count++;
+        if (handleData->count <= MAP_INDEX_THRESHOLD)
         {
-            Map_DecreaseStorageKeysValues(handleData);
-            LogError("unable to mallocAndStrcpy_s\r\n");
-            result = __LINE__;
+            /*no index yet*/
+        }
+        else if ((handleData->index == NULL) || (2 * handleData->count > handleData->indexSize))
+        {
+            Map_BuildIndex(handleData);
         }
         else
         {
-            if (mallocAndStrcpy_s(&(handleData->values[handleData->count - 1]), value) != 0)
-            {
-                free(handleData->keys[handleData->count - 1]);
-                Map_DecreaseStorageKeysValues(handleData);
-                LogError("unable to mallocAndStrcpy_s\r\n");
-                result = __LINE__;
-            }
-            else
-            {
-                result = 0;
-            }
+            Map_IndexInsert(handleData, handleData->count - 1);
         }
+        result = 0;
     }
     return result; 
 }
@@ -340,6 +789,11 @@ MAP_RESULT Map_Add(MAP_HANDLE handle, const char* key, const char* value)
         result = MAP_INVALIDARG;
         LOG_MAP_ERROR; 
     }
+    else if (((MAP_HANDLE_DATA*)handle)->readOnly)
+    {
+        result = MAP_ERROR;
+        LogError("a snapshot cannot be modified\r\n");
+    }
     else
     {
         MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
@@ -390,6 +844,11 @@ MAP_RESULT Map_AddOrUpdate(MAP_HANDLE handle, const char* key, const char* value
         result = MAP_INVALIDARG;
         LOG_MAP_ERROR;
     }
+    else if (((MAP_HANDLE_DATA*)handle)->readOnly)
+    {
+        result = MAP_ERROR;
+        LogError("a snapshot cannot be modified\r\n");
+    }
     else
     {
         MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
@@ -420,9 +879,14 @@ MAP_RESULT Map_AddOrUpdate(MAP_HANDLE handle, const char* key, const char* value
                 /*Codes_SRS_MAP_02_016: [If the key already exists, then Map_AddOrUpdate shall overwrite the value of the existing key with parameter value.]*/
                 size_t index = whereIsIt - handleData->keys;
                 size_t valueLength = strlen(value);
+                char* newValue;
+                if (Map_MakeExclusive(handleData) != 0)
+                {
+                    result = MAP_ERROR;
+                    LOG_MAP_ERROR;
+                }
                 /*try to realloc value of this key*/
-                char* newValue = (char*)realloc(handleData->values[index],valueLength  + 1);
-                if (newValue == NULL)
+                else if ((newValue = (char*)Map_Realloc(handleData, handleData->values[index], strlen(handleData->values[index]) + 1, valueLength + 1)) == NULL)
                 {
                     result = MAP_ERROR;
                     LOG_MAP_ERROR;
@@ -453,6 +917,11 @@ MAP_RESULT Map_Delete(MAP_HANDLE handle, const char* key)
         result = MAP_INVALIDARG;
         LOG_MAP_ERROR;
     }
+    else if (((MAP_HANDLE_DATA*)handle)->readOnly)
+    {
+        result = MAP_ERROR;
+        LogError("a snapshot cannot be modified\r\n");
+    }
     else
     {
         MAP_HANDLE_DATA* handleData = (MAP_HANDLE_DATA*)handle;
@@ -464,14 +933,21 @@ MAP_RESULT Map_Delete(MAP_HANDLE handle, const char* key)
         }
         else
         {
-            /*Codes_SRS_MAP_02_023: [Otherwise, Map_Delete shall remove the key and its associated value from the map and return MAP_OK.]*/
+            /*the copy made by Map_MakeExclusive keeps the positions*/
             size_t index = whereIsIt - handleData->keys;
-            free(handleData->keys[index]);
-            free(handleData->values[index]);
-            memmove(handleData->keys + index, handleData->keys + index + 1, (handleData->count - index - 1)*sizeof(char*)); /*if order doesn't matter... then this can be optimized*/
-            memmove(handleData->values + index, handleData->values + index + 1, (handleData->count - index - 1)*sizeof(char*));
-            Map_DecreaseStorageKeysValues(handleData);
-            result = MAP_OK;
+            if (Map_MakeExclusive(handleData) != 0)
+            {
+                result = MAP_ERROR;
+                LOG_MAP_ERROR;
+            }
+            else
+            {
+                /*Codes_SRS_MAP_02_023: [Otherwise, Map_Delete shall remove the key and its associated value from the map and return MAP_OK.]*/
+                Map_KeyFree(handleData, handleData->keys[index]);
+                Map_Free(handleData, handleData->values[index]);
+                Map_DecreaseStorageKeysValues(handleData, index);
+                result = MAP_OK;
+            }
         }
 
     }
@@ -0,0 +1,271 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+#include "gballoc.h"
+
+#include "mpsc_queue.h"
+#include "lock.h"
+#include "condition.h"
+#include "tickcounter.h"
+#include "atomics.h"
+#include "iot_logging.h"
+
+/*the pointers shared between threads are swapped, loaded and stored with sequentially consistent operations, which the
+blocking handshake below relies on*/
+#if defined(ATOMIC_NOT_SUPPORTED) && !defined(REFCOUNT_ATOMIC_DONTCARE)
+#error do not know how to atomically exchange a pointer :(. Platform support needs to be extended to your platform.
+#endif
+#define MPSC_QUEUE_EXCHANGE(location, value) ATOMIC_POINTER_EXCHANGE((location), (value))
+#define MPSC_QUEUE_LOAD(location) ATOMIC_POINTER_LOAD(location)
+#define MPSC_QUEUE_STORE(location, value) (void)ATOMIC_POINTER_EXCHANGE((location), (value))
+
+/*Dmitry Vyukov's intrusive MPSC queue. Producers swap themselves in as the newest node (one atomic exchange) and then
+link the previous newest node to themselves. The consumer walks from the oldest node. The stub node keeps the queue
+from ever being empty, so producers and the consumer never touch the same pointer except through the exchange*/
+typedef struct MPSC_QUEUE_TAG
+{
+    /*newest node, written by producers*/
+    ATOMIC_POINTER head;
+    /*oldest node, consumer only*/
+    MPSC_QUEUE_NODE* tail;
+    MPSC_QUEUE_NODE stub;
+
+    /*the blocking wait. sleeper is the condition while the consumer is (about to be) blocked, NULL otherwise*/
+    LOCK_HANDLE lock;
+    COND_HANDLE condition;
+    ATOMIC_POINTER sleeper;
+    /*measures how much of the timeout of a blocking wait is left*/
+    TICK_COUNTER_HANDLE tickCounter;
+} MPSC_QUEUE;
+
+static void push_node(MPSC_QUEUE* queue, MPSC_QUEUE_NODE* node)
+{
+    MPSC_QUEUE_NODE* previous;
+    MPSC_QUEUE_STORE(&node->next, NULL);
+    previous = (MPSC_QUEUE_NODE*)MPSC_QUEUE_EXCHANGE(&queue->head, node);
+    /*until this store the consumer sees the queue end at previous*/
+    MPSC_QUEUE_STORE(&previous->next, node);
+}
+
+MPSC_QUEUE_HANDLE MPSC_QUEUE_create(void)
+{
+    MPSC_QUEUE* result = (MPSC_QUEUE*)malloc(sizeof(MPSC_QUEUE));
+    if (result == NULL)
+    {
+        LogError("unable to malloc\r\n");
+    }
+    else if ((result->lock = Lock_Init()) == NULL)
+    {
+        LogError("unable to Lock_Init\r\n");
+        free(result);
+        result = NULL;
+    }
+    else if ((result->condition = Condition_Init()) == NULL)
+    {
+        LogError("unable to Condition_Init\r\n");
+        (void)Lock_Deinit(result->lock);
+        free(result);
+        result = NULL;
+    }
+    else if ((result->tickCounter = tickcounter_create()) == NULL)
+    {
+        LogError("unable to tickcounter_create\r\n");
+        Condition_Deinit(result->condition);
+        (void)Lock_Deinit(result->lock);
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        ATOMIC_POINTER_INIT(&result->stub.next, NULL);
+        ATOMIC_POINTER_INIT(&result->head, &result->stub);
+        result->tail = &result->stub;
+        ATOMIC_POINTER_INIT(&result->sleeper, NULL);
+    }
+    return result;
+}
+
+void MPSC_QUEUE_destroy(MPSC_QUEUE_HANDLE handle)
+{
+    if (handle != NULL)
+    {
+        MPSC_QUEUE* queue = (MPSC_QUEUE*)handle;
+        tickcounter_destroy(queue->tickCounter);
+        Condition_Deinit(queue->condition);
+        (void)Lock_Deinit(queue->lock);
+        free(queue);
+    }
+}
+
+int MPSC_QUEUE_push(MPSC_QUEUE_HANDLE handle, MPSC_QUEUE_NODE* node)
+{
+    int result;
+    if ((handle == NULL) ||
+        (node == NULL))
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        MPSC_QUEUE* queue = (MPSC_QUEUE*)handle;
+        push_node(queue, node);
+
+        /*either the consumer sees the node when it checks again after announcing itself, or this sees it asleep. The
+        lock makes sure it really waits on the condition before it is posted*/
+        if (MPSC_QUEUE_LOAD(&queue->sleeper) != NULL)
+        {
+            if (Lock(queue->lock) != LOCK_OK)
+            {
+                LogError("unable to Lock, the consumer wakes up on its timeout\r\n");
+            }
+            else
+            {
+                (void)Condition_Post(queue->condition);
+                (void)Unlock(queue->lock);
+            }
+        }
+        result = 0;
+    }
+    return result;
+}
+
+MPSC_QUEUE_NODE* MPSC_QUEUE_pop(MPSC_QUEUE_HANDLE handle)
+{
+    MPSC_QUEUE_NODE* result;
+    if (handle == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else
+    {
+        MPSC_QUEUE* queue = (MPSC_QUEUE*)handle;
+        MPSC_QUEUE_NODE* tail = queue->tail;
+        MPSC_QUEUE_NODE* next = (MPSC_QUEUE_NODE*)MPSC_QUEUE_LOAD(&tail->next);
+
+        /*the stub is never handed out, skip it*/
+        if (tail == &queue->stub)
+        {
+            if (next != NULL)
+            {
+                queue->tail = next;
+                tail = next;
+                next = (MPSC_QUEUE_NODE*)MPSC_QUEUE_LOAD(&tail->next);
+            }
+        }
+
+        if (tail == &queue->stub)
+        {
+            /*empty*/
+            result = NULL;
+        }
+        else if (next != NULL)
+        {
+            queue->tail = next;
+            result = tail;
+        }
+        else if (tail != (MPSC_QUEUE_NODE*)MPSC_QUEUE_LOAD(&queue->head))
+        {
+            /*a producer has swapped itself in after tail but has not linked it yet*/
+            result = NULL;
+        }
+        else
+        {
+            /*tail is the last node, the stub goes behind it so that tail can be handed out*/
+            push_node(queue, &queue->stub);
+            next = (MPSC_QUEUE_NODE*)MPSC_QUEUE_LOAD(&tail->next);
+            if (next != NULL)
+            {
+                queue->tail = next;
+                result = tail;
+            }
+            else
+            {
+                result = NULL;
+            }
+        }
+    }
+    return result;
+}
+
+/*the milliseconds left until deadline, 0 once it has passed*/
+static int getRemainingMilliseconds(MPSC_QUEUE* queue, uint64_t deadline)
+{
+    int result;
+    uint64_t now;
+    if (tickcounter_get_current_ms(queue->tickCounter, &now) != 0)
+    {
+        LogError("unable to tickcounter_get_current_ms, the wait ends early\r\n");
+        result = 0;
+    }
+    else
+    {
+        result = (now >= deadline) ? 0 : (int)(deadline - now);
+    }
+    return result;
+}
+
+MPSC_QUEUE_NODE* MPSC_QUEUE_wait_pop(MPSC_QUEUE_HANDLE handle, int timeout_milliseconds)
+{
+    MPSC_QUEUE_NODE* result;
+    uint64_t deadline = 0;
+    if (handle == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else if ((result = MPSC_QUEUE_pop(handle)) != NULL)
+    {
+        /*nothing to wait for*/
+    }
+    else if ((timeout_milliseconds != 0) &&
+        (tickcounter_get_current_ms(((MPSC_QUEUE*)handle)->tickCounter, &deadline) != 0))
+    {
+        LogError("unable to tickcounter_get_current_ms\r\n");
+    }
+    else
+    {
+        MPSC_QUEUE* queue = (MPSC_QUEUE*)handle;
+        /*the deadline is computed once, a wake up that finds the queue empty only waits for what is left of the timeout*/
+        int remaining = timeout_milliseconds;
+        deadline += (uint64_t)timeout_milliseconds;
+
+        if (Lock(queue->lock) != LOCK_OK)
+        {
+            LogError("unable to Lock\r\n");
+        }
+        else
+        {
+            MPSC_QUEUE_STORE(&queue->sleeper, queue->condition);
+            while ((result = MPSC_QUEUE_pop(handle)) == NULL)
+            {
+                COND_RESULT waitResult = Condition_Wait(queue->condition, queue->lock, remaining);
+                if (waitResult != COND_OK)
+                {
+                    /*a node pushed right before the timeout is still taken*/
+                    result = MPSC_QUEUE_pop(handle);
+                    if (waitResult != COND_TIMEOUT)
+                    {
+                        LogError("unable to Condition_Wait\r\n");
+                    }
+                    break;
+                }
+                else if ((timeout_milliseconds != 0) &&
+                    ((remaining = getRemainingMilliseconds(queue, deadline)) == 0))
+                {
+                    /*woken up right at the deadline*/
+                    result = MPSC_QUEUE_pop(handle);
+                    break;
+                }
+            }
+            MPSC_QUEUE_STORE(&queue->sleeper, NULL);
+            (void)Unlock(queue->lock);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+#include "gballoc.h"
+
+#include <stdint.h>
+#include <string.h>
+#include "ring_buffer.h"
+#include "atomics.h"
+#include "iot_logging.h"
+
+/*the producer publishes bytes by storing head after writing them (release) and the consumer frees bytes by storing
+tail after reading them. Each side loads the other's index with acquire semantics*/
+#if defined(ATOMIC_NOT_SUPPORTED) && !defined(REFCOUNT_ATOMIC_DONTCARE)
+#error do not know how to publish an index between threads :(. Platform support needs to be extended to your platform.
+#endif
+
+/*the fields both sides read, head and tail each have a cache line of their own, so that a commit of one side does not
+invalidate the lines the other side reads. The structure is allocated aligned to a cache line for its lines to be the
+cache's lines*/
+#define RING_BUFFER_CACHE_LINE_SIZE 64
+
+/*head and tail run freely, they are masked only to address the storage. Their difference is the readable size, also
+after they wrap around SIZE_MAX, because the capacity divides SIZE_MAX + 1*/
+typedef struct RING_BUFFER_TAG
+{
+    /*read-only after create*/
+    size_t mask;
+    unsigned char* bytes;
+    void* allocation;
+    unsigned char sharedPadding[RING_BUFFER_CACHE_LINE_SIZE - sizeof(size_t) - 2 * sizeof(void*)];
+    /*written by the producer*/
+    ATOMIC_SIZE head;
+    unsigned char headPadding[RING_BUFFER_CACHE_LINE_SIZE - sizeof(ATOMIC_SIZE)];
+    /*written by the consumer*/
+    ATOMIC_SIZE tail;
+    unsigned char tailPadding[RING_BUFFER_CACHE_LINE_SIZE - sizeof(ATOMIC_SIZE)];
+} RING_BUFFER;
+
+RING_BUFFER_HANDLE RING_BUFFER_create(size_t capacity)
+{
+    RING_BUFFER* result;
+    void* allocation;
+    if ((capacity == 0) ||
+        (capacity > (SIZE_MAX / 2) + 1))
+    {
+        LogError("invalid arg (capacity=%lu)\r\n", (unsigned long)capacity);
+        result = NULL;
+    }
+    else if ((allocation = malloc(sizeof(RING_BUFFER) + RING_BUFFER_CACHE_LINE_SIZE - 1)) == NULL)
+    {
+        LogError("unable to malloc\r\n");
+        result = NULL;
+    }
+    else
+    {
+        size_t roundedCapacity = 1;
+        while (roundedCapacity < capacity)
+        {
+            roundedCapacity *= 2;
+        }
+
+        result = (RING_BUFFER*)(((uintptr_t)allocation + RING_BUFFER_CACHE_LINE_SIZE - 1) & ~(uintptr_t)(RING_BUFFER_CACHE_LINE_SIZE - 1));
+        if ((result->bytes = (unsigned char*)malloc(roundedCapacity)) == NULL)
+        {
+            LogError("unable to malloc\r\n");
+            free(allocation);
+            result = NULL;
+        }
+        else
+        {
+            result->allocation = allocation;
+            ATOMIC_SIZE_INIT(&result->head, 0);
+            ATOMIC_SIZE_INIT(&result->tail, 0);
+            result->mask = roundedCapacity - 1;
+        }
+    }
+    return result;
+}
+
+void RING_BUFFER_destroy(RING_BUFFER_HANDLE handle)
+{
+    if (handle != NULL)
+    {
+        RING_BUFFER* ringBuffer = (RING_BUFFER*)handle;
+        free(ringBuffer->bytes);
+        free(ringBuffer->allocation);
+    }
+}
+
+/*the free bytes from head up to the end of the storage*/
+static size_t getWriteRegionSize(RING_BUFFER* ringBuffer, size_t* head)
+{
+    /*only the producer stores head, it reads its own index back*/
+    size_t freeSize;
+    size_t untilEnd;
+    *head = ATOMIC_SIZE_LOAD_ACQUIRE(&ringBuffer->head);
+    freeSize = ringBuffer->mask + 1 - (*head - ATOMIC_SIZE_LOAD_ACQUIRE(&ringBuffer->tail));
+    untilEnd = ringBuffer->mask + 1 - (*head & ringBuffer->mask);
+    return (freeSize < untilEnd) ? freeSize : untilEnd;
+}
+
+/*the readable bytes from tail up to the end of the storage*/
+static size_t getReadRegionSize(RING_BUFFER* ringBuffer, size_t* tail)
+{
+    /*only the consumer stores tail, it reads its own index back*/
+    size_t readableSize;
+    size_t untilEnd;
+    *tail = ATOMIC_SIZE_LOAD_ACQUIRE(&ringBuffer->tail);
+    readableSize = ATOMIC_SIZE_LOAD_ACQUIRE(&ringBuffer->head) - *tail;
+    untilEnd = ringBuffer->mask + 1 - (*tail & ringBuffer->mask);
+    return (readableSize < untilEnd) ? readableSize : untilEnd;
+}
+
+unsigned char* RING_BUFFER_write_region(RING_BUFFER_HANDLE handle, size_t* size)
+{
+    unsigned char* result;
+    if ((handle == NULL) ||
+        (size == NULL))
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else
+    {
+        RING_BUFFER* ringBuffer = (RING_BUFFER*)handle;
+        size_t head;
+        *size = getWriteRegionSize(ringBuffer, &head);
+        result = (*size == 0) ? NULL : ringBuffer->bytes + (head & ringBuffer->mask);
+    }
+    return result;
+}
+
+int RING_BUFFER_commit_write(RING_BUFFER_HANDLE handle, size_t size)
+{
+    int result;
+    size_t head;
+    if (handle == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = __LINE__;
+    }
+    else if (size > getWriteRegionSize((RING_BUFFER*)handle, &head))
+    {
+        LogError("invalid arg (size=%lu is more than the write region)\r\n", (unsigned long)size);
+        result = __LINE__;
+    }
+    else
+    {
+        ATOMIC_SIZE_STORE_RELEASE(&((RING_BUFFER*)handle)->head, head + size);
+        result = 0;
+    }
+    return result;
+}
+
+size_t RING_BUFFER_write(RING_BUFFER_HANDLE handle, const unsigned char* source, size_t size)
+{
+    size_t result = 0;
+    if ((handle == NULL) ||
+        (source == NULL))
+    {
+        LogError("invalid arg (NULL)\r\n");
+    }
+    else
+    {
+        /*at most two regions: up to the end of the storage, then from its start*/
+        RING_BUFFER* ringBuffer = (RING_BUFFER*)handle;
+        size_t head;
+        size_t regionSize;
+        while ((result < size) &&
+            ((regionSize = getWriteRegionSize(ringBuffer, &head)) > 0))
+        {
+            size_t chunk = (size - result < regionSize) ? size - result : regionSize;
+            (void)memcpy(ringBuffer->bytes + (head & ringBuffer->mask), source + result, chunk);
+            ATOMIC_SIZE_STORE_RELEASE(&ringBuffer->head, head + chunk);
+            result += chunk;
+        }
+    }
+    return result;
+}
+
+const unsigned char* RING_BUFFER_read_region(RING_BUFFER_HANDLE handle, size_t* size)
+{
+    const unsigned char* result;
+    if ((handle == NULL) ||
+        (size == NULL))
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else
+    {
+        RING_BUFFER* ringBuffer = (RING_BUFFER*)handle;
+        size_t tail;
+        *size = getReadRegionSize(ringBuffer, &tail);
+        result = (*size == 0) ? NULL : ringBuffer->bytes + (tail & ringBuffer->mask);
+    }
+    return result;
+}
+
+int RING_BUFFER_commit_read(RING_BUFFER_HANDLE handle, size_t size)
+{
+    int result;
+    size_t tail;
+    if (handle == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = __LINE__;
+    }
+    else if (size > getReadRegionSize((RING_BUFFER*)handle, &tail))
+    {
+        LogError("invalid arg (size=%lu is more than the read region)\r\n", (unsigned long)size);
+        result = __LINE__;
+    }
+    else
+    {
+        ATOMIC_SIZE_STORE_RELEASE(&((RING_BUFFER*)handle)->tail, tail + size);
+        result = 0;
+    }
+    return result;
+}
+
+size_t RING_BUFFER_read(RING_BUFFER_HANDLE handle, unsigned char* destination, size_t size)
+{
+    size_t result = 0;
+    if ((handle == NULL) ||
+        (destination == NULL))
+    {
+        LogError("invalid arg (NULL)\r\n");
+    }
+    else
+    {
+        RING_BUFFER* ringBuffer = (RING_BUFFER*)handle;
+        size_t tail;
+        size_t regionSize;
+        while ((result < size) &&
+            ((regionSize = getReadRegionSize(ringBuffer, &tail)) > 0))
+        {
+            size_t chunk = (size - result < regionSize) ? size - result : regionSize;
+            (void)memcpy(destination + result, ringBuffer->bytes + (tail & ringBuffer->mask), chunk);
+            ATOMIC_SIZE_STORE_RELEASE(&ringBuffer->tail, tail + chunk);
+            result += chunk;
+        }
+    }
+    return result;
+}
+
+size_t RING_BUFFER_size(RING_BUFFER_HANDLE handle)
+{
+    size_t result = 0;
+    if (handle != NULL)
+    {
+        RING_BUFFER* ringBuffer = (RING_BUFFER*)handle;
+        size_t tail = ATOMIC_SIZE_LOAD_ACQUIRE(&ringBuffer->tail);
+        result = ATOMIC_SIZE_LOAD_ACQUIRE(&ringBuffer->head) - tail;
+    }
+    return result;
+}
+
+size_t RING_BUFFER_capacity(RING_BUFFER_HANDLE handle)
+{
+    size_t result = 0;
+    if (handle != NULL)
+    {
+        result = ((RING_BUFFER*)handle)->mask + 1;
+    }
+    return result;
+}
@@ -0,0 +1,337 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+#include "gballoc.h"
+
+#include <stdint.h>
+#include <string.h>
+#include "string_intern.h"
+#include "lock.h"
+#include "atomics.h"
+#include "iot_logging.h"
+
+/*the table starts with static buckets and only allocates when it outgrows them*/
+#define STRING_INTERN_INITIAL_BUCKET_COUNT 64
+
+typedef struct INTERNED_STRING_TAG
+{
+    struct INTERNED_STRING_TAG* next;
+    size_t hash;
+    size_t length;
+    /*guarded by the lock, like the rest of the table*/
+    size_t count;
+    /*the chars follow*/
+} INTERNED_STRING;
+
+#define INTERNED_CHARS(entry) ((char*)((entry) + 1))
+#define INTERNED_ENTRY(chars) (((INTERNED_STRING*)(chars)) - 1)
+
+/*the lock is made by the first call that needs it and lives as long as the process. Everything below is guarded by it*/
+static ATOMIC_POINTER tableLock;
+static INTERNED_STRING* initialBuckets[STRING_INTERN_INITIAL_BUCKET_COUNT];
+static INTERNED_STRING** buckets = initialBuckets;
+static size_t bucketCount = STRING_INTERN_INITIAL_BUCKET_COUNT;
+static size_t internedCount = 0;
+
+/*returns NULL when the table cannot be locked*/
+static LOCK_HANDLE lockTable(void)
+{
+    LOCK_HANDLE result = (LOCK_HANDLE)ATOMIC_POINTER_LOAD_ACQUIRE(&tableLock);
+    if (result == NULL)
+    {
+        LOCK_HANDLE newLock = Lock_Init();
+        void* expected = NULL;
+        if (newLock == NULL)
+        {
+            LogError("unable to Lock_Init\r\n");
+        }
+        else if (ATOMIC_POINTER_COMPARE_EXCHANGE(&tableLock, expected, newLock))
+        {
+            result = newLock;
+        }
+        else
+        {
+            /*another thread made it first*/
+            (void)Lock_Deinit(newLock);
+            result = (LOCK_HANDLE)ATOMIC_POINTER_LOAD_ACQUIRE(&tableLock);
+        }
+    }
+
+    if ((result != NULL) &&
+        (Lock(result) != LOCK_OK))
+    {
+        LogError("unable to Lock\r\n");
+        result = NULL;
+    }
+    return result;
+}
+
+/*FNV-1a, it also measures the string*/
+static size_t getHash(const char* value, size_t* length)
+{
+    uint32_t hash = 2166136261u;
+    const char* pos = value;
+    while (*pos != '\0')
+    {
+        hash = (hash ^ (unsigned char)*pos) * 16777619u;
+        pos++;
+    }
+    *length = (size_t)(pos - value);
+    return (size_t)hash;
+}
+
+static INTERNED_STRING* findEntry(size_t hash, const char* value, size_t length)
+{
+    INTERNED_STRING* result = buckets[hash & (bucketCount - 1)];
+    while ((result != NULL) &&
+        ((result->hash != hash) || (result->length != length) || (memcmp(INTERNED_CHARS(result), value, length) != 0)))
+    {
+        result = result->next;
+    }
+    return result;
+}
+
+/*doubles the buckets once there are more strings than buckets. The new buckets are allocated and the old ones freed
+outside the lock, so another thread may have resized the table meanwhile, then there is nothing left to do.
+Failing to grow only makes the chains longer*/
+static void growTable(size_t fromBucketCount)
+{
+    size_t newBucketCount = 2 * fromBucketCount;
+    INTERNED_STRING** newBuckets;
+    if ((newBucketCount > SIZE_MAX / sizeof(INTERNED_STRING*)) ||
+        ((newBuckets = (INTERNED_STRING**)malloc(newBucketCount * sizeof(INTERNED_STRING*))) == NULL))
+    {
+        LogError("unable to grow the interned strings table\r\n");
+    }
+    else
+    {
+        INTERNED_STRING** unusedBuckets;
+        LOCK_HANDLE lock;
+        (void)memset(newBuckets, 0, newBucketCount * sizeof(INTERNED_STRING*));
+
+        if ((lock = lockTable()) == NULL)
+        {
+            unusedBuckets = newBuckets;
+        }
+        else
+        {
+            if ((bucketCount != fromBucketCount) ||
+                (internedCount <= bucketCount))
+            {
+                unusedBuckets = newBuckets;
+            }
+            else
+            {
+                size_t i;
+                for (i = 0; i < bucketCount; i++)
+                {
+                    while (buckets[i] != NULL)
+                    {
+                        INTERNED_STRING* entry = buckets[i];
+                        buckets[i] = entry->next;
+                        entry->next = newBuckets[entry->hash & (newBucketCount - 1)];
+                        newBuckets[entry->hash & (newBucketCount - 1)] = entry;
+                    }
+                }
+                unusedBuckets = (buckets != initialBuckets) ? buckets : NULL;
+                buckets = newBuckets;
+                bucketCount = newBucketCount;
+            }
+            (void)Unlock(lock);
+        }
+
+        if (unusedBuckets != NULL)
+        {
+            free(unusedBuckets);
+        }
+    }
+}
+
+/*adds newEntry to the table, unless an equal string got in since the caller looked. Returns the interned chars, newEntry
+is then either in the table or to be freed*/
+static const char* addEntry(LOCK_HANDLE lock, INTERNED_STRING** newEntry)
+{
+    const char* result;
+    INTERNED_STRING* entry = findEntry((*newEntry)->hash, INTERNED_CHARS(*newEntry), (*newEntry)->length);
+    size_t growFromBucketCount = 0;
+    if (entry != NULL)
+    {
+        entry->count++;
+        result = INTERNED_CHARS(entry);
+    }
+    else
+    {
+        entry = *newEntry;
+        *newEntry = NULL;
+        entry->next = buckets[entry->hash & (bucketCount - 1)];
+        buckets[entry->hash & (bucketCount - 1)] = entry;
+        internedCount++;
+        if (internedCount > bucketCount)
+        {
+            growFromBucketCount = bucketCount;
+        }
+        result = INTERNED_CHARS(entry);
+    }
+    (void)Unlock(lock);
+
+    if (growFromBucketCount != 0)
+    {
+        growTable(growFromBucketCount);
+    }
+    return result;
+}
+
+const char* STRING_INTERN_acquire(const char* value)
+{
+    const char* result;
+    LOCK_HANDLE lock;
+    if (value == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else if ((lock = lockTable()) == NULL)
+    {
+        result = NULL;
+    }
+    else
+    {
+        size_t length;
+        size_t hash = getHash(value, &length);
+        INTERNED_STRING* entry = findEntry(hash, value, length);
+
+        if (entry != NULL)
+        {
+            entry->count++;
+            result = INTERNED_CHARS(entry);
+            (void)Unlock(lock);
+        }
+        else
+        {
+            /*the copy is made outside the lock*/
+            (void)Unlock(lock);
+            if ((length > SIZE_MAX - sizeof(INTERNED_STRING) - 1) ||
+                ((entry = (INTERNED_STRING*)malloc(sizeof(INTERNED_STRING) + length + 1)) == NULL))
+            {
+                LogError("unable to malloc\r\n");
+                result = NULL;
+            }
+            else
+            {
+                entry->hash = hash;
+                entry->length = length;
+                entry->count = 1;
+                (void)memcpy(INTERNED_CHARS(entry), value, length + 1);
+
+                if ((lock = lockTable()) == NULL)
+                {
+                    result = NULL;
+                }
+                else
+                {
+                    result = addEntry(lock, &entry);
+                }
+                if (entry != NULL)
+                {
+                    /*the table did not take it*/
+                    free(entry);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+const char* STRING_INTERN_add_ref(const char* interned)
+{
+    const char* result;
+    LOCK_HANDLE lock;
+    if (interned == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else if ((lock = lockTable()) == NULL)
+    {
+        result = NULL;
+    }
+    else
+    {
+        INTERNED_ENTRY(interned)->count++;
+        (void)Unlock(lock);
+        result = interned;
+    }
+    return result;
+}
+
+void STRING_INTERN_release(const char* interned)
+{
+    LOCK_HANDLE lock;
+    if (interned == NULL)
+    {
+        /*nothing to do*/
+    }
+    else if ((lock = lockTable()) == NULL)
+    {
+        LogError("the reference is leaked\r\n");
+    }
+    else
+    {
+        INTERNED_STRING* entry = INTERNED_ENTRY(interned);
+        INTERNED_STRING** unusedBuckets = NULL;
+        if (--entry->count != 0)
+        {
+            /*still referenced*/
+            entry = NULL;
+        }
+        else
+        {
+            INTERNED_STRING** link = &buckets[entry->hash & (bucketCount - 1)];
+            while (*link != entry)
+            {
+                link = &(*link)->next;
+            }
+            *link = entry->next;
+
+            internedCount--;
+            if ((internedCount == 0) && (buckets != initialBuckets))
+            {
+                /*an empty table holds no memory*/
+                unusedBuckets = buckets;
+                (void)memset(initialBuckets, 0, sizeof(initialBuckets));
+                buckets = initialBuckets;
+                bucketCount = STRING_INTERN_INITIAL_BUCKET_COUNT;
+            }
+        }
+        (void)Unlock(lock);
+
+        if (entry != NULL)
+        {
+            free(entry);
+        }
+        if (unusedBuckets != NULL)
+        {
+            free(unusedBuckets);
+        }
+    }
+}
+
+size_t STRING_INTERN_count(void)
+{
+    size_t result;
+    LOCK_HANDLE lock = lockTable();
+    if (lock == NULL)
+    {
+        result = 0;
+    }
+    else
+    {
+        result = internedCount;
+        (void)Unlock(lock);
+    }
+    return result;
+}
@@ -11,21 +11,327 @@
 #include "gballoc.h"
 
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+/*STRING_new_JSON looks for the chars to escape 16 (SSE2) or 32 (AVX2) at a time, STRING_NO_SIMD keeps it scalar*/
+#if !defined(STRING_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define STRING_USE_SSE2
+#if defined(__AVX2__)
+#define STRING_USE_AVX2
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
 //
 // PUT NO CLIENT LIBRARY INCLUDES BEFORE HERE
 //
 
 #include "strings.h"
+#include "arena.h"
 #include "iot_logging.h"
 
+/*strings shorter than this are kept inside the handle, which then is their only allocation*/
+#define STRING_SMALL_CAPACITY 24
+
 static const char hexToASCII[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
 
+/*the chars that JSON copies as they are: everything in [0x20...0x7F] but the quote, the backslash and the slash*/
+#define IS_PLAIN_JSON_CHAR(c) (((unsigned char)(c) >= 0x20) && ((unsigned char)(c) < 0x80) && ((c) != '"') && ((c) != '\\') && ((c) != '/'))
+
+#ifdef STRING_USE_SSE2
+#ifdef _MSC_VER
+static unsigned int getFirstSetBit(unsigned int mask)
+{
+    unsigned long index;
+    (void)_BitScanForward(&index, mask);
+    return (unsigned int)index;
+}
+#else
+#define getFirstSetBit(mask) ((unsigned int)__builtin_ctz(mask))
+#endif
+#endif
+
 typedef struct STRING_TAG
 {
     char* s;
+    /*strlen(s), kept up to date by every operation so that it never has to be computed*/
+    size_t length;
+    /*how many chars s can hold, '\0' included, length < capacity*/
+    size_t capacity;
+    /*NULL unless the string was created in an arena*/
+    ARENA_HANDLE arena;
+    /*s points here for as long as the string fits*/
+    char small[STRING_SMALL_CAPACITY];
 }STRING;
 
+#define IS_SMALL(str) ((str)->s == (str)->small)
+
+/*points s to size chars, inside the handle when they fit there*/
+static char* allocChars(STRING* str, ARENA_HANDLE arena, size_t size)
+{
+    str->arena = arena;
+    if (size <= STRING_SMALL_CAPACITY)
+    {
+        str->s = str->small;
+        str->capacity = STRING_SMALL_CAPACITY;
+    }
+    else if ((str->s = (str->arena == NULL) ? (char*)malloc(size) : (char*)ARENA_malloc(str->arena, size)) != NULL)
+    {
+        str->capacity = size;
+    }
+    return str->s;
+}
+
+/*the characters of a string created in an arena are reallocated in the arena and only released with it*/
+static char* reallocChars(STRING* str, size_t size)
+{
+    char* result;
+    if (IS_SMALL(str))
+    {
+        /*the chars leave the handle only when they no longer fit in it*/
+        if (size <= STRING_SMALL_CAPACITY)
+        {
+            result = str->s;
+        }
+        else if ((result = (str->arena == NULL) ? (char*)malloc(size) : (char*)ARENA_malloc(str->arena, size)) != NULL)
+        {
+            memcpy(result, str->small, STRING_SMALL_CAPACITY);
+        }
+    }
+    else if (str->arena == NULL)
+    {
+        result = (char*)realloc(str->s, size);
+    }
+    else
+    {
+        result = (char*)ARENA_realloc(str->arena, str->s, str->capacity, size);
+    }
+    return result;
+}
+
+/*makes room for length chars plus '\0'. When growing is needed, growGeometrically doubles the capacity (at least),
+which is what makes appending in a loop linear*/
+static int ensureCapacity(STRING* str, size_t length, int growGeometrically)
+{
+    int result;
+    if (length < str->capacity)
+    {
+        result = 0;
+    }
+    else if (length == SIZE_MAX)
+    {
+        LogError("a string cannot be longer than SIZE_MAX - 1 chars\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        size_t newCapacity = length + 1;
+        char* temp;
+        if (growGeometrically)
+        {
+            size_t doubleCapacity = (str->capacity > SIZE_MAX / 2) ? SIZE_MAX : 2 * str->capacity;
+            if (doubleCapacity > newCapacity)
+            {
+                newCapacity = doubleCapacity;
+            }
+        }
+
+        temp = reallocChars(str, newCapacity);
+        if (temp == NULL)
+        {
+            LogError("unable to reallocate %lu chars\r\n", (unsigned long)newCapacity);
+            result = __LINE__;
+        }
+        else
+        {
+            str->s = temp;
+            str->capacity = newCapacity;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+/*reallocates the chars to exactly length chars plus '\0', a copy or an empty string gives back what it does not need*/
+static int resizeChars(STRING* str, size_t length)
+{
+    int result;
+    char* temp;
+    if (length == SIZE_MAX)
+    {
+        LogError("a string cannot be longer than SIZE_MAX - 1 chars\r\n");
+        result = __LINE__;
+    }
+    else if (length < STRING_SMALL_CAPACITY)
+    {
+        if (!IS_SMALL(str))
+        {
+            /*the chars go back into the handle*/
+            memcpy(str->small, str->s, (length < str->length) ? length : str->length);
+            if (str->arena == NULL)
+            {
+                free(str->s);
+            }
+            str->s = str->small;
+            str->capacity = STRING_SMALL_CAPACITY;
+        }
+        result = 0;
+    }
+    else if ((temp = reallocChars(str, length + 1)) == NULL)
+    {
+        LogError("unable to reallocate %lu chars\r\n", (unsigned long)(length + 1));
+        result = __LINE__;
+    }
+    else
+    {
+        str->s = temp;
+        str->capacity = length + 1;
+        result = 0;
+    }
+    return result;
+}
+
+/*appends length chars of source to str*/
+static int appendChars(STRING* str, const char* source, size_t length)
+{
+    int result;
+    if ((str->length + length < str->length) ||
+        (ensureCapacity(str, str->length + length, 1) != 0))
+    {
+        result = __LINE__;
+    }
+    else
+    {
+        /*source may be the string itself, its chars are only read after the reallocation*/
+        memcpy(str->s + str->length, (source == NULL) ? str->s : source, length);
+        str->length += length;
+        str->s[str->length] = '\0';
+        result = 0;
+    }
+    return result;
+}
+
+/*returns how many chars at the beginning of source (out of length) are plain JSON chars*/
+static size_t getPlainJSONLength(const char* source, size_t length)
+{
+    size_t i = 0;
+#ifdef STRING_USE_SSE2
+    /*the compares are signed, which makes the chars from 0x80 on "less than 0x20" too*/
+#ifdef STRING_USE_AVX2
+    const __m256i controlLimit32 = _mm256_set1_epi8(0x20);
+    const __m256i quote32 = _mm256_set1_epi8('"');
+    const __m256i backslash32 = _mm256_set1_epi8('\\');
+    const __m256i slash32 = _mm256_set1_epi8('/');
+    for (; i + 32 <= length; i += 32)
+    {
+        __m256i chars = _mm256_loadu_si256((const __m256i*)(source + i));
+        __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpgt_epi8(controlLimit32, chars), _mm256_cmpeq_epi8(chars, quote32)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chars, backslash32), _mm256_cmpeq_epi8(chars, slash32)));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(special);
+        if (mask != 0)
+        {
+            return i + getFirstSetBit(mask);
+        }
+    }
+#endif
+    {
+        const __m128i controlLimit = _mm_set1_epi8(0x20);
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i slash = _mm_set1_epi8('/');
+        for (; i + 16 <= length; i += 16)
+        {
+            __m128i chars = _mm_loadu_si128((const __m128i*)(source + i));
+            __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmplt_epi8(chars, controlLimit), _mm_cmpeq_epi8(chars, quote)),
+                _mm_or_si128(_mm_cmpeq_epi8(chars, backslash), _mm_cmpeq_epi8(chars, slash)));
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(special);
+            if (mask != 0)
+            {
+                return i + getFirstSetBit(mask);
+            }
+        }
+    }
+#endif
+    while ((i < length) && IS_PLAIN_JSON_CHAR(source[i]))
+    {
+        i++;
+    }
+    return i;
+}
+
+/*formats into str from position on, the chars before position are kept. The first vsnprintf writes straight into the spare capacity
+when nothing past position would be lost, and it measures the output at the same time; only output that does not fit is formatted twice*/
+static int formatChars(STRING* str, size_t position, const char* format, va_list args)
+{
+    int result;
+    int formattedLength;
+    size_t spare = (position == str->length) ? str->capacity - position : 0;
+    va_list argsCopy;
+
+    va_copy(argsCopy, args);
+    formattedLength = vsnprintf((spare == 0) ? NULL : str->s + position, spare, format, argsCopy);
+    va_end(argsCopy);
+
+    if (formattedLength < 0)
+    {
+        LogError("vsnprintf failed\r\n");
+        str->s[str->length] = '\0';
+        result = __LINE__;
+    }
+    else if ((size_t)formattedLength < spare)
+    {
+        str->length = position + formattedLength;
+        result = 0;
+    }
+    else
+    {
+        /*a truncated first pass left its output past the content*/
+        str->s[str->length] = '\0';
+        if ((position + (size_t)formattedLength < position) ||
+            (ensureCapacity(str, position + (size_t)formattedLength, position != 0) != 0))
+        {
+            result = __LINE__;
+        }
+        else
+        {
+            (void)vsnprintf(str->s + position, (size_t)formattedLength + 1, format, args);
+            str->length = position + (size_t)formattedLength;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+static STRING_HANDLE constructInArena(ARENA_HANDLE arena, const char* psz)
+{
+    STRING* result;
+    size_t nLen = strlen(psz) + 1;
+    if ((result = (STRING*)ARENA_malloc(arena, sizeof(STRING))) == NULL)
+    {
+        LogError("ARENA_malloc failed\r\n");
+    }
+    else if (allocChars(result, arena, nLen) == NULL)
+    {
+        /*what was taken from the arena goes away with it*/
+        LogError("ARENA_malloc failed\r\n");
+        result = NULL;
+    }
+    else
+    {
+        memcpy(result->s, psz, nLen);
+        result->length = nLen - 1;
+    }
+    return (STRING_HANDLE)result;
+}
+
 /*this function will allocate a new string with just '\0' in it*/
 /*return NULL if it fails*/
 /* Codes_SRS_STRING_07_001: [STRING_new shall allocate a new STRING_HANDLE pointing to an empty string.] */
@@ -34,16 +340,9 @@ STRING_HANDLE STRING_new(void)
     STRING* result;
     if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
     {
-        if ((result->s = (char*)malloc(1)) != NULL)
-        {
-            result->s[0] = '\0';
-        }
-        else
-        {
-            /* Codes_SRS_STRING_07_002: [STRING_new shall return an NULL STRING_HANDLE on any error that is encountered.] */
-            free(result);
-            result = NULL;
-        }
+        (void)allocChars(result, NULL, 1);
+        result->s[0] = '\0';
+        result->length = 0;
     }
     return (STRING_HANDLE)result;
 }
@@ -64,8 +363,9 @@ STRING_HANDLE STRING_clone(STRING_HANDLE handle)
         {
             STRING* source = (STRING*)handle;
             /*Codes_SRS_STRING_02_003: [If STRING_clone fails for any reason, it shall return NULL.] */
-            size_t sourceLen = strlen(source->s);
-            if ((result->s = (char*)malloc(sourceLen + 1)) == NULL)
+            size_t sourceLen = source->length;
+            /*a clone is always on the heap, even when the source lives in an arena*/
+            if (allocChars(result, NULL, sourceLen + 1) == NULL)
             {
                 free(result);
                 result = NULL;
@@ -73,6 +373,7 @@ STRING_HANDLE STRING_clone(STRING_HANDLE handle)
             else
             {
                 memcpy(result->s, source->s, sourceLen + 1);
+                result->length = sourceLen;
             }
         }
         else
@@ -98,9 +399,10 @@ STRING_HANDLE STRING_construct(const char* psz)
         if ((str = (STRING*)malloc(sizeof(STRING))) != NULL)
         {
             size_t nLen = strlen(psz) + 1;
-            if ((str->s = (char*)malloc(nLen)) != NULL)
+            if (allocChars(str, NULL, nLen) != NULL)
             {
                 memcpy(str->s, psz, nLen);
+                str->length = nLen - 1;
                 result = (STRING_HANDLE)str;
             }
             /* Codes_SRS_STRING_07_032: [STRING_construct encounters any error it shall return a NULL value.] */
@@ -136,6 +438,9 @@ STRING_HANDLE STRING_new_with_memory(const char* memory)
         if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
         {
             result->s = (char*)memory;
+            result->length = strlen(memory);
+            result->capacity = result->length + 1;
+            result->arena = NULL;
         }
     }
     return (STRING_HANDLE)result;
@@ -153,12 +458,13 @@ STRING_HANDLE STRING_new_quoted(const char* source)
     else if ((result = (STRING*)malloc(sizeof(STRING))) != NULL)
     {
         size_t sourceLength = strlen(source);
-        if ((result->s = (char*)malloc(sourceLength + 3)) != NULL)
+        if (allocChars(result, NULL, sourceLength + 3) != NULL)
         {
             result->s[0] = '"';
             memcpy(result->s + 1, source, sourceLength);
             result->s[sourceLength + 1] = '"';
             result->s[sourceLength + 2] = '\0';
+            result->length = sourceLength + 2;
         }
         else
         {
@@ -184,33 +490,29 @@ STRING_HANDLE STRING_new_JSON(const char* source)
     }
     else
     {
-        size_t i;
+        size_t i = 0;
         size_t nControlCharacters = 0; /*counts how many characters are to be expanded from 1 character to \uxxxx (6 characters)*/
         size_t nEscapeCharacters = 0;
         size_t vlen = strlen(source);
 
-        for (i = 0; i < vlen; i++)
+        /*only the chars that end a run of plain chars are looked at one by one*/
+        while ((i += getPlainJSONLength(source + i, vlen - i)) < vlen)
         {
             /*Codes_SRS_STRING_02_014: [If any character has the value outside [1...127] then STRING_new_JSON shall fail and return NULL.] */
             if ((unsigned char)source[i] >= 128) /*this be a UNICODE character begin*/
             {
                 break;
             }
+            else if (source[i] <= 0x1F)
+            {
+                nControlCharacters++;
+            }
             else
             {
-                if (source[i] <= 0x1F)
-                {
-                    nControlCharacters++;
-                }
-                else if (
-                    (source[i] == '"') ||
-                    (source[i] == '\\') ||
-                    (source[i] == '/')
-                    )
-                {
-                    nEscapeCharacters++;
-                }
+                /*the quote, the backslash or the slash*/
+                nEscapeCharacters++;
             }
+            i++;
         }
 
         if (i < vlen)
@@ -225,7 +527,7 @@ STRING_HANDLE STRING_new_JSON(const char* source)
                 /*Codes_SRS_STRING_02_021: [If the complete JSON representation cannot be produced, then STRING_new_JSON shall fail and return NULL.] */
                 LogError("malloc failure\r\n");
             }
-            else if ((result->s = (char*)malloc(vlen + 5 * nControlCharacters + nEscapeCharacters + 3)) == NULL)
+            else if (allocChars(result, NULL, vlen + 5 * nControlCharacters + nEscapeCharacters + 3) == NULL)
             {
                 /*Codes_SRS_STRING_02_021: [If the complete JSON representation cannot be produced, then STRING_new_JSON shall fail and return NULL.] */
                 free(result);
@@ -239,7 +541,17 @@ STRING_HANDLE STRING_new_JSON(const char* source)
                 result->s[pos++] = '"';
                 for (i = 0; i < vlen; i++)
                 {
-                    if (source[i] <= 0x1F)
+                    /*Codes_SRS_STRING_02_013: [The string shall copy the characters of source "as they are" (until the '\0' character) with the following exceptions:] */
+                    size_t plainLength = getPlainJSONLength(source + i, vlen - i);
+                    memcpy(result->s + pos, source + i, plainLength);
+                    pos += plainLength;
+                    i += plainLength;
+
+                    if (i == vlen)
+                    {
+                        break;
+                    }
+                    else if (source[i] <= 0x1F)
                     {
                         /*Codes_SRS_STRING_02_019: [If the character code is less than 0x20 then it shall be represented as \u00xx, where xx is the hex representation of the character code.]*/
                         result->s[pos++] = '\\';
@@ -267,16 +579,12 @@ STRING_HANDLE STRING_new_JSON(const char* source)
                         result->s[pos++] = '\\';
                         result->s[pos++] = '/';
                     }
-                    else
-                    {
-                        /*Codes_SRS_STRING_02_013: [The string shall copy the characters of source "as they are" (until the '\0' character) with the following exceptions:] */
-                        result->s[pos++] = source[i];
-                    }
                 }
                 /*Codes_SRS_STRING_02_020: [The string shall end with " (quote).] */
                 result->s[pos++] = '"';
                 /*zero terminating it*/
                 result->s[pos] = '\0';
+                result->length = pos;
             }
         }
 
@@ -299,18 +607,19 @@ int STRING_concat(STRING_HANDLE handle, const char* s2)
     else
     {
         STRING* s1 = (STRING*)handle;
-        size_t s1Length = strlen(s1->s);
-        size_t s2Length = strlen(s2);
-        char* temp = (char*)realloc(s1->s, s1Length + s2Length + 1);
-        if (temp == NULL)
+        if (s2 == s1->s)
+        {
+            /*s2 would not survive the reallocation, appendChars copies from the string itself then*/
+            s2 = NULL;
+        }
+
+        if (appendChars(s1, s2, (s2 == NULL) ? s1->length : strlen(s2)) != 0)
         {
             /* Codes_SRS_STRING_07_013: [STRING_concat shall return a nonzero number if an error is encountered.] */
             result = __LINE__;
         }
         else
         {
-            s1->s = temp;
-            memcpy(s1->s + s1Length, s2, s2Length + 1);
             result = 0;
         }
     }
@@ -334,25 +643,64 @@ int STRING_concat_with_STRING(STRING_HANDLE s1, STRING_HANDLE s2)
         STRING* dest = (STRING*)s1;
         STRING* src = (STRING*)s2;
 
-        size_t s1Length = strlen(dest->s);
-        size_t s2Length = strlen(src->s);
-        char* temp = (char*)realloc(dest->s, s1Length + s2Length + 1);
-        if (temp == NULL)
+        /* Codes_SRS_STRING_07_034: [String_Concat_with_STRING shall concatenate a given STRING_HANDLE variable with a source STRING_HANDLE.] */
+        if (appendChars(dest, (dest == src) ? NULL : src->s, src->length) != 0)
         {
             /* Codes_SRS_STRING_07_035: [String_Concat_with_STRING shall return a nonzero number if an error is encountered.] */
             result = __LINE__;
         }
         else
         {
-            dest->s = temp;
-            /* Codes_SRS_STRING_07_034: [String_Concat_with_STRING shall concatenate a given STRING_HANDLE variable with a source STRING_HANDLE.] */
-            memcpy(dest->s + s1Length, src->s, s2Length + 1);
             result = 0;
         }
     }
     return result;
 }
 
+/*replaces the content of handle with the formatted output, handle is left empty on failure*/
+int STRING_sprintf(STRING_HANDLE handle, const char* format, ...)
+{
+    int result;
+    if ((handle == NULL) || (format == NULL))
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        STRING* str = (STRING*)handle;
+        va_list args;
+
+        /*the old content is dropped first, which lets the first pass format in place*/
+        str->length = 0;
+        str->s[0] = '\0';
+        va_start(args, format);
+        result = formatChars(str, 0, format, args);
+        va_end(args);
+    }
+    return result;
+}
+
+/*appends the formatted output to handle, the content is unchanged on failure*/
+int STRING_concat_format(STRING_HANDLE handle, const char* format, ...)
+{
+    int result;
+    if ((handle == NULL) || (format == NULL))
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        STRING* str = (STRING*)handle;
+        va_list args;
+        va_start(args, format);
+        result = formatChars(str, str->length, format, args);
+        va_end(args);
+    }
+    return result;
+}
+
 /*this function will copy the string from s2 to s1*/
 /*returns 0 if success*/
 /*any other error code is failure*/
@@ -372,16 +720,15 @@ int STRING_copy(STRING_HANDLE handle, const char* s2)
         if (s1->s != s2)
         {
             size_t s2Length = strlen(s2);
-            char* temp = (char*)realloc(s1->s, s2Length + 1);
-            if (temp == NULL)
+            if (resizeChars(s1, s2Length) != 0)
             {
                 /* Codes_SRS_STRING_07_027: [STRING_copy shall return a nonzero value if any error is encountered.] */
                 result = __LINE__;
             }
             else
             {
-                s1->s = temp;
                 memmove(s1->s, s2, s2Length + 1);
+                s1->length = s2Length;
                 result = 0;
             }
         }
@@ -410,23 +757,21 @@ int STRING_copy_n(STRING_HANDLE handle, const char* s2, size_t n)
     {
         STRING* s1 = (STRING*)handle;
         size_t s2Length = strlen(s2);
-        char* temp;
         if (s2Length > n)
         {
             s2Length = n;
         }
 
-        temp = (char*)realloc(s1->s, s2Length + 1);
-        if (temp == NULL)
+        if (resizeChars(s1, s2Length) != 0)
         {
             /* Codes_SRS_STRING_07_028: [STRING_copy_n shall return a nonzero value if any error is encountered.] */
             result = __LINE__;
         }
         else
         {
-            s1->s = temp;
             memcpy(s1->s, s2, s2Length);
             s1->s[s2Length] = 0;
+            s1->length = s2Length;
             result = 0;
         }
 
@@ -449,20 +794,20 @@ int STRING_quote(STRING_HANDLE handle)
     else
     {
         STRING* s1 = (STRING*)handle;
-        size_t s1Length = strlen(s1->s);
-        char* temp = (char*)realloc(s1->s, s1Length + 2 + 1);/*2 because 2 quotes, 1 because '\0'*/
-        if (temp == NULL)
+        size_t s1Length = s1->length;
+        if ((s1Length > SIZE_MAX - 2) ||
+            (ensureCapacity(s1, s1Length + 2, 0) != 0)) /*2 because 2 quotes*/
         {
             /* Codes_SRS_STRING_07_029: [STRING_quote shall return a nonzero value if any error is encountered.] */
             result = __LINE__;
         }
         else
         {
-            s1->s = temp;
             memmove(s1->s + 1, s1->s, s1Length);
             s1->s[0] = '"';
             s1->s[s1Length + 1] = '"';
             s1->s[s1Length + 2] = '\0';
+            s1->length = s1Length + 2;
             result = 0;
         }
     }
@@ -482,16 +827,15 @@ int STRING_empty(STRING_HANDLE handle)
     else
     {
         STRING* s1 = (STRING*)handle;
-        char* temp = (char*)realloc(s1->s, 1);
-        if (temp == NULL)
+        if (resizeChars(s1, 0) != 0)
         {
             /* Codes_SRS_STRING_07_030: [STRING_empty shall return a nonzero value if the STRING_HANDLE is NULL.] */
             result = __LINE__;
         }
         else
         {
-            s1->s = temp;
             s1->s[0] = '\0';
+            s1->length = 0;
             result = 0;
         }
     }
@@ -506,9 +850,16 @@ void STRING_delete(STRING_HANDLE handle)
     if (handle != NULL)
     {
         STRING* value = (STRING*)handle;
-        free(value->s);
-        value->s = NULL;
-        free(value);
+        /*a string created in an arena is released with the arena*/
+        if (value->arena == NULL)
+        {
+            if (!IS_SMALL(value))
+            {
+                free(value->s);
+            }
+            value->s = NULL;
+            free(value);
+        }
     }
 }
 
@@ -536,7 +887,7 @@ size_t STRING_length(STRING_HANDLE handle)
     if (handle != NULL)
     {
         STRING* value = (STRING*)handle;
-        result = strlen(value->s);
+        result = value->length;
     }
     return result;
 }
@@ -565,10 +916,11 @@ STRING_HANDLE STRING_construct_n(const char* psz, size_t n)
             STRING* str;
             if ((str = (STRING*)malloc(sizeof(STRING))) != NULL)
             {
-                if ((str->s = (char*)malloc(len + 1)) != NULL)
+                if (allocChars(str, NULL, n + 1) != NULL)
                 {
                     memcpy(str->s, psz, n);
                     str->s[n] = '\0';
+                    str->length = n;
                     result = (STRING_HANDLE)str;
                 }
                 /* Codes_SRS_STRING_02_010: [In all other error cases, STRING_construct_n shall return NULL.]  */
@@ -588,6 +940,36 @@ STRING_HANDLE STRING_construct_n(const char* psz, size_t n)
     return result;
 }
 
+STRING_HANDLE STRING_new_in_arena(ARENA_HANDLE arena)
+{
+    STRING_HANDLE result;
+    if (arena == NULL)
+    {
+        result = NULL;
+        LogError("invalid arg (NULL)\r\n");
+    }
+    else
+    {
+        result = constructInArena(arena, "");
+    }
+    return result;
+}
+
+STRING_HANDLE STRING_construct_in_arena(ARENA_HANDLE arena, const char* psz)
+{
+    STRING_HANDLE result;
+    if ((arena == NULL) || (psz == NULL))
+    {
+        result = NULL;
+        LogError("invalid arg (NULL)\r\n");
+    }
+    else
+    {
+        result = constructInArena(arena, psz);
+    }
+    return result;
+}
+
 /* Codes_SRS_STRING_07_034: [STRING_compare returns an integer greater than, equal to, or less than zero, accordingly as the string pointed to by s1 is greater than, equal to, or less than the string s2.] */
 int STRING_compare(STRING_HANDLE s1, STRING_HANDLE s2)
 {
@@ -9,10 +9,12 @@
 #include <time.h>
 #include "tickcounter.h"
 
+/* the portable counter, built on clock(). That is process time on some platforms, where it stands still while the
+process is blocked. Linux uses adapters/tickcounter_linux.c instead */
 typedef struct TICK_COUNTER_INSTANCE_TAG
 {
 	clock_t last_clock_value;
-	uint64_t current_ms;
+	uint64_t elapsed_clocks;
 } TICK_COUNTER_INSTANCE;
 
 TICK_COUNTER_HANDLE tickcounter_create(void)
@@ -21,7 +23,7 @@ TICK_COUNTER_HANDLE tickcounter_create(void)
 	if (result != NULL)
 	{
 		result->last_clock_value = clock();
-		result->current_ms = result->last_clock_value * 1000 / CLOCKS_PER_SEC;
+		result->elapsed_clocks = 0;
 	}
 
 	return result;
@@ -35,11 +37,12 @@ void tickcounter_destroy(TICK_COUNTER_HANDLE tick_counter)
 	}
 }
 
-int tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, uint64_t* current_ms)
+/* converts the clocks elapsed so far to units_per_second, without overflowing for large counts */
+static int get_current(TICK_COUNTER_HANDLE tick_counter, uint64_t units_per_second, uint64_t* current)
 {
 	int result;
 
-	if (tick_counter == NULL || current_ms == NULL)
+	if (tick_counter == NULL || current == NULL)
 	{
 		result = __LINE__;
 	}
@@ -49,12 +52,28 @@ int tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, uint64_t* curre
 
 		clock_t clock_value = clock();
 
-		tick_counter_instance->current_ms += (clock_value - tick_counter_instance->last_clock_value) * 1000 / CLOCKS_PER_SEC;
+		tick_counter_instance->elapsed_clocks += (uint64_t)(clock_value - tick_counter_instance->last_clock_value);
 		tick_counter_instance->last_clock_value = clock_value;
-		*current_ms = tick_counter_instance->current_ms;
+		*current = ((tick_counter_instance->elapsed_clocks / CLOCKS_PER_SEC) * units_per_second) +
+			((tick_counter_instance->elapsed_clocks % CLOCKS_PER_SEC) * units_per_second / CLOCKS_PER_SEC);
 
 		result = 0;
 	}
 
 	return result;
 }
+
+int tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, uint64_t* current_ms)
+{
+	return get_current(tick_counter, 1000, current_ms);
+}
+
+int tickcounter_get_current_us(TICK_COUNTER_HANDLE tick_counter, uint64_t* current_us)
+{
+	return get_current(tick_counter, 1000000, current_us);
+}
+
+int tickcounter_get_current_ns(TICK_COUNTER_HANDLE tick_counter, uint64_t* current_ns)
+{
+	return get_current(tick_counter, 1000000000, current_ns);
+}
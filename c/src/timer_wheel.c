@@ -0,0 +1,284 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+#include "gballoc.h"
+
+#include <string.h>
+#include "timer_wheel.h"
+#include "iot_logging.h"
+
+/*level 0 has a slot per millisecond of the next 64, level 1 a slot per 64 milliseconds of the next 4096 and so on.
+When level 0 wraps around, the level 1 slot that starts there is cascaded: its timers are spread over level 0. Timers
+further away than the last level (about 4.6 hours) wait in its furthest slot and are spread again from there*/
+#define TIMER_WHEEL_SLOT_BITS 6
+#define TIMER_WHEEL_SLOT_COUNT (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOT_COUNT - 1)
+#define TIMER_WHEEL_LEVEL_COUNT 4
+
+#define LEVEL_SHIFT(level) ((level) * TIMER_WHEEL_SLOT_BITS)
+#define LEVEL_SPAN(level) (((uint64_t)1) << LEVEL_SHIFT((level) + 1))
+
+typedef struct TIMER_WHEEL_TAG
+{
+    TICK_COUNTER_HANDLE tick_counter;
+    /*all the timers expiring at or before current_ms have fired*/
+    uint64_t current_ms;
+    size_t scheduled_count;
+    TIMER_WHEEL_TIMER* slots[TIMER_WHEEL_LEVEL_COUNT][TIMER_WHEEL_SLOT_COUNT];
+} TIMER_WHEEL;
+
+static void link_timer(TIMER_WHEEL_TIMER** slot, TIMER_WHEEL_TIMER* timer)
+{
+    timer->next = *slot;
+    if (timer->next != NULL)
+    {
+        timer->next->link = &timer->next;
+    }
+    timer->link = slot;
+    *slot = timer;
+}
+
+static void unlink_timer(TIMER_WHEEL_TIMER* timer)
+{
+    *timer->link = timer->next;
+    if (timer->next != NULL)
+    {
+        timer->next->link = timer->link;
+    }
+    timer->link = NULL;
+}
+
+/*expiry_ms is never before current_ms. A timer expiring at current_ms goes to the level 0 slot that is about to fire*/
+static void insert_timer(TIMER_WHEEL* timerWheel, TIMER_WHEEL_TIMER* timer)
+{
+    uint64_t delta = timer->expiry_ms - timerWheel->current_ms;
+    size_t level = 0;
+    size_t slot;
+    while ((level < TIMER_WHEEL_LEVEL_COUNT - 1) &&
+        (delta >= LEVEL_SPAN(level)))
+    {
+        level++;
+    }
+
+    if (delta >= LEVEL_SPAN(level))
+    {
+        /*the slot before the current one of the last level is cascaded last*/
+        slot = (size_t)(((timerWheel->current_ms >> LEVEL_SHIFT(level)) + TIMER_WHEEL_SLOT_MASK) & TIMER_WHEEL_SLOT_MASK);
+    }
+    else
+    {
+        slot = (size_t)((timer->expiry_ms >> LEVEL_SHIFT(level)) & TIMER_WHEEL_SLOT_MASK);
+    }
+    link_timer(&timerWheel->slots[level][slot], timer);
+}
+
+/*moves the timers of a slot one or more levels down, relative to current_ms*/
+static void cascade(TIMER_WHEEL* timerWheel, size_t level)
+{
+    TIMER_WHEEL_TIMER** slot = &timerWheel->slots[level][(timerWheel->current_ms >> LEVEL_SHIFT(level)) & TIMER_WHEEL_SLOT_MASK];
+    TIMER_WHEEL_TIMER* timer = *slot;
+    *slot = NULL;
+    while (timer != NULL)
+    {
+        TIMER_WHEEL_TIMER* next = timer->next;
+        insert_timer(timerWheel, timer);
+        timer = next;
+    }
+}
+
+static void fire_current_slot(TIMER_WHEEL* timerWheel)
+{
+    /*the slot is detached first, so that callbacks can schedule into it. The remaining timers link to expired, so
+    that callbacks can also cancel them*/
+    TIMER_WHEEL_TIMER** slot = &timerWheel->slots[0][timerWheel->current_ms & TIMER_WHEEL_SLOT_MASK];
+    TIMER_WHEEL_TIMER* expired = *slot;
+    *slot = NULL;
+    if (expired != NULL)
+    {
+        expired->link = &expired;
+    }
+
+    while (expired != NULL)
+    {
+        TIMER_WHEEL_TIMER* timer = expired;
+        unlink_timer(timer);
+        timerWheel->scheduled_count--;
+        timer->on_timer_expired(timer->callback_context);
+    }
+}
+
+TIMER_WHEEL_HANDLE TIMER_WHEEL_create(TICK_COUNTER_HANDLE tick_counter)
+{
+    TIMER_WHEEL* result;
+    if (tick_counter == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = NULL;
+    }
+    else if ((result = (TIMER_WHEEL*)malloc(sizeof(TIMER_WHEEL))) == NULL)
+    {
+        LogError("unable to malloc\r\n");
+    }
+    else if (tickcounter_get_current_ms(tick_counter, &result->current_ms) != 0)
+    {
+        LogError("unable to read the tick counter\r\n");
+        free(result);
+        result = NULL;
+    }
+    else
+    {
+        result->tick_counter = tick_counter;
+        result->scheduled_count = 0;
+        (void)memset(result->slots, 0, sizeof(result->slots));
+    }
+    return result;
+}
+
+void TIMER_WHEEL_destroy(TIMER_WHEEL_HANDLE handle)
+{
+    if (handle != NULL)
+    {
+        TIMER_WHEEL* timerWheel = (TIMER_WHEEL*)handle;
+        size_t level;
+        size_t slot;
+        for (level = 0; (level < TIMER_WHEEL_LEVEL_COUNT) && (timerWheel->scheduled_count > 0); level++)
+        {
+            for (slot = 0; slot < TIMER_WHEEL_SLOT_COUNT; slot++)
+            {
+                while (timerWheel->slots[level][slot] != NULL)
+                {
+                    unlink_timer(timerWheel->slots[level][slot]);
+                    timerWheel->scheduled_count--;
+                }
+            }
+        }
+        free(timerWheel);
+    }
+}
+
+void TIMER_WHEEL_init_timer(TIMER_WHEEL_TIMER* timer, ON_TIMER_EXPIRED on_timer_expired, void* callback_context)
+{
+    if (timer == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+    }
+    else
+    {
+        timer->next = NULL;
+        timer->link = NULL;
+        timer->expiry_ms = 0;
+        timer->on_timer_expired = on_timer_expired;
+        timer->callback_context = callback_context;
+    }
+}
+
+int TIMER_WHEEL_schedule(TIMER_WHEEL_HANDLE handle, TIMER_WHEEL_TIMER* timer, uint64_t timeout_ms)
+{
+    int result;
+    uint64_t now;
+    if ((handle == NULL) ||
+        (timer == NULL) ||
+        (timer->on_timer_expired == NULL))
+    {
+        LogError("invalid arg (NULL)\r\n");
+        result = __LINE__;
+    }
+    else if (tickcounter_get_current_ms(((TIMER_WHEEL*)handle)->tick_counter, &now) != 0)
+    {
+        LogError("unable to read the tick counter\r\n");
+        result = __LINE__;
+    }
+    else
+    {
+        TIMER_WHEEL* timerWheel = (TIMER_WHEEL*)handle;
+        if (timer->link != NULL)
+        {
+            unlink_timer(timer);
+            timerWheel->scheduled_count--;
+        }
+
+        /*the wheel can be behind now if dowork is late, it is never ahead of it. The slot of current_ms has fired
+        already, so the earliest a timer can expire is the next millisecond*/
+        if (timeout_ms > UINT64_MAX - now)
+        {
+            timer->expiry_ms = UINT64_MAX;
+        }
+        else
+        {
+            timer->expiry_ms = now + timeout_ms;
+        }
+        if (timer->expiry_ms <= timerWheel->current_ms)
+        {
+            timer->expiry_ms = timerWheel->current_ms + 1;
+        }
+
+        insert_timer(timerWheel, timer);
+        timerWheel->scheduled_count++;
+        result = 0;
+    }
+    return result;
+}
+
+void TIMER_WHEEL_cancel(TIMER_WHEEL_HANDLE handle, TIMER_WHEEL_TIMER* timer)
+{
+    if ((handle == NULL) ||
+        (timer == NULL))
+    {
+        LogError("invalid arg (NULL)\r\n");
+    }
+    else if (timer->link != NULL)
+    {
+        unlink_timer(timer);
+        ((TIMER_WHEEL*)handle)->scheduled_count--;
+    }
+}
+
+bool TIMER_WHEEL_is_scheduled(const TIMER_WHEEL_TIMER* timer)
+{
+    return (timer != NULL) && (timer->link != NULL);
+}
+
+void TIMER_WHEEL_dowork(TIMER_WHEEL_HANDLE handle)
+{
+    uint64_t now;
+    if (handle == NULL)
+    {
+        LogError("invalid arg (NULL)\r\n");
+    }
+    else if (tickcounter_get_current_ms(((TIMER_WHEEL*)handle)->tick_counter, &now) != 0)
+    {
+        LogError("unable to read the tick counter\r\n");
+    }
+    else
+    {
+        TIMER_WHEEL* timerWheel = (TIMER_WHEEL*)handle;
+        while (timerWheel->current_ms < now)
+        {
+            if (timerWheel->scheduled_count == 0)
+            {
+                /*an empty wheel can skip ahead, there is nothing to cascade or fire*/
+                timerWheel->current_ms = now;
+            }
+            else
+            {
+                size_t level;
+                timerWheel->current_ms++;
+
+                /*the higher levels first, their timers may land in the lower level slots cascaded next*/
+                for (level = TIMER_WHEEL_LEVEL_COUNT - 1; level > 0; level--)
+                {
+                    if ((timerWheel->current_ms & (LEVEL_SPAN(level - 1) - 1)) == 0)
+                    {
+                        cascade(timerWheel, level);
+                    }
+                }
+
+                fire_current_slot(timerWheel);
+            }
+        }
+    }
+}
@@ -8,13 +8,20 @@
 #include "gballoc.h"
 
 #include "vector.h"
+#include <stdint.h>
 #include <string.h>
 
+/*the first growth makes room for a few elements, every later one doubles the capacity*/
+#define VECTOR_INITIAL_CAPACITY 4
+
+/*ranges this short are finished by insertion sort, it beats partitioning them further*/
+#define VECTOR_INSERTION_SORT_THRESHOLD 16
 
 typedef struct VECTOR_TAG
 {
     void* storage;
     size_t count;
+    size_t capacity;
     size_t elementSize;
 } VECTOR;
 
@@ -31,6 +38,7 @@ VECTOR_HANDLE VECTOR_create(size_t elementSize)
     {
         vec->storage = NULL;
         vec->count = 0;
+        vec->capacity = 0;
         vec->elementSize = elementSize;
         result = (VECTOR_HANDLE)vec;
     }
@@ -45,6 +53,29 @@ static void internal_VECTOR_clear(VECTOR* vec)
         vec->storage = NULL;
     }
     vec->count = 0;
+    vec->capacity = 0;
+}
+
+/*reallocs the storage to hold exactly newCapacity elements*/
+static int internal_VECTOR_resize(VECTOR* vec, size_t newCapacity)
+{
+    int result;
+    void* temp;
+    if ((vec->elementSize != 0) && (newCapacity > SIZE_MAX / vec->elementSize))
+    {
+        result = __LINE__;
+    }
+    else if ((temp = realloc(vec->storage, vec->elementSize * newCapacity)) == NULL)
+    {
+        result = __LINE__;
+    }
+    else
+    {
+        vec->storage = temp;
+        vec->capacity = newCapacity;
+        result = 0;
+    }
+    return result;
 }
 
 void VECTOR_destroy(VECTOR_HANDLE handle)
@@ -57,6 +88,30 @@ void VECTOR_destroy(VECTOR_HANDLE handle)
     }
 }
 
+/*makes room for at least newCount elements. Doubling keeps a run of insertions linear*/
+static int internal_VECTOR_grow(VECTOR* vec, size_t newCount)
+{
+    int result;
+    if (newCount <= vec->capacity)
+    {
+        result = 0;
+    }
+    else
+    {
+        size_t newCapacity = (vec->capacity == 0) ? VECTOR_INITIAL_CAPACITY : vec->capacity;
+        while ((newCapacity < newCount) && (newCapacity <= SIZE_MAX / 2))
+        {
+            newCapacity *= 2;
+        }
+        if (newCapacity < newCount)
+        {
+            newCapacity = newCount;
+        }
+        result = internal_VECTOR_resize(vec, newCapacity);
+    }
+    return result;
+}
+
 /* insertion */
 int VECTOR_push_back(VECTOR_HANDLE handle, const void* elements, size_t numElements)
 {
@@ -68,18 +123,17 @@ int VECTOR_push_back(VECTOR_HANDLE handle, const void* elements, size_t numEleme
     else
     {
         VECTOR* vec = (VECTOR*)handle;
-        const size_t curSize = vec->elementSize * vec->count;
-        const size_t appendSize = vec->elementSize * numElements;
-
-        void* temp = realloc(vec->storage, curSize + appendSize);
-        if (temp == NULL)
+        if (numElements > SIZE_MAX - vec->count)
+        {
+            result = __LINE__;
+        }
+        else if (internal_VECTOR_grow(vec, vec->count + numElements) != 0)
         {
             result = __LINE__;
         }
         else
         {
-            memcpy((unsigned char*)temp + curSize, elements, appendSize);
-            vec->storage = temp;
+            memcpy((unsigned char*)vec->storage + (vec->elementSize * vec->count), elements, vec->elementSize * numElements);
             vec->count += numElements;
             result = 0;
         }
@@ -96,15 +150,19 @@ void VECTOR_erase(VECTOR_HANDLE handle, void* elements, size_t numElements)
         unsigned char* src = (unsigned char*)elements + (vec->elementSize * numElements);
         unsigned char* srcEnd = (unsigned char*)vec->storage + (vec->elementSize * vec->count);
         (void)memmove(elements, src, srcEnd - src);
+        /*the capacity is kept, VECTOR_shrink_to_fit gives it back*/
         vec->count -= numElements;
-        if (vec->count == 0)
-        {
-            free(vec->storage);
-            vec->storage = NULL;
-        }
-        else
+    }
+}
+
+void VECTOR_pop_back(VECTOR_HANDLE handle)
+{
+    if (handle != NULL)
+    {
+        VECTOR* vec = (VECTOR*)handle;
+        if (vec->count > 0)
         {
-            vec->storage = realloc(vec->storage, (vec->elementSize * vec->count));
+            vec->count--;
         }
     }
 }
@@ -188,3 +246,299 @@ size_t VECTOR_size(const VECTOR_HANDLE handle)
     }
     return result;
 }
+
+size_t VECTOR_capacity(const VECTOR_HANDLE handle)
+{
+    size_t result = 0;
+    if (handle != NULL)
+    {
+        const VECTOR* vec = (const VECTOR*)handle;
+        result = vec->capacity;
+    }
+    return result;
+}
+
+int VECTOR_reserve(VECTOR_HANDLE handle, size_t numElements)
+{
+    int result;
+    if (handle == NULL)
+    {
+        result = __LINE__;
+    }
+    else
+    {
+        VECTOR* vec = (VECTOR*)handle;
+        if (numElements <= vec->capacity)
+        {
+            result = 0;
+        }
+        else
+        {
+            result = internal_VECTOR_resize(vec, numElements);
+        }
+    }
+    return result;
+}
+
+void VECTOR_shrink_to_fit(VECTOR_HANDLE handle)
+{
+    if (handle != NULL)
+    {
+        VECTOR* vec = (VECTOR*)handle;
+        if (vec->count == 0)
+        {
+            internal_VECTOR_clear(vec);
+        }
+        else if (vec->count < vec->capacity)
+        {
+            /*when realloc fails the bigger storage is simply kept*/
+            (void)internal_VECTOR_resize(vec, vec->count);
+        }
+    }
+}
+
+/* ordering */
+
+#define VECTOR_ITEM(vec, index) ((unsigned char*)(vec)->storage + ((vec)->elementSize * (index)))
+
+static void internal_VECTOR_swap(VECTOR* vec, size_t left, size_t right)
+{
+    if (left != right)
+    {
+        unsigned char temp[64];
+        unsigned char* leftItem = VECTOR_ITEM(vec, left);
+        unsigned char* rightItem = VECTOR_ITEM(vec, right);
+        size_t remaining = vec->elementSize;
+        while (remaining > 0)
+        {
+            size_t chunk = (remaining < sizeof(temp)) ? remaining : sizeof(temp);
+            (void)memcpy(temp, leftItem, chunk);
+            (void)memcpy(leftItem, rightItem, chunk);
+            (void)memcpy(rightItem, temp, chunk);
+            leftItem += chunk;
+            rightItem += chunk;
+            remaining -= chunk;
+        }
+    }
+}
+
+static int internal_VECTOR_compare(VECTOR* vec, VECTOR_COMPARE_FUNCTION compare, size_t left, size_t right)
+{
+    return compare(VECTOR_ITEM(vec, left), VECTOR_ITEM(vec, right));
+}
+
+/*sorts [begin, end)*/
+static void internal_VECTOR_insertion_sort(VECTOR* vec, VECTOR_COMPARE_FUNCTION compare, size_t begin, size_t end)
+{
+    size_t i;
+    for (i = begin + 1; i < end; i++)
+    {
+        size_t j = i;
+        while ((j > begin) && (internal_VECTOR_compare(vec, compare, j - 1, j) > 0))
+        {
+            internal_VECTOR_swap(vec, j - 1, j);
+            j--;
+        }
+    }
+}
+
+static void internal_VECTOR_sift_down(VECTOR* vec, VECTOR_COMPARE_FUNCTION compare, size_t begin, size_t root, size_t heapSize)
+{
+    while ((2 * root) + 1 < heapSize)
+    {
+        size_t child = (2 * root) + 1;
+        if ((child + 1 < heapSize) && (internal_VECTOR_compare(vec, compare, begin + child, begin + child + 1) < 0))
+        {
+            child++;
+        }
+        if (internal_VECTOR_compare(vec, compare, begin + root, begin + child) >= 0)
+        {
+            break;
+        }
+        internal_VECTOR_swap(vec, begin + root, begin + child);
+        root = child;
+    }
+}
+
+/*sorts [begin, end), used when partitioning goes quadratic*/
+static void internal_VECTOR_heap_sort(VECTOR* vec, VECTOR_COMPARE_FUNCTION compare, size_t begin, size_t end)
+{
+    size_t heapSize = end - begin;
+    size_t i;
+    for (i = heapSize / 2; i > 0; i--)
+    {
+        internal_VECTOR_sift_down(vec, compare, begin, i - 1, heapSize);
+    }
+    while (heapSize > 1)
+    {
+        heapSize--;
+        internal_VECTOR_swap(vec, begin, begin + heapSize);
+        internal_VECTOR_sift_down(vec, compare, begin, 0, heapSize);
+    }
+}
+
+/*partitions [begin, end) around the median of its first, middle and last elements and returns where the pivot lands*/
+static size_t internal_VECTOR_partition(VECTOR* vec, VECTOR_COMPARE_FUNCTION compare, size_t begin, size_t end)
+{
+    size_t middle = begin + ((end - begin) / 2);
+    size_t last = end - 1;
+    size_t i = begin;
+    size_t j = end;
+
+    if (internal_VECTOR_compare(vec, compare, middle, begin) < 0)
+    {
+        internal_VECTOR_swap(vec, middle, begin);
+    }
+    if (internal_VECTOR_compare(vec, compare, last, middle) < 0)
+    {
+        internal_VECTOR_swap(vec, last, middle);
+        if (internal_VECTOR_compare(vec, compare, middle, begin) < 0)
+        {
+            internal_VECTOR_swap(vec, middle, begin);
+        }
+    }
+    internal_VECTOR_swap(vec, begin, middle);
+
+    /*both scans stop on elements equal to the pivot, so runs of equal elements still split evenly*/
+    for (;;)
+    {
+        do
+        {
+            i++;
+        } while ((i < last) && (internal_VECTOR_compare(vec, compare, i, begin) < 0));
+        do
+        {
+            j--;
+        } while (internal_VECTOR_compare(vec, compare, j, begin) > 0);
+        if (i >= j)
+        {
+            break;
+        }
+        internal_VECTOR_swap(vec, i, j);
+    }
+    internal_VECTOR_swap(vec, begin, j);
+    return j;
+}
+
+/*introsort: quicksort that falls back to heap sort once depthLimit partitions did not finish the range*/
+static void internal_VECTOR_intro_sort(VECTOR* vec, VECTOR_COMPARE_FUNCTION compare, size_t begin, size_t end, size_t depthLimit)
+{
+    while (end - begin > VECTOR_INSERTION_SORT_THRESHOLD)
+    {
+        if (depthLimit == 0)
+        {
+            internal_VECTOR_heap_sort(vec, compare, begin, end);
+            begin = end;
+        }
+        else
+        {
+            size_t pivot = internal_VECTOR_partition(vec, compare, begin, end);
+            depthLimit--;
+            /*recursing into the smaller side bounds the stack to log(n) frames*/
+            if (pivot - begin < end - pivot)
+            {
+                internal_VECTOR_intro_sort(vec, compare, begin, pivot, depthLimit);
+                begin = pivot + 1;
+            }
+            else
+            {
+                internal_VECTOR_intro_sort(vec, compare, pivot + 1, end, depthLimit);
+                end = pivot;
+            }
+        }
+    }
+    internal_VECTOR_insertion_sort(vec, compare, begin, end);
+}
+
+void VECTOR_sort(VECTOR_HANDLE handle, VECTOR_COMPARE_FUNCTION compare)
+{
+    if (handle != NULL && compare != NULL)
+    {
+        VECTOR* vec = (VECTOR*)handle;
+        size_t depthLimit = 0;
+        size_t n;
+        for (n = vec->count; n > 1; n /= 2)
+        {
+            depthLimit += 2;
+        }
+        internal_VECTOR_intro_sort(vec, compare, 0, vec->count, depthLimit);
+    }
+}
+
+/*index of the first element for which compare(element, value) is not < 0 (orAfterEqual == false) or is > 0 (orAfterEqual == true)*/
+static size_t internal_VECTOR_bound(const VECTOR* vec, VECTOR_COMPARE_FUNCTION compare, const void* value, bool orAfterEqual)
+{
+    size_t begin = 0;
+    size_t end = vec->count;
+    while (begin < end)
+    {
+        size_t middle = begin + ((end - begin) / 2);
+        int comparison = compare(VECTOR_ITEM(vec, middle), value);
+        if ((comparison < 0) || (orAfterEqual && (comparison == 0)))
+        {
+            begin = middle + 1;
+        }
+        else
+        {
+            end = middle;
+        }
+    }
+    return begin;
+}
+
+void* VECTOR_lower_bound(const VECTOR_HANDLE handle, VECTOR_COMPARE_FUNCTION compare, const void* value)
+{
+    void* result = NULL;
+    if (handle != NULL && compare != NULL && value != NULL)
+    {
+        const VECTOR* vec = (const VECTOR*)handle;
+        size_t index = internal_VECTOR_bound(vec, compare, value, false);
+        if (index < vec->count)
+        {
+            result = VECTOR_ITEM(vec, index);
+        }
+    }
+    return result;
+}
+
+void* VECTOR_binary_search(const VECTOR_HANDLE handle, VECTOR_COMPARE_FUNCTION compare, const void* value)
+{
+    void* result = NULL;
+    if (handle != NULL && compare != NULL && value != NULL)
+    {
+        const VECTOR* vec = (const VECTOR*)handle;
+        size_t index = internal_VECTOR_bound(vec, compare, value, false);
+        if ((index < vec->count) && (compare(VECTOR_ITEM(vec, index), value) == 0))
+        {
+            result = VECTOR_ITEM(vec, index);
+        }
+    }
+    return result;
+}
+
+int VECTOR_insert_sorted(VECTOR_HANDLE handle, const void* element, VECTOR_COMPARE_FUNCTION compare)
+{
+    int result;
+    if (handle == NULL || element == NULL || compare == NULL)
+    {
+        result = __LINE__;
+    }
+    else
+    {
+        VECTOR* vec = (VECTOR*)handle;
+        /*equal elements keep the order in which they were inserted*/
+        size_t index = internal_VECTOR_bound(vec, compare, element, true);
+        if ((vec->count == SIZE_MAX) || (internal_VECTOR_grow(vec, vec->count + 1) != 0))
+        {
+            result = __LINE__;
+        }
+        else
+        {
+            (void)memmove(VECTOR_ITEM(vec, index + 1), VECTOR_ITEM(vec, index), vec->elementSize * (vec->count - index));
+            (void)memcpy(VECTOR_ITEM(vec, index), element, vec->elementSize);
+            vec->count++;
+            result = 0;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,387 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "micromock.h"
+
+#include "arena.h"
+#include "gballoc.h"
+
+#ifndef SIZE_MAX
+#define SIZE_MAX ((size_t)~(size_t)0)
+#endif
+
+#define TEST_BLOCK_SIZE 256
+
+static MICROMOCK_MUTEX_HANDLE g_testByTest;
+static MICROMOCK_GLOBAL_SEMAPHORE_HANDLE g_dllByDll;
+
+BEGIN_TEST_SUITE(Arena_UnitTests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = MicroMockCreateMutex();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    MicroMockDestroyMutex(g_testByTest);
+    DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (!MicroMockAcquireMutex(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    if (!MicroMockReleaseMutex(g_testByTest))
+    {
+        ASSERT_FAIL("failure in test framework at ReleaseMutex");
+    }
+}
+
+/* ARENA_create */
+
+TEST_FUNCTION(ARENA_create_with_0_block_size_succeeds)
+{
+    // arrange
+
+    // act
+    ARENA_HANDLE result = ARENA_create(0);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+
+    // cleanup
+    ARENA_destroy(result);
+}
+
+TEST_FUNCTION(ARENA_create_with_a_too_big_block_size_fails)
+{
+    // arrange
+
+    // act
+    ARENA_HANDLE result = ARENA_create(SIZE_MAX);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* ARENA_destroy */
+
+TEST_FUNCTION(ARENA_destroy_with_NULL_does_nothing)
+{
+    // arrange
+
+    // act
+    ARENA_destroy(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(ARENA_destroy_releases_all_the_memory_of_the_arena)
+{
+    // arrange
+    size_t i;
+    ASSERT_ARE_EQUAL(int, 0, gballoc_init());
+    ARENA_HANDLE arena = ARENA_create(TEST_BLOCK_SIZE);
+    for (i = 0; i < 100; i++)
+    {
+        ASSERT_IS_NOT_NULL(ARENA_malloc(arena, 30));
+    }
+    ASSERT_IS_NOT_NULL(ARENA_malloc(arena, 10 * TEST_BLOCK_SIZE));
+
+    // act
+    ARENA_destroy(arena);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    gballoc_deinit();
+}
+
+/* ARENA_malloc */
+
+TEST_FUNCTION(ARENA_malloc_with_NULL_arena_fails)
+{
+    // arrange
+
+    // act
+    void* result = ARENA_malloc(NULL, 1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(ARENA_malloc_returns_usable_aligned_memory)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(0);
+    (void)ARENA_malloc(arena, 3);
+
+    // act
+    unsigned char* result = (unsigned char*)ARENA_malloc(arena, 10);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, ((size_t)(uintptr_t)result) % sizeof(void*));
+    (void)memset(result, 0x42, 10);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+TEST_FUNCTION(ARENA_malloc_with_0_size_returns_distinct_pointers)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(0);
+
+    // act
+    void* result1 = ARENA_malloc(arena, 0);
+    void* result2 = ARENA_malloc(arena, 0);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result1);
+    ASSERT_IS_NOT_NULL(result2);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, result1, result2);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+TEST_FUNCTION(ARENA_malloc_hands_out_non_overlapping_memory)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_BLOCK_SIZE);
+    unsigned char* blocks[100];
+    size_t i;
+
+    // act
+    for (i = 0; i < 100; i++)
+    {
+        blocks[i] = (unsigned char*)ARENA_malloc(arena, 17);
+        ASSERT_IS_NOT_NULL(blocks[i]);
+        (void)memset(blocks[i], (int)i, 17);
+    }
+
+    // assert
+    for (i = 0; i < 100; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)i, blocks[i][0]);
+        ASSERT_ARE_EQUAL(int, (int)i, blocks[i][16]);
+    }
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+TEST_FUNCTION(ARENA_malloc_of_more_than_a_block_keeps_serving_small_allocations_from_the_current_block)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_BLOCK_SIZE);
+    unsigned char* first = (unsigned char*)ARENA_malloc(arena, 8);
+
+    // act
+    unsigned char* big = (unsigned char*)ARENA_malloc(arena, 4 * TEST_BLOCK_SIZE);
+    unsigned char* next = (unsigned char*)ARENA_malloc(arena, 8);
+
+    // assert
+    ASSERT_IS_NOT_NULL(big);
+    (void)memset(big, 0x42, 4 * TEST_BLOCK_SIZE);
+    ASSERT_IS_TRUE((next > first) && (next < first + TEST_BLOCK_SIZE));
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+TEST_FUNCTION(ARENA_malloc_with_an_overflowing_size_fails)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(0);
+
+    // act
+    void* result = ARENA_malloc(arena, SIZE_MAX - 2);
+
+    // assert
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* ARENA_realloc */
+
+TEST_FUNCTION(ARENA_realloc_with_NULL_arena_fails)
+{
+    // arrange
+
+    // act
+    void* result = ARENA_realloc(NULL, NULL, 0, 1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(ARENA_realloc_with_NULL_ptr_allocates)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(0);
+
+    // act
+    void* result = ARENA_realloc(arena, NULL, 0, 10);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+TEST_FUNCTION(ARENA_realloc_of_the_last_allocation_grows_in_place)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_BLOCK_SIZE);
+    char* block = (char*)ARENA_malloc(arena, 6);
+    (void)memcpy(block, "abcde", 6);
+
+    // act
+    char* result = (char*)ARENA_realloc(arena, block, 6, 100);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, block, result);
+    ASSERT_ARE_EQUAL(char_ptr, "abcde", result);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+TEST_FUNCTION(ARENA_realloc_of_an_older_allocation_copies_the_content)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_BLOCK_SIZE);
+    char* block = (char*)ARENA_malloc(arena, 6);
+    (void)memcpy(block, "abcde", 6);
+    (void)ARENA_malloc(arena, 1);
+
+    // act
+    char* result = (char*)ARENA_realloc(arena, block, 6, 100);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, block, result);
+    ASSERT_ARE_EQUAL(char_ptr, "abcde", result);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+TEST_FUNCTION(ARENA_realloc_to_a_smaller_size_keeps_the_allocation)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_BLOCK_SIZE);
+    char* block = (char*)ARENA_malloc(arena, 100);
+    (void)memcpy(block, "abcde", 6);
+    (void)ARENA_malloc(arena, 1);
+
+    // act
+    char* result = (char*)ARENA_realloc(arena, block, 100, 6);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, block, result);
+    ASSERT_ARE_EQUAL(char_ptr, "abcde", result);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+TEST_FUNCTION(ARENA_realloc_beyond_the_block_moves_to_a_new_block)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_BLOCK_SIZE);
+    char* block = (char*)ARENA_malloc(arena, 6);
+    (void)memcpy(block, "abcde", 6);
+
+    // act
+    char* result = (char*)ARENA_realloc(arena, block, 6, 2 * TEST_BLOCK_SIZE);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, "abcde", result);
+    (void)memset(result, 0x42, 2 * TEST_BLOCK_SIZE);
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+/* ARENA_reset */
+
+TEST_FUNCTION(ARENA_reset_with_NULL_does_nothing)
+{
+    // arrange
+
+    // act
+    ARENA_reset(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(ARENA_reset_reuses_the_memory_of_the_arena)
+{
+    // arrange
+    ARENA_HANDLE arena = ARENA_create(TEST_BLOCK_SIZE);
+    void* first = ARENA_malloc(arena, 8);
+    (void)ARENA_malloc(arena, 4 * TEST_BLOCK_SIZE);
+
+    // act
+    ARENA_reset(arena);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, first, ARENA_malloc(arena, 8));
+
+    // cleanup
+    ARENA_destroy(arena);
+}
+
+TEST_FUNCTION(ARENA_reset_keeps_only_one_block)
+{
+    // arrange
+    size_t i;
+    size_t usedByOneBlock;
+    ASSERT_ARE_EQUAL(int, 0, gballoc_init());
+    ARENA_HANDLE arena = ARENA_create(TEST_BLOCK_SIZE);
+    (void)ARENA_malloc(arena, 8);
+    usedByOneBlock = gballoc_getCurrentMemoryUsed();
+    for (i = 0; i < 100; i++)
+    {
+        (void)ARENA_malloc(arena, 30);
+    }
+
+    // act
+    ARENA_reset(arena);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, usedByOneBlock, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    ARENA_destroy(arena);
+    gballoc_deinit();
+}
+
+END_TEST_SUITE(Arena_UnitTests)
@@ -0,0 +1,443 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <cstdlib>
+#include <cstring>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "micromock.h"
+
+#include "buffer_chain.h"
+#include "gballoc.h"
+
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+static const unsigned char HEADER[] = { 'H', 'E', 'A', 'D' };
+static const unsigned char BODY[] = { 'b', 'o', 'd', 'y', 'b', 'o', 'd', 'y' };
+static const unsigned char TRAILER[] = { 'T', 'R' };
+static const unsigned char FRAMED[] = { 'H', 'E', 'A', 'D', 'b', 'o', 'd', 'y', 'b', 'o', 'd', 'y', 'T', 'R' };
+
+static MICROMOCK_MUTEX_HANDLE g_testByTest;
+static MICROMOCK_GLOBAL_SEMAPHORE_HANDLE g_dllByDll;
+
+/*header, body and trailer, with the header prepended last*/
+static BUFFER_CHAIN_HANDLE createFramedChain(void)
+{
+    BUFFER_CHAIN_HANDLE result = BUFFER_CHAIN_create();
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_CHAIN_append(result, BUFFER_create(BODY, sizeof(BODY))));
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_CHAIN_append(result, BUFFER_create(TRAILER, sizeof(TRAILER))));
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_CHAIN_prepend(result, BUFFER_create(HEADER, sizeof(HEADER))));
+    return result;
+}
+
+BEGIN_TEST_SUITE(BufferChain_UnitTests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = MicroMockCreateMutex();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    MicroMockDestroyMutex(g_testByTest);
+    DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (!MicroMockAcquireMutex(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    if (!MicroMockReleaseMutex(g_testByTest))
+    {
+        ASSERT_FAIL("failure in test framework at ReleaseMutex");
+    }
+}
+
+/* BUFFER_CHAIN_create */
+
+TEST_FUNCTION(BUFFER_CHAIN_create_returns_an_empty_chain)
+{
+    // arrange
+
+    // act
+    BUFFER_CHAIN_HANDLE result = BUFFER_CHAIN_create();
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, BUFFER_CHAIN_segment_count(result));
+    ASSERT_ARE_EQUAL(size_t, 0, BUFFER_CHAIN_length(result));
+
+    // cleanup
+    BUFFER_CHAIN_destroy(result);
+}
+
+/* BUFFER_CHAIN_destroy */
+
+TEST_FUNCTION(BUFFER_CHAIN_destroy_with_NULL_does_nothing)
+{
+    // arrange
+
+    // act
+    BUFFER_CHAIN_destroy(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_destroy_deletes_the_segments)
+{
+    // arrange
+    ASSERT_ARE_EQUAL(int, 0, gballoc_init());
+    BUFFER_CHAIN_HANDLE chain = BUFFER_CHAIN_create();
+    (void)BUFFER_CHAIN_append(chain, BUFFER_create(BODY, sizeof(BODY)));
+    (void)BUFFER_CHAIN_prepend(chain, BUFFER_create(HEADER, sizeof(HEADER)));
+
+    // act
+    BUFFER_CHAIN_destroy(chain);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    gballoc_deinit();
+}
+
+/* BUFFER_CHAIN_append */
+
+TEST_FUNCTION(BUFFER_CHAIN_append_with_NULL_chain_fails)
+{
+    // arrange
+    BUFFER_HANDLE segment = BUFFER_create(BODY, sizeof(BODY));
+
+    // act
+    int result = BUFFER_CHAIN_append(NULL, segment);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    BUFFER_delete(segment);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_append_with_NULL_segment_fails)
+{
+    // arrange
+    BUFFER_CHAIN_HANDLE chain = BUFFER_CHAIN_create();
+
+    // act
+    int result = BUFFER_CHAIN_append(chain, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, BUFFER_CHAIN_segment_count(chain));
+
+    // cleanup
+    BUFFER_CHAIN_destroy(chain);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_append_does_not_copy_the_segment)
+{
+    // arrange
+    BUFFER_CHAIN_HANDLE chain = BUFFER_CHAIN_create();
+    BUFFER_HANDLE segment = BUFFER_create(BODY, sizeof(BODY));
+    const unsigned char* content;
+    (void)BUFFER_content(segment, &content);
+    ASSERT_ARE_EQUAL(int, 0, gballoc_init());
+
+    // act
+    int result = BUFFER_CHAIN_append(chain, segment);
+    size_t memoryUsed = gballoc_getCurrentMemoryUsed();
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, BUFFER_CHAIN_segment_count(chain));
+    ASSERT_ARE_EQUAL(size_t, sizeof(BODY), BUFFER_CHAIN_length(chain));
+    /*only the bookkeeping of the segment is allocated*/
+    ASSERT_ARE_EQUAL(size_t, 3 * sizeof(void*), memoryUsed);
+
+    // cleanup
+    gballoc_deinit();
+    BUFFER_CHAIN_destroy(chain);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_append_of_an_empty_segment_succeeds)
+{
+    // arrange
+    BUFFER_CHAIN_HANDLE chain = BUFFER_CHAIN_create();
+
+    // act
+    int result = BUFFER_CHAIN_append(chain, BUFFER_new());
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 1, BUFFER_CHAIN_segment_count(chain));
+    ASSERT_ARE_EQUAL(size_t, 0, BUFFER_CHAIN_length(chain));
+
+    // cleanup
+    BUFFER_CHAIN_destroy(chain);
+}
+
+/* BUFFER_CHAIN_prepend */
+
+TEST_FUNCTION(BUFFER_CHAIN_prepend_with_NULL_chain_fails)
+{
+    // arrange
+    BUFFER_HANDLE segment = BUFFER_create(HEADER, sizeof(HEADER));
+
+    // act
+    int result = BUFFER_CHAIN_prepend(NULL, segment);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    BUFFER_delete(segment);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_prepend_puts_the_segment_first)
+{
+    // arrange
+    BUFFER_CHAIN_HANDLE chain = BUFFER_CHAIN_create();
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_CHAIN_append(chain, BUFFER_create(BODY, sizeof(BODY))));
+
+    // act
+    int result = BUFFER_CHAIN_prepend(chain, BUFFER_create(HEADER, sizeof(HEADER)));
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 2, BUFFER_CHAIN_segment_count(chain));
+    ASSERT_ARE_EQUAL(size_t, sizeof(HEADER) + sizeof(BODY), BUFFER_CHAIN_length(chain));
+    BUFFER_HANDLE flat = BUFFER_CHAIN_flatten(chain);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(flat), FRAMED, sizeof(HEADER) + sizeof(BODY)));
+
+    // cleanup
+    BUFFER_delete(flat);
+    BUFFER_CHAIN_destroy(chain);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_append_of_a_shared_buffer_leaves_the_original_with_the_caller)
+{
+    // arrange
+    BUFFER_CHAIN_HANDLE chain = BUFFER_CHAIN_create();
+    BUFFER_HANDLE body = BUFFER_create(BODY, sizeof(BODY));
+
+    // act
+    int result = BUFFER_CHAIN_append(chain, BUFFER_share(body));
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    BUFFER_CHAIN_destroy(chain);
+    ASSERT_ARE_EQUAL(size_t, sizeof(BODY), BUFFER_length(body));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(body), BODY, sizeof(BODY)));
+
+    // cleanup
+    BUFFER_delete(body);
+}
+
+/* BUFFER_CHAIN_segment_count / BUFFER_CHAIN_length */
+
+TEST_FUNCTION(BUFFER_CHAIN_segment_count_with_NULL_returns_0)
+{
+    // arrange
+
+    // act
+    size_t result = BUFFER_CHAIN_segment_count(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_length_with_NULL_returns_0)
+{
+    // arrange
+
+    // act
+    size_t result = BUFFER_CHAIN_length(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+}
+
+/* BUFFER_CHAIN_flatten */
+
+TEST_FUNCTION(BUFFER_CHAIN_flatten_with_NULL_fails)
+{
+    // arrange
+
+    // act
+    BUFFER_HANDLE result = BUFFER_CHAIN_flatten(NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_flatten_of_an_empty_chain_returns_an_empty_buffer)
+{
+    // arrange
+    BUFFER_CHAIN_HANDLE chain = BUFFER_CHAIN_create();
+
+    // act
+    BUFFER_HANDLE result = BUFFER_CHAIN_flatten(chain);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, BUFFER_length(result));
+
+    // cleanup
+    BUFFER_delete(result);
+    BUFFER_CHAIN_destroy(chain);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_flatten_copies_the_segments_in_order)
+{
+    // arrange
+    BUFFER_CHAIN_HANDLE chain = createFramedChain();
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_CHAIN_append(chain, BUFFER_new()));
+
+    // act
+    BUFFER_HANDLE result = BUFFER_CHAIN_flatten(chain);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, sizeof(FRAMED), BUFFER_length(result));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(result), FRAMED, sizeof(FRAMED)));
+
+    // cleanup
+    BUFFER_delete(result);
+    BUFFER_CHAIN_destroy(chain);
+}
+
+#ifndef WIN32
+/* BUFFER_CHAIN_get_iovec */
+
+TEST_FUNCTION(BUFFER_CHAIN_get_iovec_with_NULL_chain_fails)
+{
+    // arrange
+    struct iovec iov[1];
+    size_t iovCount = 1;
+
+    // act
+    int result = BUFFER_CHAIN_get_iovec(NULL, iov, &iovCount);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_get_iovec_with_NULL_iov_fails)
+{
+    // arrange
+    BUFFER_CHAIN_HANDLE chain = BUFFER_CHAIN_create();
+    size_t iovCount = 1;
+
+    // act
+    int result = BUFFER_CHAIN_get_iovec(chain, NULL, &iovCount);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    BUFFER_CHAIN_destroy(chain);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_get_iovec_with_NULL_iovCount_fails)
+{
+    // arrange
+    BUFFER_CHAIN_HANDLE chain = BUFFER_CHAIN_create();
+    struct iovec iov[1];
+
+    // act
+    int result = BUFFER_CHAIN_get_iovec(chain, iov, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    BUFFER_CHAIN_destroy(chain);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_get_iovec_with_too_few_entries_fails)
+{
+    // arrange
+    BUFFER_CHAIN_HANDLE chain = createFramedChain();
+    struct iovec iov[2];
+    size_t iovCount = 2;
+
+    // act
+    int result = BUFFER_CHAIN_get_iovec(chain, iov, &iovCount);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 2, iovCount);
+
+    // cleanup
+    BUFFER_CHAIN_destroy(chain);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_get_iovec_points_into_the_segments)
+{
+    // arrange
+    BUFFER_CHAIN_HANDLE chain = BUFFER_CHAIN_create();
+    BUFFER_HANDLE body = BUFFER_create(BODY, sizeof(BODY));
+    const unsigned char* bodyContent;
+    (void)BUFFER_content(body, &bodyContent);
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_CHAIN_append(chain, body));
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_CHAIN_prepend(chain, BUFFER_create(HEADER, sizeof(HEADER))));
+    struct iovec iov[4];
+    size_t iovCount = 4;
+
+    // act
+    int result = BUFFER_CHAIN_get_iovec(chain, iov, &iovCount);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 2, iovCount);
+    ASSERT_ARE_EQUAL(size_t, sizeof(HEADER), iov[0].iov_len);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(iov[0].iov_base, HEADER, sizeof(HEADER)));
+    ASSERT_ARE_EQUAL(void_ptr, (void*)bodyContent, iov[1].iov_base);
+    ASSERT_ARE_EQUAL(size_t, sizeof(BODY), iov[1].iov_len);
+
+    // cleanup
+    BUFFER_CHAIN_destroy(chain);
+}
+
+TEST_FUNCTION(BUFFER_CHAIN_get_iovec_can_be_handed_to_writev)
+{
+    // arrange
+    BUFFER_CHAIN_HANDLE chain = createFramedChain();
+    struct iovec iov[3];
+    size_t iovCount = 3;
+    unsigned char received[sizeof(FRAMED)];
+    int fds[2];
+    ASSERT_ARE_EQUAL(int, 0, pipe(fds));
+
+    // act
+    ASSERT_ARE_EQUAL(int, 0, BUFFER_CHAIN_get_iovec(chain, iov, &iovCount));
+    ssize_t written = writev(fds[1], iov, (int)iovCount);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, (int)sizeof(FRAMED), (int)written);
+    ASSERT_ARE_EQUAL(int, (int)sizeof(FRAMED), (int)read(fds[0], received, sizeof(received)));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(received, FRAMED, sizeof(FRAMED)));
+
+    // cleanup
+    (void)close(fds[0]);
+    (void)close(fds[1]);
+    BUFFER_CHAIN_destroy(chain);
+}
+#endif
+
+END_TEST_SUITE(BufferChain_UnitTests)
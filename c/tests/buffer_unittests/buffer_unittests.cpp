@@ -448,9 +448,6 @@ BEGIN_TEST_SUITE(Buffer_UnitTests)
         int nResult = BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, ALLOCATION_SIZE))
-            .IgnoreArgument(1);
-
         ///act
         nResult = BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
 
@@ -496,14 +493,12 @@ BEGIN_TEST_SUITE(Buffer_UnitTests)
         int nResult = BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, ALLOCATION_SIZE - 1))
-            .IgnoreArgument(1);
-
         ///act
         nResult = BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE - 1);
 
         ///assert
         ASSERT_ARE_EQUAL(int, nResult, 0);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE - 1, BUFFER_length(g_hBuffer));
         mocks.AssertActualAndExpectedCalls();
 
         ///cleanup
@@ -1091,4 +1086,1122 @@ BEGIN_TEST_SUITE(Buffer_UnitTests)
         BUFFER_delete(res);
     }
 
+    TEST_FUNCTION(BUFFER_enlarge_doubles_the_capacity)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        (void)BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * ALLOCATION_SIZE))
+            .IgnoreArgument(1);
+
+        ///act
+        int nResult = BUFFER_enlarge(g_hBuffer, 1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE + 1, BUFFER_length(g_hBuffer));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_enlarge_within_the_capacity_does_not_reallocate)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        (void)BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        (void)BUFFER_enlarge(g_hBuffer, 1);
+        mocks.ResetAllCalls();
+
+        ///act
+        int nResult = BUFFER_enlarge(g_hBuffer, ALLOCATION_SIZE - 1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, 2 * ALLOCATION_SIZE, BUFFER_length(g_hBuffer));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_enlarge_with_an_overflowing_size_fails)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        (void)BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        ///act
+        int nResult = BUFFER_enlarge(g_hBuffer, (size_t)-1);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_length(g_hBuffer));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_append_of_many_small_pieces_reallocates_a_logarithmic_number_of_times)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        BUFFER_HANDLE hAppend = BUFFER_new();
+        size_t i;
+        (void)BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, 1);
+        (void)BUFFER_build(hAppend, BUFFER_TEST_VALUE, 1);
+        mocks.ResetAllCalls();
+
+        /*the capacity goes 1, 2, 4, ..., 1024*/
+        for (i = 1; i <= 10; i++)
+        {
+            STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, (size_t)1 << i))
+                .IgnoreArgument(1);
+        }
+
+        ///act
+        for (i = 1; i < 1024; i++)
+        {
+            ASSERT_ARE_EQUAL(int, 0, BUFFER_append(g_hBuffer, hAppend));
+        }
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 1024, BUFFER_length(g_hBuffer));
+        ASSERT_ARE_EQUAL(int, BUFFER_TEST_VALUE[0], BUFFER_u_char(g_hBuffer)[1023]);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(hAppend);
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_prepend_within_the_capacity_does_not_allocate)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        BUFFER_HANDLE hPrepend = BUFFER_new();
+        (void)BUFFER_build(g_hBuffer, ADDITIONAL_BUFFER, ALLOCATION_SIZE);
+        (void)BUFFER_build(hPrepend, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        (void)BUFFER_reserve(g_hBuffer, TOTAL_ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        ///act
+        int nResult = BUFFER_prepend(g_hBuffer, hPrepend);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, TOTAL_ALLOCATION_SIZE, BUFFER_length(g_hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), TOTAL_BUFFER, TOTAL_ALLOCATION_SIZE));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(hPrepend);
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_reserve_with_NULL_handle_fails)
+    {
+        ///arrange
+        CMocks mocks;
+
+        ///act
+        int nResult = BUFFER_reserve(NULL, ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, nResult);
+        mocks.AssertActualAndExpectedCalls();
+    }
+
+    TEST_FUNCTION(BUFFER_reserve_allocates_exactly_the_requested_capacity)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        (void)BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 100))
+            .IgnoreArgument(1);
+
+        ///act
+        int nResult = BUFFER_reserve(g_hBuffer, 100);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_length(g_hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_reserve_of_less_than_the_capacity_does_nothing)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        (void)BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        ///act
+        int nResult = BUFFER_reserve(g_hBuffer, ALLOCATION_SIZE - 1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_reserve_fails_when_gballoc_realloc_fails)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        (void)BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        whenShallrealloc_fail = currentrealloc_call + 1;
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 100))
+            .IgnoreArgument(1);
+
+        ///act
+        int nResult = BUFFER_reserve(g_hBuffer, 100);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_pre_build_after_BUFFER_reserve_uses_the_reserved_storage)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        (void)BUFFER_reserve(g_hBuffer, 100);
+        mocks.ResetAllCalls();
+
+        ///act
+        int nResult = BUFFER_pre_build(g_hBuffer, ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_length(g_hBuffer));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_shrink_to_fit_with_NULL_handle_fails)
+    {
+        ///arrange
+        CMocks mocks;
+
+        ///act
+        int nResult = BUFFER_shrink_to_fit(NULL);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, nResult);
+        mocks.AssertActualAndExpectedCalls();
+    }
+
+    TEST_FUNCTION(BUFFER_shrink_to_fit_reallocates_to_the_size)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        (void)BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        (void)BUFFER_enlarge(g_hBuffer, 1);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, ALLOCATION_SIZE + 1))
+            .IgnoreArgument(1);
+
+        ///act
+        int nResult = BUFFER_shrink_to_fit(g_hBuffer);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_shrink_to_fit_when_the_buffer_is_full_does_nothing)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        (void)BUFFER_build(g_hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        ///act
+        int nResult = BUFFER_shrink_to_fit(g_hBuffer);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_shrink_to_fit_of_an_empty_buffer_frees_the_storage)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        (void)BUFFER_reserve(g_hBuffer, 100);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        int nResult = BUFFER_shrink_to_fit(g_hBuffer);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_IS_NULL(BUFFER_u_char(g_hBuffer));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_new_in_arena_with_NULL_arena_fails)
+    {
+        ///arrange
+        CMocks mocks;
+
+        ///act
+        auto res = BUFFER_new_in_arena(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        mocks.AssertActualAndExpectedCalls();
+    }
+
+    TEST_FUNCTION(BUFFER_create_in_arena_with_NULL_source_fails)
+    {
+        ///arrange
+        CMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        mocks.ResetAllCalls();
+
+        ///act
+        auto res = BUFFER_create_in_arena(arena, NULL, 1);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        ARENA_destroy(arena);
+    }
+
+    TEST_FUNCTION(BUFFER_create_in_arena_succeeds)
+    {
+        ///arrange
+        CMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+
+        ///act
+        auto res = BUFFER_create_in_arena(arena, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(res);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_length(res));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(res), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+
+        ///cleanup
+        BUFFER_delete(res);
+        ARENA_destroy(arena);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(BUFFER_operations_on_a_buffer_in_an_arena_do_not_use_the_heap)
+    {
+        ///arrange
+        CMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto hBuffer = BUFFER_new_in_arena(arena);
+        auto hAppend = BUFFER_create_in_arena(arena, ADDITIONAL_BUFFER, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        ///act
+        ASSERT_ARE_EQUAL(int, 0, BUFFER_build(hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(int, 0, BUFFER_append(hBuffer, hAppend));
+        ASSERT_ARE_EQUAL(int, 0, BUFFER_prepend(hAppend, hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, BUFFER_enlarge(hBuffer, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(int, 0, BUFFER_unbuild(hBuffer));
+        BUFFER_delete(hAppend);
+        BUFFER_delete(hBuffer);
+
+        ///assert
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        ARENA_destroy(arena);
+    }
+
+    TEST_FUNCTION(BUFFER_append_on_a_buffer_in_an_arena_keeps_the_content)
+    {
+        ///arrange
+        CMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto hBuffer = BUFFER_create_in_arena(arena, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        auto hAppend = BUFFER_create_in_arena(arena, ADDITIONAL_BUFFER, ALLOCATION_SIZE);
+
+        ///act
+        int nResult = BUFFER_append(hBuffer, hAppend);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(size_t, TOTAL_ALLOCATION_SIZE, BUFFER_length(hBuffer));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hBuffer), TOTAL_BUFFER, TOTAL_ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hAppend), ADDITIONAL_BUFFER, ALLOCATION_SIZE));
+
+        ///cleanup
+        ARENA_destroy(arena);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(BUFFER_clone_of_a_buffer_in_an_arena_is_on_the_heap)
+    {
+        ///arrange
+        CMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto hBuffer = BUFFER_create_in_arena(arena, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(ALLOCATION_SIZE));
+
+        ///act
+        auto res = BUFFER_clone(hBuffer);
+
+        ///assert
+        mocks.AssertActualAndExpectedCalls();
+        ARENA_destroy(arena);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(res), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+
+        ///cleanup
+        BUFFER_delete(res);
+    }
+
+    TEST_FUNCTION(BUFFER_share_with_NULL_handle_fails)
+    {
+        ///arrange
+        CMocks mocks;
+
+        ///act
+        auto res = BUFFER_share(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        mocks.AssertActualAndExpectedCalls();
+    }
+
+    TEST_FUNCTION(BUFFER_share_does_not_copy_the_bytes)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the shared storage*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the new handle*/
+            .IgnoreArgument(1);
+
+        ///act
+        auto res = BUFFER_share(g_hBuffer);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(res);
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_length(res));
+        const unsigned char* sourceContent;
+        const unsigned char* content;
+        (void)BUFFER_content(g_hBuffer, &sourceContent);
+        (void)BUFFER_content(res, &content);
+        ASSERT_ARE_EQUAL(void_ptr, (void*)sourceContent, (void*)content);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(res);
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_share_of_an_empty_buffer_returns_an_empty_buffer)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_new();
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        auto res = BUFFER_share(g_hBuffer);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(res);
+        ASSERT_ARE_EQUAL(size_t, 0, BUFFER_length(res));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(res);
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_share_twice_uses_the_same_storage)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        auto hShared1 = BUFFER_share(g_hBuffer);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        auto res = BUFFER_share(hShared1);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(res);
+        const unsigned char* content;
+        (void)BUFFER_content(res, &content);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(content, BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(res);
+        BUFFER_delete(hShared1);
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_slice_with_NULL_handle_fails)
+    {
+        ///arrange
+        CMocks mocks;
+
+        ///act
+        auto res = BUFFER_slice(NULL, 0, 1);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        mocks.AssertActualAndExpectedCalls();
+    }
+
+    TEST_FUNCTION(BUFFER_slice_with_offset_past_the_end_fails)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        ///act
+        auto res = BUFFER_slice(g_hBuffer, ALLOCATION_SIZE + 1, 0);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_slice_with_length_past_the_end_fails)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        ///act
+        auto res = BUFFER_slice(g_hBuffer, 2, ALLOCATION_SIZE - 1);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_slice_with_overflowing_length_fails)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        ///act
+        auto res = BUFFER_slice(g_hBuffer, 2, SIZE_MAX);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_slice_views_the_range_without_copying)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        auto res = BUFFER_slice(g_hBuffer, 4, 8);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(res);
+        ASSERT_ARE_EQUAL(size_t, 8, BUFFER_length(res));
+        const unsigned char* sourceContent;
+        const unsigned char* content;
+        (void)BUFFER_content(g_hBuffer, &sourceContent);
+        (void)BUFFER_content(res, &content);
+        ASSERT_ARE_EQUAL(void_ptr, (void*)(sourceContent + 4), (void*)content);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(res);
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_slice_when_allocating_the_handle_fails_keeps_the_source_usable)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        whenShallmalloc_fail = currentmalloc_call + 2;
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        auto res = BUFFER_slice(g_hBuffer, 4, 8);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        mocks.AssertActualAndExpectedCalls();
+        ASSERT_ARE_EQUAL(int, 0, BUFFER_enlarge(g_hBuffer, 1));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_u_char_on_a_slice_copies_the_bytes_and_leaves_the_source_intact)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        auto hSlice = BUFFER_slice(g_hBuffer, 4, 8);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(8));
+
+        ///act
+        unsigned char* content = BUFFER_u_char(hSlice);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(content);
+        mocks.AssertActualAndExpectedCalls();
+        content[0] = 0xFF;
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(content + 1, BUFFER_TEST_VALUE + 5, 7));
+
+        ///cleanup
+        BUFFER_delete(hSlice);
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_append_on_the_source_of_a_share_leaves_the_share_intact)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        BUFFER_HANDLE hAppend = BUFFER_create(ADDITIONAL_BUFFER, ALLOCATION_SIZE);
+        auto hShared = BUFFER_share(g_hBuffer);
+        mocks.ResetAllCalls();
+
+        ///act
+        int nResult = BUFFER_append(g_hBuffer, hAppend);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), TOTAL_BUFFER, TOTAL_ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(size_t, ALLOCATION_SIZE, BUFFER_length(hShared));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hShared), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+
+        ///cleanup
+        BUFFER_delete(hShared);
+        BUFFER_delete(hAppend);
+        BUFFER_delete(g_hBuffer);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(BUFFER_build_on_a_share_does_not_touch_the_shared_bytes)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        auto hShared = BUFFER_share(g_hBuffer);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, ALLOCATION_SIZE));
+
+        ///act
+        int nResult = BUFFER_build(hShared, ADDITIONAL_BUFFER, ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        mocks.AssertActualAndExpectedCalls();
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(hShared), ADDITIONAL_BUFFER, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+
+        ///cleanup
+        BUFFER_delete(hShared);
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_delete_of_the_source_keeps_the_bytes_for_the_slice)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        auto hSlice = BUFFER_slice(g_hBuffer, 4, 8);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        BUFFER_delete(g_hBuffer);
+
+        ///assert
+        mocks.AssertActualAndExpectedCalls();
+        const unsigned char* content;
+        (void)BUFFER_content(hSlice, &content);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(content, BUFFER_TEST_VALUE + 4, 8));
+
+        ///cleanup
+        BUFFER_delete(hSlice);
+    }
+
+    TEST_FUNCTION(BUFFER_delete_of_the_last_sharing_buffer_frees_the_bytes)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        auto hSlice = BUFFER_slice(g_hBuffer, 4, 8);
+        BUFFER_delete(g_hBuffer);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*the bytes*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*the shared storage*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*the handle*/
+            .IgnoreArgument(1);
+
+        ///act
+        BUFFER_delete(hSlice);
+
+        ///assert
+        mocks.AssertActualAndExpectedCalls();
+    }
+
+    TEST_FUNCTION(BUFFER_enlarge_of_the_last_sharing_buffer_takes_the_bytes_back_without_copying)
+    {
+        ///arrange
+        CMocks mocks;
+        BUFFER_HANDLE g_hBuffer = BUFFER_create(BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        auto hShared = BUFFER_share(g_hBuffer);
+        BUFFER_delete(hShared);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*the shared storage*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * ALLOCATION_SIZE))
+            .IgnoreArgument(1);
+
+        ///act
+        int nResult = BUFFER_enlarge(g_hBuffer, ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        mocks.AssertActualAndExpectedCalls();
+        ASSERT_ARE_EQUAL(int, 0, memcmp(BUFFER_u_char(g_hBuffer), BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+
+        ///cleanup
+        BUFFER_delete(g_hBuffer);
+    }
+
+    TEST_FUNCTION(BUFFER_slice_of_a_buffer_in_an_arena_outlives_the_arena_buffer_handle)
+    {
+        ///arrange
+        CMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto hBuffer = BUFFER_create_in_arena(arena, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        auto hSlice = BUFFER_slice(hBuffer, 4, 8);
+        BUFFER_delete(hBuffer);
+
+        ///act
+        unsigned char* content = BUFFER_u_char(hSlice);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(content);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(content, BUFFER_TEST_VALUE + 4, 8));
+
+        ///cleanup
+        ARENA_destroy(arena);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(content, BUFFER_TEST_VALUE + 4, 8));
+        BUFFER_delete(hSlice);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(BUFFER_POOL_create_with_0_buffers_fails)
+    {
+        ///arrange
+        CMocks mocks;
+
+        ///act
+        auto res = BUFFER_POOL_create(0, ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        mocks.AssertActualAndExpectedCalls();
+    }
+
+    TEST_FUNCTION(BUFFER_POOL_create_allocates_the_buffers_upfront)
+    {
+        ///arrange
+        CMocks mocks;
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the pool*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the buffers*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the free list*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(ALLOCATION_SIZE));
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(ALLOCATION_SIZE));
+
+        ///act
+        auto res = BUFFER_POOL_create(2, ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(res);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_POOL_destroy(res);
+    }
+
+    TEST_FUNCTION(BUFFER_POOL_create_when_allocating_a_buffer_fails_frees_everything)
+    {
+        ///arrange
+        CMocks mocks;
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(ALLOCATION_SIZE));
+        whenShallmalloc_fail = 5;
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(ALLOCATION_SIZE));
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        auto res = BUFFER_POOL_create(2, ALLOCATION_SIZE);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        mocks.AssertActualAndExpectedCalls();
+    }
+
+    TEST_FUNCTION(BUFFER_POOL_acquire_with_NULL_pool_fails)
+    {
+        ///arrange
+        CMocks mocks;
+
+        ///act
+        auto res = BUFFER_POOL_acquire(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(res);
+        mocks.AssertActualAndExpectedCalls();
+    }
+
+    TEST_FUNCTION(BUFFER_POOL_acquire_returns_an_empty_buffer_with_room_for_the_buffer_size)
+    {
+        ///arrange
+        CMocks mocks;
+        auto pool = BUFFER_POOL_create(2, TOTAL_ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        ///act
+        auto res = BUFFER_POOL_acquire(pool);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(res);
+        ASSERT_ARE_EQUAL(size_t, 0, BUFFER_length(res));
+        ASSERT_ARE_EQUAL(int, 0, BUFFER_build(res, BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+        ASSERT_ARE_EQUAL(int, 0, BUFFER_enlarge(res, ALLOCATION_SIZE));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(res);
+        BUFFER_POOL_destroy(pool);
+    }
+
+    TEST_FUNCTION(BUFFER_delete_of_a_pooled_buffer_gives_it_back_to_the_pool)
+    {
+        ///arrange
+        CMocks mocks;
+        auto pool = BUFFER_POOL_create(1, ALLOCATION_SIZE);
+        auto hBuffer = BUFFER_POOL_acquire(pool);
+        (void)BUFFER_build(hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        ///act
+        BUFFER_delete(hBuffer);
+        auto res = BUFFER_POOL_acquire(pool);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, (void*)hBuffer, (void*)res);
+        ASSERT_ARE_EQUAL(size_t, 0, BUFFER_length(res));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(res);
+        BUFFER_POOL_destroy(pool);
+    }
+
+    TEST_FUNCTION(BUFFER_POOL_acquire_hands_out_every_buffer_once)
+    {
+        ///arrange
+        CMocks mocks;
+        auto pool = BUFFER_POOL_create(3, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        ///act
+        auto res1 = BUFFER_POOL_acquire(pool);
+        auto res2 = BUFFER_POOL_acquire(pool);
+        auto res3 = BUFFER_POOL_acquire(pool);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(res1);
+        ASSERT_IS_NOT_NULL(res2);
+        ASSERT_IS_NOT_NULL(res3);
+        ASSERT_ARE_NOT_EQUAL(void_ptr, (void*)res1, (void*)res2);
+        ASSERT_ARE_NOT_EQUAL(void_ptr, (void*)res1, (void*)res3);
+        ASSERT_ARE_NOT_EQUAL(void_ptr, (void*)res2, (void*)res3);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(res3);
+        BUFFER_delete(res2);
+        BUFFER_delete(res1);
+        BUFFER_POOL_destroy(pool);
+    }
+
+    TEST_FUNCTION(BUFFER_POOL_acquire_of_an_exhausted_pool_returns_a_heap_buffer)
+    {
+        ///arrange
+        CMocks mocks;
+        auto pool = BUFFER_POOL_create(1, ALLOCATION_SIZE);
+        auto hBuffer = BUFFER_POOL_acquire(pool);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, ALLOCATION_SIZE));
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        auto res = BUFFER_POOL_acquire(pool);
+        BUFFER_delete(res);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(res);
+        ASSERT_ARE_NOT_EQUAL(void_ptr, (void*)hBuffer, (void*)res);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(hBuffer);
+        BUFFER_POOL_destroy(pool);
+    }
+
+    TEST_FUNCTION(BUFFER_delete_of_a_grown_pooled_buffer_shrinks_it_back_to_the_buffer_size)
+    {
+        ///arrange
+        CMocks mocks;
+        auto pool = BUFFER_POOL_create(1, ALLOCATION_SIZE);
+        auto hBuffer = BUFFER_POOL_acquire(pool);
+        (void)BUFFER_build(hBuffer, TOTAL_BUFFER, TOTAL_ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, ALLOCATION_SIZE))
+            .IgnoreArgument(1);
+
+        ///act
+        BUFFER_delete(hBuffer);
+
+        ///assert
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_POOL_destroy(pool);
+    }
+
+    TEST_FUNCTION(BUFFER_POOL_acquire_of_a_buffer_that_gave_its_storage_back_reserves_it_again)
+    {
+        ///arrange
+        CMocks mocks;
+        auto pool = BUFFER_POOL_create(1, ALLOCATION_SIZE);
+        auto hBuffer = BUFFER_POOL_acquire(pool);
+        (void)BUFFER_shrink_to_fit(hBuffer);
+        BUFFER_delete(hBuffer);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, ALLOCATION_SIZE));
+
+        ///act
+        auto res = BUFFER_POOL_acquire(pool);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, (void*)hBuffer, (void*)res);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        BUFFER_delete(res);
+        BUFFER_POOL_destroy(pool);
+    }
+
+    TEST_FUNCTION(BUFFER_delete_of_a_pooled_buffer_that_is_shared_keeps_the_bytes_for_the_share)
+    {
+        ///arrange
+        CMocks mocks;
+        auto pool = BUFFER_POOL_create(1, ALLOCATION_SIZE);
+        auto hBuffer = BUFFER_POOL_acquire(pool);
+        (void)BUFFER_build(hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        auto hShared = BUFFER_share(hBuffer);
+
+        ///act
+        BUFFER_delete(hBuffer);
+        auto res = BUFFER_POOL_acquire(pool);
+        (void)BUFFER_build(res, ADDITIONAL_BUFFER, ALLOCATION_SIZE);
+
+        ///assert
+        const unsigned char* content;
+        (void)BUFFER_content(hShared, &content);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(content, BUFFER_TEST_VALUE, ALLOCATION_SIZE));
+
+        ///cleanup
+        BUFFER_delete(hShared);
+        BUFFER_delete(res);
+        BUFFER_POOL_destroy(pool);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(BUFFER_delete_of_a_pooled_buffer_of_a_pool_of_0_byte_buffers_frees_the_bytes)
+    {
+        ///arrange
+        CMocks mocks;
+        auto pool = BUFFER_POOL_create(1, 0);
+        auto hBuffer = BUFFER_POOL_acquire(pool);
+        (void)BUFFER_build(hBuffer, BUFFER_TEST_VALUE, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        BUFFER_delete(hBuffer);
+
+        ///assert
+        mocks.AssertActualAndExpectedCalls();
+        auto res = BUFFER_POOL_acquire(pool);
+        ASSERT_ARE_EQUAL(void_ptr, (void*)hBuffer, (void*)res);
+        ASSERT_ARE_EQUAL(size_t, 0, BUFFER_length(res));
+
+        ///cleanup
+        BUFFER_delete(res);
+        BUFFER_POOL_destroy(pool);
+    }
+
+    TEST_FUNCTION(BUFFER_POOL_destroy_frees_the_buffers)
+    {
+        ///arrange
+        CMocks mocks;
+        auto pool = BUFFER_POOL_create(2, ALLOCATION_SIZE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        BUFFER_POOL_destroy(pool);
+
+        ///assert
+        mocks.AssertActualAndExpectedCalls();
+    }
+
 END_TEST_SUITE(Buffer_UnitTests)
\ No newline at end of file
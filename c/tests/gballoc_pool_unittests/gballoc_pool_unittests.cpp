@@ -0,0 +1,430 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "micromock.h"
+
+#define GB_POOL_ALLOC
+#include "gballoc.h"
+#include "strings.h"
+#include "crt_abstractions.h"
+
+#ifndef SIZE_MAX
+#define SIZE_MAX ((size_t)~(size_t)0)
+#endif
+
+static MICROMOCK_MUTEX_HANDLE g_testByTest;
+static MICROMOCK_GLOBAL_SEMAPHORE_HANDLE g_dllByDll;
+
+BEGIN_TEST_SUITE(GBAllocPool_UnitTests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = MicroMockCreateMutex();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    MicroMockDestroyMutex(g_testByTest);
+    DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (!MicroMockAcquireMutex(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    if (!MicroMockReleaseMutex(g_testByTest))
+    {
+        ASSERT_FAIL("failure in test framework at ReleaseMutex");
+    }
+}
+
+/* gballoc_pool_malloc */
+
+TEST_FUNCTION(gballoc_pool_malloc_of_a_small_block_returns_usable_aligned_memory)
+{
+    // arrange
+
+    // act
+    unsigned char* result = (unsigned char*)gballoc_pool_malloc(10);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, ((size_t)(uintptr_t)result) % sizeof(void*));
+    (void)memset(result, 0x42, 10);
+
+    // cleanup
+    gballoc_pool_free(result);
+}
+
+TEST_FUNCTION(gballoc_pool_malloc_with_0_size_returns_a_block)
+{
+    // arrange
+
+    // act
+    void* result = gballoc_pool_malloc(0);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+
+    // cleanup
+    gballoc_pool_free(result);
+}
+
+TEST_FUNCTION(gballoc_pool_malloc_of_a_large_block_returns_usable_memory)
+{
+    // arrange
+
+    // act
+    unsigned char* result = (unsigned char*)gballoc_pool_malloc(100000);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    (void)memset(result, 0x42, 100000);
+
+    // cleanup
+    gballoc_pool_free(result);
+}
+
+TEST_FUNCTION(gballoc_pool_malloc_reuses_a_block_freed_by_the_same_thread)
+{
+    // arrange
+    void* first = gballoc_pool_malloc(20);
+    gballoc_pool_free(first);
+
+    // act
+    void* result = gballoc_pool_malloc(24);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, first, result);
+
+    // cleanup
+    gballoc_pool_free(result);
+}
+
+TEST_FUNCTION(gballoc_pool_malloc_hands_out_distinct_blocks)
+{
+    // arrange
+    void* blocks[1000];
+    size_t i;
+
+    // act
+    for (i = 0; i < 1000; i++)
+    {
+        blocks[i] = gballoc_pool_malloc(32);
+        ASSERT_IS_NOT_NULL(blocks[i]);
+        (void)memset(blocks[i], (int)(i & 0xFF), 32);
+    }
+
+    // assert
+    for (i = 0; i < 1000; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)(i & 0xFF), ((unsigned char*)blocks[i])[0]);
+        ASSERT_ARE_EQUAL(int, (int)(i & 0xFF), ((unsigned char*)blocks[i])[31]);
+    }
+
+    // cleanup
+    for (i = 0; i < 1000; i++)
+    {
+        gballoc_pool_free(blocks[i]);
+    }
+}
+
+/* gballoc_pool_calloc */
+
+TEST_FUNCTION(gballoc_pool_calloc_returns_zeroed_memory)
+{
+    // arrange
+    unsigned char* dirty = (unsigned char*)gballoc_pool_malloc(40);
+    (void)memset(dirty, 0xFF, 40);
+    gballoc_pool_free(dirty);
+    size_t i;
+
+    // act
+    unsigned char* result = (unsigned char*)gballoc_pool_calloc(4, 10);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    for (i = 0; i < 40; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, result[i]);
+    }
+
+    // cleanup
+    gballoc_pool_free(result);
+}
+
+TEST_FUNCTION(gballoc_pool_calloc_with_an_overflowing_size_fails)
+{
+    // arrange
+
+    // act
+    void* result = gballoc_pool_calloc(SIZE_MAX / 2, 4);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+/* gballoc_pool_realloc */
+
+TEST_FUNCTION(gballoc_pool_realloc_with_NULL_allocates)
+{
+    // arrange
+
+    // act
+    void* result = gballoc_pool_realloc(NULL, 8);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+
+    // cleanup
+    gballoc_pool_free(result);
+}
+
+TEST_FUNCTION(gballoc_pool_realloc_within_the_size_class_keeps_the_block)
+{
+    // arrange
+    void* block = gballoc_pool_malloc(17);
+
+    // act
+    void* result = gballoc_pool_realloc(block, 30);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, block, result);
+
+    // cleanup
+    gballoc_pool_free(result);
+}
+
+TEST_FUNCTION(gballoc_pool_realloc_to_a_bigger_class_keeps_the_content)
+{
+    // arrange
+    char* block = (char*)gballoc_pool_malloc(6);
+    (void)memcpy(block, "abcde", 6);
+
+    // act
+    char* result = (char*)gballoc_pool_realloc(block, 200);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, "abcde", result);
+
+    // cleanup
+    gballoc_pool_free(result);
+}
+
+TEST_FUNCTION(gballoc_pool_realloc_from_a_small_to_a_large_block_keeps_the_content)
+{
+    // arrange
+    char* block = (char*)gballoc_pool_malloc(6);
+    (void)memcpy(block, "abcde", 6);
+
+    // act
+    char* result = (char*)gballoc_pool_realloc(block, 5000);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, "abcde", result);
+    (void)memset(result + 6, 0, 5000 - 6);
+
+    // cleanup
+    gballoc_pool_free(result);
+}
+
+TEST_FUNCTION(gballoc_pool_realloc_of_a_large_block_keeps_the_content)
+{
+    // arrange
+    char* block = (char*)gballoc_pool_malloc(1000);
+    (void)memcpy(block, "abcde", 6);
+
+    // act
+    char* result = (char*)gballoc_pool_realloc(block, 100000);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, "abcde", result);
+
+    // cleanup
+    gballoc_pool_free(result);
+}
+
+/* gballoc_pool_free */
+
+TEST_FUNCTION(gballoc_pool_free_with_NULL_does_nothing)
+{
+    // arrange
+
+    // act
+    gballoc_pool_free(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(gballoc_pool_free_releases_a_block_that_came_from_the_CRT)
+{
+    // arrange
+    char* block = (char*)malloc(10);
+    ASSERT_IS_NOT_NULL(block);
+
+    // act
+    gballoc_pool_free(block);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(gballoc_pool_free_recognizes_the_blocks_of_many_slabs)
+{
+    // arrange
+    /*enough 256 byte blocks for the slabs to outgrow the first slab set*/
+    const size_t blockCount = 20000;
+    void** blocks = (void**)malloc(blockCount * sizeof(void*));
+    ASSERT_IS_NOT_NULL(blocks);
+    size_t i;
+    for (i = 0; i < blockCount; i++)
+    {
+        blocks[i] = gballoc_pool_malloc(256);
+        ASSERT_IS_NOT_NULL(blocks[i]);
+    }
+
+    // act
+    for (i = 0; i < blockCount; i++)
+    {
+        gballoc_pool_free(blocks[i]);
+    }
+
+    // assert
+    /*the blocks went back to the pool, not to the CRT: they are handed out again*/
+    void* block = gballoc_pool_malloc(256);
+    bool found = false;
+    for (i = 0; (i < blockCount) && !found; i++)
+    {
+        found = (blocks[i] == block);
+    }
+    ASSERT_IS_TRUE(found);
+
+    // cleanup
+    gballoc_pool_free(block);
+    free(blocks);
+}
+
+TEST_FUNCTION(gballoc_pool_free_of_a_large_block_can_be_done_by_the_CRT)
+{
+    // arrange
+    void* block = gballoc_pool_malloc(1000);
+    ASSERT_IS_NOT_NULL(block);
+
+    // act
+    free(block);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(gballoc_pool_realloc_of_a_block_that_came_from_the_CRT_keeps_the_content)
+{
+    // arrange
+    char* block = (char*)malloc(6);
+    ASSERT_IS_NOT_NULL(block);
+    (void)memcpy(block, "abcde", 6);
+
+    // act
+    char* result = (char*)gballoc_pool_realloc(block, 100);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, "abcde", result);
+
+    // cleanup
+    free(result);
+}
+
+/* gballoc_pool_crt_malloc */
+
+TEST_FUNCTION(gballoc_pool_crt_malloc_returns_memory_the_CRT_can_release)
+{
+    // arrange
+
+    // act
+    void* result = gballoc_pool_crt_malloc(10);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    (void)memset(result, 0, 10);
+
+    // cleanup
+    free(result);
+}
+
+/* memory crossing the API of translation units built with GB_POOL_ALLOC and GB_MEASURE_MEMORY_FOR_THIS */
+
+TEST_FUNCTION(STRING_new_with_memory_takes_CRT_memory_that_STRING_concat_and_STRING_delete_handle)
+{
+    // arrange
+    char* memory = (char*)malloc(6);
+    ASSERT_IS_NOT_NULL(memory);
+    (void)memcpy(memory, "abcde", 6);
+    STRING_HANDLE handle = STRING_new_with_memory(memory);
+    ASSERT_IS_NOT_NULL(handle);
+
+    // act
+    int result = STRING_concat(handle, "fghij");
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, "abcdefghij", STRING_c_str(handle));
+
+    // cleanup
+    STRING_delete(handle);
+}
+
+TEST_FUNCTION(mallocAndStrcpy_s_returns_memory_the_CRT_can_release)
+{
+    // arrange
+    char* destination = NULL;
+
+    // act
+    int result = mallocAndStrcpy_s(&destination, "abcde");
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, "abcde", destination);
+
+    // cleanup
+    free(destination);
+}
+
+TEST_FUNCTION(mallocAndStrcpy_s_output_round_trips_through_STRING_new_with_memory)
+{
+    // arrange
+    char* destination = NULL;
+    ASSERT_ARE_EQUAL(int, 0, mallocAndStrcpy_s(&destination, "abcde"));
+
+    // act
+    STRING_HANDLE handle = STRING_new_with_memory(destination);
+
+    // assert
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, "abcde", STRING_c_str(handle));
+
+    // cleanup
+    STRING_delete(handle);
+}
+
+END_TEST_SUITE(GBAllocPool_UnitTests)
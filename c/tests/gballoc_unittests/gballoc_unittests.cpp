@@ -26,6 +26,13 @@ static void* TEST_ALLOC_PTR2 = (void*)0x4243;
 #define OVERHEAD_SIZE	4096
 static const LOCK_HANDLE TEST_LOCK_HANDLE = (LOCK_HANDLE)0x4244;
 
+/* gballoc creates one lock per shard, this has to match GBALLOC_LOCK_SHARD_COUNT in gballoc.c */
+#define TEST_LOCK_SHARD_COUNT 16
+/* plus the lock of the allocation site table */
+#define TEST_LOCK_COUNT (TEST_LOCK_SHARD_COUNT + 1)
+
+static const char* TEST_FILE = "test_file.c";
+
 TYPED_MOCK_CLASS(CGBAllocMocks, CGlobalMock)
 {
 public:
@@ -137,7 +144,8 @@ TEST_FUNCTION(when_gballoc_init_calls_lock_init_and_it_succeeds_then_gballoc_ini
 {
     // arrange
     CGBAllocMocks mocks;
-    STRICT_EXPECTED_CALL(mocks, Lock_Init());
+    STRICT_EXPECTED_CALL(mocks, Lock_Init())
+        .ExpectedTimesExactly(TEST_LOCK_COUNT);
 
     // act
     int result = gballoc_init();
@@ -161,12 +169,56 @@ TEST_FUNCTION(when_lock_init_fails_gballoc_init_fails)
     ASSERT_ARE_NOT_EQUAL(int, 0, result);
 }
 
+/* Tests_SRS_GBALLOC_01_027: [If the Lock creation fails, gballoc_init shall return a non-zero value.] */
+TEST_FUNCTION(when_creating_the_second_lock_fails_gballoc_init_frees_the_first_lock_and_fails)
+{
+    // arrange
+    CGBAllocMocks mocks;
+    STRICT_EXPECTED_CALL(mocks, Lock_Init());
+    STRICT_EXPECTED_CALL(mocks, Lock_Init())
+        .SetReturn((LOCK_HANDLE)NULL);
+    STRICT_EXPECTED_CALL(mocks, Lock_Deinit(TEST_LOCK_HANDLE));
+
+    // act
+    int result = gballoc_init();
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    mocks.AssertActualAndExpectedCalls();
+    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, gballoc_getCurrentMemoryUsed());
+}
+
+/* Tests_SRS_GBALLOC_01_027: [If the Lock creation fails, gballoc_init shall return a non-zero value.] */
+TEST_FUNCTION(when_creating_the_allocation_site_lock_fails_gballoc_init_frees_the_shard_locks_and_fails)
+{
+    // arrange
+    CGBAllocMocks mocks;
+    size_t i;
+    for (i = 0; i < TEST_LOCK_SHARD_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(mocks, Lock_Init());
+    }
+    STRICT_EXPECTED_CALL(mocks, Lock_Init())
+        .SetReturn((LOCK_HANDLE)NULL);
+    STRICT_EXPECTED_CALL(mocks, Lock_Deinit(TEST_LOCK_HANDLE))
+        .ExpectedTimesExactly(TEST_LOCK_SHARD_COUNT);
+
+    // act
+    int result = gballoc_init();
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    mocks.AssertActualAndExpectedCalls();
+    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, gballoc_getCurrentMemoryUsed());
+}
+
 /* Tests_SRS_GBALLOC_01_025: [Init after Init shall fail and return a non-zero value.] */
 TEST_FUNCTION(gballoc_init_after_gballoc_init_fails)
 {
     // arrange
     CGBAllocMocks mocks;
-    STRICT_EXPECTED_CALL(mocks, Lock_Init());
+    STRICT_EXPECTED_CALL(mocks, Lock_Init())
+        .ExpectedTimesExactly(TEST_LOCK_COUNT);
     gballoc_init();
 
     //act
@@ -186,7 +238,8 @@ TEST_FUNCTION(gballoc_deinit_frees_the_lock_when_the_module_was_initialized)
     gballoc_init();
     mocks.ResetAllCalls();
 
-    STRICT_EXPECTED_CALL(mocks, Lock_Deinit(TEST_LOCK_HANDLE));
+    STRICT_EXPECTED_CALL(mocks, Lock_Deinit(TEST_LOCK_HANDLE))
+        .ExpectedTimesExactly(TEST_LOCK_COUNT);
 
     // act
     gballoc_deinit();
@@ -217,15 +270,26 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_malloc_fails)
     CGBAllocMocks mocks;
     gballoc_init();
     mocks.ResetAllCalls();
+    void* allocation = malloc(OVERHEAD_SIZE);
 
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(mocks, mock_malloc(1));
     STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE))
         .SetReturn(LOCK_ERROR);
+    STRICT_EXPECTED_CALL(mocks, mock_free(TEST_ALLOC_PTR1));
+    STRICT_EXPECTED_CALL(mocks, mock_free(allocation));
 
     // act
     void* result = gballoc_malloc(1);
 
     // assert
     ASSERT_IS_NULL(result);
+    mocks.AssertActualAndExpectedCalls();
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    free(allocation);
 }
 
 /* Tests_SRS_GBALLOC_01_003: [gballoc_malloc shall call the C99 malloc function and return its result.] */
@@ -300,7 +364,6 @@ TEST_FUNCTION(When_malloc_Fails_Then_gballoc_malloc_fails_too)
     mocks.ResetAllCalls();
     void* allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mocks, mock_malloc(0))
         .SetReturn(allocation);
@@ -308,7 +371,6 @@ TEST_FUNCTION(When_malloc_Fails_Then_gballoc_malloc_fails_too)
     STRICT_EXPECTED_CALL(mocks, mock_malloc(1))
         .SetReturn((void*)NULL);
     STRICT_EXPECTED_CALL(mocks, mock_free(allocation));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     void* result = gballoc_malloc(1);
@@ -330,11 +392,9 @@ TEST_FUNCTION(When_allocating_memory_for_tracking_information_fails_Then_gballoc
     gballoc_init();
     mocks.ResetAllCalls();
 
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mocks, mock_malloc(0))
         .SetReturn((void*)NULL);
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     void* result = gballoc_malloc(1);
@@ -369,15 +429,26 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_calloc_fails)
     CGBAllocMocks mocks;
     gballoc_init();
     mocks.ResetAllCalls();
+    void* allocation = malloc(OVERHEAD_SIZE);
 
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(mocks, mock_calloc(1, 1));
     STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE))
-    .SetReturn(LOCK_ERROR);
+        .SetReturn(LOCK_ERROR);
+    STRICT_EXPECTED_CALL(mocks, mock_free(TEST_ALLOC_PTR1));
+    STRICT_EXPECTED_CALL(mocks, mock_free(allocation));
 
     // act
     void* result = gballoc_calloc(1,1);
 
     // assert
     ASSERT_IS_NULL(result);
+    mocks.AssertActualAndExpectedCalls();
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    free(allocation);
 }
 
 /* Tests_SRS_GBALLOC_01_020: [gballoc_calloc shall call the C99 calloc function and return its result.] */
@@ -545,7 +616,6 @@ TEST_FUNCTION(When_calloc_Fails_Then_gballoc_calloc_fails_too)
     mocks.ResetAllCalls();
     void* allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mocks, mock_malloc(0))
         .SetReturn(allocation);
@@ -553,7 +623,6 @@ TEST_FUNCTION(When_calloc_Fails_Then_gballoc_calloc_fails_too)
     STRICT_EXPECTED_CALL(mocks, mock_calloc(1, 1))
         .SetReturn((void*)NULL);
     STRICT_EXPECTED_CALL(mocks, mock_free(allocation));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     void* result = gballoc_calloc(1, 1);
@@ -575,11 +644,9 @@ TEST_FUNCTION(When_allocating_memory_for_tracking_information_fails_Then_gballoc
     gballoc_init();
     mocks.ResetAllCalls();
 
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mocks, mock_malloc(0))
         .SetReturn((void*)NULL);
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     void* result = gballoc_calloc(1, 1);
@@ -615,15 +682,56 @@ TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_realloc_fails)
     CGBAllocMocks mocks;
     gballoc_init();
     mocks.ResetAllCalls();
+    void* allocation = malloc(OVERHEAD_SIZE);
 
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(mocks, mock_realloc(NULL, 1));
     STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE))
         .SetReturn(LOCK_ERROR);
+    STRICT_EXPECTED_CALL(mocks, mock_free(TEST_ALLOC_PTR1));
+    STRICT_EXPECTED_CALL(mocks, mock_free(allocation));
 
     // act
     void* result = gballoc_realloc(NULL, 1);
 
     // assert
     ASSERT_IS_NULL(result);
+    mocks.AssertActualAndExpectedCalls();
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    free(allocation);
+}
+
+/* Tests_SRS_GBALLOC_01_047: [If acquiring the lock fails, gballoc_realloc shall return NULL.]*/
+TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_realloc_of_a_tracked_block_fails)
+{
+    // arrange
+    CGBAllocMocks mocks;
+    gballoc_init();
+    mocks.ResetAllCalls();
+    void* allocation = malloc(OVERHEAD_SIZE);
+
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation);
+    void* block = gballoc_malloc(1);
+    mocks.ResetAllCalls();
+
+    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE))
+        .SetReturn(LOCK_ERROR);
+
+    // act
+    void* result = gballoc_realloc(block, 2);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    mocks.AssertActualAndExpectedCalls();
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    gballoc_free(block);
+    free(allocation);
 }
 
 /* Tests_SRS_GBALLOC_01_041: [If gballoc was not initialized gballoc_realloc shall shall simply call realloc without any memory tracking being performed.] */
@@ -771,6 +879,8 @@ TEST_FUNCTION(When_realloc_fails_then_gballoc_realloc_Fails_Too_And_No_Change_Is
     ASSERT_IS_NULL(result);
     mocks.AssertActualAndExpectedCalls();
     ASSERT_ARE_EQUAL(size_t, 1, gballoc_getMaximumMemoryUsed());
+    /* the block is still tracked */
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getCurrentMemoryUsed());
 
     // cleanup
     gballoc_free(TEST_ALLOC_PTR1);
@@ -785,11 +895,9 @@ TEST_FUNCTION(When_Allocating_Memory_For_tracking_fails_gballoc_realloc_fails)
     gballoc_init();
     mocks.ResetAllCalls();
 
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mocks, mock_malloc(0))
         .SetReturn((void*)NULL);
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     void* result = gballoc_realloc(NULL, 1);
@@ -843,7 +951,6 @@ TEST_FUNCTION(When_ptr_is_null_and_the_underlying_realloc_fails_then_the_memory_
     mocks.ResetAllCalls();
     void* allocation = malloc(OVERHEAD_SIZE);
 
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
     /* don't quite like this, but I'm unsure I want to invest more in this memory counting */
     EXPECTED_CALL(mocks, mock_malloc(0))
         .SetReturn(allocation);
@@ -851,7 +958,6 @@ TEST_FUNCTION(When_ptr_is_null_and_the_underlying_realloc_fails_then_the_memory_
     STRICT_EXPECTED_CALL(mocks, mock_realloc(NULL, 1))
         .SetReturn((void*)NULL);
     STRICT_EXPECTED_CALL(mocks, mock_free(allocation));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     void* result = gballoc_realloc(NULL, 1);
@@ -1022,42 +1128,56 @@ TEST_FUNCTION(gballoc_free_with_an_untracked_pointer_does_not_alter_total_memory
     free(allocation);
 }
 
-/* gballoc_getMaximumMemoryUsed */
-
-
-/* Tests_SRS_GBALLOC_01_034: [gballoc_getMaximumMemoryUsed shall ensure thread safety by using the lock created by gballoc_Init.] */
-TEST_FUNCTION(when_gballoc_getMaximumMemoryUsed_called_It_Shall_Lock_And_Unlock)
+/* Tests_SRS_GBALLOC_01_019:[When the ptr pointer cannot be found in the pointers tracked by gballoc, gballoc_free shall not free any memory.] */
+TEST_FUNCTION(gballoc_free_with_the_old_pointer_after_a_moving_realloc_does_not_alter_total_memory_used)
 {
     // arrange
     CGBAllocMocks mocks;
     gballoc_init();
+    void* allocation = malloc(OVERHEAD_SIZE);
+
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation);
+    STRICT_EXPECTED_CALL(mocks, mock_malloc(1));
+    STRICT_EXPECTED_CALL(mocks, mock_realloc(TEST_ALLOC_PTR1, 3))
+        .SetReturn(TEST_ALLOC_PTR2);
+
+    void* block = gballoc_malloc(1);
+    block = gballoc_realloc(block, 3);
     mocks.ResetAllCalls();
 
     STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
     STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
+
     // act
-    (void)gballoc_getMaximumMemoryUsed();
+    gballoc_free(TEST_ALLOC_PTR1);
 
     // assert
-    // no explicit assert, uMock checks the calls
+    mocks.AssertActualAndExpectedCalls();
+    ASSERT_ARE_EQUAL(size_t, 3, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    gballoc_free(block);
+    free(allocation);
 }
 
-/* Tests_SRS_GBALLOC_01_050: [If the lock cannot be acquired, gballoc_getMaximumMemoryUsed shall return SIZE_MAX.] */
-TEST_FUNCTION(when_acquiring_the_lock_fails_then_gballoc_getMaximumMemoryUsed_fails)
+/* gballoc_getMaximumMemoryUsed */
+
+
+/* the maximum is read atomically, without taking any of the allocation locks */
+TEST_FUNCTION(gballoc_getMaximumMemoryUsed_does_not_lock)
 {
     // arrange
     CGBAllocMocks mocks;
     gballoc_init();
     mocks.ResetAllCalls();
 
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE))
-        .SetReturn(LOCK_ERROR);
-
     // act
     size_t result = gballoc_getMaximumMemoryUsed();
 
     // assert
-    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, result);
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+    mocks.AssertActualAndExpectedCalls();
 }
 
 /* Tests_SRS_GBALLOC_01_038: [If gballoc was not initialized gballoc_getMaximumMemoryUsed shall return MAX_INT_SIZE.]  */
@@ -1090,8 +1210,6 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_returns_1)
     STRICT_EXPECTED_CALL(mocks, mock_malloc(1));
     void *toBeFreed = gballoc_malloc(1);
     mocks.ResetAllCalls();
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     size_t result = gballoc_getCurrentMemoryUsed();
@@ -1117,8 +1235,6 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_2x3_byte_calloc_returns_6)
         .SetReturn(allocation);
     void *toBeFreed = gballoc_calloc(2, 3);
     mocks.ResetAllCalls();
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     size_t result = gballoc_getCurrentMemoryUsed();
@@ -1148,8 +1264,6 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_3_bytes_reall
     void *toBeFreed = gballoc_malloc(1);
     toBeFreed = gballoc_realloc(toBeFreed, 3);
     mocks.ResetAllCalls();
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     size_t result = gballoc_getCurrentMemoryUsed();
@@ -1178,8 +1292,6 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_free_returns_
     void *toBeFreed = gballoc_malloc(1);
     gballoc_free(toBeFreed);
     mocks.ResetAllCalls();
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     size_t result = gballoc_getCurrentMemoryUsed();
@@ -1206,8 +1318,6 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_2x3_byte_calloc_and_free_return
     void *toBeFreed = gballoc_calloc(2, 3);
     gballoc_free(toBeFreed);
     mocks.ResetAllCalls();
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     size_t result = gballoc_getCurrentMemoryUsed();
@@ -1236,8 +1346,6 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_realloc_and_free_returns_0)
     toBeFreed = gballoc_realloc(toBeFreed, 3);
     gballoc_free(toBeFreed);
     mocks.ResetAllCalls();
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     size_t result = gballoc_getCurrentMemoryUsed();
@@ -1270,8 +1378,6 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
     void *toBeFreed1 = gballoc_malloc(1);
     void *toBeFreed2 = gballoc_malloc(1);
     mocks.ResetAllCalls();
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     size_t result = gballoc_getCurrentMemoryUsed();
@@ -1309,8 +1415,6 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
     void *toBeFreed2 = gballoc_malloc(1);
     toBeFreed2 = gballoc_realloc(toBeFreed2, 3);
     mocks.ResetAllCalls();
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     size_t result = gballoc_getCurrentMemoryUsed();
@@ -1346,8 +1450,6 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_6_byte_calloc
     void *toBeFreed1 = gballoc_malloc(1);
     void *toBeFreed2 = gballoc_calloc(2, 3);
     mocks.ResetAllCalls();
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     size_t result = gballoc_getCurrentMemoryUsed();
@@ -1385,8 +1487,6 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_6_byte_calloc
     void *toBeFreed2 = gballoc_calloc(2, 3);
     gballoc_free(toBeFreed1);
     mocks.ResetAllCalls();
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     size_t result = gballoc_getCurrentMemoryUsed();
@@ -1425,8 +1525,6 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
     toBeFreed2 = gballoc_realloc(toBeFreed2, 3);
     gballoc_free(toBeFreed1);
     mocks.ResetAllCalls();
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
 
     // act
     size_t result = gballoc_getCurrentMemoryUsed();
@@ -1441,22 +1539,20 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_1_byte_malloc_and_1_byte_malloc
     mocks.ResetAllCalls(); //this is just for mathematics, not for functionality
 }
 
-/* Tests_SRS_GBALLOC_01_036: [gballoc_getCurrentMemoryUsed shall ensure thread safety by using the lock created by gballoc_Init.] */
-TEST_FUNCTION(gballoc_getCurrentMemoryUsed_locks_and_unlocks)
+/* the current usage is read atomically, without taking any of the allocation locks */
+TEST_FUNCTION(gballoc_getCurrentMemoryUsed_does_not_lock)
 {
-    // assert
+    // arrange
     CGBAllocMocks mocks;
     gballoc_init();
     mocks.ResetAllCalls();
 
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE));
-    STRICT_EXPECTED_CALL(mocks, Unlock(TEST_LOCK_HANDLE));
-
     // act
     size_t result = gballoc_getCurrentMemoryUsed();
 
     // assert
     ASSERT_ARE_EQUAL(size_t, 0, result);
+    mocks.AssertActualAndExpectedCalls();
 }
 
 /* Tests_SRS_GBALLOC_01_044: [If gballoc was not initialized gballoc_getCurrentMemoryUsed shall return SIZE_MAX.] */
@@ -1472,23 +1568,266 @@ TEST_FUNCTION(gballoc_getCurrentMemoryUsed_after_deinit_fails)
     ASSERT_ARE_EQUAL(size_t, SIZE_MAX, result);
 }
 
-/* Tests_SRS_GBALLOC_01_051: [If the lock cannot be acquired, gballoc_getCurrentMemoryUsed shall return SIZE_MAX.] */
-TEST_FUNCTION(when_acquiring_the_lock_fails_gballoc_getCurrentMemoryUsed_fails)
+/* gballoc_xxx_at */
+
+TEST_FUNCTION(gballoc_calloc_at_accounts_the_block_to_its_call_site)
 {
     // arrange
     CGBAllocMocks mocks;
+    mocks.SetPerformAutomaticCallComparison(AUTOMATIC_CALL_COMPARISON_OFF);
     gballoc_init();
-    mocks.ResetAllCalls();
+    void* allocation = malloc(OVERHEAD_SIZE);
+    void* site = malloc(OVERHEAD_SIZE);
+    GBALLOC_ALLOCATION_SITE sites[2];
 
-    STRICT_EXPECTED_CALL(mocks, Lock(TEST_LOCK_HANDLE))
-        .SetReturn(LOCK_ERROR);
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation);
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(site);
 
     // act
-    size_t result = gballoc_getCurrentMemoryUsed();
+    void* block = gballoc_calloc_at(2, 3, TEST_FILE, 42);
 
     // assert
-    ASSERT_ARE_EQUAL(size_t, SIZE_MAX, result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_ALLOC_PTR1, block);
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getAllocationSites(sites, 2));
+    ASSERT_ARE_EQUAL(char_ptr, TEST_FILE, sites[0].file);
+    ASSERT_ARE_EQUAL(int, 42, sites[0].line);
+    ASSERT_ARE_EQUAL(size_t, 6, sites[0].liveBytes);
+    ASSERT_ARE_EQUAL(size_t, 1, sites[0].liveCount);
+    ASSERT_ARE_EQUAL(size_t, 1, sites[0].totalCount);
 
+    // cleanup
+    gballoc_free(block);
+    gballoc_deinit();
+    free(allocation);
+    free(site);
+}
+
+TEST_FUNCTION(gballoc_free_takes_the_block_off_its_call_site)
+{
+    // arrange
+    CGBAllocMocks mocks;
+    mocks.SetPerformAutomaticCallComparison(AUTOMATIC_CALL_COMPARISON_OFF);
+    gballoc_init();
+    void* allocation = malloc(OVERHEAD_SIZE);
+    void* site = malloc(OVERHEAD_SIZE);
+    GBALLOC_ALLOCATION_SITE sites[1];
+
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation);
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(site);
+    void* block = gballoc_calloc_at(2, 3, TEST_FILE, 42);
+
+    // act
+    gballoc_free(block);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, gballoc_getAllocationSites(sites, 1));
+    ASSERT_ARE_EQUAL(size_t, 0, sites[0].liveBytes);
+    ASSERT_ARE_EQUAL(size_t, 0, sites[0].liveCount);
+    ASSERT_ARE_EQUAL(size_t, 1, sites[0].totalCount);
+
+    // cleanup
+    gballoc_deinit();
+    free(allocation);
+    free(site);
+}
+
+TEST_FUNCTION(gballoc_realloc_at_accounts_the_block_to_the_site_that_resized_it)
+{
+    // arrange
+    CGBAllocMocks mocks;
+    mocks.SetPerformAutomaticCallComparison(AUTOMATIC_CALL_COMPARISON_OFF);
+    gballoc_init();
+    void* allocation = malloc(OVERHEAD_SIZE);
+    void* site1 = malloc(OVERHEAD_SIZE);
+    void* site2 = malloc(OVERHEAD_SIZE);
+    GBALLOC_ALLOCATION_SITE sites[2];
+
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation);
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(site1);
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(site2);
+    void* block = gballoc_calloc_at(1, 1, TEST_FILE, 1);
+
+    // act
+    block = gballoc_realloc_at(block, 10, TEST_FILE, 2);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 2, gballoc_getAllocationSites(sites, 2));
+    ASSERT_ARE_EQUAL(int, 2, sites[0].line);
+    ASSERT_ARE_EQUAL(size_t, 10, sites[0].liveBytes);
+    ASSERT_ARE_EQUAL(int, 1, sites[1].line);
+    ASSERT_ARE_EQUAL(size_t, 0, sites[1].liveBytes);
+    ASSERT_ARE_EQUAL(size_t, 10, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    gballoc_free(block);
+    gballoc_deinit();
+    free(allocation);
+    free(site1);
+    free(site2);
+}
+
+TEST_FUNCTION(gballoc_getAllocationSites_returns_the_sites_holding_the_most_live_bytes_first)
+{
+    // arrange
+    CGBAllocMocks mocks;
+    mocks.SetPerformAutomaticCallComparison(AUTOMATIC_CALL_COMPARISON_OFF);
+    gballoc_init();
+    void* allocation1 = malloc(OVERHEAD_SIZE);
+    void* site1 = malloc(OVERHEAD_SIZE);
+    void* allocation2 = malloc(OVERHEAD_SIZE);
+    void* site2 = malloc(OVERHEAD_SIZE);
+    GBALLOC_ALLOCATION_SITE sites[1];
+
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation1);
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(site1);
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation2);
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(site2);
+    STRICT_EXPECTED_CALL(mocks, mock_calloc(1, 5))
+        .SetReturn(TEST_ALLOC_PTR2);
+    void* block1 = gballoc_calloc_at(1, 1, TEST_FILE, 1);
+    void* block2 = gballoc_calloc_at(1, 5, TEST_FILE, 2);
+
+    // act
+    size_t result = gballoc_getAllocationSites(sites, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, result);
+    ASSERT_ARE_EQUAL(int, 2, sites[0].line);
+    ASSERT_ARE_EQUAL(size_t, 5, sites[0].liveBytes);
+
+    // cleanup
+    gballoc_free(block1);
+    gballoc_free(block2);
+    gballoc_deinit();
+    free(allocation1);
+    free(site1);
+    free(allocation2);
+    free(site2);
+}
+
+TEST_FUNCTION(when_allocating_the_site_record_fails_gballoc_calloc_at_still_tracks_the_block)
+{
+    // arrange
+    CGBAllocMocks mocks;
+    mocks.SetPerformAutomaticCallComparison(AUTOMATIC_CALL_COMPARISON_OFF);
+    gballoc_init();
+    void* allocation = malloc(OVERHEAD_SIZE);
+    GBALLOC_ALLOCATION_SITE sites[1];
+
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation);
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn((void*)NULL);
+
+    // act
+    void* block = gballoc_calloc_at(2, 3, TEST_FILE, 42);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_ALLOC_PTR1, block);
+    ASSERT_ARE_EQUAL(size_t, 6, gballoc_getCurrentMemoryUsed());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getAllocationSites(sites, 1));
+
+    // cleanup
+    gballoc_free(block);
+    gballoc_deinit();
+    free(allocation);
+}
+
+TEST_FUNCTION(gballoc_getAllocationSites_after_deinit_returns_0)
+{
+    // arrange
+    CGBAllocMocks mocks;
+    GBALLOC_ALLOCATION_SITE sites[1];
+
+    // act
+    size_t result = gballoc_getAllocationSites(sites, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+}
+
+/* gballoc_getSizeHistogram */
+
+TEST_FUNCTION(gballoc_getSizeHistogram_counts_the_allocations_made_at_a_call_site_by_power_of_2)
+{
+    // arrange
+    CGBAllocMocks mocks;
+    mocks.SetPerformAutomaticCallComparison(AUTOMATIC_CALL_COMPARISON_OFF);
+    gballoc_init();
+    void* allocation1 = malloc(OVERHEAD_SIZE);
+    void* site = malloc(OVERHEAD_SIZE);
+    void* allocation2 = malloc(OVERHEAD_SIZE);
+    size_t histogram[GBALLOC_SIZE_HISTOGRAM_BUCKET_COUNT];
+    size_t i;
+
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation1);
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(site);
+    EXPECTED_CALL(mocks, mock_malloc(0))
+        .SetReturn(allocation2);
+    STRICT_EXPECTED_CALL(mocks, mock_calloc(1, 1))
+        .SetReturn(TEST_ALLOC_PTR2);
+    void* block1 = gballoc_calloc_at(3, 2, TEST_FILE, 42);
+    /* not made through the _at functions, so not counted */
+    void* block2 = gballoc_calloc(1, 1);
+
+    // act
+    int result = gballoc_getSizeHistogram(histogram, GBALLOC_SIZE_HISTOGRAM_BUCKET_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    for (i = 0; i < GBALLOC_SIZE_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        /* 6 bytes fall in the 4 to 7 bytes bucket */
+        ASSERT_ARE_EQUAL(size_t, (i == 3) ? 1 : 0, histogram[i]);
+    }
+
+    // cleanup
+    gballoc_free(block1);
+    gballoc_free(block2);
+    gballoc_deinit();
+    free(allocation1);
+    free(site);
+    free(allocation2);
+}
+
+TEST_FUNCTION(gballoc_getSizeHistogram_with_NULL_histogram_fails)
+{
+    // arrange
+    CGBAllocMocks mocks;
+    gballoc_init();
+    mocks.ResetAllCalls();
+
+    // act
+    int result = gballoc_getSizeHistogram(NULL, 1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+TEST_FUNCTION(gballoc_getSizeHistogram_after_deinit_fails)
+{
+    // arrange
+    CGBAllocMocks mocks;
+    size_t histogram[GBALLOC_SIZE_HISTOGRAM_BUCKET_COUNT];
+
+    // act
+    int result = gballoc_getSizeHistogram(histogram, GBALLOC_SIZE_HISTOGRAM_BUCKET_COUNT);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 }
 
 END_TEST_SUITE(GBAlloc_UnitTests)
@@ -34,6 +34,9 @@ extern "C" void* gballoc_calloc(size_t nmemb, size_t size);
 extern "C" void* gballoc_realloc(void* ptr, size_t size);
 extern "C" void gballoc_free(void* ptr);
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <immintrin.h> /*the intrinsics of strings.c cannot be declared inside BASEIMPLEMENTATION*/
+#endif
 
 namespace BASEIMPLEMENTATION
 {
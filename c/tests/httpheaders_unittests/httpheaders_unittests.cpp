@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <cstdlib>
+#include <cstring>
 #ifdef _CRTDBG_MAP_ALLOC
 #include <crtdbg.h>
 #endif
@@ -71,6 +72,16 @@ static size_t whenShallMap_Create_fail;
 static size_t currentMap_Clone_call;
 static size_t whenShallMap_Clone_fail;
 
+#define TEST_ARENA_HANDLE (ARENA_HANDLE)0x4244
+static void* arenaMemory[8];
+
+#define TEST_BUFFER_HANDLE (BUFFER_HANDLE)0x4245
+static unsigned char wireBuffer[TEMP_BUFFER_SIZE];
+static size_t wireBufferLength;
+
+#define TEST_SEGMENT_HANDLE (BUFFER_HANDLE)0x4246
+#define TEST_BUFFER_CHAIN_HANDLE (BUFFER_CHAIN_HANDLE)0x4247
+
 
 static size_t currentmalloc_call;
 static size_t whenShallmalloc_fail;
@@ -97,6 +108,15 @@ public:
     }
     MOCK_METHOD_END(MAP_HANDLE, result2)
 
+    MOCK_STATIC_METHOD_2(, MAP_HANDLE, Map_CreateInArena, ARENA_HANDLE, arena, MAP_FILTER_CALLBACK, mapFilterFunc)
+    MOCK_METHOD_END(MAP_HANDLE, (MAP_HANDLE)malloc(1))
+
+    MOCK_STATIC_METHOD_1(, MAP_RESULT, Map_IgnoreKeyCase, MAP_HANDLE, handle)
+    MOCK_METHOD_END(MAP_RESULT, MAP_OK)
+
+    MOCK_STATIC_METHOD_2(, void*, ARENA_malloc, ARENA_HANDLE, arena, size_t, size)
+    MOCK_METHOD_END(void*, (void*)arenaMemory)
+
         MOCK_STATIC_METHOD_1(, MAP_HANDLE, Map_Clone, MAP_HANDLE, handle)
         MAP_HANDLE result2;
     currentMap_Clone_call++;
@@ -124,6 +144,25 @@ public:
     MOCK_STATIC_METHOD_4(, MAP_RESULT, Map_GetInternals, MAP_HANDLE, handle, const char*const**, keys, const char*const**, values, size_t*, count)
     MOCK_METHOD_END(MAP_RESULT, MAP_OK)
 
+    MOCK_STATIC_METHOD_1(, size_t, BUFFER_length, BUFFER_HANDLE, handle)
+    MOCK_METHOD_END(size_t, wireBufferLength)
+
+    MOCK_STATIC_METHOD_2(, int, BUFFER_enlarge, BUFFER_HANDLE, handle, size_t, enlargeSize)
+        wireBufferLength += enlargeSize;
+    MOCK_METHOD_END(int, 0)
+
+    MOCK_STATIC_METHOD_1(, unsigned char*, BUFFER_u_char, BUFFER_HANDLE, handle)
+    MOCK_METHOD_END(unsigned char*, wireBuffer)
+
+    MOCK_STATIC_METHOD_0(, BUFFER_HANDLE, BUFFER_new)
+    MOCK_METHOD_END(BUFFER_HANDLE, TEST_SEGMENT_HANDLE)
+
+    MOCK_STATIC_METHOD_1(, void, BUFFER_delete, BUFFER_HANDLE, handle)
+    MOCK_VOID_METHOD_END()
+
+    MOCK_STATIC_METHOD_2(, int, BUFFER_CHAIN_append, BUFFER_CHAIN_HANDLE, chain, BUFFER_HANDLE, segment)
+    MOCK_METHOD_END(int, 0)
+
     MOCK_STATIC_METHOD_1(, void*, gballoc_malloc, size_t, size)
     void* result2;
     currentmalloc_call++;
@@ -171,12 +210,22 @@ public:
 };
 
 DECLARE_GLOBAL_MOCK_METHOD_1(CHTTPHeadersMocks, , MAP_HANDLE, Map_Create, MAP_FILTER_CALLBACK, mapFilterFunc);
+DECLARE_GLOBAL_MOCK_METHOD_2(CHTTPHeadersMocks, , MAP_HANDLE, Map_CreateInArena, ARENA_HANDLE, arena, MAP_FILTER_CALLBACK, mapFilterFunc);
+DECLARE_GLOBAL_MOCK_METHOD_1(CHTTPHeadersMocks, , MAP_RESULT, Map_IgnoreKeyCase, MAP_HANDLE, handle);
+DECLARE_GLOBAL_MOCK_METHOD_2(CHTTPHeadersMocks, , void*, ARENA_malloc, ARENA_HANDLE, arena, size_t, size);
 DECLARE_GLOBAL_MOCK_METHOD_1(CHTTPHeadersMocks, , void, Map_Destroy, MAP_HANDLE, handle)
 DECLARE_GLOBAL_MOCK_METHOD_1(CHTTPHeadersMocks, , MAP_HANDLE, Map_Clone, MAP_HANDLE, handle);
 DECLARE_GLOBAL_MOCK_METHOD_3(CHTTPHeadersMocks, , MAP_RESULT, Map_AddOrUpdate, MAP_HANDLE, handle, const char*, key, const char*, value);
 DECLARE_GLOBAL_MOCK_METHOD_2(CHTTPHeadersMocks, , const char*, Map_GetValueFromKey, MAP_HANDLE, handle, const char*, key);
 DECLARE_GLOBAL_MOCK_METHOD_4(CHTTPHeadersMocks, , MAP_RESULT, Map_GetInternals, MAP_HANDLE, handle, const char*const**, keys, const char*const**, values, size_t*, count);
 
+DECLARE_GLOBAL_MOCK_METHOD_1(CHTTPHeadersMocks, , size_t, BUFFER_length, BUFFER_HANDLE, handle);
+DECLARE_GLOBAL_MOCK_METHOD_2(CHTTPHeadersMocks, , int, BUFFER_enlarge, BUFFER_HANDLE, handle, size_t, enlargeSize);
+DECLARE_GLOBAL_MOCK_METHOD_1(CHTTPHeadersMocks, , unsigned char*, BUFFER_u_char, BUFFER_HANDLE, handle);
+DECLARE_GLOBAL_MOCK_METHOD_0(CHTTPHeadersMocks, , BUFFER_HANDLE, BUFFER_new);
+DECLARE_GLOBAL_MOCK_METHOD_1(CHTTPHeadersMocks, , void, BUFFER_delete, BUFFER_HANDLE, handle);
+DECLARE_GLOBAL_MOCK_METHOD_2(CHTTPHeadersMocks, , int, BUFFER_CHAIN_append, BUFFER_CHAIN_HANDLE, chain, BUFFER_HANDLE, segment);
+
 DECLARE_GLOBAL_MOCK_METHOD_1(CHTTPHeadersMocks, , void*, gballoc_malloc, size_t, size);
 DECLARE_GLOBAL_MOCK_METHOD_2(CHTTPHeadersMocks, , void*, gballoc_realloc, void*, ptr, size_t, size);
 DECLARE_GLOBAL_MOCK_METHOD_1(CHTTPHeadersMocks, , void, gballoc_free, void*, ptr);
@@ -217,6 +266,8 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
 
             currentrealloc_call = 0;
             whenShallrealloc_fail = 0;
+
+            wireBufferLength = 0;
         }
 
         TEST_FUNCTION_CLEANUP(TestMethodCleanup)
@@ -239,6 +290,9 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
 
             STRICT_EXPECTED_CALL(mocks, Map_Create(IGNORED_PTR_ARG));
 
+            STRICT_EXPECTED_CALL(mocks, Map_IgnoreKeyCase(IGNORED_PTR_ARG)) /*header names are case-insensitive*/
+                .IgnoreArgument(1);
+
             ///act
             auto handle = HTTPHeaders_Alloc();
 
@@ -250,6 +304,31 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
             HTTPHeaders_Free(handle);
         }
 
+        /*Tests_SRS_HTTP_HEADERS_99_003:[ The function shall return NULL when the function cannot execute properly]*/
+        TEST_FUNCTION(HTTPHeaders_Alloc_fails_when_Map_IgnoreKeyCase_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+
+            STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+                .IgnoreArgument(1);
+            STRICT_EXPECTED_CALL(mocks, Map_Create(IGNORED_PTR_ARG));
+            STRICT_EXPECTED_CALL(mocks, Map_IgnoreKeyCase(IGNORED_PTR_ARG))
+                .IgnoreArgument(1)
+                .SetReturn(MAP_ERROR);
+            STRICT_EXPECTED_CALL(mocks, Map_Destroy(IGNORED_PTR_ARG))
+                .IgnoreArgument(1);
+            STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+                .IgnoreArgument(1);
+
+            ///act
+            auto httpHandle = HTTPHeaders_Alloc();
+
+            ///assert
+            ASSERT_IS_NULL(httpHandle);
+            mocks.AssertActualAndExpectedCalls();
+        }
+
 
         /*Tests_SRS_HTTP_HEADERS_99_003:[ The function shall return NULL when the function cannot execute properly]*/
         TEST_FUNCTION(HTTPHeaders_Alloc_fails_when_malloc_fails)
@@ -327,6 +406,115 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
 
         }
 
+        TEST_FUNCTION(HTTPHeaders_AllocInArena_takes_its_memory_from_the_arena)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+
+            STRICT_EXPECTED_CALL(mocks, ARENA_malloc(TEST_ARENA_HANDLE, IGNORED_NUM_ARG))
+                .IgnoreArgument(2);
+            STRICT_EXPECTED_CALL(mocks, Map_CreateInArena(TEST_ARENA_HANDLE, NULL));
+            STRICT_EXPECTED_CALL(mocks, Map_IgnoreKeyCase(IGNORED_PTR_ARG))
+                .IgnoreArgument(1);
+
+            ///act
+            auto handle = HTTPHeaders_AllocInArena(TEST_ARENA_HANDLE);
+
+            ///assert
+            ASSERT_IS_NOT_NULL(handle);
+            mocks.AssertActualAndExpectedCalls();
+
+            /// cleanup
+            HTTPHeaders_Free(handle);
+        }
+
+        TEST_FUNCTION(HTTPHeaders_AllocInArena_fails_when_Map_IgnoreKeyCase_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+
+            STRICT_EXPECTED_CALL(mocks, ARENA_malloc(TEST_ARENA_HANDLE, IGNORED_NUM_ARG))
+                .IgnoreArgument(2);
+            STRICT_EXPECTED_CALL(mocks, Map_CreateInArena(TEST_ARENA_HANDLE, NULL));
+            STRICT_EXPECTED_CALL(mocks, Map_IgnoreKeyCase(IGNORED_PTR_ARG))
+                .IgnoreArgument(1)
+                .SetReturn(MAP_ERROR);
+            STRICT_EXPECTED_CALL(mocks, Map_Destroy(IGNORED_PTR_ARG))
+                .IgnoreArgument(1);
+
+            ///act
+            auto handle = HTTPHeaders_AllocInArena(TEST_ARENA_HANDLE);
+
+            ///assert
+            ASSERT_IS_NULL(handle);
+            mocks.AssertActualAndExpectedCalls();
+        }
+
+        TEST_FUNCTION(HTTPHeaders_AllocInArena_with_NULL_arena_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+
+            ///act
+            auto handle = HTTPHeaders_AllocInArena(NULL);
+
+            ///assert
+            ASSERT_IS_NULL(handle);
+            mocks.AssertActualAndExpectedCalls();
+        }
+
+        TEST_FUNCTION(HTTPHeaders_AllocInArena_fails_when_ARENA_malloc_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+
+            STRICT_EXPECTED_CALL(mocks, ARENA_malloc(TEST_ARENA_HANDLE, IGNORED_NUM_ARG))
+                .IgnoreArgument(2)
+                .SetReturn((void*)NULL);
+
+            ///act
+            auto handle = HTTPHeaders_AllocInArena(TEST_ARENA_HANDLE);
+
+            ///assert
+            ASSERT_IS_NULL(handle);
+            mocks.AssertActualAndExpectedCalls();
+        }
+
+        TEST_FUNCTION(HTTPHeaders_AllocInArena_fails_when_Map_CreateInArena_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+
+            STRICT_EXPECTED_CALL(mocks, ARENA_malloc(TEST_ARENA_HANDLE, IGNORED_NUM_ARG))
+                .IgnoreArgument(2);
+            STRICT_EXPECTED_CALL(mocks, Map_CreateInArena(TEST_ARENA_HANDLE, NULL))
+                .SetReturn((MAP_HANDLE)NULL);
+
+            ///act
+            auto handle = HTTPHeaders_AllocInArena(TEST_ARENA_HANDLE);
+
+            ///assert
+            ASSERT_IS_NULL(handle);
+            mocks.AssertActualAndExpectedCalls();
+        }
+
+        TEST_FUNCTION(HTTPHeaders_Free_with_headers_in_an_arena_does_not_free_them)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto handle = HTTPHeaders_AllocInArena(TEST_ARENA_HANDLE);
+            mocks.ResetAllCalls();
+
+            STRICT_EXPECTED_CALL(mocks, Map_Destroy(IGNORED_PTR_ARG))
+                .IgnoreArgument(1);
+
+            ///act
+            HTTPHeaders_Free(handle);
+
+            ///assert
+            mocks.AssertActualAndExpectedCalls();
+        }
+
         /*Tests_SRS_HTTP_HEADERS_99_004:[ After a successful init, HTTPHeaders_GetHeaderCount shall report 0 existing headers.]*/
         TEST_FUNCTION(HTTPHeaders_Alloc_succeeds_and_GetHeaderCount_returns_0)
         {
@@ -1470,5 +1658,366 @@ BEGIN_TEST_SUITE(HTTPHeaders_UnitTests)
             HTTPHeaders_Free(result);
         }
 
+        TEST_FUNCTION(HTTPHeaders_Serialize_with_NULL_handle_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+
+            ///act
+            auto res = HTTPHeaders_Serialize(NULL, TEST_BUFFER_HANDLE);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+            mocks.AssertActualAndExpectedCalls();
+        }
+
+        TEST_FUNCTION(HTTPHeaders_Serialize_with_NULL_destination_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto httpHandle = HTTPHeaders_Alloc();
+            mocks.ResetAllCalls();
+
+            ///act
+            auto res = HTTPHeaders_Serialize(httpHandle, NULL);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+            mocks.AssertActualAndExpectedCalls();
+
+            ///cleanup
+            HTTPHeaders_Free(httpHandle);
+        }
+
+        TEST_FUNCTION(HTTPHeaders_Serialize_with_no_headers_leaves_the_buffer_alone)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto httpHandle = HTTPHeaders_Alloc();
+            const size_t zero = 0;
+            mocks.ResetAllCalls();
+
+            STRICT_EXPECTED_CALL(mocks, Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .IgnoreArgument(1)
+                .IgnoreArgument(2)
+                .IgnoreArgument(3)
+                .CopyOutArgumentBuffer(4, &zero, sizeof(zero));
+
+            ///act
+            auto res = HTTPHeaders_Serialize(httpHandle, TEST_BUFFER_HANDLE);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+            mocks.AssertActualAndExpectedCalls();
+
+            ///cleanup
+            HTTPHeaders_Free(httpHandle);
+        }
+
+        TEST_FUNCTION(HTTPHeaders_Serialize_appends_all_the_headers_after_the_buffer_content)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto httpHandle = HTTPHeaders_Alloc();
+            const char* keys[2] = { NAME1, NAME2 };
+            auto pKeys = &keys;
+            const char* values[2] = { VALUE1, VALUE2 };
+            auto pValues = &values;
+            const size_t two = 2;
+            (void)memcpy(wireBuffer, "GET", 3);
+            wireBufferLength = 3;
+            mocks.ResetAllCalls();
+
+            STRICT_EXPECTED_CALL(mocks, Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .IgnoreArgument(1)
+                .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
+                .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
+                .CopyOutArgumentBuffer(4, &two, sizeof(two));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_length(TEST_BUFFER_HANDLE));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_enlarge(TEST_BUFFER_HANDLE, sizeof(HEADER1 "\r\n" HEADER2 "\r\n") - 1));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_u_char(TEST_BUFFER_HANDLE));
+
+            ///act
+            auto res = HTTPHeaders_Serialize(httpHandle, TEST_BUFFER_HANDLE);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+            ASSERT_ARE_EQUAL(size_t, sizeof("GET" HEADER1 "\r\n" HEADER2 "\r\n") - 1, wireBufferLength);
+            ASSERT_ARE_EQUAL(int, 0, memcmp("GET" HEADER1 "\r\n" HEADER2 "\r\n", wireBuffer, wireBufferLength));
+            mocks.AssertActualAndExpectedCalls();
+
+            ///cleanup
+            HTTPHeaders_Free(httpHandle);
+        }
+
+        TEST_FUNCTION(HTTPHeaders_Serialize_fails_when_BUFFER_enlarge_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto httpHandle = HTTPHeaders_Alloc();
+            const char* keys[1] = { NAME1 };
+            auto pKeys = &keys;
+            const char* values[1] = { VALUE1 };
+            auto pValues = &values;
+            const size_t one = 1;
+            mocks.ResetAllCalls();
+
+            STRICT_EXPECTED_CALL(mocks, Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .IgnoreArgument(1)
+                .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
+                .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
+                .CopyOutArgumentBuffer(4, &one, sizeof(one));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_length(TEST_BUFFER_HANDLE));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_enlarge(TEST_BUFFER_HANDLE, sizeof(HEADER1 "\r\n") - 1))
+                .SetReturn(__LINE__);
+
+            ///act
+            auto res = HTTPHeaders_Serialize(httpHandle, TEST_BUFFER_HANDLE);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ALLOC_FAILED, res);
+            mocks.AssertActualAndExpectedCalls();
+
+            ///cleanup
+            HTTPHeaders_Free(httpHandle);
+        }
+
+        TEST_FUNCTION(HTTPHeaders_Serialize_fails_when_Map_GetInternals_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto httpHandle = HTTPHeaders_Alloc();
+            mocks.ResetAllCalls();
+
+            STRICT_EXPECTED_CALL(mocks, Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .IgnoreAllArguments()
+                .SetReturn(MAP_ERROR);
+
+            ///act
+            auto res = HTTPHeaders_Serialize(httpHandle, TEST_BUFFER_HANDLE);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ERROR, res);
+            mocks.AssertActualAndExpectedCalls();
+
+            ///cleanup
+            HTTPHeaders_Free(httpHandle);
+        }
+
+        TEST_FUNCTION(HTTPHeaders_SerializeToChain_with_NULL_handle_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+
+            ///act
+            auto res = HTTPHeaders_SerializeToChain(NULL, TEST_BUFFER_CHAIN_HANDLE);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+            mocks.AssertActualAndExpectedCalls();
+        }
+
+        TEST_FUNCTION(HTTPHeaders_SerializeToChain_with_NULL_destination_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto httpHandle = HTTPHeaders_Alloc();
+            mocks.ResetAllCalls();
+
+            ///act
+            auto res = HTTPHeaders_SerializeToChain(httpHandle, NULL);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_INVALID_ARG, res);
+            mocks.AssertActualAndExpectedCalls();
+
+            ///cleanup
+            HTTPHeaders_Free(httpHandle);
+        }
+
+        TEST_FUNCTION(HTTPHeaders_SerializeToChain_with_no_headers_appends_nothing)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto httpHandle = HTTPHeaders_Alloc();
+            const size_t zero = 0;
+            mocks.ResetAllCalls();
+
+            STRICT_EXPECTED_CALL(mocks, Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .IgnoreArgument(1)
+                .IgnoreArgument(2)
+                .IgnoreArgument(3)
+                .CopyOutArgumentBuffer(4, &zero, sizeof(zero));
+
+            ///act
+            auto res = HTTPHeaders_SerializeToChain(httpHandle, TEST_BUFFER_CHAIN_HANDLE);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+            mocks.AssertActualAndExpectedCalls();
+
+            ///cleanup
+            HTTPHeaders_Free(httpHandle);
+        }
+
+        TEST_FUNCTION(HTTPHeaders_SerializeToChain_appends_all_the_headers_as_one_segment)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto httpHandle = HTTPHeaders_Alloc();
+            const char* keys[2] = { NAME1, NAME2 };
+            auto pKeys = &keys;
+            const char* values[2] = { VALUE1, VALUE2 };
+            auto pValues = &values;
+            const size_t two = 2;
+            wireBufferLength = 0;
+            mocks.ResetAllCalls();
+
+            STRICT_EXPECTED_CALL(mocks, Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .IgnoreArgument(1)
+                .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
+                .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
+                .CopyOutArgumentBuffer(4, &two, sizeof(two));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_new());
+            STRICT_EXPECTED_CALL(mocks, BUFFER_enlarge(TEST_SEGMENT_HANDLE, sizeof(HEADER1 "\r\n" HEADER2 "\r\n") - 1));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_u_char(TEST_SEGMENT_HANDLE));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_CHAIN_append(TEST_BUFFER_CHAIN_HANDLE, TEST_SEGMENT_HANDLE));
+
+            ///act
+            auto res = HTTPHeaders_SerializeToChain(httpHandle, TEST_BUFFER_CHAIN_HANDLE);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_OK, res);
+            ASSERT_ARE_EQUAL(size_t, sizeof(HEADER1 "\r\n" HEADER2 "\r\n") - 1, wireBufferLength);
+            ASSERT_ARE_EQUAL(int, 0, memcmp(HEADER1 "\r\n" HEADER2 "\r\n", wireBuffer, wireBufferLength));
+            mocks.AssertActualAndExpectedCalls();
+
+            ///cleanup
+            HTTPHeaders_Free(httpHandle);
+        }
+
+        TEST_FUNCTION(HTTPHeaders_SerializeToChain_fails_when_BUFFER_new_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto httpHandle = HTTPHeaders_Alloc();
+            const char* keys[1] = { NAME1 };
+            auto pKeys = &keys;
+            const char* values[1] = { VALUE1 };
+            auto pValues = &values;
+            const size_t one = 1;
+            wireBufferLength = 0;
+            mocks.ResetAllCalls();
+
+            STRICT_EXPECTED_CALL(mocks, Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .IgnoreArgument(1)
+                .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
+                .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
+                .CopyOutArgumentBuffer(4, &one, sizeof(one));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_new())
+                .SetReturn((BUFFER_HANDLE)NULL);
+
+            ///act
+            auto res = HTTPHeaders_SerializeToChain(httpHandle, TEST_BUFFER_CHAIN_HANDLE);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ALLOC_FAILED, res);
+            mocks.AssertActualAndExpectedCalls();
+
+            ///cleanup
+            HTTPHeaders_Free(httpHandle);
+        }
+
+        TEST_FUNCTION(HTTPHeaders_SerializeToChain_deletes_the_segment_when_BUFFER_enlarge_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto httpHandle = HTTPHeaders_Alloc();
+            const char* keys[1] = { NAME1 };
+            auto pKeys = &keys;
+            const char* values[1] = { VALUE1 };
+            auto pValues = &values;
+            const size_t one = 1;
+            wireBufferLength = 0;
+            mocks.ResetAllCalls();
+
+            STRICT_EXPECTED_CALL(mocks, Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .IgnoreArgument(1)
+                .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
+                .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
+                .CopyOutArgumentBuffer(4, &one, sizeof(one));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_new());
+            STRICT_EXPECTED_CALL(mocks, BUFFER_enlarge(TEST_SEGMENT_HANDLE, sizeof(HEADER1 "\r\n") - 1))
+                .SetReturn(__LINE__);
+            STRICT_EXPECTED_CALL(mocks, BUFFER_delete(TEST_SEGMENT_HANDLE));
+
+            ///act
+            auto res = HTTPHeaders_SerializeToChain(httpHandle, TEST_BUFFER_CHAIN_HANDLE);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ALLOC_FAILED, res);
+            mocks.AssertActualAndExpectedCalls();
+
+            ///cleanup
+            HTTPHeaders_Free(httpHandle);
+        }
+
+        TEST_FUNCTION(HTTPHeaders_SerializeToChain_deletes_the_segment_when_BUFFER_CHAIN_append_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto httpHandle = HTTPHeaders_Alloc();
+            const char* keys[1] = { NAME1 };
+            auto pKeys = &keys;
+            const char* values[1] = { VALUE1 };
+            auto pValues = &values;
+            const size_t one = 1;
+            wireBufferLength = 0;
+            mocks.ResetAllCalls();
+
+            STRICT_EXPECTED_CALL(mocks, Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .IgnoreArgument(1)
+                .CopyOutArgumentBuffer(2, &pKeys, sizeof(pKeys))
+                .CopyOutArgumentBuffer(3, &pValues, sizeof(pValues))
+                .CopyOutArgumentBuffer(4, &one, sizeof(one));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_new());
+            STRICT_EXPECTED_CALL(mocks, BUFFER_enlarge(TEST_SEGMENT_HANDLE, sizeof(HEADER1 "\r\n") - 1));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_u_char(TEST_SEGMENT_HANDLE));
+            STRICT_EXPECTED_CALL(mocks, BUFFER_CHAIN_append(TEST_BUFFER_CHAIN_HANDLE, TEST_SEGMENT_HANDLE))
+                .SetReturn(__LINE__);
+            STRICT_EXPECTED_CALL(mocks, BUFFER_delete(TEST_SEGMENT_HANDLE));
+
+            ///act
+            auto res = HTTPHeaders_SerializeToChain(httpHandle, TEST_BUFFER_CHAIN_HANDLE);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ALLOC_FAILED, res);
+            mocks.AssertActualAndExpectedCalls();
+
+            ///cleanup
+            HTTPHeaders_Free(httpHandle);
+        }
+
+        TEST_FUNCTION(HTTPHeaders_SerializeToChain_fails_when_Map_GetInternals_fails)
+        {
+            ///arrange
+            CHTTPHeadersMocks mocks;
+            auto httpHandle = HTTPHeaders_Alloc();
+            mocks.ResetAllCalls();
+
+            STRICT_EXPECTED_CALL(mocks, Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .IgnoreAllArguments()
+                .SetReturn(MAP_ERROR);
+
+            ///act
+            auto res = HTTPHeaders_SerializeToChain(httpHandle, TEST_BUFFER_CHAIN_HANDLE);
+
+            ///assert
+            ASSERT_ARE_EQUAL(HTTP_HEADERS_RESULT, HTTP_HEADERS_ERROR, res);
+            mocks.AssertActualAndExpectedCalls();
+
+            ///cleanup
+            HTTPHeaders_Free(httpHandle);
+        }
 
 END_TEST_SUITE(HTTPHeaders_UnitTests)
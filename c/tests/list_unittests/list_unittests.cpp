@@ -283,6 +283,142 @@ TEST_FUNCTION(when_the_underlying_malloc_fails_list_add_fails)
 	list_destroy(list);
 }
 
+TEST_FUNCTION(list_add_after_the_last_item_was_removed_adds_at_the_end)
+{
+    // arrange
+    list_mocks mocks;
+    LIST_HANDLE list = list_create();
+    int x1 = 42;
+    int x2 = 43;
+    int x3 = 44;
+    (void)list_add(list, &x1);
+    (void)list_remove(list, list_add(list, &x2));
+    mocks.ResetAllCalls();
+
+    EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG));
+
+    // act
+    LIST_ITEM_HANDLE result = list_add(list, &x3);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    LIST_ITEM_HANDLE list_item = list_get_head_item(list);
+    ASSERT_ARE_EQUAL(int, x1, *(const int*)list_item_get_value(list_item));
+    list_item = list_get_next_item(list_item);
+    ASSERT_ARE_EQUAL(void_ptr, result, list_item);
+    ASSERT_IS_NULL(list_get_next_item(list_item));
+    mocks.AssertActualAndExpectedCalls();
+
+    // cleanup
+    list_destroy(list);
+}
+
+/* list_add_node */
+
+TEST_FUNCTION(list_add_node_with_NULL_node_fails)
+{
+    // arrange
+    list_mocks mocks;
+    LIST_HANDLE list = list_create();
+    int x = 42;
+    mocks.ResetAllCalls();
+
+    // act
+    LIST_ITEM_HANDLE result = list_add_node(list, NULL, &x);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_IS_NULL(list_get_head_item(list));
+    mocks.AssertActualAndExpectedCalls();
+
+    // cleanup
+    list_destroy(list);
+}
+
+TEST_FUNCTION(list_add_node_with_NULL_list_fails)
+{
+    // arrange
+    list_mocks mocks;
+    LIST_ITEM_INSTANCE node;
+    int x = 42;
+
+    // act
+    LIST_ITEM_HANDLE result = list_add_node(NULL, &node, &x);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(list_add_node_links_the_node_at_the_end_without_allocating)
+{
+    // arrange
+    list_mocks mocks;
+    LIST_HANDLE list = list_create();
+    LIST_ITEM_INSTANCE node;
+    int x1 = 42;
+    int x2 = 43;
+    (void)list_add(list, &x1);
+    mocks.ResetAllCalls();
+
+    // act
+    LIST_ITEM_HANDLE result = list_add_node(list, &node, &x2);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, &node, result);
+    LIST_ITEM_HANDLE list_item = list_get_next_item(list_get_head_item(list));
+    ASSERT_ARE_EQUAL(void_ptr, result, list_item);
+    ASSERT_ARE_EQUAL(int, x2, *(const int*)list_item_get_value(list_item));
+    mocks.AssertActualAndExpectedCalls();
+
+    // cleanup
+    list_destroy(list);
+}
+
+TEST_FUNCTION(list_remove_of_an_added_node_does_not_free_it)
+{
+    // arrange
+    list_mocks mocks;
+    LIST_HANDLE list = list_create();
+    LIST_ITEM_INSTANCE node;
+    int x = 42;
+    LIST_ITEM_HANDLE item = list_add_node(list, &node, &x);
+    mocks.ResetAllCalls();
+
+    // act
+    int result = list_remove(list, item);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(list_get_head_item(list));
+    mocks.AssertActualAndExpectedCalls();
+
+    // cleanup
+    list_destroy(list);
+}
+
+TEST_FUNCTION(list_destroy_frees_only_the_nodes_allocated_by_the_list)
+{
+    // arrange
+    list_mocks mocks;
+    LIST_HANDLE list = list_create();
+    LIST_ITEM_INSTANCE node;
+    int x1 = 42;
+    int x2 = 43;
+    (void)list_add_node(list, &node, &x1);
+    (void)list_add(list, &x2);
+    mocks.ResetAllCalls();
+
+    STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+        .IgnoreArgument(1);
+    STRICT_EXPECTED_CALL(mocks, gballoc_free(list));
+
+    // act
+    list_destroy(list);
+
+    // assert
+    mocks.AssertActualAndExpectedCalls();
+}
+
 /* list_get_head_item */
 
 /* Tests_SRS_LIST_01_010: [If the list is empty, list_get_head_item_shall_return NULL.] */
@@ -806,4 +942,34 @@ TEST_FUNCTION(list_remove_second_of_2_items_succeeds)
 	list_destroy(list);
 }
 
+/* Tests_SRS_LIST_01_023: [list_remove shall remove a list item from the list and on success it shall return 0.] */
+TEST_FUNCTION(list_remove_second_of_3_items_keeps_the_others)
+{
+	// arrange
+	list_mocks mocks;
+	int x1 = 0x42;
+	int x2 = 0x43;
+	int x3 = 0x44;
+	LIST_HANDLE list = list_create();
+	LIST_ITEM_HANDLE item1 = list_add(list, &x1);
+	LIST_ITEM_HANDLE item2 = list_add(list, &x2);
+	LIST_ITEM_HANDLE item3 = list_add(list, &x3);
+	mocks.ResetAllCalls();
+
+	EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG));
+
+	// act
+	int result = list_remove(list, item2);
+
+	// assert
+	ASSERT_ARE_EQUAL(int, 0, result);
+	ASSERT_ARE_EQUAL(void_ptr, item1, list_get_head_item(list));
+	ASSERT_ARE_EQUAL(void_ptr, item3, list_get_next_item(item1));
+	ASSERT_IS_NULL(list_get_next_item(item3));
+	mocks.AssertActualAndExpectedCalls();
+
+	// cleanup
+	list_destroy(list);
+}
+
 END_TEST_SUITE(list_unittests)
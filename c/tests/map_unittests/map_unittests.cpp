@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <cstdlib>
+#include <cstdio>
 #ifdef _CRTDBG_MAP_ALLOC
 #include <crtdbg.h>
 #endif
@@ -146,6 +147,22 @@ static const char* TEST_BLUEVALUE = "cyan";
 static const char* TEST_GREENKEY = "testgreenkey";
 static const char* TEST_GREENVALUE = "green";
 
+/*the number of pairs the storage of a map makes room for when it grows for the first time, as in map.c*/
+#define MAP_INITIAL_CAPACITY 4
+
+/*fills an empty map up to the room made by its first growth, the red pair comes first*/
+static void fillToTheInitialCapacity(MAP_HANDLE handle)
+{
+    char key[] = "key0";
+    size_t i;
+    (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+    for (i = 1; i < MAP_INITIAL_CAPACITY; i++)
+    {
+        key[3] = (char)('0' + i);
+        (void)Map_Add(handle, key, "value");
+    }
+}
+
 BEGIN_TEST_SUITE(map_unittests)
 
     TEST_SUITE_INITIALIZE(TestClassInitialize)
@@ -198,6 +215,7 @@ BEGIN_TEST_SUITE(map_unittests)
             .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*values*/
             .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(NULL)); /*index*/
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*handleData*/
             .IgnoreArgument(1);
 
@@ -220,7 +238,7 @@ BEGIN_TEST_SUITE(map_unittests)
         mocks.ResetAllCalls();
 
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*free the red key*/
-            .ValidateArgumentBuffer(1, TEST_REDKEY, strlen(TEST_REDKEY)+1);
+            .IgnoreArgument(1);
 
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))/*free the red value*/
             .ValidateArgumentBuffer(1, TEST_REDVALUE, strlen(TEST_REDVALUE)+1);
@@ -231,6 +249,8 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*free values array*/
             .IgnoreArgument(1);
 
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(NULL)); /*a map this small has no index*/
+
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*free handle*/
             .IgnoreArgument(1);
 
@@ -254,7 +274,7 @@ BEGIN_TEST_SUITE(map_unittests)
         mocks.ResetAllCalls();
 
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*free the red key*/
-            .ValidateArgumentBuffer(1, TEST_REDKEY, strlen(TEST_REDKEY)+1);
+            .IgnoreArgument(1);
 
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))/*free the red value*/
             .ValidateArgumentBuffer(1, "a", 2);
@@ -265,6 +285,8 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*free values array*/
             .IgnoreArgument(1);
 
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(NULL)); /*a map this small has no index*/
+
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*free handle*/
             .IgnoreArgument(1);
 
@@ -406,11 +428,12 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of red key*/
+            .IgnoreArgument(1);
 
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
@@ -445,22 +468,18 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of red key*/
+            .IgnoreArgument(1);
 
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2*sizeof(const char*))) /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of blue key*/
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2*sizeof(const char*))) /*growing values*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of blue key*/
-
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEVALUE) + 1)); /*copy of blue value*/
 
         ///act
@@ -495,31 +514,23 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of red key*/
+            .IgnoreArgument(1);
 
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of blue key*/
             .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing values*/
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of blue key*/
         
         whenShallmalloc_fail =currentmalloc_call+ 4;
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEVALUE) + 1)); /*copy of blue value*/
 
         /*below are undo actions*/
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*undo copy of blue key*/
-            .ValidateArgumentBuffer(1, TEST_BLUEKEY, strlen(TEST_BLUEKEY) + 1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing values*/
             .IgnoreArgument(1);
 
 
@@ -553,28 +564,20 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of red key*/
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing values*/
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
         whenShallmalloc_fail = currentmalloc_call + 3;
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of blue key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of blue key*/
+            .IgnoreArgument(1);
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing values*/
-            .IgnoreArgument(1);
 
 
         ///act
@@ -605,40 +608,27 @@ BEGIN_TEST_SUITE(map_unittests)
         const char*const* values;
         size_t count;
         auto handle = Map_Create(NULL);
+        fillToTheInitialCapacity(handle);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * MAP_INITIAL_CAPACITY * sizeof(const char*))) /*growing keys*/
             .IgnoreArgument(1);
-
-        whenShallrealloc_fail = currentrealloc_call + 4;
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing values*/
+        whenShallrealloc_fail = currentrealloc_call + 2;
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * MAP_INITIAL_CAPACITY * sizeof(const char*))) /*growing values*/
             .IgnoreArgument(1);
 
-        /*below are undo actions*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
+        /*below are undo actions*/ /*none, the keys keep their room for the next insertion*/
 
         ///act
-        auto result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
         auto result2 = Map_Add(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
         auto result3 = Map_GetInternals(handle, &keys, &values, &count);
 
         ///assert
-        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result1);
         ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result2);
         ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result3);
-        ASSERT_ARE_EQUAL(size_t, 1, count);
+        ASSERT_ARE_EQUAL(size_t, MAP_INITIAL_CAPACITY, count);
         ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
         ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
-
         mocks.AssertActualAndExpectedCalls();
 
         ///cleanup
@@ -654,35 +644,25 @@ BEGIN_TEST_SUITE(map_unittests)
         const char*const* values;
         size_t count;
         auto handle = Map_Create(NULL);
+        fillToTheInitialCapacity(handle);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
-
-        whenShallrealloc_fail = currentrealloc_call + 3;
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing keys*/
+        whenShallrealloc_fail = currentrealloc_call + 1;
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * MAP_INITIAL_CAPACITY * sizeof(const char*))) /*growing keys*/
             .IgnoreArgument(1);
 
-        /*below are undo actions*/
+        /*below are undo actions*/ /*none*/
 
         ///act
-        auto result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
         auto result2 = Map_Add(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
         auto result3 = Map_GetInternals(handle, &keys, &values, &count);
 
         ///assert
-        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result1);
         ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result2);
         ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result3);
-        ASSERT_ARE_EQUAL(size_t, 1, count);
+        ASSERT_ARE_EQUAL(size_t, MAP_INITIAL_CAPACITY, count);
         ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
         ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
-
         mocks.AssertActualAndExpectedCalls();
 
         ///cleanup
@@ -700,21 +680,18 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of red key*/
+            .IgnoreArgument(1);
 
         whenShallmalloc_fail = currentmalloc_call + 2;
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
         /*below are undo actions*/
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*undo copy of red key*/
-            .ValidateArgumentBuffer(1, TEST_REDKEY, strlen(TEST_REDKEY) + 1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))/*undo growing values*/
             .IgnoreArgument(1);
 
         ///act
@@ -743,18 +720,15 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
 
         whenShallmalloc_fail = currentmalloc_call + 1;
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of red key*/
+            .IgnoreArgument(1);
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))/*undo growing values*/
-            .IgnoreArgument(1);
 
         ///act
         auto result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -782,14 +756,12 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
 
         whenShallrealloc_fail = currentrealloc_call + 2;
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*undo growing keys*/
-            .IgnoreArgument(1);
 
         ///act
         auto result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -818,7 +790,7 @@ BEGIN_TEST_SUITE(map_unittests)
         mocks.ResetAllCalls();
 
         whenShallrealloc_fail = currentrealloc_call + 1;
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
 
         /*below are undo actions*/ /*none*/
 
@@ -969,9 +941,10 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY)+1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of red key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
         ///act
@@ -1001,16 +974,14 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of red key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of blue key*/
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of red key*/
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEVALUE) + 1)); /*copy of red value*/
 
         ///act
@@ -1045,26 +1016,20 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of red key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of blue key*/
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of red key*/
 
         whenShallmalloc_fail = currentmalloc_call + 4;
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEVALUE) + 1)); /*copy of red value*/
 
         /*below are undo actions*/
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*undo blue key value*/
-            .ValidateArgumentBuffer(1, TEST_BLUEKEY, strlen(TEST_BLUEKEY) + 1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing values*/
             .IgnoreArgument(1);
 
         ///act
@@ -1096,23 +1061,17 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of red key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing values*/
-            .IgnoreArgument(1);
         whenShallmalloc_fail = currentmalloc_call + 3;
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of blue key*/
+            .IgnoreArgument(1);
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing values*/
-            .IgnoreArgument(1);
 
         ///act
         auto result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1141,33 +1100,25 @@ BEGIN_TEST_SUITE(map_unittests)
         const char*const* values;
         size_t count;
         auto handle = Map_Create(NULL);
+        fillToTheInitialCapacity(handle);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * MAP_INITIAL_CAPACITY * sizeof(const char*))) /*growing keys*/
             .IgnoreArgument(1);
-        whenShallrealloc_fail = currentrealloc_call + 4;
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing values*/
+        whenShallrealloc_fail = currentrealloc_call + 2;
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * MAP_INITIAL_CAPACITY * sizeof(const char*))) /*growing values*/
             .IgnoreArgument(1);
 
-        /*below are undo actions*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*undo growing keys*/
-            .IgnoreArgument(1);
+        /*below are undo actions*/ /*none, the keys keep their room for the next insertion*/
 
         ///act
-        auto result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         auto result2 = Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
         auto result3 = Map_GetInternals(handle, &keys, &values, &count);
 
         ///assert
-        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result1);
         ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result2);
         ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result3);
-        ASSERT_ARE_EQUAL(size_t, 1, count);
+        ASSERT_ARE_EQUAL(size_t, MAP_INITIAL_CAPACITY, count);
         ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
         ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
         mocks.AssertActualAndExpectedCalls();
@@ -1185,29 +1136,23 @@ BEGIN_TEST_SUITE(map_unittests)
         const char*const* values;
         size_t count;
         auto handle = Map_Create(NULL);
+        fillToTheInitialCapacity(handle);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
-
-        whenShallrealloc_fail = currentrealloc_call + 3;
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * sizeof(const char*))) /*growing keys*/
+        whenShallrealloc_fail = currentrealloc_call + 1;
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * MAP_INITIAL_CAPACITY * sizeof(const char*))) /*growing keys*/
             .IgnoreArgument(1);
-        
+
         /*below are undo actions*/ /*none*/
 
         ///act
-        auto result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         auto result2 = Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
         auto result3 = Map_GetInternals(handle, &keys, &values, &count);
 
         ///assert
-        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result1);
         ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result2);
         ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result3);
-        ASSERT_ARE_EQUAL(size_t, 1, count);
+        ASSERT_ARE_EQUAL(size_t, MAP_INITIAL_CAPACITY, count);
         ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, keys[0]);
         ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
         mocks.AssertActualAndExpectedCalls();
@@ -1227,18 +1172,15 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of red key*/
+            .IgnoreArgument(1);
         whenShallmalloc_fail = currentmalloc_call + 2;
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*copy of red value*/
 
         /*below are undo actions*/
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*undo red key value*/
-            .ValidateArgumentBuffer(1, TEST_REDKEY, strlen(TEST_REDKEY) + 1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*undo growing values*/
             .IgnoreArgument(1);
 
         ///act
@@ -1266,17 +1208,14 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
 
         whenShallmalloc_fail = currentmalloc_call + 1;
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*copy of red key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of red key*/
+            .IgnoreArgument(1);
         
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*undo growing keys*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*undo growing values*/
-            .IgnoreArgument(1);
 
         ///act
         auto result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1303,13 +1242,11 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(NULL);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
         whenShallrealloc_fail = currentrealloc_call + 2;
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing values*/
 
         /*below are undo actions*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*undo growing keys*/
-            .IgnoreArgument(1);
 
         ///act
         auto result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
@@ -1337,7 +1274,7 @@ BEGIN_TEST_SUITE(map_unittests)
         mocks.ResetAllCalls();
 
         whenShallrealloc_fail = currentrealloc_call + 1;
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*))); /*growing keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*))); /*growing keys*/
 
         /*below are undo actions*/
 
@@ -1584,17 +1521,19 @@ BEGIN_TEST_SUITE(map_unittests)
         (void)Map_AddOrUpdate(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
         mocks.ResetAllCalls();
 
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*releasing interned yellow key*/
+            .IgnoreArgument(1);
+
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*freeing yellow value*/
             .ValidateArgumentBuffer(1, TEST_YELLOWVALUE, strlen(TEST_YELLOWVALUE) + 1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*freeing yellow key*/
-            .ValidateArgumentBuffer(1, TEST_YELLOWKEY, strlen(TEST_YELLOWKEY) + 1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*ungrowing keys*/
+            .IgnoreArgument(1);
 
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*ungrowing values*/
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*ungowing keys*/
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(NULL)); /*a map this small has no index*/
 
         ///act
         auto result1 = Map_Delete(handle, TEST_YELLOWKEY);
@@ -1624,17 +1563,11 @@ BEGIN_TEST_SUITE(map_unittests)
         
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*freeing yellow value*/
-            .ValidateArgumentBuffer(1, TEST_YELLOWVALUE, strlen(TEST_YELLOWVALUE) + 1);
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*freeing yellow key*/
-            .ValidateArgumentBuffer(1, TEST_YELLOWKEY, strlen(TEST_YELLOWKEY) + 1);
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1* sizeof(const char*))) /*ungrowing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*releasing interned yellow key*/
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*ungrowing keys*/
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*freeing yellow value*/
+            .ValidateArgumentBuffer(1, TEST_YELLOWVALUE, strlen(TEST_YELLOWVALUE) + 1);
 
         ///act
         auto result1 = Map_Delete(handle, TEST_YELLOWKEY);
@@ -1666,17 +1599,11 @@ BEGIN_TEST_SUITE(map_unittests)
 
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*freeing yellow value*/
-            .ValidateArgumentBuffer(1, TEST_REDVALUE, strlen(TEST_REDVALUE) + 1);
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*freeing yellow key*/
-            .ValidateArgumentBuffer(1, TEST_REDKEY, strlen(TEST_REDKEY) + 1);
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*ungrowing values*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*releasing interned red key*/
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1 * sizeof(const char*))) /*ungrowing keys*/
-            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*freeing red value*/
+            .ValidateArgumentBuffer(1, TEST_REDVALUE, strlen(TEST_REDVALUE) + 1);
 
         ///act
         auto result1 = Map_Delete(handle, TEST_REDKEY);
@@ -2101,13 +2028,8 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(sizeof(char*))); /*this is creating a clone of the storage for values*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the storage shared by the maps*/
+            .IgnoreArgument(1);
 
         ///act
         auto result = Map_Clone(handle);
@@ -2132,7 +2054,8 @@ BEGIN_TEST_SUITE(map_unittests)
     {
         ///arrange
         CMapMocks mocks;
-        auto handle = Map_Create(NULL);
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = Map_CreateInArena(arena, NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         mocks.ResetAllCalls();
 
@@ -2145,7 +2068,8 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the keys of an arena map are interned by the clone, RED key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
@@ -2165,7 +2089,7 @@ BEGIN_TEST_SUITE(map_unittests)
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        ARENA_destroy(arena);
     }
 
     /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
@@ -2173,7 +2097,8 @@ BEGIN_TEST_SUITE(map_unittests)
     {
         ///arrange
         CMapMocks mocks;
-        auto handle = Map_Create(NULL);
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = Map_CreateInArena(arena, NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         mocks.ResetAllCalls();
 
@@ -2186,7 +2111,8 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the keys of an arena map are interned by the clone, RED key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
@@ -2202,40 +2128,38 @@ BEGIN_TEST_SUITE(map_unittests)
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        ARENA_destroy(arena);
     }
 
-    /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
-    TEST_FUNCTION(Map_Clone_with_map_with_1_element_fails_when_gbaloc_fails_3)
+    /*Tests_SRS_MAP_02_039: [Map_Clone shall make a copy of the map indicated by parameter handle and return a non-NULL handle to it.]*/
+    TEST_FUNCTION(Map_Clone_with_map_with_1_element_shares_the_pairs)
     {
         ///arrange
         CMapMocks mocks;
+        const char*const* keys;
+        const char*const* clonedKeys;
+        const char*const* values;
+        const char*const* clonedValues;
+        size_t count;
         auto handle = Map_Create(NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
-        mocks.ResetAllCalls();
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
-            .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(sizeof(char*))); /*this is creating a clone of the storage for keys*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
-
-        whenShallmalloc_fail = currentmalloc_call + 3;
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        (void)Map_GetInternals(handle, &keys, &values, &count);
 
         ///act
         auto result = Map_Clone(handle);
 
         ///assert
-        ASSERT_IS_NULL(result);
-        mocks.AssertActualAndExpectedCalls();
+        ASSERT_IS_NOT_NULL(result);
+        (void)Map_GetInternals(result, &clonedKeys, &clonedValues, &count);
+        ASSERT_ARE_EQUAL(void_ptr, (void*)keys, (void*)clonedKeys);
+        ASSERT_ARE_EQUAL(void_ptr, (void*)values, (void*)clonedValues);
+        Map_Destroy(handle);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDKEY, clonedKeys[0]); /*the clone keeps the pairs alive*/
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, clonedValues[0]);
 
         ///cleanup
-        Map_Destroy(handle);
         Map_Destroy(result);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
     }
 
     /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
@@ -2253,7 +2177,8 @@ BEGIN_TEST_SUITE(map_unittests)
             .IgnoreArgument(1);
 
         whenShallmalloc_fail = currentmalloc_call + 2;
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(sizeof(char*))); /*this is creating a clone of the storage for keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the storage shared by the maps*/
+            .IgnoreArgument(1);
 
         ///act
         auto result = Map_Clone(handle);
@@ -2308,15 +2233,8 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(2*sizeof(char*))); /*this is creating a clone of the storage for keys*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a clone of BLUE key*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(2*sizeof(char*))); /*this is creating a clone of the storage for values*/
-
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1)); /*this is creating a clone of RED value*/
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEVALUE) + 1)); /*this is creating a clone of RED value*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the storage shared by the maps*/
+            .IgnoreArgument(1);
 
         ///act
         auto result = Map_Clone(handle);
@@ -2338,12 +2256,40 @@ BEGIN_TEST_SUITE(map_unittests)
         Map_Destroy(result);
     }
 
+    /*Tests_SRS_MAP_02_039: [Map_Clone shall make a copy of the map indicated by parameter handle and return a non-NULL handle to it.]*/
+    TEST_FUNCTION(Map_Clone_of_a_map_already_shared_only_creates_the_HANDLE_structure)
+    {
+        ///arrange
+        CMapMocks mocks;
+        auto handle = Map_Create(NULL);
+        (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
+        auto clone1 = Map_Clone(handle);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the HANDLE structure*/
+            .IgnoreArgument(1);
+
+        ///act
+        auto result = Map_Clone(clone1);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(result, TEST_REDKEY));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone1);
+        Map_Destroy(result);
+    }
+
     /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
     TEST_FUNCTION(Map_Clone_with_map_with_2_element_fails_when_gballoc_fails_1)
     {
         ///arrange
         CMapMocks mocks;
-        auto handle = Map_Create(NULL);
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = Map_CreateInArena(arena, NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
         mocks.ResetAllCalls();
@@ -2357,11 +2303,13 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the keys of an arena map are interned by the clone, RED key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a clone of BLUE key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*BLUE key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
@@ -2385,7 +2333,7 @@ BEGIN_TEST_SUITE(map_unittests)
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        ARENA_destroy(arena);
     }
 
     /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
@@ -2393,7 +2341,8 @@ BEGIN_TEST_SUITE(map_unittests)
     {
         ///arrange
         CMapMocks mocks;
-        auto handle = Map_Create(NULL);
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = Map_CreateInArena(arena, NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
         mocks.ResetAllCalls();
@@ -2407,11 +2356,13 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the keys of an arena map are interned by the clone, RED key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a clone of BLUE key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*BLUE key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
@@ -2431,7 +2382,7 @@ BEGIN_TEST_SUITE(map_unittests)
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        ARENA_destroy(arena);
     }
 
     /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
@@ -2439,7 +2390,8 @@ BEGIN_TEST_SUITE(map_unittests)
     {
         ///arrange
         CMapMocks mocks;
-        auto handle = Map_Create(NULL);
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = Map_CreateInArena(arena, NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
         mocks.ResetAllCalls();
@@ -2453,11 +2405,13 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the keys of an arena map are interned by the clone, RED key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a clone of BLUE key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*BLUE key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
@@ -2473,7 +2427,7 @@ BEGIN_TEST_SUITE(map_unittests)
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        ARENA_destroy(arena);
     }
 
     /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
@@ -2481,7 +2435,8 @@ BEGIN_TEST_SUITE(map_unittests)
     {
         ///arrange
         CMapMocks mocks;
-        auto handle = Map_Create(NULL);
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = Map_CreateInArena(arena, NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
         mocks.ResetAllCalls();
@@ -2495,12 +2450,14 @@ BEGIN_TEST_SUITE(map_unittests)
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the keys of an arena map are interned by the clone, RED key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
         whenShallmalloc_fail = currentmalloc_call + 4;
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_BLUEKEY) + 1)); /*this is creating a clone of BLUE key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*BLUE key*/
+            .IgnoreArgument(1);
 
         ///act
         auto result = Map_Clone(handle);
@@ -2511,7 +2468,7 @@ BEGIN_TEST_SUITE(map_unittests)
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        ARENA_destroy(arena);
     }
 
     /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
@@ -2519,7 +2476,8 @@ BEGIN_TEST_SUITE(map_unittests)
     {
         ///arrange
         CMapMocks mocks;
-        auto handle = Map_Create(NULL);
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = Map_CreateInArena(arena, NULL);
         (void)Map_AddOrUpdate(handle, TEST_REDKEY, TEST_REDVALUE);
         (void)Map_AddOrUpdate(handle, TEST_BLUEKEY, TEST_BLUEVALUE);
         mocks.ResetAllCalls();
@@ -2534,7 +2492,8 @@ BEGIN_TEST_SUITE(map_unittests)
             .IgnoreArgument(1);
 
         whenShallmalloc_fail = currentmalloc_call + 3;
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDKEY) + 1)); /*this is creating a clone of RED key*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the keys of an arena map are interned by the clone, RED key*/
+            .IgnoreArgument(1);
 
         ///act
         auto result = Map_Clone(handle);
@@ -2545,7 +2504,7 @@ BEGIN_TEST_SUITE(map_unittests)
 
         ///cleanup
         Map_Destroy(handle);
-        Map_Destroy(result);
+        ARENA_destroy(arena);
     }
 
     /*Tests_SRS_MAP_02_047: [If during cloning, any operation fails, then Map_Clone shall return NULL.] */
@@ -2564,7 +2523,8 @@ BEGIN_TEST_SUITE(map_unittests)
             .IgnoreArgument(1);
 
         whenShallmalloc_fail = currentmalloc_call + 2;
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(2 * sizeof(char*))); /*this is creating a clone of the storage for keys*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*this is creating the storage shared by the maps*/
+            .IgnoreArgument(1);
 
         ///act
         auto result = Map_Clone(handle);
@@ -2612,9 +2572,10 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(DontAllowCapitalsFilters);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*)));
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*)));
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_GREENKEY) + 1));
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*)));
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*)));
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of green key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_GREENVALUE) + 1));
 
         ///act
@@ -2640,9 +2601,10 @@ BEGIN_TEST_SUITE(map_unittests)
         auto handle = Map_Create(DontAllowCapitalsFilters);
         mocks.ResetAllCalls();
 
-        EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*)));
-        EXPECTED_CALL(mocks, gballoc_realloc(NULL, sizeof(const char*)));
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_GREENKEY) + 1));
+        EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*)));
+        EXPECTED_CALL(mocks, gballoc_realloc(NULL, MAP_INITIAL_CAPACITY * sizeof(const char*)));
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of green key*/
+            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_GREENVALUE) + 1));
 
         ///act
@@ -2658,4 +2620,593 @@ BEGIN_TEST_SUITE(map_unittests)
         Map_Destroy(handle);
     }
 
+    TEST_FUNCTION(Map_CreateInArena_with_NULL_arena_fails)
+    {
+        ///arrange
+        CMapMocks mocks;
+
+        ///act
+        auto handle = Map_CreateInArena(NULL, NULL);
+
+        ///assert
+        ASSERT_IS_NULL(handle);
+        mocks.AssertActualAndExpectedCalls();
+    }
+
+    TEST_FUNCTION(Map_operations_on_a_map_in_an_arena_do_not_use_the_heap)
+    {
+        ///arrange
+        CMapMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = Map_CreateInArena(arena, NULL);
+        mocks.ResetAllCalls();
+
+        ///act
+        auto result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        auto result2 = Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+        auto result3 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_GREENVALUE);
+        auto result4 = Map_Delete(handle, TEST_YELLOWKEY);
+        Map_Destroy(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result1);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result2);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result3);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result4);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        ARENA_destroy(arena);
+    }
+
+    TEST_FUNCTION(Map_in_an_arena_keeps_the_keys_and_values)
+    {
+        ///arrange
+        CMapMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = Map_CreateInArena(arena, NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        (void)Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+
+        ///act
+        auto result = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_GREENVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_GREENVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWVALUE, Map_GetValueFromKey(handle, TEST_YELLOWKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+        ARENA_destroy(arena);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(Map_Clone_of_a_map_in_an_arena_is_on_the_heap)
+    {
+        ///arrange
+        CMapMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = Map_CreateInArena(arena, NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+
+        ///act
+        auto result = Map_Clone(handle);
+        ARENA_destroy(arena);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(result, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(result);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(Map_Add_past_the_initial_capacity_doubles_the_storage)
+    {
+        ///arrange
+        CMapMocks mocks;
+        auto handle = Map_Create(NULL);
+        fillToTheInitialCapacity(handle);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * MAP_INITIAL_CAPACITY * sizeof(const char*))) /*keys*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 * MAP_INITIAL_CAPACITY * sizeof(const char*))) /*values*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of the yellow key*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_YELLOWVALUE) + 1));
+
+        ///act
+        auto result = Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    TEST_FUNCTION(Map_Add_past_the_index_threshold_builds_the_index)
+    {
+        ///arrange
+        CMapMocks mocks;
+        char key[] = "key0";
+        size_t i;
+        auto handle = Map_Create(NULL);
+        for (i = 0; i < 8; i++)
+        {
+            key[3] = (char)('0' + i);
+            (void)Map_Add(handle, key, "value");
+        }
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 16 * sizeof(const char*))) /*keys*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 16 * sizeof(const char*))) /*values*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*interning of the red key*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_REDVALUE) + 1));
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(NULL, 32 * sizeof(size_t))); /*the index, at most half full*/
+
+        ///act
+        auto result = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    TEST_FUNCTION(Map_Add_succeeds_when_building_the_index_fails)
+    {
+        ///arrange
+        CMapMocks mocks;
+        char key[] = "key0";
+        size_t i;
+        auto handle = Map_Create(NULL);
+        for (i = 0; i < 8; i++)
+        {
+            key[3] = (char)('0' + i);
+            (void)Map_Add(handle, key, "value");
+        }
+        whenShallrealloc_fail = currentrealloc_call + 3; /*keys, values, index*/
+
+        ///act
+        auto result1 = Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        auto result2 = Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result1);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result2);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWVALUE, Map_GetValueFromKey(handle, TEST_YELLOWKEY));
+        ASSERT_ARE_EQUAL(char_ptr, "value", Map_GetValueFromKey(handle, "key3"));
+
+        ///cleanup
+        Map_Destroy(handle);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(Map_with_many_keys_finds_all_of_them_and_keeps_the_insertion_order)
+    {
+        ///arrange
+        CMapMocks mocks;
+        char key[16];
+        char value[16];
+        size_t i;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        bool exists;
+        auto handle = Map_Create(NULL);
+        for (i = 0; i < 100; i++)
+        {
+            (void)sprintf(key, "key%u", (unsigned int)i);
+            (void)sprintf(value, "value%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(handle, key, value));
+        }
+
+        ///act
+        auto result1 = Map_Delete(handle, "key50");
+        auto result2 = Map_Add(handle, "key7", "again");
+        auto result3 = Map_AddOrUpdate(handle, "key99", "updated");
+        auto result4 = Map_GetInternals(handle, &keys, &values, &count);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result1);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_KEYEXISTS, result2);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result3);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result4);
+        ASSERT_ARE_EQUAL(size_t, 99, count);
+        for (i = 0; i < 100; i++)
+        {
+            size_t position = (i < 50) ? i : i - 1;
+            (void)sprintf(key, "key%u", (unsigned int)i);
+            (void)sprintf(value, "value%u", (unsigned int)i);
+            (void)Map_ContainsKey(handle, key, &exists);
+            if (i == 50)
+            {
+                ASSERT_IS_FALSE(exists);
+            }
+            else
+            {
+                ASSERT_IS_TRUE(exists);
+                ASSERT_ARE_EQUAL(char_ptr, key, keys[position]);
+                ASSERT_ARE_EQUAL(char_ptr, (i == 99) ? "updated" : value, Map_GetValueFromKey(handle, key));
+            }
+        }
+
+        ///cleanup
+        Map_Destroy(handle);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(Map_with_many_keys_in_an_arena_finds_all_of_them)
+    {
+        ///arrange
+        CMapMocks mocks;
+        char key[16];
+        size_t i;
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = Map_CreateInArena(arena, NULL);
+        for (i = 0; i < 100; i++)
+        {
+            (void)sprintf(key, "key%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, Map_Add(handle, key, "value"));
+        }
+
+        ///act
+        auto result = Map_Delete(handle, "key0");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, "key0"));
+        for (i = 1; i < 100; i++)
+        {
+            (void)sprintf(key, "key%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(char_ptr, "value", Map_GetValueFromKey(handle, key));
+        }
+
+        ///cleanup
+        Map_Destroy(handle);
+        ARENA_destroy(arena);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(Map_Add_on_a_clone_does_not_change_the_source)
+    {
+        ///arrange
+        CMapMocks mocks;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        auto handle = Map_Create(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        auto clone = Map_Clone(handle);
+
+        ///act
+        auto result = Map_Add(clone, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        (void)Map_GetInternals(handle, &keys, &values, &count);
+        ASSERT_ARE_EQUAL(size_t, 1, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
+        (void)Map_GetInternals(clone, &keys, &values, &count);
+        ASSERT_ARE_EQUAL(size_t, 2, count);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, values[0]);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWVALUE, values[1]);
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(Map_AddOrUpdate_on_the_source_does_not_change_the_clone)
+    {
+        ///arrange
+        CMapMocks mocks;
+        auto handle = Map_Create(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        auto clone = Map_Clone(handle);
+
+        ///act
+        auto result = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_GREENVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_GREENVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(clone, TEST_REDKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(Map_Delete_on_a_clone_with_many_keys_does_not_change_the_source)
+    {
+        ///arrange
+        CMapMocks mocks;
+        char key[16];
+        size_t i;
+        auto handle = Map_Create(NULL);
+        for (i = 0; i < 20; i++)
+        {
+            (void)sprintf(key, "key%u", (unsigned int)i);
+            (void)Map_Add(handle, key, "value");
+        }
+        auto clone = Map_Clone(handle);
+
+        ///act
+        auto result = Map_Delete(clone, "key10");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, "value", Map_GetValueFromKey(handle, "key10"));
+        ASSERT_IS_NULL(Map_GetValueFromKey(clone, "key10"));
+        for (i = 11; i < 20; i++)
+        {
+            (void)sprintf(key, "key%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(char_ptr, "value", Map_GetValueFromKey(clone, key));
+        }
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(Map_AddOrUpdate_after_the_clone_is_destroyed_does_not_copy_the_pairs)
+    {
+        ///arrange
+        CMapMocks mocks;
+        auto handle = Map_Create(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        Map_Destroy(Map_Clone(handle));
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG)) /*the storage that is not shared anymore*/
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, strlen(TEST_GREENVALUE) + 1))
+            .IgnoreArgument(1);
+
+        ///act
+        auto result = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_GREENVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_GREENVALUE, Map_GetValueFromKey(handle, TEST_REDKEY));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    TEST_FUNCTION(Map_Add_on_a_clone_fails_when_copying_the_pairs_fails)
+    {
+        ///arrange
+        CMapMocks mocks;
+        auto handle = Map_Create(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        auto clone = Map_Clone(handle);
+        mocks.ResetAllCalls();
+
+        whenShallmalloc_fail = currentmalloc_call + 1;
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(sizeof(char*))); /*this is copying the storage for keys*/
+
+        ///act
+        auto result = Map_Add(clone, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(clone, TEST_REDKEY));
+        ASSERT_IS_NULL(Map_GetValueFromKey(clone, TEST_YELLOWKEY));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+    }
+
+    TEST_FUNCTION(Map_Snapshot_with_NULL_handle_returns_NULL)
+    {
+        ///arrange
+
+        ///act
+        auto result = Map_Snapshot(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+    }
+
+    TEST_FUNCTION(Map_Snapshot_cannot_be_modified)
+    {
+        ///arrange
+        CMapMocks mocks;
+        auto handle = Map_Create(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        auto snapshot = Map_Snapshot(handle);
+        mocks.ResetAllCalls();
+
+        ///act
+        auto result1 = Map_Add(snapshot, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+        auto result2 = Map_AddOrUpdate(snapshot, TEST_REDKEY, TEST_GREENVALUE);
+        auto result3 = Map_Delete(snapshot, TEST_REDKEY);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result1);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result2);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result3);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(snapshot, TEST_REDKEY));
+        ASSERT_IS_NULL(Map_GetValueFromKey(snapshot, TEST_YELLOWKEY));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(snapshot);
+    }
+
+    TEST_FUNCTION(Map_Snapshot_keeps_its_pairs_when_the_map_is_modified)
+    {
+        ///arrange
+        CMapMocks mocks;
+        auto handle = Map_Create(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        auto snapshot = Map_Snapshot(handle);
+
+        ///act
+        auto result1 = Map_AddOrUpdate(handle, TEST_REDKEY, TEST_GREENVALUE);
+        auto result2 = Map_Add(handle, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result1);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result2);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_REDVALUE, Map_GetValueFromKey(snapshot, TEST_REDKEY));
+        ASSERT_IS_NULL(Map_GetValueFromKey(snapshot, TEST_YELLOWKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(snapshot);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(Map_Clone_of_a_snapshot_can_be_modified)
+    {
+        ///arrange
+        CMapMocks mocks;
+        auto handle = Map_Create(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        auto snapshot = Map_Snapshot(handle);
+        auto clone = Map_Clone(snapshot);
+
+        ///act
+        auto result = Map_Add(clone, TEST_YELLOWKEY, TEST_YELLOWVALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_YELLOWVALUE, Map_GetValueFromKey(clone, TEST_YELLOWKEY));
+        ASSERT_IS_NULL(Map_GetValueFromKey(snapshot, TEST_YELLOWKEY));
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(snapshot);
+        Map_Destroy(clone);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(Map_IgnoreKeyCase_with_NULL_handle_fails)
+    {
+        ///arrange
+
+        ///act
+        auto result = Map_IgnoreKeyCase(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_INVALIDARG, result);
+    }
+
+    TEST_FUNCTION(Map_IgnoreKeyCase_on_a_map_with_keys_fails)
+    {
+        ///arrange
+        CMapMocks mocks;
+        auto handle = Map_Create(NULL);
+        (void)Map_Add(handle, TEST_REDKEY, TEST_REDVALUE);
+        mocks.ResetAllCalls();
+
+        ///act
+        auto result = Map_IgnoreKeyCase(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_ERROR, result);
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, "TESTREDKEY"));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        Map_Destroy(handle);
+    }
+
+    TEST_FUNCTION(Map_IgnoreKeyCase_makes_the_lookups_ignore_the_case_of_the_keys)
+    {
+        ///arrange
+        CMapMocks mocks;
+        const char*const* keys;
+        const char*const* values;
+        size_t count;
+        bool exists;
+        auto handle = Map_Create(NULL);
+        auto result = Map_IgnoreKeyCase(handle);
+        (void)Map_Add(handle, "Content-Type", "text/plain");
+
+        ///act
+        auto result1 = Map_Add(handle, "content-type", "application/json");
+        auto result2 = Map_AddOrUpdate(handle, "CONTENT-TYPE", "application/json");
+        auto result3 = Map_ContainsKey(handle, "cOnTeNt-TyPe", &exists);
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_KEYEXISTS, result1);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result2);
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result3);
+        ASSERT_IS_TRUE(exists);
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, "Content-Typ"));
+        ASSERT_IS_NULL(Map_GetValueFromKey(handle, "Content-Type2"));
+        (void)Map_GetInternals(handle, &keys, &values, &count);
+        ASSERT_ARE_EQUAL(size_t, 1, count);
+        ASSERT_ARE_EQUAL(char_ptr, "Content-Type", keys[0]); /*the key keeps the case it was added with*/
+        ASSERT_ARE_EQUAL(char_ptr, "application/json", values[0]);
+
+        ///cleanup
+        Map_Destroy(handle);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(Map_IgnoreKeyCase_with_many_keys_and_their_clones_ignore_the_case_of_the_keys)
+    {
+        ///arrange
+        CMapMocks mocks;
+        char key[16];
+        size_t i;
+        auto handle = Map_Create(NULL);
+        (void)Map_IgnoreKeyCase(handle);
+        for (i = 0; i < 20; i++)
+        {
+            (void)sprintf(key, "Header-%u", (unsigned int)i);
+            (void)Map_Add(handle, key, "value");
+        }
+
+        ///act
+        auto clone = Map_Clone(handle);
+        auto result = Map_Delete(clone, "HEADER-3");
+
+        ///assert
+        ASSERT_ARE_EQUAL(MAP_RESULT, MAP_OK, result);
+        for (i = 0; i < 20; i++)
+        {
+            (void)sprintf(key, "hEADER-%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(char_ptr, "value", Map_GetValueFromKey(handle, key));
+            if (i == 3)
+            {
+                ASSERT_IS_NULL(Map_GetValueFromKey(clone, key));
+            }
+            else
+            {
+                ASSERT_ARE_EQUAL(char_ptr, "value", Map_GetValueFromKey(clone, key));
+            }
+        }
+
+        ///cleanup
+        Map_Destroy(handle);
+        Map_Destroy(clone);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
 END_TEST_SUITE(map_unittests)
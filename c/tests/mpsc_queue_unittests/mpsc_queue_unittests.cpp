@@ -0,0 +1,362 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <cstdlib>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "micromock.h"
+
+#include "mpsc_queue.h"
+#include "threadapi.h"
+#include "gballoc.h"
+
+#define PRODUCER_COUNT 4
+#define ITEMS_PER_PRODUCER 10000
+
+typedef struct TEST_ITEM_TAG
+{
+    size_t producer;
+    size_t sequence;
+    MPSC_QUEUE_NODE node;
+} TEST_ITEM;
+
+typedef struct TEST_PRODUCER_TAG
+{
+    MPSC_QUEUE_HANDLE queue;
+    TEST_ITEM* items;
+    size_t count;
+    unsigned int delay;
+} TEST_PRODUCER;
+
+static int produce(void* arg)
+{
+    TEST_PRODUCER* producer = (TEST_PRODUCER*)arg;
+    size_t i;
+    if (producer->delay > 0)
+    {
+        ThreadAPI_Sleep(producer->delay);
+    }
+    for (i = 0; i < producer->count; i++)
+    {
+        (void)MPSC_QUEUE_push(producer->queue, &producer->items[i].node);
+    }
+    return 0;
+}
+
+static MICROMOCK_MUTEX_HANDLE g_testByTest;
+static MICROMOCK_GLOBAL_SEMAPHORE_HANDLE g_dllByDll;
+
+BEGIN_TEST_SUITE(MpscQueue_UnitTests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = MicroMockCreateMutex();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    MicroMockDestroyMutex(g_testByTest);
+    DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (!MicroMockAcquireMutex(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    if (!MicroMockReleaseMutex(g_testByTest))
+    {
+        ASSERT_FAIL("failure in test framework at ReleaseMutex");
+    }
+}
+
+/* MPSC_QUEUE_create */
+
+TEST_FUNCTION(MPSC_QUEUE_create_returns_an_empty_queue)
+{
+    // arrange
+
+    // act
+    MPSC_QUEUE_HANDLE result = MPSC_QUEUE_create();
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_NULL(MPSC_QUEUE_pop(result));
+
+    // cleanup
+    MPSC_QUEUE_destroy(result);
+}
+
+/* MPSC_QUEUE_destroy */
+
+TEST_FUNCTION(MPSC_QUEUE_destroy_with_NULL_does_nothing)
+{
+    // arrange
+
+    // act
+    MPSC_QUEUE_destroy(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(MPSC_QUEUE_destroy_releases_all_the_memory_of_the_queue)
+{
+    // arrange
+    TEST_ITEM item;
+    ASSERT_ARE_EQUAL(int, 0, gballoc_init());
+    MPSC_QUEUE_HANDLE queue = MPSC_QUEUE_create();
+    (void)MPSC_QUEUE_push(queue, &item.node);
+
+    // act
+    MPSC_QUEUE_destroy(queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    gballoc_deinit();
+}
+
+/* MPSC_QUEUE_push */
+
+TEST_FUNCTION(MPSC_QUEUE_push_with_NULL_queue_fails)
+{
+    // arrange
+    TEST_ITEM item;
+
+    // act
+    int result = MPSC_QUEUE_push(NULL, &item.node);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+TEST_FUNCTION(MPSC_QUEUE_push_with_NULL_node_fails)
+{
+    // arrange
+    MPSC_QUEUE_HANDLE queue = MPSC_QUEUE_create();
+
+    // act
+    int result = MPSC_QUEUE_push(queue, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(MPSC_QUEUE_pop(queue));
+
+    // cleanup
+    MPSC_QUEUE_destroy(queue);
+}
+
+TEST_FUNCTION(MPSC_QUEUE_push_does_not_allocate)
+{
+    // arrange
+    TEST_ITEM items[3];
+    size_t i;
+    MPSC_QUEUE_HANDLE queue = MPSC_QUEUE_create();
+    ASSERT_ARE_EQUAL(int, 0, gballoc_init());
+
+    // act
+    for (i = 0; i < 3; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, MPSC_QUEUE_push(queue, &items[i].node));
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getMaximumMemoryUsed());
+
+    // cleanup
+    gballoc_deinit();
+    MPSC_QUEUE_destroy(queue);
+}
+
+/* MPSC_QUEUE_pop */
+
+TEST_FUNCTION(MPSC_QUEUE_pop_with_NULL_queue_fails)
+{
+    // arrange
+
+    // act
+    MPSC_QUEUE_NODE* result = MPSC_QUEUE_pop(NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(MPSC_QUEUE_pop_returns_the_nodes_in_the_order_they_were_pushed)
+{
+    // arrange
+    TEST_ITEM items[5];
+    size_t i;
+    MPSC_QUEUE_HANDLE queue = MPSC_QUEUE_create();
+    for (i = 0; i < 5; i++)
+    {
+        items[i].sequence = i;
+        (void)MPSC_QUEUE_push(queue, &items[i].node);
+    }
+
+    // act
+    for (i = 0; i < 5; i++)
+    {
+        MPSC_QUEUE_NODE* result = MPSC_QUEUE_pop(queue);
+
+        // assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(void_ptr, &items[i], MPSC_QUEUE_ITEM(result, TEST_ITEM, node));
+        ASSERT_ARE_EQUAL(size_t, i, MPSC_QUEUE_ITEM(result, TEST_ITEM, node)->sequence);
+    }
+    ASSERT_IS_NULL(MPSC_QUEUE_pop(queue));
+
+    // cleanup
+    MPSC_QUEUE_destroy(queue);
+}
+
+TEST_FUNCTION(MPSC_QUEUE_pop_after_the_queue_emptied_returns_new_nodes)
+{
+    // arrange
+    TEST_ITEM item1;
+    TEST_ITEM item2;
+    MPSC_QUEUE_HANDLE queue = MPSC_QUEUE_create();
+    (void)MPSC_QUEUE_push(queue, &item1.node);
+    (void)MPSC_QUEUE_pop(queue);
+    ASSERT_IS_NULL(MPSC_QUEUE_pop(queue));
+
+    // act
+    (void)MPSC_QUEUE_push(queue, &item2.node);
+    (void)MPSC_QUEUE_push(queue, &item1.node);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, &item2.node, MPSC_QUEUE_pop(queue));
+    ASSERT_ARE_EQUAL(void_ptr, &item1.node, MPSC_QUEUE_pop(queue));
+    ASSERT_IS_NULL(MPSC_QUEUE_pop(queue));
+
+    // cleanup
+    MPSC_QUEUE_destroy(queue);
+}
+
+TEST_FUNCTION(MPSC_QUEUE_pop_gets_every_node_from_concurrent_producers_in_their_order)
+{
+    // arrange
+    static TEST_ITEM items[PRODUCER_COUNT][ITEMS_PER_PRODUCER];
+    TEST_PRODUCER producers[PRODUCER_COUNT];
+    THREAD_HANDLE threads[PRODUCER_COUNT];
+    size_t nextSequence[PRODUCER_COUNT] = { 0 };
+    size_t popped = 0;
+    size_t i;
+    size_t j;
+    MPSC_QUEUE_HANDLE queue = MPSC_QUEUE_create();
+    for (i = 0; i < PRODUCER_COUNT; i++)
+    {
+        for (j = 0; j < ITEMS_PER_PRODUCER; j++)
+        {
+            items[i][j].producer = i;
+            items[i][j].sequence = j;
+        }
+        producers[i].queue = queue;
+        producers[i].items = items[i];
+        producers[i].count = ITEMS_PER_PRODUCER;
+        producers[i].delay = 0;
+    }
+
+    // act
+    for (i = 0; i < PRODUCER_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&threads[i], produce, &producers[i]));
+    }
+    while (popped < PRODUCER_COUNT * ITEMS_PER_PRODUCER)
+    {
+        MPSC_QUEUE_NODE* result = MPSC_QUEUE_wait_pop(queue, 1000);
+
+        // assert
+        ASSERT_IS_NOT_NULL(result);
+        TEST_ITEM* item = MPSC_QUEUE_ITEM(result, TEST_ITEM, node);
+        ASSERT_ARE_EQUAL(size_t, nextSequence[item->producer], item->sequence);
+        nextSequence[item->producer]++;
+        popped++;
+    }
+    ASSERT_IS_NULL(MPSC_QUEUE_pop(queue));
+
+    // cleanup
+    for (i = 0; i < PRODUCER_COUNT; i++)
+    {
+        (void)ThreadAPI_Join(threads[i], NULL);
+    }
+    MPSC_QUEUE_destroy(queue);
+}
+
+/* MPSC_QUEUE_wait_pop */
+
+TEST_FUNCTION(MPSC_QUEUE_wait_pop_with_NULL_queue_fails)
+{
+    // arrange
+
+    // act
+    MPSC_QUEUE_NODE* result = MPSC_QUEUE_wait_pop(NULL, 1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(MPSC_QUEUE_wait_pop_returns_a_queued_node_without_waiting)
+{
+    // arrange
+    TEST_ITEM item;
+    MPSC_QUEUE_HANDLE queue = MPSC_QUEUE_create();
+    (void)MPSC_QUEUE_push(queue, &item.node);
+
+    // act
+    MPSC_QUEUE_NODE* result = MPSC_QUEUE_wait_pop(queue, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, &item.node, result);
+
+    // cleanup
+    MPSC_QUEUE_destroy(queue);
+}
+
+TEST_FUNCTION(MPSC_QUEUE_wait_pop_on_an_empty_queue_times_out)
+{
+    // arrange
+    MPSC_QUEUE_HANDLE queue = MPSC_QUEUE_create();
+
+    // act
+    MPSC_QUEUE_NODE* result = MPSC_QUEUE_wait_pop(queue, 10);
+
+    // assert
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    MPSC_QUEUE_destroy(queue);
+}
+
+TEST_FUNCTION(MPSC_QUEUE_wait_pop_wakes_up_when_a_node_is_pushed)
+{
+    // arrange
+    TEST_ITEM item;
+    TEST_PRODUCER producer = { NULL, &item, 1, 50 };
+    THREAD_HANDLE thread;
+    producer.queue = MPSC_QUEUE_create();
+    ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&thread, produce, &producer));
+
+    // act
+    MPSC_QUEUE_NODE* result = MPSC_QUEUE_wait_pop(producer.queue, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, &item.node, result);
+
+    // cleanup
+    (void)ThreadAPI_Join(thread, NULL);
+    MPSC_QUEUE_destroy(producer.queue);
+}
+
+END_TEST_SUITE(MpscQueue_UnitTests)
@@ -0,0 +1,657 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "micromock.h"
+
+#include "ring_buffer.h"
+#include "threadapi.h"
+#include "gballoc.h"
+
+#ifndef SIZE_MAX
+#define SIZE_MAX ((size_t)~(size_t)0)
+#endif
+
+#define TEST_CAPACITY 16
+
+/*many times the capacity, so that the indexes wrap around the storage often*/
+#define STREAM_SIZE 100000
+
+typedef struct TEST_PRODUCER_TAG
+{
+    RING_BUFFER_HANDLE ringBuffer;
+    size_t count;
+} TEST_PRODUCER;
+
+/*writes the bytes 0, 1, 2... in chunks of varying size, half of them in place. Both sides yield while they wait for
+the other one, the test machine might have a single core*/
+static int produce(void* arg)
+{
+    TEST_PRODUCER* producer = (TEST_PRODUCER*)arg;
+    size_t written = 0;
+    unsigned char chunk[7];
+    while (written < producer->count)
+    {
+        if ((written % 2) == 0)
+        {
+            size_t regionSize;
+            unsigned char* region = RING_BUFFER_write_region(producer->ringBuffer, &regionSize);
+            if (region != NULL)
+            {
+                size_t i;
+                if (regionSize > producer->count - written)
+                {
+                    regionSize = producer->count - written;
+                }
+                for (i = 0; i < regionSize; i++)
+                {
+                    region[i] = (unsigned char)(written + i);
+                }
+                (void)RING_BUFFER_commit_write(producer->ringBuffer, regionSize);
+                written += regionSize;
+            }
+            else
+            {
+                ThreadAPI_Sleep(0);
+            }
+        }
+        else
+        {
+            size_t i;
+            size_t chunkSize = 1 + (written % sizeof(chunk));
+            if (chunkSize > producer->count - written)
+            {
+                chunkSize = producer->count - written;
+            }
+            for (i = 0; i < chunkSize; i++)
+            {
+                chunk[i] = (unsigned char)(written + i);
+            }
+            chunkSize = RING_BUFFER_write(producer->ringBuffer, chunk, chunkSize);
+            if (chunkSize == 0)
+            {
+                ThreadAPI_Sleep(0);
+            }
+            written += chunkSize;
+        }
+    }
+    return 0;
+}
+
+static MICROMOCK_MUTEX_HANDLE g_testByTest;
+static MICROMOCK_GLOBAL_SEMAPHORE_HANDLE g_dllByDll;
+
+BEGIN_TEST_SUITE(RingBuffer_UnitTests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = MicroMockCreateMutex();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    MicroMockDestroyMutex(g_testByTest);
+    DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (!MicroMockAcquireMutex(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    if (!MicroMockReleaseMutex(g_testByTest))
+    {
+        ASSERT_FAIL("failure in test framework at ReleaseMutex");
+    }
+}
+
+/* RING_BUFFER_create */
+
+TEST_FUNCTION(RING_BUFFER_create_with_0_capacity_fails)
+{
+    // arrange
+
+    // act
+    RING_BUFFER_HANDLE result = RING_BUFFER_create(0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(RING_BUFFER_create_with_a_too_big_capacity_fails)
+{
+    // arrange
+
+    // act
+    RING_BUFFER_HANDLE result = RING_BUFFER_create(SIZE_MAX);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(RING_BUFFER_create_rounds_the_capacity_up_to_a_power_of_two)
+{
+    // arrange
+
+    // act
+    RING_BUFFER_HANDLE result = RING_BUFFER_create(TEST_CAPACITY + 1);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 2 * TEST_CAPACITY, RING_BUFFER_capacity(result));
+    ASSERT_ARE_EQUAL(size_t, 0, RING_BUFFER_size(result));
+
+    // cleanup
+    RING_BUFFER_destroy(result);
+}
+
+TEST_FUNCTION(RING_BUFFER_create_aligns_the_ring_buffer_to_a_cache_line)
+{
+    // arrange
+
+    // act
+    RING_BUFFER_HANDLE result = RING_BUFFER_create(TEST_CAPACITY);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, (size_t)((uintptr_t)result % 64));
+
+    // cleanup
+    RING_BUFFER_destroy(result);
+}
+
+/* RING_BUFFER_destroy */
+
+TEST_FUNCTION(RING_BUFFER_destroy_with_NULL_does_nothing)
+{
+    // arrange
+
+    // act
+    RING_BUFFER_destroy(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(RING_BUFFER_destroy_releases_all_the_memory)
+{
+    // arrange
+    ASSERT_ARE_EQUAL(int, 0, gballoc_init());
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+
+    // act
+    RING_BUFFER_destroy(ringBuffer);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    gballoc_deinit();
+}
+
+/* RING_BUFFER_write_region */
+
+TEST_FUNCTION(RING_BUFFER_write_region_with_NULL_arguments_fails)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    size_t size;
+
+    // act
+    unsigned char* result1 = RING_BUFFER_write_region(NULL, &size);
+    unsigned char* result2 = RING_BUFFER_write_region(ringBuffer, NULL);
+
+    // assert
+    ASSERT_IS_NULL(result1);
+    ASSERT_IS_NULL(result2);
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+TEST_FUNCTION(RING_BUFFER_write_region_of_an_empty_buffer_is_the_whole_storage)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    size_t size;
+
+    // act
+    unsigned char* result = RING_BUFFER_write_region(ringBuffer, &size);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, TEST_CAPACITY, size);
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+TEST_FUNCTION(RING_BUFFER_write_region_of_a_full_buffer_returns_NULL)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    size_t size;
+    (void)RING_BUFFER_write_region(ringBuffer, &size);
+    ASSERT_ARE_EQUAL(int, 0, RING_BUFFER_commit_write(ringBuffer, size));
+
+    // act
+    unsigned char* result = RING_BUFFER_write_region(ringBuffer, &size);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, size);
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+TEST_FUNCTION(RING_BUFFER_write_region_stops_at_the_end_of_the_storage)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    unsigned char bytes[TEST_CAPACITY] = { 0 };
+    size_t size;
+    unsigned char* start = RING_BUFFER_write_region(ringBuffer, &size);
+    ASSERT_ARE_EQUAL(size_t, 10, RING_BUFFER_write(ringBuffer, bytes, 10));
+    ASSERT_ARE_EQUAL(size_t, 6, RING_BUFFER_read(ringBuffer, bytes, 6));
+
+    // act
+    unsigned char* result = RING_BUFFER_write_region(ringBuffer, &size);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, start + 10, result);
+    ASSERT_ARE_EQUAL(size_t, TEST_CAPACITY - 10, size);
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+TEST_FUNCTION(RING_BUFFER_write_region_after_wrapping_stops_at_the_unread_bytes)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    unsigned char bytes[TEST_CAPACITY] = { 0 };
+    size_t size;
+    unsigned char* start = RING_BUFFER_write_region(ringBuffer, &size);
+    ASSERT_ARE_EQUAL(size_t, TEST_CAPACITY, RING_BUFFER_write(ringBuffer, bytes, TEST_CAPACITY));
+    ASSERT_ARE_EQUAL(size_t, 6, RING_BUFFER_read(ringBuffer, bytes, 6));
+
+    // act
+    unsigned char* result = RING_BUFFER_write_region(ringBuffer, &size);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, start, result);
+    ASSERT_ARE_EQUAL(size_t, 6, size);
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+/* RING_BUFFER_commit_write */
+
+TEST_FUNCTION(RING_BUFFER_commit_write_with_NULL_handle_fails)
+{
+    // arrange
+
+    // act
+    int result = RING_BUFFER_commit_write(NULL, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+TEST_FUNCTION(RING_BUFFER_commit_write_of_more_than_the_write_region_fails)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+
+    // act
+    int result = RING_BUFFER_commit_write(ringBuffer, TEST_CAPACITY + 1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 0, RING_BUFFER_size(ringBuffer));
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+TEST_FUNCTION(RING_BUFFER_commit_write_makes_the_written_bytes_readable)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    size_t size;
+    unsigned char* region = RING_BUFFER_write_region(ringBuffer, &size);
+    (void)memcpy(region, "abc", 3);
+
+    // act
+    int result = RING_BUFFER_commit_write(ringBuffer, 3);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 3, RING_BUFFER_size(ringBuffer));
+    const unsigned char* readRegion = RING_BUFFER_read_region(ringBuffer, &size);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)region, (void*)readRegion);
+    ASSERT_ARE_EQUAL(size_t, 3, size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(readRegion, "abc", 3));
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+/* RING_BUFFER_write */
+
+TEST_FUNCTION(RING_BUFFER_write_with_NULL_arguments_writes_nothing)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+
+    // act
+    size_t result1 = RING_BUFFER_write(NULL, (const unsigned char*)"abc", 3);
+    size_t result2 = RING_BUFFER_write(ringBuffer, NULL, 3);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, result1);
+    ASSERT_ARE_EQUAL(size_t, 0, result2);
+    ASSERT_ARE_EQUAL(size_t, 0, RING_BUFFER_size(ringBuffer));
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+TEST_FUNCTION(RING_BUFFER_write_copies_only_what_fits)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    unsigned char bytes[2 * TEST_CAPACITY] = { 0 };
+
+    // act
+    size_t result = RING_BUFFER_write(ringBuffer, bytes, sizeof(bytes));
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, TEST_CAPACITY, result);
+    ASSERT_ARE_EQUAL(size_t, TEST_CAPACITY, RING_BUFFER_size(ringBuffer));
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+TEST_FUNCTION(RING_BUFFER_write_wraps_around_the_end_of_the_storage)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    unsigned char bytes[TEST_CAPACITY] = { 0 };
+    unsigned char readBytes[TEST_CAPACITY];
+    ASSERT_ARE_EQUAL(size_t, 10, RING_BUFFER_write(ringBuffer, bytes, 10));
+    ASSERT_ARE_EQUAL(size_t, 10, RING_BUFFER_read(ringBuffer, readBytes, 10));
+
+    // act
+    size_t result = RING_BUFFER_write(ringBuffer, (const unsigned char*)"0123456789abcdef", TEST_CAPACITY);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, TEST_CAPACITY, result);
+    ASSERT_ARE_EQUAL(size_t, TEST_CAPACITY, RING_BUFFER_read(ringBuffer, readBytes, TEST_CAPACITY));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(readBytes, "0123456789abcdef", TEST_CAPACITY));
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+/* RING_BUFFER_read_region */
+
+TEST_FUNCTION(RING_BUFFER_read_region_with_NULL_arguments_fails)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    size_t size;
+    (void)RING_BUFFER_write(ringBuffer, (const unsigned char*)"abc", 3);
+
+    // act
+    const unsigned char* result1 = RING_BUFFER_read_region(NULL, &size);
+    const unsigned char* result2 = RING_BUFFER_read_region(ringBuffer, NULL);
+
+    // assert
+    ASSERT_IS_NULL(result1);
+    ASSERT_IS_NULL(result2);
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+TEST_FUNCTION(RING_BUFFER_read_region_of_an_empty_buffer_returns_NULL)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    size_t size;
+
+    // act
+    const unsigned char* result = RING_BUFFER_read_region(ringBuffer, &size);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, size);
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+TEST_FUNCTION(RING_BUFFER_read_region_of_wrapped_bytes_takes_two_regions)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    unsigned char bytes[TEST_CAPACITY] = { 0 };
+    size_t size;
+    ASSERT_ARE_EQUAL(size_t, 10, RING_BUFFER_write(ringBuffer, bytes, 10));
+    ASSERT_ARE_EQUAL(size_t, 10, RING_BUFFER_read(ringBuffer, bytes, 10));
+    ASSERT_ARE_EQUAL(size_t, 9, RING_BUFFER_write(ringBuffer, (const unsigned char*)"012345678", 9));
+
+    // act
+    const unsigned char* first = RING_BUFFER_read_region(ringBuffer, &size);
+    ASSERT_ARE_EQUAL(size_t, TEST_CAPACITY - 10, size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(first, "012345", size));
+    ASSERT_ARE_EQUAL(int, 0, RING_BUFFER_commit_read(ringBuffer, size));
+    const unsigned char* second = RING_BUFFER_read_region(ringBuffer, &size);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 3, size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(second, "678", size));
+    ASSERT_IS_TRUE(second < first);
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+/* RING_BUFFER_commit_read */
+
+TEST_FUNCTION(RING_BUFFER_commit_read_with_NULL_handle_fails)
+{
+    // arrange
+
+    // act
+    int result = RING_BUFFER_commit_read(NULL, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+TEST_FUNCTION(RING_BUFFER_commit_read_of_more_than_the_read_region_fails)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    (void)RING_BUFFER_write(ringBuffer, (const unsigned char*)"abc", 3);
+
+    // act
+    int result = RING_BUFFER_commit_read(ringBuffer, 4);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, 3, RING_BUFFER_size(ringBuffer));
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+TEST_FUNCTION(RING_BUFFER_commit_read_frees_the_read_bytes)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    size_t size;
+    ASSERT_ARE_EQUAL(size_t, TEST_CAPACITY, RING_BUFFER_write(ringBuffer, (const unsigned char*)"0123456789abcdef", TEST_CAPACITY));
+
+    // act
+    int result = RING_BUFFER_commit_read(ringBuffer, 4);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(size_t, TEST_CAPACITY - 4, RING_BUFFER_size(ringBuffer));
+    ASSERT_IS_NOT_NULL(RING_BUFFER_write_region(ringBuffer, &size));
+    ASSERT_ARE_EQUAL(size_t, 4, size);
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+/* RING_BUFFER_read */
+
+TEST_FUNCTION(RING_BUFFER_read_with_NULL_arguments_reads_nothing)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    unsigned char bytes[3];
+    (void)RING_BUFFER_write(ringBuffer, (const unsigned char*)"abc", 3);
+
+    // act
+    size_t result1 = RING_BUFFER_read(NULL, bytes, 3);
+    size_t result2 = RING_BUFFER_read(ringBuffer, NULL, 3);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, result1);
+    ASSERT_ARE_EQUAL(size_t, 0, result2);
+    ASSERT_ARE_EQUAL(size_t, 3, RING_BUFFER_size(ringBuffer));
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+TEST_FUNCTION(RING_BUFFER_read_copies_at_most_the_readable_bytes)
+{
+    // arrange
+    RING_BUFFER_HANDLE ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    unsigned char bytes[TEST_CAPACITY];
+    (void)RING_BUFFER_write(ringBuffer, (const unsigned char*)"abc", 3);
+
+    // act
+    size_t result = RING_BUFFER_read(ringBuffer, bytes, sizeof(bytes));
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 3, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(bytes, "abc", 3));
+    ASSERT_ARE_EQUAL(size_t, 0, RING_BUFFER_size(ringBuffer));
+
+    // cleanup
+    RING_BUFFER_destroy(ringBuffer);
+}
+
+/* RING_BUFFER_size */
+
+TEST_FUNCTION(RING_BUFFER_size_with_NULL_handle_returns_0)
+{
+    // arrange
+
+    // act
+    size_t result = RING_BUFFER_size(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+}
+
+/* RING_BUFFER_capacity */
+
+TEST_FUNCTION(RING_BUFFER_capacity_with_NULL_handle_returns_0)
+{
+    // arrange
+
+    // act
+    size_t result = RING_BUFFER_capacity(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, result);
+}
+
+/* one producer and one consumer thread */
+
+TEST_FUNCTION(RING_BUFFER_delivers_a_stream_from_another_thread_in_order)
+{
+    // arrange
+    THREAD_HANDLE thread;
+    TEST_PRODUCER producer;
+    size_t read = 0;
+    unsigned char chunk[5];
+    producer.ringBuffer = RING_BUFFER_create(TEST_CAPACITY);
+    producer.count = STREAM_SIZE;
+
+    // act
+    ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&thread, produce, &producer));
+    while (read < STREAM_SIZE)
+    {
+        if ((read % 2) == 0)
+        {
+            size_t size;
+            const unsigned char* region = RING_BUFFER_read_region(producer.ringBuffer, &size);
+            if (region != NULL)
+            {
+                size_t i;
+                for (i = 0; i < size; i++)
+                {
+                    // assert
+                    ASSERT_ARE_EQUAL(int, (int)(unsigned char)(read + i), (int)region[i]);
+                }
+                ASSERT_ARE_EQUAL(int, 0, RING_BUFFER_commit_read(producer.ringBuffer, size));
+                read += size;
+            }
+            else
+            {
+                ThreadAPI_Sleep(0);
+            }
+        }
+        else
+        {
+            size_t i;
+            size_t size = RING_BUFFER_read(producer.ringBuffer, chunk, sizeof(chunk));
+            if (size == 0)
+            {
+                ThreadAPI_Sleep(0);
+            }
+            for (i = 0; i < size; i++)
+            {
+                // assert
+                ASSERT_ARE_EQUAL(int, (int)(unsigned char)(read + i), (int)chunk[i]);
+            }
+            read += size;
+        }
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, STREAM_SIZE, read);
+    (void)ThreadAPI_Join(thread, NULL);
+    ASSERT_ARE_EQUAL(size_t, 0, RING_BUFFER_size(producer.ringBuffer));
+
+    // cleanup
+    RING_BUFFER_destroy(producer.ringBuffer);
+}
+
+END_TEST_SUITE(RingBuffer_UnitTests)
@@ -7,6 +7,7 @@
 #include "micromockcharstararenullterminatedstrings.h"
 #include "socketio.h"
 #include "list.h"
+#include "ring_buffer.h"
 #include "lock.h"
 
 #undef DECLSPEC_IMPORT
@@ -14,6 +15,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netdb.h>
+#include <fcntl.h>
 
 #define GBALLOC_H
 extern "C" int gballoc_init(void);
@@ -43,10 +45,35 @@ static bool g_addrinfo_call_fail;
 static int g_socket_recv_size_value;
 
 static const LIST_HANDLE TEST_LIST_HANDLE = (LIST_HANDLE)0x4242;
+static const RING_BUFFER_HANDLE TEST_RING_BUFFER_HANDLE = (RING_BUFFER_HANDLE)0x4244;
+static unsigned char receiveBuffer[64];
+
+typedef struct TEST_REGION_TAG
+{
+    size_t offset;
+    size_t size;
+} TEST_REGION;
+
+/* the regions of receiveBuffer the RING_BUFFER_write_region and RING_BUFFER_read_region mocks hand out in turn, a region
+of size 0 is handed out as NULL. Once they run out the write region is all of receiveBuffer and the read region is NULL */
+static TEST_REGION g_write_regions[4];
+static size_t g_write_region_count;
+static size_t g_write_region_index;
+static TEST_REGION g_read_regions[4];
+static size_t g_read_region_count;
+static size_t g_read_region_index;
+
+/* what socketio handed to OnBytesRecieved */
+static const unsigned char* g_received_bytes[4];
+static size_t g_received_sizes[4];
+static size_t g_received_count;
 static const LIST_ITEM_HANDLE TEST_LIST_ITEM_HANDLE = (LIST_ITEM_HANDLE)0x11;
 static const void** list_items = NULL;
 static size_t list_item_count = 0;
-static int test_socket = 0x4243;
+#define TEST_SOCKET 0x4243
+static int test_socket = TEST_SOCKET;
+/* a descriptor fcntl accepts, for the tests that need socketio_open to succeed */
+static int g_open_socket = -1;
 
 static size_t list_head_count = 0;
 static int PORT_NUM = 80;
@@ -99,6 +126,14 @@ public:
             list_items[list_item_count++] = item;
         }
     MOCK_METHOD_END(LIST_ITEM_HANDLE, (LIST_ITEM_HANDLE)list_item_count);
+    MOCK_STATIC_METHOD_3(, LIST_ITEM_HANDLE, list_add_node, LIST_HANDLE, list, LIST_ITEM_INSTANCE*, node, const void*, item)
+        const void** items = (const void**)realloc(list_items, (list_item_count + 1) * sizeof(item));
+        if (items != NULL)
+        {
+            list_items = items;
+            list_items[list_item_count++] = item;
+        }
+    MOCK_METHOD_END(LIST_ITEM_HANDLE, (LIST_ITEM_HANDLE)list_item_count);
     MOCK_STATIC_METHOD_1(, const void*, list_item_get_value, LIST_ITEM_HANDLE, item_handle)
         const void* resultPtr = NULL;
         if (list_add_called)
@@ -133,6 +168,36 @@ public:
         }
     MOCK_METHOD_END(int, res);
 
+    // ring_buffer
+    MOCK_STATIC_METHOD_1(, RING_BUFFER_HANDLE, RING_BUFFER_create, size_t, capacity)
+    MOCK_METHOD_END(RING_BUFFER_HANDLE, TEST_RING_BUFFER_HANDLE);
+    MOCK_STATIC_METHOD_1(, void, RING_BUFFER_destroy, RING_BUFFER_HANDLE, handle)
+    MOCK_VOID_METHOD_END();
+    MOCK_STATIC_METHOD_2(, unsigned char*, RING_BUFFER_write_region, RING_BUFFER_HANDLE, handle, size_t*, size)
+        unsigned char* region = receiveBuffer;
+        *size = sizeof(receiveBuffer);
+        if (g_write_region_index < g_write_region_count)
+        {
+            const TEST_REGION* next_region = &g_write_regions[g_write_region_index++];
+            *size = next_region->size;
+            region = (next_region->size == 0) ? NULL : receiveBuffer + next_region->offset;
+        }
+    MOCK_METHOD_END(unsigned char*, region);
+    MOCK_STATIC_METHOD_2(, int, RING_BUFFER_commit_write, RING_BUFFER_HANDLE, handle, size_t, size)
+    MOCK_METHOD_END(int, 0);
+    MOCK_STATIC_METHOD_2(, const unsigned char*, RING_BUFFER_read_region, RING_BUFFER_HANDLE, handle, size_t*, size)
+        const unsigned char* region = NULL;
+        *size = 0;
+        if (g_read_region_index < g_read_region_count)
+        {
+            const TEST_REGION* next_region = &g_read_regions[g_read_region_index++];
+            *size = next_region->size;
+            region = (next_region->size == 0) ? NULL : receiveBuffer + next_region->offset;
+        }
+    MOCK_METHOD_END(const unsigned char*, region);
+    MOCK_STATIC_METHOD_2(, int, RING_BUFFER_commit_read, RING_BUFFER_HANDLE, handle, size_t, size)
+    MOCK_METHOD_END(int, 0);
+
     // ws2 mocks
     MOCK_STATIC_METHOD_3(, int, socket, int, af, int, type, int, protocol)
     MOCK_METHOD_END(int, test_socket);
@@ -178,10 +243,18 @@ extern "C"
     DECLARE_GLOBAL_MOCK_METHOD_1(socketio_mocks, , LIST_ITEM_HANDLE, list_get_head_item, LIST_HANDLE, list);
     DECLARE_GLOBAL_MOCK_METHOD_2(socketio_mocks, , int, list_remove, LIST_HANDLE, list, LIST_ITEM_HANDLE, item);
     DECLARE_GLOBAL_MOCK_METHOD_2(socketio_mocks, , LIST_ITEM_HANDLE, list_add, LIST_HANDLE, list, const void*, item);
+    DECLARE_GLOBAL_MOCK_METHOD_3(socketio_mocks, , LIST_ITEM_HANDLE, list_add_node, LIST_HANDLE, list, LIST_ITEM_INSTANCE*, node, const void*, item);
     DECLARE_GLOBAL_MOCK_METHOD_1(socketio_mocks, , const void*, list_item_get_value, LIST_ITEM_HANDLE, item_handle);
     DECLARE_GLOBAL_MOCK_METHOD_3(socketio_mocks, , LIST_ITEM_HANDLE, list_find, LIST_HANDLE, handle, LIST_MATCH_FUNCTION, match_function, const void*, match_context);
     DECLARE_GLOBAL_MOCK_METHOD_3(socketio_mocks, , int, list_remove_matching_item, LIST_HANDLE, handle, LIST_MATCH_FUNCTION, match_function, const void*, match_context);
 
+    DECLARE_GLOBAL_MOCK_METHOD_1(socketio_mocks, , RING_BUFFER_HANDLE, RING_BUFFER_create, size_t, capacity);
+    DECLARE_GLOBAL_MOCK_METHOD_1(socketio_mocks, , void, RING_BUFFER_destroy, RING_BUFFER_HANDLE, handle);
+    DECLARE_GLOBAL_MOCK_METHOD_2(socketio_mocks, , unsigned char*, RING_BUFFER_write_region, RING_BUFFER_HANDLE, handle, size_t*, size);
+    DECLARE_GLOBAL_MOCK_METHOD_2(socketio_mocks, , int, RING_BUFFER_commit_write, RING_BUFFER_HANDLE, handle, size_t, size);
+    DECLARE_GLOBAL_MOCK_METHOD_2(socketio_mocks, , const unsigned char*, RING_BUFFER_read_region, RING_BUFFER_HANDLE, handle, size_t*, size);
+    DECLARE_GLOBAL_MOCK_METHOD_2(socketio_mocks, , int, RING_BUFFER_commit_read, RING_BUFFER_HANDLE, handle, size_t, size);
+
     DECLARE_GLOBAL_MOCK_METHOD_3(socketio_mocks, , int, socket, int, af, int, type, int, protocol);
     DECLARE_GLOBAL_MOCK_METHOD_1(socketio_mocks, , int, close, int, s);
     DECLARE_GLOBAL_MOCK_METHOD_3(socketio_mocks, , int, connect, int, s, const struct sockaddr*, addr, socklen_t, addrlen);
@@ -200,6 +273,10 @@ TEST_SUITE_INITIALIZE(suite_init)
 {
     test_serialize_mutex = MicroMockCreateMutex();
     ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    /* close is mocked in this binary, so this stays open until the process exits */
+    g_open_socket = open("/dev/null", O_RDONLY);
+    ASSERT_ARE_NOT_EQUAL(int, -1, g_open_socket);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -218,6 +295,12 @@ TEST_FUNCTION_INITIALIZE(method_init)
     g_addrinfo_call_fail = false;
     //g_socket_send_size_value = -1;
     g_socket_recv_size_value = -1;
+    test_socket = TEST_SOCKET;
+    g_write_region_count = 0;
+    g_write_region_index = 0;
+    g_read_region_count = 0;
+    g_read_region_index = 0;
+    g_received_count = 0;
 }
 
 TEST_FUNCTION_CLEANUP(method_cleanup)
@@ -231,8 +314,12 @@ TEST_FUNCTION_CLEANUP(method_cleanup)
 static void OnBytesRecieved(void* context, const unsigned char* buffer, size_t size)
 {
     (void)context;
-    (void)buffer;
-    (void)size;
+    if (g_received_count < sizeof(g_received_sizes) / sizeof(g_received_sizes[0]))
+    {
+        g_received_bytes[g_received_count] = buffer;
+        g_received_sizes[g_received_count] = size;
+    }
+    g_received_count++;
 }
 
 static void OnIoStateChanged(void* context, IO_STATE new_io_state, IO_STATE previous_io_state)
@@ -285,6 +372,29 @@ TEST_FUNCTION(socketio_create_list_create_fails)
     ASSERT_IS_NULL(ioHandle);
 }
 
+TEST_FUNCTION(socketio_create_RING_BUFFER_create_fails)
+{
+    // arrange
+    socketio_mocks mocks;
+
+    EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG));
+    EXPECTED_CALL(mocks, list_create());
+    EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG));
+    EXPECTED_CALL(mocks, RING_BUFFER_create(IGNORED_NUM_ARG)).SetReturn((RING_BUFFER_HANDLE)NULL);
+    EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(mocks, list_destroy(IGNORED_PTR_ARG));
+    EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG));
+
+    SOCKETIO_CONFIG socketConfig = { HOSTNAME_ARG, PORT_NUM };
+
+    // act
+    CONCRETE_IO_HANDLE ioHandle = socketio_create(&socketConfig, PrintLogFunction);
+
+    // assert
+    ASSERT_IS_NULL(ioHandle);
+    mocks.AssertActualAndExpectedCalls();
+}
+
 TEST_FUNCTION(socketio_create_succeeds)
 {
     // arrange
@@ -293,6 +403,7 @@ TEST_FUNCTION(socketio_create_succeeds)
     EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG));
     EXPECTED_CALL(mocks, list_create());
     EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG));
+    EXPECTED_CALL(mocks, RING_BUFFER_create(IGNORED_NUM_ARG));
 
     SOCKETIO_CONFIG socketConfig = { HOSTNAME_ARG, PORT_NUM };
 
@@ -334,6 +445,7 @@ TEST_FUNCTION(socketio_destroy_socket_succeeds)
     EXPECTED_CALL(mocks, list_item_get_value(IGNORED_PTR_ARG));
     EXPECTED_CALL(mocks, list_remove(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     EXPECTED_CALL(mocks, list_destroy(IGNORED_PTR_ARG));
+    EXPECTED_CALL(mocks, RING_BUFFER_destroy(TEST_RING_BUFFER_HANDLE));
     EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG));
 
@@ -612,7 +724,7 @@ TEST_FUNCTION(socketio_send_size_zero_fails)
 //    EXPECTED_CALL(mocks, send(IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(1);
 //    EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG));
 //    EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG));
-//    EXPECTED_CALL(mocks, list_add(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+//    EXPECTED_CALL(mocks, list_add_node(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 //
 //    // act
 //    result = socketio_send(ioHandle, (const void*)TEST_BUFFER_VALUE, TEST_BUFFER_SIZE, OnSendComplete, (void*)TEST_CALLBACK_CONTEXT);
@@ -635,55 +747,189 @@ TEST_FUNCTION(socketio_dowork_socket_io_NULL_fails)
     // assert
 }
 
-// TBD:  To be implemented when fcntl is mocked
-//TEST_FUNCTION(socketio_dowork_succeeds)
-//{
-//    // arrange
-//    socketio_mocks mocks;
-//    SOCKETIO_CONFIG socketConfig = { HOSTNAME_ARG, PORT_NUM };
-//    CONCRETE_IO_HANDLE ioHandle = socketio_create(&socketConfig, PrintLogFunction);
-//
-//    int result = socketio_open(ioHandle, OnBytesRecieved, OnIoStateChanged, &callbackContext);
-//
-//    mocks.ResetAllCalls();
-//
-//    EXPECTED_CALL(mocks, list_get_head_item(IGNORED_PTR_ARG));
-//    EXPECTED_CALL(mocks, recv(IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG));
-//
-//    // act
-//    socketio_dowork(ioHandle);
-//
-//    // assert
-//    mocks.AssertActualAndExpectedCalls();
-//
-//    socketio_destroy(ioHandle);
-//}
+TEST_FUNCTION(socketio_dowork_receives_into_the_write_region)
+{
+    // arrange
+    socketio_mocks mocks;
+    SOCKETIO_CONFIG socketConfig = { HOSTNAME_ARG, PORT_NUM };
+    CONCRETE_IO_HANDLE ioHandle = socketio_create(&socketConfig, PrintLogFunction);
+    test_socket = g_open_socket;
+    int result = socketio_open(ioHandle, OnBytesRecieved, OnIoStateChanged, &callbackContext);
+    ASSERT_ARE_EQUAL(int, 0, result);
+    g_write_regions[0].offset = 8;
+    g_write_regions[0].size = 40;
+    g_write_regions[1].offset = 8 + TEST_BUFFER_SIZE;
+    g_write_regions[1].size = 40 - TEST_BUFFER_SIZE;
+    g_write_region_count = 2;
+    g_read_regions[0].offset = 8;
+    g_read_regions[0].size = TEST_BUFFER_SIZE;
+    g_read_region_count = 1;
 
-// TBD:  To be implemented when fcntl is mocked
-//TEST_FUNCTION(socketio_dowork_recv_bytes_succeeds)
-//{
-//    // arrange
-//    socketio_mocks mocks;
-//    SOCKETIO_CONFIG socketConfig = { HOSTNAME_ARG, PORT_NUM };
-//    CONCRETE_IO_HANDLE ioHandle = socketio_create(&socketConfig, PrintLogFunction);
-//
-//    int result = socketio_open(ioHandle, OnBytesRecieved, OnIoStateChanged, &callbackContext);
-//
-//    mocks.ResetAllCalls();
-//
-//    EXPECTED_CALL(mocks, list_get_head_item(IGNORED_PTR_ARG));
-//    EXPECTED_CALL(mocks, recv(IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG))
-//        .CopyOutArgumentBuffer(2, "t", 1)
-//        .SetReturn(1);
-//    EXPECTED_CALL(mocks, recv(IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG));
-//
-//    // act
-//    socketio_dowork(ioHandle);
-//
-//    // assert
-//    mocks.AssertActualAndExpectedCalls();
-//
-//    socketio_destroy(ioHandle);
-//}
+    mocks.ResetAllCalls();
+
+    STRICT_EXPECTED_CALL(mocks, list_get_head_item(TEST_LIST_HANDLE));
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_write_region(TEST_RING_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(mocks, recv(g_open_socket, receiveBuffer + 8, 40, 0))
+        .CopyOutArgumentBuffer(2, TEST_BUFFER_VALUE, TEST_BUFFER_SIZE)
+        .SetReturn(TEST_BUFFER_SIZE);
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_commit_write(TEST_RING_BUFFER_HANDLE, TEST_BUFFER_SIZE));
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_read_region(TEST_RING_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_commit_read(TEST_RING_BUFFER_HANDLE, TEST_BUFFER_SIZE));
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_read_region(TEST_RING_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_write_region(TEST_RING_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(mocks, recv(g_open_socket, receiveBuffer + 8 + TEST_BUFFER_SIZE, 40 - TEST_BUFFER_SIZE, 0));
+
+    // act
+    socketio_dowork(ioHandle);
+
+    // assert
+    mocks.AssertActualAndExpectedCalls();
+
+    socketio_destroy(ioHandle);
+}
+
+TEST_FUNCTION(socketio_dowork_indicates_exactly_the_committed_bytes)
+{
+    // arrange
+    socketio_mocks mocks;
+    SOCKETIO_CONFIG socketConfig = { HOSTNAME_ARG, PORT_NUM };
+    CONCRETE_IO_HANDLE ioHandle = socketio_create(&socketConfig, PrintLogFunction);
+    test_socket = g_open_socket;
+    int result = socketio_open(ioHandle, OnBytesRecieved, OnIoStateChanged, &callbackContext);
+    ASSERT_ARE_EQUAL(int, 0, result);
+    g_write_regions[0].offset = 8;
+    g_write_regions[0].size = 40;
+    g_write_region_count = 1;
+    g_read_regions[0].offset = 8;
+    g_read_regions[0].size = TEST_BUFFER_SIZE;
+    g_read_region_count = 1;
+
+    mocks.ResetAllCalls();
+
+    EXPECTED_CALL(mocks, list_get_head_item(IGNORED_PTR_ARG));
+    EXPECTED_CALL(mocks, RING_BUFFER_write_region(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    EXPECTED_CALL(mocks, recv(IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG))
+        .CopyOutArgumentBuffer(2, TEST_BUFFER_VALUE, TEST_BUFFER_SIZE)
+        .SetReturn(TEST_BUFFER_SIZE);
+    EXPECTED_CALL(mocks, RING_BUFFER_commit_write(IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    EXPECTED_CALL(mocks, RING_BUFFER_read_region(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    EXPECTED_CALL(mocks, RING_BUFFER_commit_read(IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    EXPECTED_CALL(mocks, RING_BUFFER_read_region(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    EXPECTED_CALL(mocks, RING_BUFFER_write_region(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    EXPECTED_CALL(mocks, recv(IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG));
+
+    // act
+    socketio_dowork(ioHandle);
+
+    // assert
+    mocks.AssertActualAndExpectedCalls();
+    ASSERT_ARE_EQUAL(size_t, 1, g_received_count);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)(receiveBuffer + 8), (void*)g_received_bytes[0]);
+    ASSERT_ARE_EQUAL(size_t, TEST_BUFFER_SIZE, g_received_sizes[0]);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(TEST_BUFFER_VALUE, g_received_bytes[0], TEST_BUFFER_SIZE));
+
+    socketio_destroy(ioHandle);
+}
+
+TEST_FUNCTION(socketio_dowork_receives_across_the_end_of_the_receive_buffer_in_two_regions)
+{
+    // arrange
+    socketio_mocks mocks;
+    SOCKETIO_CONFIG socketConfig = { HOSTNAME_ARG, PORT_NUM };
+    CONCRETE_IO_HANDLE ioHandle = socketio_create(&socketConfig, PrintLogFunction);
+    test_socket = g_open_socket;
+    int result = socketio_open(ioHandle, OnBytesRecieved, OnIoStateChanged, &callbackContext);
+    ASSERT_ARE_EQUAL(int, 0, result);
+    /* the first recv fills the end of the buffer, the second one carries on at its start */
+    g_write_regions[0].offset = sizeof(receiveBuffer) - 4;
+    g_write_regions[0].size = 4;
+    g_write_regions[1].offset = 0;
+    g_write_regions[1].size = sizeof(receiveBuffer) - 4;
+    g_write_regions[2].offset = 3;
+    g_write_regions[2].size = sizeof(receiveBuffer) - 7;
+    g_write_region_count = 3;
+    g_read_regions[0].offset = sizeof(receiveBuffer) - 4;
+    g_read_regions[0].size = 4;
+    g_read_regions[1].size = 0;
+    g_read_regions[2].offset = 0;
+    g_read_regions[2].size = 3;
+    g_read_region_count = 3;
+
+    mocks.ResetAllCalls();
+
+    STRICT_EXPECTED_CALL(mocks, list_get_head_item(TEST_LIST_HANDLE));
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_write_region(TEST_RING_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(mocks, recv(g_open_socket, receiveBuffer + sizeof(receiveBuffer) - 4, 4, 0))
+        .CopyOutArgumentBuffer(2, "abcd", 4)
+        .SetReturn(4);
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_commit_write(TEST_RING_BUFFER_HANDLE, 4));
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_read_region(TEST_RING_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_commit_read(TEST_RING_BUFFER_HANDLE, 4));
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_read_region(TEST_RING_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_write_region(TEST_RING_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(mocks, recv(g_open_socket, receiveBuffer, sizeof(receiveBuffer) - 4, 0))
+        .CopyOutArgumentBuffer(2, "efg", 3)
+        .SetReturn(3);
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_commit_write(TEST_RING_BUFFER_HANDLE, 3));
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_read_region(TEST_RING_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_commit_read(TEST_RING_BUFFER_HANDLE, 3));
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_read_region(TEST_RING_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_write_region(TEST_RING_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(mocks, recv(g_open_socket, receiveBuffer + 3, sizeof(receiveBuffer) - 7, 0));
+
+    // act
+    socketio_dowork(ioHandle);
+
+    // assert
+    mocks.AssertActualAndExpectedCalls();
+    ASSERT_ARE_EQUAL(size_t, 2, g_received_count);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)(receiveBuffer + sizeof(receiveBuffer) - 4), (void*)g_received_bytes[0]);
+    ASSERT_ARE_EQUAL(size_t, 4, g_received_sizes[0]);
+    ASSERT_ARE_EQUAL(int, 0, memcmp("abcd", g_received_bytes[0], 4));
+    ASSERT_ARE_EQUAL(void_ptr, (void*)receiveBuffer, (void*)g_received_bytes[1]);
+    ASSERT_ARE_EQUAL(size_t, 3, g_received_sizes[1]);
+    ASSERT_ARE_EQUAL(int, 0, memcmp("efg", g_received_bytes[1], 3));
+
+    socketio_destroy(ioHandle);
+}
+
+TEST_FUNCTION(socketio_dowork_does_not_recv_when_the_receive_buffer_is_full)
+{
+    // arrange
+    socketio_mocks mocks;
+    SOCKETIO_CONFIG socketConfig = { HOSTNAME_ARG, PORT_NUM };
+    CONCRETE_IO_HANDLE ioHandle = socketio_create(&socketConfig, PrintLogFunction);
+    test_socket = g_open_socket;
+    int result = socketio_open(ioHandle, OnBytesRecieved, OnIoStateChanged, &callbackContext);
+    ASSERT_ARE_EQUAL(int, 0, result);
+    g_write_regions[0].size = 0;
+    g_write_region_count = 1;
+
+    mocks.ResetAllCalls();
+
+    STRICT_EXPECTED_CALL(mocks, list_get_head_item(TEST_LIST_HANDLE));
+    STRICT_EXPECTED_CALL(mocks, RING_BUFFER_write_region(TEST_RING_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .IgnoreArgument(2);
+
+    // act
+    socketio_dowork(ioHandle);
+
+    // assert
+    mocks.AssertActualAndExpectedCalls();
+    ASSERT_ARE_EQUAL(size_t, 0, g_received_count);
+
+    socketio_destroy(ioHandle);
+}
 
 END_TEST_SUITE(socketio_win32_unittests)
@@ -0,0 +1,308 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "micromock.h"
+
+#include "string_intern.h"
+#include "threadapi.h"
+#include "gballoc.h"
+
+#define TEST_NAME "Content-Type"
+
+/*more strings than the table has buckets to begin with*/
+#define MANY_STRINGS 1000
+#define THREAD_COUNT 4
+
+static const char* g_threadInterned[THREAD_COUNT][MANY_STRINGS];
+
+static int internManyStrings(void* arg)
+{
+    const char** interned = (const char**)arg;
+    char value[32];
+    size_t i;
+    for (i = 0; i < MANY_STRINGS; i++)
+    {
+        (void)sprintf(value, "thread-%u", (unsigned int)i);
+        interned[i] = STRING_INTERN_acquire(value);
+    }
+    return 0;
+}
+
+static MICROMOCK_MUTEX_HANDLE g_testByTest;
+static MICROMOCK_GLOBAL_SEMAPHORE_HANDLE g_dllByDll;
+
+BEGIN_TEST_SUITE(StringIntern_UnitTests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = MicroMockCreateMutex();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    MicroMockDestroyMutex(g_testByTest);
+    DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (!MicroMockAcquireMutex(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    if (!MicroMockReleaseMutex(g_testByTest))
+    {
+        ASSERT_FAIL("failure in test framework at ReleaseMutex");
+    }
+}
+
+/* STRING_INTERN_acquire */
+
+TEST_FUNCTION(STRING_INTERN_acquire_with_NULL_fails)
+{
+    // arrange
+
+    // act
+    const char* result = STRING_INTERN_acquire(NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(STRING_INTERN_acquire_returns_a_copy_of_the_string)
+{
+    // arrange
+    char value[] = TEST_NAME;
+
+    // act
+    const char* result = STRING_INTERN_acquire(value);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, (void*)value, (void*)result);
+    value[0] = 'X';
+    ASSERT_ARE_EQUAL(char_ptr, TEST_NAME, result);
+    ASSERT_ARE_EQUAL(size_t, 1, STRING_INTERN_count());
+
+    // cleanup
+    STRING_INTERN_release(result);
+}
+
+TEST_FUNCTION(STRING_INTERN_acquire_of_an_equal_string_returns_the_same_pointer)
+{
+    // arrange
+    char otherCopy[] = TEST_NAME;
+    const char* first = STRING_INTERN_acquire(TEST_NAME);
+
+    // act
+    const char* result = STRING_INTERN_acquire(otherCopy);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, (void*)first, (void*)result);
+    ASSERT_ARE_EQUAL(size_t, 1, STRING_INTERN_count());
+
+    // cleanup
+    STRING_INTERN_release(first);
+    STRING_INTERN_release(result);
+}
+
+TEST_FUNCTION(STRING_INTERN_acquire_of_different_strings_returns_different_pointers)
+{
+    // arrange
+    const char* first = STRING_INTERN_acquire("Content-Type");
+
+    // act
+    const char* second = STRING_INTERN_acquire("Content-Length");
+    const char* third = STRING_INTERN_acquire("Content");
+    const char* empty = STRING_INTERN_acquire("");
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, "Content-Type", first);
+    ASSERT_ARE_EQUAL(char_ptr, "Content-Length", second);
+    ASSERT_ARE_EQUAL(char_ptr, "Content", third);
+    ASSERT_ARE_EQUAL(char_ptr, "", empty);
+    ASSERT_ARE_EQUAL(size_t, 4, STRING_INTERN_count());
+
+    // cleanup
+    STRING_INTERN_release(first);
+    STRING_INTERN_release(second);
+    STRING_INTERN_release(third);
+    STRING_INTERN_release(empty);
+}
+
+TEST_FUNCTION(STRING_INTERN_acquire_keeps_finding_the_strings_after_the_table_grows)
+{
+    // arrange
+    static const char* interned[MANY_STRINGS];
+    char value[32];
+    size_t i;
+    for (i = 0; i < MANY_STRINGS; i++)
+    {
+        (void)sprintf(value, "iothub-%u", (unsigned int)i);
+        interned[i] = STRING_INTERN_acquire(value);
+        ASSERT_IS_NOT_NULL(interned[i]);
+    }
+
+    // act
+    for (i = 0; i < MANY_STRINGS; i++)
+    {
+        (void)sprintf(value, "iothub-%u", (unsigned int)i);
+        const char* result = STRING_INTERN_acquire(value);
+
+        // assert
+        ASSERT_ARE_EQUAL(void_ptr, (void*)interned[i], (void*)result);
+        STRING_INTERN_release(result);
+    }
+    ASSERT_ARE_EQUAL(size_t, MANY_STRINGS, STRING_INTERN_count());
+
+    // cleanup
+    for (i = 0; i < MANY_STRINGS; i++)
+    {
+        STRING_INTERN_release(interned[i]);
+    }
+}
+
+TEST_FUNCTION(STRING_INTERN_acquire_from_several_threads_hands_out_one_copy_of_each_string)
+{
+    // arrange
+    THREAD_HANDLE threads[THREAD_COUNT];
+    size_t i;
+    size_t j;
+
+    // act
+    for (i = 0; i < THREAD_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Create(&threads[i], internManyStrings, (void*)g_threadInterned[i]));
+    }
+    for (i = 0; i < THREAD_COUNT; i++)
+    {
+        int threadResult;
+        ASSERT_ARE_EQUAL(int, (int)THREADAPI_OK, (int)ThreadAPI_Join(threads[i], &threadResult));
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, MANY_STRINGS, STRING_INTERN_count());
+    for (j = 0; j < MANY_STRINGS; j++)
+    {
+        ASSERT_IS_NOT_NULL(g_threadInterned[0][j]);
+        for (i = 1; i < THREAD_COUNT; i++)
+        {
+            ASSERT_ARE_EQUAL(void_ptr, (void*)g_threadInterned[0][j], (void*)g_threadInterned[i][j]);
+        }
+    }
+
+    // cleanup
+    for (i = 0; i < THREAD_COUNT; i++)
+    {
+        for (j = 0; j < MANY_STRINGS; j++)
+        {
+            STRING_INTERN_release(g_threadInterned[i][j]);
+        }
+    }
+}
+
+/* STRING_INTERN_add_ref */
+
+TEST_FUNCTION(STRING_INTERN_add_ref_with_NULL_returns_NULL)
+{
+    // arrange
+
+    // act
+    const char* result = STRING_INTERN_add_ref(NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(STRING_INTERN_add_ref_keeps_the_string_after_one_release)
+{
+    // arrange
+    const char* interned = STRING_INTERN_acquire(TEST_NAME);
+
+    // act
+    const char* result = STRING_INTERN_add_ref(interned);
+    STRING_INTERN_release(interned);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, (void*)interned, (void*)result);
+    ASSERT_ARE_EQUAL(char_ptr, TEST_NAME, result);
+    ASSERT_ARE_EQUAL(size_t, 1, STRING_INTERN_count());
+
+    // cleanup
+    STRING_INTERN_release(result);
+}
+
+/* STRING_INTERN_release */
+
+TEST_FUNCTION(STRING_INTERN_release_with_NULL_does_nothing)
+{
+    // arrange
+
+    // act
+    STRING_INTERN_release(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(STRING_INTERN_release_of_the_last_reference_removes_the_string)
+{
+    // arrange
+    ASSERT_ARE_EQUAL(int, 0, gballoc_init());
+    const char* first = STRING_INTERN_acquire(TEST_NAME);
+    const char* second = STRING_INTERN_acquire(TEST_NAME);
+    STRING_INTERN_release(first);
+
+    // act
+    STRING_INTERN_release(second);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, STRING_INTERN_count());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    gballoc_deinit();
+}
+
+TEST_FUNCTION(STRING_INTERN_release_of_all_the_strings_releases_the_grown_table)
+{
+    // arrange
+    static const char* interned[MANY_STRINGS];
+    char value[32];
+    size_t i;
+    ASSERT_ARE_EQUAL(int, 0, gballoc_init());
+    for (i = 0; i < MANY_STRINGS; i++)
+    {
+        (void)sprintf(value, "iothub-%u", (unsigned int)i);
+        interned[i] = STRING_INTERN_acquire(value);
+    }
+
+    // act
+    for (i = 0; i < MANY_STRINGS; i++)
+    {
+        STRING_INTERN_release(interned[i]);
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, STRING_INTERN_count());
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    gballoc_deinit();
+}
+
+END_TEST_SUITE(StringIntern_UnitTests)
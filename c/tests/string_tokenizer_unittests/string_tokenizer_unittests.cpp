@@ -298,10 +298,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
 
         stMocks.ResetAllCalls();
 
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-
         ///act
         int r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "m");
 
@@ -329,10 +325,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
 
         stMocks.ResetAllCalls();
 
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-
         ///act
         int r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "P");
 
@@ -361,10 +353,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
 
         stMocks.ResetAllCalls();
 
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-
         ///act
         int r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "P");
 
@@ -418,10 +406,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
 
         stMocks.ResetAllCalls();
 
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-
         ///act1
         int r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "P");
 
@@ -456,10 +440,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
 
         stMocks.ResetAllCalls();
 
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-
         ///act1
         int r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "?");
 
@@ -488,16 +468,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
 
         stMocks.ResetAllCalls();
 
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result1. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result2. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result3. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
-
         ///act1
         int r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "P");
         
@@ -567,9 +537,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
         stMocks.ResetAllCalls();
 
         ///act1
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
 
 
         int r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "?");
@@ -579,9 +546,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
         ASSERT_ARE_EQUAL(int, r, 0);
 
         ///act2
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
 
 
         r = STRING_TOKENIZER_get_next_token(t, output_string_handle, ",");
@@ -591,9 +555,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
         ASSERT_ARE_EQUAL(int, r, 0);
 
         ///act3
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
 
         r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "#,");
 
@@ -629,9 +590,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
         stMocks.ResetAllCalls();
 
         ///act1
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
 
 
         int r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "?");
@@ -668,9 +626,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
         stMocks.ResetAllCalls();
 
         ///act1
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
 
 
         int r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "1");
@@ -701,10 +656,10 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
 
         stMocks.ResetAllCalls();
 
+        EXPECTED_CALL(stMocks, gballoc_free(0))  //the first token fits in the STRING, the longer content is released.
+            .IgnoreArgument(1);
+
         ///act1
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
 
 
         int r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "\r\n");
@@ -714,9 +669,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
         ASSERT_ARE_EQUAL(int, r, 0);
 
         ///act2
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
 
 
         r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "\r\n");
@@ -726,9 +678,6 @@ BEGIN_TEST_SUITE(string_tokenizer_unittests)
         ASSERT_ARE_EQUAL(int, r, 0);
 
         ///act3
-        EXPECTED_CALL(stMocks, gballoc_realloc(0, 0))  //Alloc memory to copy result. 
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
 
 
         r = STRING_TOKENIZER_get_next_token(t, output_string_handle, "\r\n\t");
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "strings.h"
+
+#define PAYLOAD_SIZE (8 * 1024)
+#define PASSES 4000
+
+/*a telemetry message: long runs of plain text with a few chars to escape*/
+static const char TEXT_PATTERN[] = "temperature reading from sensor 42 is within range; humidity 37.5 percent, wind 10 km\\h\n";
+/*a JSON document that is escaped again: a quote every few chars*/
+static const char JSON_PATTERN[] = "{\"deviceId\":\"myFirstDevice\",\"windSpeed\":10.5,\"path\":\"/a/b\"},";
+
+static void fillPayload(char* payload, const char* pattern)
+{
+    size_t patternLength = strlen(pattern);
+    size_t i;
+    for (i = 0; i < PAYLOAD_SIZE; i++)
+    {
+        payload[i] = pattern[i % patternLength];
+    }
+    payload[PAYLOAD_SIZE] = '\0';
+}
+
+static int runBenchmark(const char* name, const char* pattern)
+{
+    int result;
+    char* payload = (char*)malloc(PAYLOAD_SIZE + 1);
+    if (payload == NULL)
+    {
+        (void)printf("unable to allocate the payload\n");
+        result = __LINE__;
+    }
+    else
+    {
+        clock_t start;
+        double seconds;
+        size_t i;
+
+        fillPayload(payload, pattern);
+        result = 0;
+        start = clock();
+        for (i = 0; i < PASSES; i++)
+        {
+            STRING_HANDLE json = STRING_new_JSON(payload);
+            if (json == NULL)
+            {
+                (void)printf("STRING_new_JSON failed\n");
+                result = __LINE__;
+                break;
+            }
+            STRING_delete(json);
+        }
+        seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        if (result == 0)
+        {
+            (void)printf("%-6s %lu bytes x %d: %8.3f s, %8.1f MB/s\n", name, (unsigned long)PAYLOAD_SIZE, PASSES, seconds,
+                (seconds > 0) ? ((double)PAYLOAD_SIZE * PASSES) / (1024 * 1024) / seconds : 0.0);
+        }
+        free(payload);
+    }
+    return result;
+}
+
+int main(void)
+{
+#ifdef STRING_NO_SIMD
+    (void)printf("STRING_new_JSON, scalar\n");
+#else
+    (void)printf("STRING_new_JSON\n");
+#endif
+    return ((runBenchmark("text", TEXT_PATTERN) == 0) && (runBenchmark("json", JSON_PATTERN) == 0)) ? 0 : 1;
+}
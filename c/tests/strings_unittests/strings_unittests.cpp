@@ -33,8 +33,11 @@ static const char MULTIPLE_TEST_STRING_VALUE[] = "DataValueTestDataValueTest";
 static const char* COMBINED_STRING_VALUE = "Initial_DataValueTest";
 static const char* QUOTED_TEST_STRING_VALUE = "\"DataValueTest\"";
 static const char* EMPTY_STRING = "";
+static const char LONG_STRING_VALUE[] = "DataValueTest that does not fit in the handle";
 
 #define NUMBER_OF_CHAR_TOCOPY               8
+/*the chars of shorter strings are kept inside the STRING handle*/
+#define SMALL_STRING_CAPACITY               24
 
 #define GBALLOC_H
 
@@ -163,7 +166,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(1));
 
         ///act
         g_hString = STRING_new();
@@ -223,7 +225,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_STRING_VALUE) + 1));
 
         ///act
         g_hString = STRING_construct(TEST_STRING_VALUE);
@@ -258,7 +259,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(2 + strlen(TEST_STRING_VALUE) + 1));
 
         ///act
         g_hString = STRING_new_quoted(TEST_STRING_VALUE);
@@ -293,9 +293,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(INITAL_STRING_VALUE);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, strlen(INITAL_STRING_VALUE) + strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
-
         ///act
         int nResult = STRING_concat(g_hString, TEST_STRING_VALUE);
 
@@ -374,9 +371,8 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_copy(g_hString, TEST_STRING_VALUE);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, strlen(TEST_STRING_VALUE) + strlen(TEST_STRING_VALUE)+1))
-            .IgnoreArgument(1)
-            .IgnoreArgument(2);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG)) /*the chars do not fit in the handle anymore*/
+            .IgnoreArgument(1);
 
         ///act
         STRING_concat(g_hString, TEST_STRING_VALUE);
@@ -399,9 +395,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         STRING_HANDLE hAppend = STRING_construct(TEST_STRING_VALUE);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, strlen(INITAL_STRING_VALUE) + strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
-
         ///act
         int nResult = STRING_concat_with_STRING(g_hString, hAppend);
 
@@ -475,9 +468,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(INITAL_STRING_VALUE);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
-
         ///act
         int nResult = STRING_copy(g_hString, TEST_STRING_VALUE);
 
@@ -519,9 +509,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(INITAL_STRING_VALUE);
         mocks.ResetAllCalls();
         
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, NUMBER_OF_CHAR_TOCOPY + 1))
-            .IgnoreArgument(1);
-
         ///act
         int nResult = STRING_copy_n(g_hString, COMBINED_STRING_VALUE, NUMBER_OF_CHAR_TOCOPY);
 
@@ -575,9 +562,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(INITAL_STRING_VALUE);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1))
-            .IgnoreArgument(1);
-
         ///act
         int nResult = STRING_copy_n(g_hString, COMBINED_STRING_VALUE, 0);
 
@@ -599,9 +583,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(TEST_STRING_VALUE);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 2 + strlen(TEST_STRING_VALUE) + 1))
-            .IgnoreArgument(1);
-
         ///act
         int nResult = STRING_quote(g_hString);
 
@@ -647,7 +628,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(TEST_STRING_VALUE) + 1));
 
         ///act
         g_hString = STRING_construct(TEST_STRING_VALUE);
@@ -670,9 +650,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_construct(TEST_STRING_VALUE);
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, 1))
-            .IgnoreArgument(1);
-
         ///act
         int nResult = STRING_empty(g_hString);
 
@@ -718,8 +695,6 @@ BEGIN_TEST_SUITE(strings_unittests)
         g_hString = STRING_new();
         mocks.ResetAllCalls();
 
-        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
-            .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
             .IgnoreArgument(1);
 
@@ -784,7 +759,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(sizeof("aa")));
 
         ///act
         auto result = STRING_clone(hSource);
@@ -832,8 +806,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(3))
-            .IgnoreArgument(1);
 
         ///act
         auto result = STRING_construct_n("qq", 2);
@@ -855,8 +827,6 @@ BEGIN_TEST_SUITE(strings_unittests)
 
         STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
             .IgnoreArgument(1);
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(4))
-            .IgnoreArgument(1);
 
         ///act
         auto result = STRING_construct_n("12345", 3);
@@ -1016,7 +986,10 @@ BEGIN_TEST_SUITE(strings_unittests)
             CSTRINGSMocks mocks;
             STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
                 .IgnoreArgument(1);
-            STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(JSONtests[i].expectedJSON) + 1));
+            if (strlen(JSONtests[i].expectedJSON) + 1 > SMALL_STRING_CAPACITY)
+            {
+                STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(JSONtests[i].expectedJSON) + 1));
+            }
 
             ///act
             auto result = STRING_new_JSON(JSONtests[i].source);
@@ -1031,6 +1004,57 @@ BEGIN_TEST_SUITE(strings_unittests)
     }
 
     /*Codes_SRS_STRING_02_021: [If the complete JSON representation cannot be produced, then STRING_new_JSON shall fail and return NULL.] */
+    TEST_FUNCTION(STRING_new_JSON_escapes_a_char_at_any_position_of_a_long_string)
+    {
+        for (size_t i = 0; i < 70; i++)
+        {
+            for (size_t j = 0; j < 4; j++)
+            {
+                ///arrange
+                CSTRINGSMocks mocks;
+                static const char special[4] = { '"', '\\', '/', '\x1F' };
+                static const char* escaped[4] = { "\\\"", "\\\\", "\\/", "\\u001F" };
+                char source[71];
+                std::string expectedJSON;
+                (void)memset(source, 'a', 70);
+                source[70] = '\0';
+                source[i] = special[j];
+                expectedJSON = "\"" + std::string(i, 'a') + escaped[j] + std::string(69 - i, 'a') + "\"";
+
+                ///act
+                auto result = STRING_new_JSON(source);
+
+                ///assert
+                ASSERT_ARE_EQUAL(char_ptr, expectedJSON.c_str(), STRING_c_str(result));
+                ASSERT_ARE_EQUAL(size_t, expectedJSON.size(), STRING_length(result));
+
+                ///cleanup
+                STRING_delete(result);
+                mocks.ResetAllCalls(); /*not caring of any calls*/
+            }
+        }
+    }
+
+    TEST_FUNCTION(STRING_new_JSON_fails_for_a_non_ASCII_char_at_any_position_of_a_long_string)
+    {
+        for (size_t i = 0; i < 70; i++)
+        {
+            ///arrange
+            CSTRINGSMocks mocks;
+            char source[71];
+            (void)memset(source, 'a', 70);
+            source[70] = '\0';
+            source[i] = '\x80';
+
+            ///act
+            auto result = STRING_new_JSON(source);
+
+            ///assert
+            ASSERT_IS_NULL(result);
+            mocks.AssertActualAndExpectedCalls();
+        }
+    }
+
     TEST_FUNCTION(STRING_new_JSON_when_gballoc_fails_it_fails_1)
     {
         ///arrange
@@ -1041,10 +1065,10 @@ BEGIN_TEST_SUITE(strings_unittests)
             .IgnoreArgument(1);
 
         whenShallmalloc_fail = 2;
-        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen("ab") + 2+1));
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(strlen(LONG_STRING_VALUE) + 2+1));
 
         ///act
-        auto result = STRING_new_JSON("ab");
+        auto result = STRING_new_JSON(LONG_STRING_VALUE);
 
         ///assert
         ASSERT_IS_NULL(result);
@@ -1088,4 +1112,592 @@ BEGIN_TEST_SUITE(strings_unittests)
         ///cleanup
     }
 
+    TEST_FUNCTION(STRING_new_in_arena_with_NULL_arena_fails)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+
+        ///act
+        auto result = STRING_new_in_arena(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        mocks.AssertActualAndExpectedCalls();
+    }
+
+    TEST_FUNCTION(STRING_construct_in_arena_with_NULL_psz_fails)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        mocks.ResetAllCalls();
+
+        ///act
+        auto result = STRING_construct_in_arena(arena, NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        ARENA_destroy(arena);
+    }
+
+    TEST_FUNCTION(STRING_construct_in_arena_succeeds)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+
+        ///act
+        auto result = STRING_construct_in_arena(arena, TEST_STRING_VALUE);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING_VALUE, STRING_c_str(result));
+
+        ///cleanup
+        STRING_delete(result);
+        ARENA_destroy(arena);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(STRING_operations_on_a_string_in_an_arena_do_not_use_the_heap)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = STRING_new_in_arena(arena);
+        mocks.ResetAllCalls();
+
+        ///act
+        ASSERT_ARE_EQUAL(int, 0, STRING_concat(handle, INITAL_STRING_VALUE));
+        ASSERT_ARE_EQUAL(int, 0, STRING_concat(handle, TEST_STRING_VALUE));
+        ASSERT_ARE_EQUAL(int, 0, STRING_quote(handle));
+        STRING_delete(handle);
+
+        ///assert
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        ARENA_destroy(arena);
+    }
+
+    TEST_FUNCTION(STRING_concat_on_a_string_in_an_arena_keeps_the_content)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = STRING_construct_in_arena(arena, INITAL_STRING_VALUE);
+        auto other = STRING_construct_in_arena(arena, EMPTY_STRING);
+
+        ///act
+        int result = STRING_concat(handle, TEST_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, COMBINED_STRING_VALUE, STRING_c_str(handle));
+        ASSERT_ARE_EQUAL(char_ptr, EMPTY_STRING, STRING_c_str(other));
+
+        ///cleanup
+        STRING_delete(other);
+        STRING_delete(handle);
+        ARENA_destroy(arena);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(STRING_clone_of_a_string_in_an_arena_is_on_the_heap)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = STRING_construct_in_arena(arena, TEST_STRING_VALUE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        auto result = STRING_clone(handle);
+
+        ///assert
+        mocks.AssertActualAndExpectedCalls();
+        ARENA_destroy(arena);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING_VALUE, STRING_c_str(result));
+
+        ///cleanup
+        STRING_delete(result);
+    }
+
+    TEST_FUNCTION(STRING_concat_of_single_chars_grows_the_string_geometrically)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        STRING_HANDLE g_hString = STRING_new();
+        size_t i;
+        mocks.ResetAllCalls();
+
+        /*the chars leave the handle at SMALL_STRING_CAPACITY, then the capacity goes 48, 96, ... 1536*/
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(2 * SMALL_STRING_CAPACITY));
+        for (i = 2; i <= 6; i++)
+        {
+            STRICT_EXPECTED_CALL(mocks, gballoc_realloc(IGNORED_PTR_ARG, SMALL_STRING_CAPACITY << i))
+                .IgnoreArgument(1);
+        }
+
+        ///act
+        for (i = 0; i < 1023; i++)
+        {
+            ASSERT_ARE_EQUAL(int, 0, STRING_concat(g_hString, "a"));
+        }
+
+        ///assert
+        mocks.AssertActualAndExpectedCalls();
+        ASSERT_ARE_EQUAL(size_t, 1023, STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(size_t, 1023, strlen(STRING_c_str(g_hString)));
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    TEST_FUNCTION(STRING_concat_within_the_capacity_does_not_reallocate)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        STRING_HANDLE g_hString = STRING_construct(INITAL_STRING_VALUE);
+        (void)STRING_concat(g_hString, TEST_STRING_VALUE);
+        (void)STRING_concat(g_hString, "a");
+        mocks.ResetAllCalls();
+
+        ///act
+        int nResult = STRING_concat(g_hString, "b");
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(char_ptr, "Initial_DataValueTestab", STRING_c_str(g_hString));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        STRING_delete(g_hString);
+    }
+
+    TEST_FUNCTION(STRING_concat_of_the_string_itself_doubles_it)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        STRING_HANDLE g_hString = STRING_construct(TEST_STRING_VALUE);
+
+        ///act
+        int nResult = STRING_concat(g_hString, STRING_c_str(g_hString));
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(char_ptr, MULTIPLE_TEST_STRING_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(size_t, strlen(MULTIPLE_TEST_STRING_VALUE), STRING_length(g_hString));
+
+        ///cleanup
+        STRING_delete(g_hString);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(STRING_concat_with_STRING_of_the_string_itself_doubles_it)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        STRING_HANDLE g_hString = STRING_construct(TEST_STRING_VALUE);
+
+        ///act
+        int nResult = STRING_concat_with_STRING(g_hString, g_hString);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, nResult);
+        ASSERT_ARE_EQUAL(char_ptr, MULTIPLE_TEST_STRING_VALUE, STRING_c_str(g_hString));
+        ASSERT_ARE_EQUAL(size_t, strlen(MULTIPLE_TEST_STRING_VALUE), STRING_length(g_hString));
+
+        ///cleanup
+        STRING_delete(g_hString);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(STRING_length_follows_every_operation)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        STRING_HANDLE g_hString = STRING_construct_n(COMBINED_STRING_VALUE, NUMBER_OF_CHAR_TOCOPY);
+        STRING_HANDLE hJSON = STRING_new_JSON("a\"b");
+        STRING_HANDLE hQuoted = STRING_new_quoted(TEST_STRING_VALUE);
+        STRING_HANDLE hClone = STRING_clone(hQuoted);
+
+        ///act
+        ASSERT_ARE_EQUAL(size_t, NUMBER_OF_CHAR_TOCOPY, STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(size_t, strlen("\"a\\\"b\""), STRING_length(hJSON));
+        ASSERT_ARE_EQUAL(size_t, strlen(QUOTED_TEST_STRING_VALUE), STRING_length(hQuoted));
+        ASSERT_ARE_EQUAL(size_t, strlen(QUOTED_TEST_STRING_VALUE), STRING_length(hClone));
+        ASSERT_ARE_EQUAL(int, 0, STRING_quote(g_hString));
+        ASSERT_ARE_EQUAL(size_t, NUMBER_OF_CHAR_TOCOPY + 2, STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(int, 0, STRING_copy(g_hString, TEST_STRING_VALUE));
+        ASSERT_ARE_EQUAL(size_t, strlen(TEST_STRING_VALUE), STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(int, 0, STRING_copy_n(g_hString, TEST_STRING_VALUE, 4));
+        ASSERT_ARE_EQUAL(size_t, 4, STRING_length(g_hString));
+        ASSERT_ARE_EQUAL(int, 0, STRING_empty(g_hString));
+        ASSERT_ARE_EQUAL(size_t, 0, STRING_length(g_hString));
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, STRING_concat(g_hString, TEST_STRING_VALUE));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING_VALUE, STRING_c_str(g_hString));
+
+        ///cleanup
+        STRING_delete(hClone);
+        STRING_delete(hQuoted);
+        STRING_delete(hJSON);
+        STRING_delete(g_hString);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(STRING_length_of_a_string_new_with_memory_is_the_length_of_the_memory)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        char* memory = (char*)malloc(sizeof(TEST_STRING_VALUE));
+        (void)memcpy(memory, TEST_STRING_VALUE, sizeof(TEST_STRING_VALUE));
+        STRING_HANDLE g_hString = STRING_new_with_memory(memory);
+
+        ///act
+        size_t result = STRING_length(g_hString);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, strlen(TEST_STRING_VALUE), result);
+        ASSERT_ARE_EQUAL(int, 0, STRING_concat(g_hString, INITAL_STRING_VALUE));
+        ASSERT_ARE_EQUAL(char_ptr, "DataValueTestInitial_", STRING_c_str(g_hString));
+
+        ///cleanup
+        STRING_delete(g_hString);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(STRING_construct_of_a_long_string_allocates_the_chars)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(sizeof(LONG_STRING_VALUE)));
+
+        ///act
+        auto result = STRING_construct(LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, LONG_STRING_VALUE, STRING_c_str(result));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        STRING_delete(result);
+    }
+
+    TEST_FUNCTION(STRING_delete_of_a_long_string_frees_the_chars)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        auto handle = STRING_construct(LONG_STRING_VALUE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        STRING_delete(handle);
+
+        ///assert
+        mocks.AssertActualAndExpectedCalls();
+    }
+
+    TEST_FUNCTION(STRING_copy_of_a_short_string_over_a_long_one_frees_the_chars)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        auto handle = STRING_construct(LONG_STRING_VALUE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        int result = STRING_copy(handle, TEST_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING_VALUE, STRING_c_str(handle));
+        ASSERT_ARE_EQUAL(size_t, strlen(TEST_STRING_VALUE), STRING_length(handle));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        STRING_delete(handle);
+    }
+
+    TEST_FUNCTION(STRING_concat_past_the_small_capacity_keeps_the_content)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        auto handle = STRING_construct(TEST_STRING_VALUE);
+        mocks.ResetAllCalls();
+
+        ///act
+        int result = STRING_concat(handle, LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, "DataValueTestDataValueTest that does not fit in the handle", STRING_c_str(handle));
+        ASSERT_ARE_EQUAL(size_t, strlen(TEST_STRING_VALUE) + strlen(LONG_STRING_VALUE), STRING_length(handle));
+
+        ///cleanup
+        STRING_delete(handle);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    TEST_FUNCTION(STRING_in_an_arena_moves_its_chars_between_the_handle_and_the_arena)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        ARENA_HANDLE arena = ARENA_create(0);
+        auto handle = STRING_construct_in_arena(arena, TEST_STRING_VALUE);
+
+        ///act
+        int result = STRING_concat(handle, LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, "DataValueTestDataValueTest that does not fit in the handle", STRING_c_str(handle));
+        ASSERT_ARE_EQUAL(int, 0, STRING_copy(handle, TEST_STRING_VALUE));
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING_VALUE, STRING_c_str(handle));
+
+        ///cleanup
+        STRING_delete(handle);
+        ARENA_destroy(arena);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
+    /* STRING_sprintf */
+
+    TEST_FUNCTION(STRING_sprintf_with_NULL_handle_fails)
+    {
+        ///arrange
+
+        ///act
+        int result = STRING_sprintf(NULL, "%d", 42);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+
+    TEST_FUNCTION(STRING_sprintf_with_NULL_format_fails)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        auto handle = STRING_construct(TEST_STRING_VALUE);
+        mocks.ResetAllCalls();
+
+        ///act
+        int result = STRING_sprintf(handle, NULL);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING_VALUE, STRING_c_str(handle));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        STRING_delete(handle);
+    }
+
+    TEST_FUNCTION(STRING_sprintf_replaces_the_content)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        auto handle = STRING_construct(TEST_STRING_VALUE);
+        mocks.ResetAllCalls();
+
+        ///act
+        int result = STRING_sprintf(handle, "%s=%d", "a", 42);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, "a=42", STRING_c_str(handle));
+        ASSERT_ARE_EQUAL(size_t, 4, STRING_length(handle));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        STRING_delete(handle);
+    }
+
+    TEST_FUNCTION(STRING_sprintf_of_a_long_output_allocates_its_exact_size)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        auto handle = STRING_new();
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(sizeof(LONG_STRING_VALUE) + 2));
+
+        ///act
+        int result = STRING_sprintf(handle, "[%s]", LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, "[DataValueTest that does not fit in the handle]", STRING_c_str(handle));
+        ASSERT_ARE_EQUAL(size_t, sizeof(LONG_STRING_VALUE) + 1, STRING_length(handle));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        STRING_delete(handle);
+    }
+
+    TEST_FUNCTION(STRING_sprintf_when_malloc_fails_leaves_the_string_empty)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        auto handle = STRING_construct(TEST_STRING_VALUE);
+        mocks.ResetAllCalls();
+
+        whenShallmalloc_fail = currentmalloc_call + 1;
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(sizeof(LONG_STRING_VALUE)));
+
+        ///act
+        int result = STRING_sprintf(handle, "%s", LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, "", STRING_c_str(handle));
+        ASSERT_ARE_EQUAL(size_t, 0, STRING_length(handle));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        STRING_delete(handle);
+    }
+
+    /* STRING_concat_format */
+
+    TEST_FUNCTION(STRING_concat_format_with_NULL_handle_fails)
+    {
+        ///arrange
+
+        ///act
+        int result = STRING_concat_format(NULL, "%d", 42);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+
+    TEST_FUNCTION(STRING_concat_format_with_NULL_format_fails)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        auto handle = STRING_construct(TEST_STRING_VALUE);
+        mocks.ResetAllCalls();
+
+        ///act
+        int result = STRING_concat_format(handle, NULL);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING_VALUE, STRING_c_str(handle));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        STRING_delete(handle);
+    }
+
+    TEST_FUNCTION(STRING_concat_format_that_fits_does_not_allocate)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        auto handle = STRING_construct(INITAL_STRING_VALUE);
+        mocks.ResetAllCalls();
+
+        ///act
+        int result = STRING_concat_format(handle, "%s%u", "x", 7u);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, "Initial_x7", STRING_c_str(handle));
+        ASSERT_ARE_EQUAL(size_t, 10, STRING_length(handle));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        STRING_delete(handle);
+    }
+
+    TEST_FUNCTION(STRING_concat_format_past_the_capacity_grows_the_string)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        auto handle = STRING_construct(TEST_STRING_VALUE);
+        mocks.ResetAllCalls();
+
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        int result = STRING_concat_format(handle, " %s %d", LONG_STRING_VALUE, -1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, "DataValueTest DataValueTest that does not fit in the handle -1", STRING_c_str(handle));
+        ASSERT_ARE_EQUAL(size_t, strlen("DataValueTest DataValueTest that does not fit in the handle -1"), STRING_length(handle));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        STRING_delete(handle);
+    }
+
+    TEST_FUNCTION(STRING_concat_format_when_malloc_fails_leaves_the_content_unchanged)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        auto handle = STRING_construct(TEST_STRING_VALUE);
+        mocks.ResetAllCalls();
+
+        whenShallmalloc_fail = currentmalloc_call + 1;
+        STRICT_EXPECTED_CALL(mocks, gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+
+        ///act
+        int result = STRING_concat_format(handle, "%s", LONG_STRING_VALUE);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, TEST_STRING_VALUE, STRING_c_str(handle));
+        ASSERT_ARE_EQUAL(size_t, strlen(TEST_STRING_VALUE), STRING_length(handle));
+        mocks.AssertActualAndExpectedCalls();
+
+        ///cleanup
+        STRING_delete(handle);
+    }
+
+    TEST_FUNCTION(STRING_concat_format_in_a_loop_builds_the_whole_string)
+    {
+        ///arrange
+        CSTRINGSMocks mocks;
+        auto handle = STRING_new();
+        size_t i;
+        char expected[1024] = { 0 };
+        char* pos = expected;
+
+        ///act
+        for (i = 0; i < 100; i++)
+        {
+            ASSERT_ARE_EQUAL(int, 0, STRING_concat_format(handle, "%u,", (unsigned int)i));
+            pos += sprintf(pos, "%u,", (unsigned int)i);
+        }
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, expected, STRING_c_str(handle));
+        ASSERT_ARE_EQUAL(size_t, strlen(expected), STRING_length(handle));
+
+        ///cleanup
+        STRING_delete(handle);
+        mocks.ResetAllCalls(); /*not caring of any calls*/
+    }
+
 END_TEST_SUITE(strings_unittests)
\ No newline at end of file
@@ -10,8 +10,11 @@
 
 #include "testrunnerswitcher.h"
 #include "tickcounter.h"
+#include "threadapi.h"
 #include "micromock.h"
 
+#define TEST_SLEEP_MS 50
+
 static MICROMOCK_GLOBAL_SEMAPHORE_HANDLE g_dllByDll;
 
 BEGIN_TEST_SUITE(tickcounter_UnitTests)
@@ -26,4 +29,178 @@ TEST_SUITE_CLEANUP(suite_cleanup)
     DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
 }
 
+/* tickcounter_create */
+
+TEST_FUNCTION(tickcounter_create_succeeds)
+{
+    // arrange
+
+    // act
+    TICK_COUNTER_HANDLE result = tickcounter_create();
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+
+    // cleanup
+    tickcounter_destroy(result);
+}
+
+/* tickcounter_destroy */
+
+TEST_FUNCTION(tickcounter_destroy_with_NULL_does_nothing)
+{
+    // arrange
+
+    // act
+    tickcounter_destroy(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+/* tickcounter_get_current_ms */
+
+TEST_FUNCTION(tickcounter_get_current_ms_with_NULL_arguments_fails)
+{
+    // arrange
+    TICK_COUNTER_HANDLE tickCounter = tickcounter_create();
+    uint64_t current_ms;
+
+    // act
+    int result1 = tickcounter_get_current_ms(NULL, &current_ms);
+    int result2 = tickcounter_get_current_ms(tickCounter, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result1);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result2);
+
+    // cleanup
+    tickcounter_destroy(tickCounter);
+}
+
+TEST_FUNCTION(tickcounter_get_current_ms_counts_from_the_creation_of_the_counter)
+{
+    // arrange
+    TICK_COUNTER_HANDLE tickCounter = tickcounter_create();
+    uint64_t current_ms;
+
+    // act
+    int result = tickcounter_get_current_ms(tickCounter, &current_ms);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(current_ms < TEST_SLEEP_MS);
+
+    // cleanup
+    tickcounter_destroy(tickCounter);
+}
+
+TEST_FUNCTION(tickcounter_get_current_ms_keeps_counting_while_the_thread_sleeps)
+{
+    // arrange
+    TICK_COUNTER_HANDLE tickCounter = tickcounter_create();
+    uint64_t before_ms;
+    uint64_t after_ms;
+    ASSERT_ARE_EQUAL(int, 0, tickcounter_get_current_ms(tickCounter, &before_ms));
+
+    // act
+    ThreadAPI_Sleep(TEST_SLEEP_MS);
+    int result = tickcounter_get_current_ms(tickCounter, &after_ms);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(after_ms - before_ms >= TEST_SLEEP_MS);
+
+    // cleanup
+    tickcounter_destroy(tickCounter);
+}
+
+/* tickcounter_get_current_us */
+
+TEST_FUNCTION(tickcounter_get_current_us_with_NULL_arguments_fails)
+{
+    // arrange
+    TICK_COUNTER_HANDLE tickCounter = tickcounter_create();
+    uint64_t current_us;
+
+    // act
+    int result1 = tickcounter_get_current_us(NULL, &current_us);
+    int result2 = tickcounter_get_current_us(tickCounter, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result1);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result2);
+
+    // cleanup
+    tickcounter_destroy(tickCounter);
+}
+
+TEST_FUNCTION(tickcounter_get_current_us_is_at_least_the_ms_read_before)
+{
+    // arrange
+    TICK_COUNTER_HANDLE tickCounter = tickcounter_create();
+    uint64_t current_ms;
+    uint64_t current_us;
+    ThreadAPI_Sleep(1);
+    ASSERT_ARE_EQUAL(int, 0, tickcounter_get_current_ms(tickCounter, &current_ms));
+
+    // act
+    int result = tickcounter_get_current_us(tickCounter, &current_us);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(current_us >= current_ms * 1000);
+
+    // cleanup
+    tickcounter_destroy(tickCounter);
+}
+
+/* tickcounter_get_current_ns */
+
+TEST_FUNCTION(tickcounter_get_current_ns_with_NULL_arguments_fails)
+{
+    // arrange
+    TICK_COUNTER_HANDLE tickCounter = tickcounter_create();
+    uint64_t current_ns;
+
+    // act
+    int result1 = tickcounter_get_current_ns(NULL, &current_ns);
+    int result2 = tickcounter_get_current_ns(tickCounter, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result1);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result2);
+
+    // cleanup
+    tickcounter_destroy(tickCounter);
+}
+
+TEST_FUNCTION(tickcounter_get_current_ns_is_at_least_the_us_read_before_and_never_goes_backwards)
+{
+    // arrange
+    TICK_COUNTER_HANDLE tickCounter = tickcounter_create();
+    uint64_t current_us;
+    uint64_t previous_ns;
+    size_t i;
+    ThreadAPI_Sleep(1);
+    ASSERT_ARE_EQUAL(int, 0, tickcounter_get_current_us(tickCounter, &current_us));
+
+    // act
+    int result = tickcounter_get_current_ns(tickCounter, &previous_ns);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(previous_ns >= current_us * 1000);
+    for (i = 0; i < 1000; i++)
+    {
+        uint64_t current_ns;
+        ASSERT_ARE_EQUAL(int, 0, tickcounter_get_current_ns(tickCounter, &current_ns));
+        ASSERT_IS_TRUE(current_ns >= previous_ns);
+        previous_ns = current_ns;
+    }
+
+    // cleanup
+    tickcounter_destroy(tickCounter);
+}
+
 END_TEST_SUITE(tickcounter_UnitTests)
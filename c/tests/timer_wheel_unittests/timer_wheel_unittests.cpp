@@ -0,0 +1,623 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <cstdlib>
+#include <cstdint>
+#ifdef _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "micromock.h"
+
+#include "timer_wheel.h"
+#include "tickcounter.h"
+#include "gballoc.h"
+
+#define TEST_TICK_COUNTER_HANDLE (TICK_COUNTER_HANDLE)0x4242
+
+/*the wheel is not expected to start at 0*/
+#define TEST_START_MS 1000003
+
+/*further away than the last level of the wheel*/
+#define TEST_FAR_TIMEOUT_MS 20000000
+
+#define MANY_TIMERS 1000
+#define MANY_TIMERS_SPAN_MS 100000
+
+static uint64_t g_now;
+static int g_tickcounter_result;
+static size_t g_tickcounter_calls;
+
+typedef struct TEST_TIMER_TAG
+{
+    TIMER_WHEEL_TIMER timer;
+    size_t fired_count;
+    uint64_t fired_ms;
+    uint64_t expected_ms;
+    TIMER_WHEEL_HANDLE timer_wheel;
+    TIMER_WHEEL_TIMER* to_cancel;
+    uint64_t reschedule_ms;
+} TEST_TIMER;
+
+static TEST_TIMER* g_fired[8];
+static size_t g_fired_count;
+
+static void on_timer_expired(void* context)
+{
+    TEST_TIMER* testTimer = (TEST_TIMER*)context;
+    testTimer->fired_count++;
+    testTimer->fired_ms = g_now;
+    if (g_fired_count < sizeof(g_fired) / sizeof(g_fired[0]))
+    {
+        g_fired[g_fired_count] = testTimer;
+    }
+    g_fired_count++;
+
+    if (testTimer->to_cancel != NULL)
+    {
+        TIMER_WHEEL_cancel(testTimer->timer_wheel, testTimer->to_cancel);
+    }
+    if (testTimer->reschedule_ms != 0)
+    {
+        (void)TIMER_WHEEL_schedule(testTimer->timer_wheel, &testTimer->timer, testTimer->reschedule_ms);
+    }
+}
+
+static void init_test_timer(TEST_TIMER* testTimer, TIMER_WHEEL_HANDLE timerWheel)
+{
+    TIMER_WHEEL_init_timer(&testTimer->timer, on_timer_expired, testTimer);
+    testTimer->fired_count = 0;
+    testTimer->fired_ms = 0;
+    testTimer->expected_ms = 0;
+    testTimer->timer_wheel = timerWheel;
+    testTimer->to_cancel = NULL;
+    testTimer->reschedule_ms = 0;
+}
+
+static void advance_to(TIMER_WHEEL_HANDLE timerWheel, uint64_t ms)
+{
+    g_now = ms;
+    TIMER_WHEEL_dowork(timerWheel);
+}
+
+/*the wheel gets its time from here instead of the real tick counter*/
+extern "C" int tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, uint64_t* current_ms)
+{
+    g_tickcounter_calls++;
+    if ((tick_counter == TEST_TICK_COUNTER_HANDLE) && (g_tickcounter_result == 0))
+    {
+        *current_ms = g_now;
+    }
+    return g_tickcounter_result;
+}
+
+static MICROMOCK_MUTEX_HANDLE g_testByTest;
+static MICROMOCK_GLOBAL_SEMAPHORE_HANDLE g_dllByDll;
+
+BEGIN_TEST_SUITE(TimerWheel_UnitTests)
+
+TEST_SUITE_INITIALIZE(TestClassInitialize)
+{
+    INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    g_testByTest = MicroMockCreateMutex();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    MicroMockDestroyMutex(g_testByTest);
+    DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+}
+
+TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+{
+    if (!MicroMockAcquireMutex(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+    g_now = TEST_START_MS;
+    g_tickcounter_result = 0;
+    g_tickcounter_calls = 0;
+    g_fired_count = 0;
+}
+
+TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+{
+    if (!MicroMockReleaseMutex(g_testByTest))
+    {
+        ASSERT_FAIL("failure in test framework at ReleaseMutex");
+    }
+}
+
+/* TIMER_WHEEL_create */
+
+TEST_FUNCTION(TIMER_WHEEL_create_with_NULL_tick_counter_fails)
+{
+    // arrange
+
+    // act
+    TIMER_WHEEL_HANDLE result = TIMER_WHEEL_create(NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_create_fails_when_the_tick_counter_fails)
+{
+    // arrange
+    ASSERT_ARE_EQUAL(int, 0, gballoc_init());
+    g_tickcounter_result = __LINE__;
+
+    // act
+    TIMER_WHEEL_HANDLE result = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    gballoc_deinit();
+}
+
+TEST_FUNCTION(TIMER_WHEEL_create_reads_the_tick_counter)
+{
+    // arrange
+
+    // act
+    TIMER_WHEEL_HANDLE result = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 1, g_tickcounter_calls);
+
+    // cleanup
+    TIMER_WHEEL_destroy(result);
+}
+
+/* TIMER_WHEEL_destroy */
+
+TEST_FUNCTION(TIMER_WHEEL_destroy_with_NULL_does_nothing)
+{
+    // arrange
+
+    // act
+    TIMER_WHEEL_destroy(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(TIMER_WHEEL_destroy_cancels_the_scheduled_timers)
+{
+    // arrange
+    ASSERT_ARE_EQUAL(int, 0, gballoc_init());
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER near;
+    TEST_TIMER far;
+    init_test_timer(&near, timerWheel);
+    init_test_timer(&far, timerWheel);
+    ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &near.timer, 10));
+    ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &far.timer, TEST_FAR_TIMEOUT_MS));
+
+    // act
+    TIMER_WHEEL_destroy(timerWheel);
+
+    // assert
+    ASSERT_IS_FALSE(TIMER_WHEEL_is_scheduled(&near.timer));
+    ASSERT_IS_FALSE(TIMER_WHEEL_is_scheduled(&far.timer));
+    ASSERT_ARE_EQUAL(size_t, 0, gballoc_getCurrentMemoryUsed());
+
+    // cleanup
+    gballoc_deinit();
+}
+
+/* TIMER_WHEEL_init_timer */
+
+TEST_FUNCTION(TIMER_WHEEL_init_timer_with_NULL_timer_does_nothing)
+{
+    // arrange
+
+    // act
+    TIMER_WHEEL_init_timer(NULL, on_timer_expired, NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(TIMER_WHEEL_init_timer_leaves_the_timer_not_scheduled)
+{
+    // arrange
+    TIMER_WHEEL_TIMER timer;
+
+    // act
+    TIMER_WHEEL_init_timer(&timer, on_timer_expired, NULL);
+
+    // assert
+    ASSERT_IS_FALSE(TIMER_WHEEL_is_scheduled(&timer));
+}
+
+/* TIMER_WHEEL_schedule */
+
+TEST_FUNCTION(TIMER_WHEEL_schedule_with_NULL_arguments_fails)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TIMER_WHEEL_TIMER timer;
+    TIMER_WHEEL_init_timer(&timer, on_timer_expired, NULL);
+
+    // act
+    int result1 = TIMER_WHEEL_schedule(NULL, &timer, 10);
+    int result2 = TIMER_WHEEL_schedule(timerWheel, NULL, 10);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result1);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result2);
+    ASSERT_IS_FALSE(TIMER_WHEEL_is_scheduled(&timer));
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_schedule_of_a_timer_without_callback_fails)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TIMER_WHEEL_TIMER timer;
+    TIMER_WHEEL_init_timer(&timer, NULL, NULL);
+
+    // act
+    int result = TIMER_WHEEL_schedule(timerWheel, &timer, 10);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_FALSE(TIMER_WHEEL_is_scheduled(&timer));
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_schedule_fails_when_the_tick_counter_fails)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER testTimer;
+    init_test_timer(&testTimer, timerWheel);
+    g_tickcounter_result = __LINE__;
+
+    // act
+    int result = TIMER_WHEEL_schedule(timerWheel, &testTimer.timer, 10);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_FALSE(TIMER_WHEEL_is_scheduled(&testTimer.timer));
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_schedule_fires_the_timer_once_the_timeout_has_passed)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER testTimer;
+    init_test_timer(&testTimer, timerWheel);
+
+    // act
+    int result = TIMER_WHEEL_schedule(timerWheel, &testTimer.timer, 10);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(TIMER_WHEEL_is_scheduled(&testTimer.timer));
+    advance_to(timerWheel, TEST_START_MS + 9);
+    ASSERT_ARE_EQUAL(size_t, 0, testTimer.fired_count);
+    advance_to(timerWheel, TEST_START_MS + 10);
+    ASSERT_ARE_EQUAL(size_t, 1, testTimer.fired_count);
+    ASSERT_IS_FALSE(TIMER_WHEEL_is_scheduled(&testTimer.timer));
+    advance_to(timerWheel, TEST_START_MS + 100);
+    ASSERT_ARE_EQUAL(size_t, 1, testTimer.fired_count);
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_schedule_with_0_timeout_fires_in_the_next_millisecond)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER testTimer;
+    init_test_timer(&testTimer, timerWheel);
+
+    // act
+    int result = TIMER_WHEEL_schedule(timerWheel, &testTimer.timer, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    advance_to(timerWheel, TEST_START_MS);
+    ASSERT_ARE_EQUAL(size_t, 0, testTimer.fired_count);
+    advance_to(timerWheel, TEST_START_MS + 1);
+    ASSERT_ARE_EQUAL(size_t, 1, testTimer.fired_count);
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_schedule_counts_from_now_when_dowork_is_late)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER pending;
+    TEST_TIMER testTimer;
+    init_test_timer(&pending, timerWheel);
+    init_test_timer(&testTimer, timerWheel);
+    ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &pending.timer, 1000000));
+    g_now = TEST_START_MS + 500;
+
+    // act
+    int result = TIMER_WHEEL_schedule(timerWheel, &testTimer.timer, 100);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    advance_to(timerWheel, TEST_START_MS + 599);
+    ASSERT_ARE_EQUAL(size_t, 0, testTimer.fired_count);
+    advance_to(timerWheel, TEST_START_MS + 600);
+    ASSERT_ARE_EQUAL(size_t, 1, testTimer.fired_count);
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_schedule_of_a_scheduled_timer_moves_it)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER testTimer;
+    init_test_timer(&testTimer, timerWheel);
+    ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &testTimer.timer, 10));
+
+    // act
+    int result = TIMER_WHEEL_schedule(timerWheel, &testTimer.timer, 5000);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    advance_to(timerWheel, TEST_START_MS + 4999);
+    ASSERT_ARE_EQUAL(size_t, 0, testTimer.fired_count);
+    advance_to(timerWheel, TEST_START_MS + 5000);
+    ASSERT_ARE_EQUAL(size_t, 1, testTimer.fired_count);
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+/* TIMER_WHEEL_cancel */
+
+TEST_FUNCTION(TIMER_WHEEL_cancel_with_NULL_arguments_does_nothing)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER testTimer;
+    init_test_timer(&testTimer, timerWheel);
+    ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &testTimer.timer, 10));
+
+    // act
+    TIMER_WHEEL_cancel(NULL, &testTimer.timer);
+    TIMER_WHEEL_cancel(timerWheel, NULL);
+
+    // assert
+    ASSERT_IS_TRUE(TIMER_WHEEL_is_scheduled(&testTimer.timer));
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_cancel_of_a_timer_that_is_not_scheduled_does_nothing)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER testTimer;
+    init_test_timer(&testTimer, timerWheel);
+
+    // act
+    TIMER_WHEEL_cancel(timerWheel, &testTimer.timer);
+
+    // assert
+    ASSERT_IS_FALSE(TIMER_WHEEL_is_scheduled(&testTimer.timer));
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_cancel_keeps_the_timer_from_firing)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER cancelled;
+    TEST_TIMER other;
+    init_test_timer(&cancelled, timerWheel);
+    init_test_timer(&other, timerWheel);
+    ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &other.timer, 10));
+    ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &cancelled.timer, 10));
+
+    // act
+    TIMER_WHEEL_cancel(timerWheel, &cancelled.timer);
+
+    // assert
+    ASSERT_IS_FALSE(TIMER_WHEEL_is_scheduled(&cancelled.timer));
+    advance_to(timerWheel, TEST_START_MS + 100);
+    ASSERT_ARE_EQUAL(size_t, 0, cancelled.fired_count);
+    ASSERT_ARE_EQUAL(size_t, 1, other.fired_count);
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+/* TIMER_WHEEL_dowork */
+
+TEST_FUNCTION(TIMER_WHEEL_dowork_with_NULL_handle_does_nothing)
+{
+    // arrange
+
+    // act
+    TIMER_WHEEL_dowork(NULL);
+
+    // assert
+    // no explicit assert, no crash
+}
+
+TEST_FUNCTION(TIMER_WHEEL_dowork_fires_nothing_when_the_tick_counter_fails)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER testTimer;
+    init_test_timer(&testTimer, timerWheel);
+    ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &testTimer.timer, 10));
+    g_tickcounter_result = __LINE__;
+
+    // act
+    advance_to(timerWheel, TEST_START_MS + 100);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 0, testTimer.fired_count);
+    ASSERT_IS_TRUE(TIMER_WHEEL_is_scheduled(&testTimer.timer));
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_dowork_fires_the_timers_of_all_levels_in_expiry_order)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    static const uint64_t timeouts[] = { TEST_FAR_TIMEOUT_MS, 300000, 5, 5000, 70, 63, 64, 4096 };
+    TEST_TIMER testTimers[sizeof(timeouts) / sizeof(timeouts[0])];
+    size_t i;
+    for (i = 0; i < sizeof(timeouts) / sizeof(timeouts[0]); i++)
+    {
+        init_test_timer(&testTimers[i], timerWheel);
+        ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &testTimers[i].timer, timeouts[i]));
+    }
+
+    // act
+    advance_to(timerWheel, TEST_START_MS + TEST_FAR_TIMEOUT_MS);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, sizeof(timeouts) / sizeof(timeouts[0]), g_fired_count);
+    ASSERT_ARE_EQUAL(void_ptr, &testTimers[2], g_fired[0]);
+    ASSERT_ARE_EQUAL(void_ptr, &testTimers[5], g_fired[1]);
+    ASSERT_ARE_EQUAL(void_ptr, &testTimers[6], g_fired[2]);
+    ASSERT_ARE_EQUAL(void_ptr, &testTimers[4], g_fired[3]);
+    ASSERT_ARE_EQUAL(void_ptr, &testTimers[7], g_fired[4]);
+    ASSERT_ARE_EQUAL(void_ptr, &testTimers[3], g_fired[5]);
+    ASSERT_ARE_EQUAL(void_ptr, &testTimers[1], g_fired[6]);
+    ASSERT_ARE_EQUAL(void_ptr, &testTimers[0], g_fired[7]);
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_dowork_fires_a_timer_beyond_the_last_level_on_time)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER testTimer;
+    init_test_timer(&testTimer, timerWheel);
+    ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &testTimer.timer, TEST_FAR_TIMEOUT_MS));
+
+    // act
+    advance_to(timerWheel, TEST_START_MS + TEST_FAR_TIMEOUT_MS - 1);
+    ASSERT_ARE_EQUAL(size_t, 0, testTimer.fired_count);
+    advance_to(timerWheel, TEST_START_MS + TEST_FAR_TIMEOUT_MS);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, testTimer.fired_count);
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_dowork_fires_each_timer_in_its_millisecond)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    static TEST_TIMER testTimers[MANY_TIMERS];
+    uint64_t ms;
+    size_t i;
+    unsigned int seed = 42;
+    for (i = 0; i < MANY_TIMERS; i++)
+    {
+        uint64_t timeout;
+        seed = seed * 1103515245 + 12345;
+        timeout = (seed >> 8) % MANY_TIMERS_SPAN_MS;
+        init_test_timer(&testTimers[i], timerWheel);
+        testTimers[i].expected_ms = TEST_START_MS + ((timeout == 0) ? 1 : timeout);
+        ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &testTimers[i].timer, timeout));
+    }
+
+    // act
+    for (ms = TEST_START_MS + 1; ms <= TEST_START_MS + MANY_TIMERS_SPAN_MS; ms++)
+    {
+        advance_to(timerWheel, ms);
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, MANY_TIMERS, g_fired_count);
+    for (i = 0; i < MANY_TIMERS; i++)
+    {
+        ASSERT_ARE_EQUAL(size_t, 1, testTimers[i].fired_count);
+        ASSERT_ARE_EQUAL(uint64_t, testTimers[i].expected_ms, testTimers[i].fired_ms);
+    }
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_dowork_lets_a_callback_reschedule_its_timer)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER testTimer;
+    uint64_t ms;
+    init_test_timer(&testTimer, timerWheel);
+    testTimer.reschedule_ms = 10;
+    ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &testTimer.timer, 10));
+
+    // act
+    for (ms = TEST_START_MS + 1; ms <= TEST_START_MS + 100; ms++)
+    {
+        advance_to(timerWheel, ms);
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 10, testTimer.fired_count);
+    ASSERT_IS_TRUE(TIMER_WHEEL_is_scheduled(&testTimer.timer));
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+TEST_FUNCTION(TIMER_WHEEL_dowork_lets_a_callback_cancel_a_timer_due_in_the_same_millisecond)
+{
+    // arrange
+    TIMER_WHEEL_HANDLE timerWheel = TIMER_WHEEL_create(TEST_TICK_COUNTER_HANDLE);
+    TEST_TIMER first;
+    TEST_TIMER second;
+    init_test_timer(&first, timerWheel);
+    init_test_timer(&second, timerWheel);
+    first.to_cancel = &second.timer;
+    second.to_cancel = &first.timer;
+    ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &first.timer, 10));
+    ASSERT_ARE_EQUAL(int, 0, TIMER_WHEEL_schedule(timerWheel, &second.timer, 10));
+
+    // act
+    advance_to(timerWheel, TEST_START_MS + 10);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, first.fired_count + second.fired_count);
+    ASSERT_IS_FALSE(TIMER_WHEEL_is_scheduled(&first.timer));
+    ASSERT_IS_FALSE(TIMER_WHEEL_is_scheduled(&second.timer));
+
+    // cleanup
+    TIMER_WHEEL_destroy(timerWheel);
+}
+
+END_TEST_SUITE(TimerWheel_UnitTests)
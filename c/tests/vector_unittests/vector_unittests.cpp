@@ -27,9 +27,24 @@ static bool PredicateFunction(const VECTOR_UNITTEST* handle, const VECTOR_UNITTE
     return (handle->nValue1 == otherHandle->nValue1 && handle->lValue2 == otherHandle->lValue2);
 }
 
+static int CompareFunction(const VECTOR_UNITTEST* left, const VECTOR_UNITTEST* right)
+{
+    return (left->nValue1 < right->nValue1) ? -1 : ((left->nValue1 > right->nValue1) ? 1 : 0);
+}
+
+static void ASSERT_IS_SORTED(VECTOR_HANDLE handle)
+{
+    size_t num = VECTOR_size(handle);
+    for (size_t nIndex = 1; nIndex < num; nIndex++)
+    {
+        ASSERT_IS_TRUE(((VECTOR_UNITTEST*)VECTOR_element(handle, nIndex - 1))->nValue1 <= ((VECTOR_UNITTEST*)VECTOR_element(handle, nIndex))->nValue1);
+    }
+}
+
 VECTOR_HANDLE g_handle;
 
 #define NUM_ITEM_PUSH_BACK      128
+#define NUM_ITEM_SORT           1000
 
 static MICROMOCK_GLOBAL_SEMAPHORE_HANDLE g_dllByDll;
 
@@ -414,6 +429,425 @@ BEGIN_TEST_SUITE(Vector_UnitTests)
         ASSERT_ARE_EQUAL(int, sItem1.lValue2, pResult->lValue2);
     }
 
+    TEST_FUNCTION(Vector_pop_back_with_NULL_Vector_Fail)
+    {
+        ///arrange
+
+        ///act
+        VECTOR_pop_back(NULL);
+
+        ///assert
+        // Make sure this pop_back doesn't crash
+    }
+
+    TEST_FUNCTION(Vector_pop_back_Empty_Vector_does_nothing)
+    {
+        ///arrange
+
+        ///act
+        VECTOR_pop_back(g_handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 0, VECTOR_size(g_handle));
+    }
+
+    TEST_FUNCTION(Vector_pop_back_removes_the_last_element)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem1 = {1, 2};
+        VECTOR_UNITTEST sItem2 = {3, 4};
+
+        (void)VECTOR_push_back(g_handle, &sItem1, 1);
+        (void)VECTOR_push_back(g_handle, &sItem2, 1);
+        size_t capacity = VECTOR_capacity(g_handle);
+
+        ///act
+        VECTOR_pop_back(g_handle);
+
+        ///assert
+        VECTOR_UNITTEST* pResult = (VECTOR_UNITTEST*)VECTOR_back(g_handle);
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_size(g_handle));
+        ASSERT_ARE_EQUAL(size_t, capacity, VECTOR_capacity(g_handle));
+        ASSERT_ARE_EQUAL(int, sItem1.nValue1, pResult->nValue1);
+        ASSERT_ARE_EQUAL(int, sItem1.lValue2, pResult->lValue2);
+    }
+
+    TEST_FUNCTION(Vector_capacity_with_NULL_Vector_fails)
+    {
+        ///arrange
+
+        ///act
+        size_t capacity = VECTOR_capacity(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 0, capacity);
+    }
+
+    TEST_FUNCTION(Vector_capacity_Empty_Success)
+    {
+        ///arrange
+
+        ///act
+        size_t capacity = VECTOR_capacity(g_handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 0, capacity);
+    }
+
+    TEST_FUNCTION(Vector_push_back_grows_the_capacity_geometrically)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem = {1, 2};
+        size_t growths = 0;
+        size_t capacity = VECTOR_capacity(g_handle);
+
+        ///act
+        for (size_t nIndex = 0; nIndex < NUM_ITEM_PUSH_BACK; nIndex++)
+        {
+            ASSERT_ARE_EQUAL(int, 0, VECTOR_push_back(g_handle, &sItem, 1));
+            if (VECTOR_capacity(g_handle) != capacity)
+            {
+                ASSERT_IS_TRUE(VECTOR_capacity(g_handle) >= 2 * capacity);
+                capacity = VECTOR_capacity(g_handle);
+                growths++;
+            }
+        }
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, NUM_ITEM_PUSH_BACK, VECTOR_size(g_handle));
+        ASSERT_IS_TRUE(VECTOR_capacity(g_handle) >= NUM_ITEM_PUSH_BACK);
+        ASSERT_IS_TRUE(growths <= 8);
+    }
+
+    TEST_FUNCTION(Vector_push_back_of_many_elements_grows_to_hold_them_all)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItems[NUM_ITEM_PUSH_BACK] = { { 0, 0 } };
+        sItems[NUM_ITEM_PUSH_BACK - 1].nValue1 = 42;
+
+        ///act
+        int result = VECTOR_push_back(g_handle, sItems, NUM_ITEM_PUSH_BACK);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, NUM_ITEM_PUSH_BACK, VECTOR_size(g_handle));
+        ASSERT_IS_TRUE(VECTOR_capacity(g_handle) >= NUM_ITEM_PUSH_BACK);
+        ASSERT_ARE_EQUAL(int, 42, ((VECTOR_UNITTEST*)VECTOR_back(g_handle))->nValue1);
+    }
+
+    TEST_FUNCTION(Vector_reserve_with_NULL_Vector_fails)
+    {
+        ///arrange
+
+        ///act
+        int result = VECTOR_reserve(NULL, 10);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+
+    TEST_FUNCTION(Vector_reserve_keeps_the_storage_while_the_elements_fit)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem = {1, 2};
+
+        ///act
+        int result = VECTOR_reserve(g_handle, NUM_ITEM_PUSH_BACK);
+        (void)VECTOR_push_back(g_handle, &sItem, 1);
+        void* storage = VECTOR_front(g_handle);
+        for (size_t nIndex = 1; nIndex < NUM_ITEM_PUSH_BACK; nIndex++)
+        {
+            ASSERT_ARE_EQUAL(int, 0, VECTOR_push_back(g_handle, &sItem, 1));
+        }
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, NUM_ITEM_PUSH_BACK, VECTOR_capacity(g_handle));
+        ASSERT_ARE_EQUAL(void_ptr, storage, VECTOR_front(g_handle));
+    }
+
+    TEST_FUNCTION(Vector_reserve_less_than_the_capacity_does_nothing)
+    {
+        ///arrange
+        (void)VECTOR_reserve(g_handle, NUM_ITEM_PUSH_BACK);
+
+        ///act
+        int result = VECTOR_reserve(g_handle, 1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, NUM_ITEM_PUSH_BACK, VECTOR_capacity(g_handle));
+    }
+
+    TEST_FUNCTION(Vector_erase_keeps_the_capacity)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem = {1, 2};
+        (void)VECTOR_push_back(g_handle, &sItem, 1);
+        (void)VECTOR_push_back(g_handle, &sItem, 1);
+        size_t capacity = VECTOR_capacity(g_handle);
+
+        ///act
+        VECTOR_erase(g_handle, VECTOR_front(g_handle), 1);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 1, VECTOR_size(g_handle));
+        ASSERT_ARE_EQUAL(size_t, capacity, VECTOR_capacity(g_handle));
+    }
+
+    TEST_FUNCTION(Vector_shrink_to_fit_with_NULL_Vector_Fail)
+    {
+        ///arrange
+
+        ///act
+        VECTOR_shrink_to_fit(NULL);
+
+        ///assert
+        // Make sure this shrink_to_fit doesn't crash
+    }
+
+    TEST_FUNCTION(Vector_shrink_to_fit_Success)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem1 = {1, 2};
+        VECTOR_UNITTEST sItem2 = {3, 4};
+        (void)VECTOR_reserve(g_handle, NUM_ITEM_PUSH_BACK);
+        (void)VECTOR_push_back(g_handle, &sItem1, 1);
+        (void)VECTOR_push_back(g_handle, &sItem2, 1);
+
+        ///act
+        VECTOR_shrink_to_fit(g_handle);
+
+        ///assert
+        VECTOR_UNITTEST* pResult = (VECTOR_UNITTEST*)VECTOR_back(g_handle);
+        ASSERT_ARE_EQUAL(size_t, 2, VECTOR_capacity(g_handle));
+        ASSERT_ARE_EQUAL(int, sItem2.nValue1, pResult->nValue1);
+        ASSERT_ARE_EQUAL(int, sItem2.lValue2, pResult->lValue2);
+    }
+
+    TEST_FUNCTION(Vector_shrink_to_fit_Empty_Vector_releases_the_storage)
+    {
+        ///arrange
+        (void)VECTOR_reserve(g_handle, NUM_ITEM_PUSH_BACK);
+
+        ///act
+        VECTOR_shrink_to_fit(g_handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 0, VECTOR_capacity(g_handle));
+        ASSERT_IS_NULL(VECTOR_front(g_handle));
+    }
+
+    TEST_FUNCTION(Vector_sort_with_NULL_Vector_Fail)
+    {
+        ///arrange
+
+        ///act
+        VECTOR_sort(NULL, (VECTOR_COMPARE_FUNCTION)CompareFunction);
+
+        ///assert
+        // Make sure this sort doesn't crash
+    }
+
+    TEST_FUNCTION(Vector_sort_with_NULL_Compare_Func_Fail)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem1 = {2, 0};
+        VECTOR_UNITTEST sItem2 = {1, 0};
+        (void)VECTOR_push_back(g_handle, &sItem1, 1);
+        (void)VECTOR_push_back(g_handle, &sItem2, 1);
+
+        ///act
+        VECTOR_sort(g_handle, NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 2, ((VECTOR_UNITTEST*)VECTOR_front(g_handle))->nValue1);
+    }
+
+    TEST_FUNCTION(Vector_sort_Empty_Vector_Success)
+    {
+        ///arrange
+
+        ///act
+        VECTOR_sort(g_handle, (VECTOR_COMPARE_FUNCTION)CompareFunction);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, 0, VECTOR_size(g_handle));
+    }
+
+    TEST_FUNCTION(Vector_sort_keeps_every_element)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem;
+        for (size_t nIndex = 0; nIndex < NUM_ITEM_SORT; nIndex++)
+        {
+            sItem.nValue1 = (nIndex * 7919) % NUM_ITEM_SORT;
+            sItem.lValue2 = (long)sItem.nValue1;
+            (void)VECTOR_push_back(g_handle, &sItem, 1);
+        }
+
+        ///act
+        VECTOR_sort(g_handle, (VECTOR_COMPARE_FUNCTION)CompareFunction);
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, NUM_ITEM_SORT, VECTOR_size(g_handle));
+        for (size_t nIndex = 0; nIndex < NUM_ITEM_SORT; nIndex++)
+        {
+            VECTOR_UNITTEST* pResult = (VECTOR_UNITTEST*)VECTOR_element(g_handle, nIndex);
+            ASSERT_ARE_EQUAL(size_t, nIndex, pResult->nValue1);
+            ASSERT_ARE_EQUAL(long, (long)nIndex, pResult->lValue2);
+        }
+    }
+
+    TEST_FUNCTION(Vector_sort_of_sorted_reversed_and_duplicate_elements_Success)
+    {
+        ///arrange
+        VECTOR_HANDLE reversed = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        VECTOR_HANDLE duplicates = VECTOR_create(sizeof(VECTOR_UNITTEST));
+        VECTOR_UNITTEST sItem = {0, 0};
+        for (size_t nIndex = 0; nIndex < NUM_ITEM_SORT; nIndex++)
+        {
+            sItem.nValue1 = nIndex;
+            (void)VECTOR_push_back(g_handle, &sItem, 1);
+            sItem.nValue1 = NUM_ITEM_SORT - nIndex;
+            (void)VECTOR_push_back(reversed, &sItem, 1);
+            sItem.nValue1 = nIndex % 3;
+            (void)VECTOR_push_back(duplicates, &sItem, 1);
+        }
+
+        ///act
+        VECTOR_sort(g_handle, (VECTOR_COMPARE_FUNCTION)CompareFunction);
+        VECTOR_sort(reversed, (VECTOR_COMPARE_FUNCTION)CompareFunction);
+        VECTOR_sort(duplicates, (VECTOR_COMPARE_FUNCTION)CompareFunction);
+
+        ///assert
+        ASSERT_IS_SORTED(g_handle);
+        ASSERT_IS_SORTED(reversed);
+        ASSERT_IS_SORTED(duplicates);
+        ASSERT_ARE_EQUAL(size_t, NUM_ITEM_SORT, VECTOR_size(duplicates));
+
+        ///cleanup
+        VECTOR_destroy(reversed);
+        VECTOR_destroy(duplicates);
+    }
+
+    TEST_FUNCTION(Vector_lower_bound_with_NULL_Vector_Fail)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem = {1, 2};
+
+        ///act
+        void* pResult = VECTOR_lower_bound(NULL, (VECTOR_COMPARE_FUNCTION)CompareFunction, &sItem);
+
+        ///assert
+        ASSERT_IS_NULL(pResult);
+    }
+
+    TEST_FUNCTION(Vector_lower_bound_returns_the_first_element_not_less_than_value)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItems[] = { {1, 0}, {3, 1}, {3, 2}, {5, 3} };
+        VECTOR_UNITTEST sValue = {3, 0};
+        VECTOR_UNITTEST sMissing = {4, 0};
+        VECTOR_UNITTEST sTooBig = {6, 0};
+        (void)VECTOR_push_back(g_handle, sItems, 4);
+
+        ///act
+        VECTOR_UNITTEST* pResult = (VECTOR_UNITTEST*)VECTOR_lower_bound(g_handle, (VECTOR_COMPARE_FUNCTION)CompareFunction, &sValue);
+        VECTOR_UNITTEST* pMissing = (VECTOR_UNITTEST*)VECTOR_lower_bound(g_handle, (VECTOR_COMPARE_FUNCTION)CompareFunction, &sMissing);
+        VECTOR_UNITTEST* pTooBig = (VECTOR_UNITTEST*)VECTOR_lower_bound(g_handle, (VECTOR_COMPARE_FUNCTION)CompareFunction, &sTooBig);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, VECTOR_element(g_handle, 1), pResult);
+        ASSERT_ARE_EQUAL(void_ptr, VECTOR_element(g_handle, 3), pMissing);
+        ASSERT_IS_NULL(pTooBig);
+    }
+
+    TEST_FUNCTION(Vector_binary_search_with_NULL_Compare_Func_Fail)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem = {1, 2};
+        (void)VECTOR_push_back(g_handle, &sItem, 1);
+
+        ///act
+        void* pResult = VECTOR_binary_search(g_handle, NULL, &sItem);
+
+        ///assert
+        ASSERT_IS_NULL(pResult);
+    }
+
+    TEST_FUNCTION(Vector_binary_search_Success)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem = {0, 0};
+        for (size_t nIndex = 0; nIndex < NUM_ITEM_SORT; nIndex++)
+        {
+            sItem.nValue1 = 2 * nIndex;
+            sItem.lValue2 = (long)nIndex;
+            (void)VECTOR_push_back(g_handle, &sItem, 1);
+        }
+
+        for (size_t nIndex = 0; nIndex < NUM_ITEM_SORT; nIndex++)
+        {
+            ///act
+            VECTOR_UNITTEST sValue = {2 * nIndex, 0};
+            VECTOR_UNITTEST sMissing = {(2 * nIndex) + 1, 0};
+            VECTOR_UNITTEST* pResult = (VECTOR_UNITTEST*)VECTOR_binary_search(g_handle, (VECTOR_COMPARE_FUNCTION)CompareFunction, &sValue);
+            VECTOR_UNITTEST* pMissing = (VECTOR_UNITTEST*)VECTOR_binary_search(g_handle, (VECTOR_COMPARE_FUNCTION)CompareFunction, &sMissing);
+
+            ///assert
+            ASSERT_IS_NOT_NULL(pResult);
+            ASSERT_ARE_EQUAL(long, (long)nIndex, pResult->lValue2);
+            ASSERT_IS_NULL(pMissing);
+        }
+    }
+
+    TEST_FUNCTION(Vector_insert_sorted_with_NULL_Element_fails)
+    {
+        ///arrange
+
+        ///act
+        int result = VECTOR_insert_sorted(g_handle, NULL, (VECTOR_COMPARE_FUNCTION)CompareFunction);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    }
+
+    TEST_FUNCTION(Vector_insert_sorted_keeps_the_Vector_sorted)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItem = {0, 0};
+
+        ///act
+        for (size_t nIndex = 0; nIndex < NUM_ITEM_SORT; nIndex++)
+        {
+            sItem.nValue1 = (nIndex * 7919) % NUM_ITEM_SORT;
+            ASSERT_ARE_EQUAL(int, 0, VECTOR_insert_sorted(g_handle, &sItem, (VECTOR_COMPARE_FUNCTION)CompareFunction));
+        }
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, NUM_ITEM_SORT, VECTOR_size(g_handle));
+        ASSERT_IS_SORTED(g_handle);
+    }
+
+    TEST_FUNCTION(Vector_insert_sorted_puts_equal_elements_after_the_existing_ones)
+    {
+        ///arrange
+        VECTOR_UNITTEST sItems[] = { {1, 0}, {3, 1}, {5, 2} };
+        VECTOR_UNITTEST sItem = {3, 42};
+        (void)VECTOR_push_back(g_handle, sItems, 3);
+
+        ///act
+        int result = VECTOR_insert_sorted(g_handle, &sItem, (VECTOR_COMPARE_FUNCTION)CompareFunction);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(size_t, 4, VECTOR_size(g_handle));
+        ASSERT_ARE_EQUAL(long, 1, ((VECTOR_UNITTEST*)VECTOR_element(g_handle, 1))->lValue2);
+        ASSERT_ARE_EQUAL(long, 42, ((VECTOR_UNITTEST*)VECTOR_element(g_handle, 2))->lValue2);
+        ASSERT_ARE_EQUAL(long, 2, ((VECTOR_UNITTEST*)VECTOR_element(g_handle, 3))->lValue2);
+    }
+
     /* Vector_Tests END */
 
 END_TEST_SUITE(Vector_UnitTests)